@@ -6,8 +6,10 @@
 #include "ext/portable_misc.h"
 
 static char *caerConfigFilePath = NULL;
+static bool caerConfigFileBinary = false;
 
 static void caerConfigShutDownWriteBack(void);
+static void caerConfigSnapshotDirectoryInit(void);
 
 void caerConfigInit(const char *configFile, int argc, char *argv[]) {
 	// If configFile is NULL, no config file will be accessed at all,
@@ -27,7 +29,18 @@ void caerConfigInit(const char *configFile, int argc, char *argv[]) {
 			fstat(configFileFd, &configFileStat);
 
 			if (configFileStat.st_size > 0) {
-				sshsNodeImportSubTreeFromXML(sshsGetNode(sshsGetGlobal(), "/"), configFileFd, true);
+				// Binary snapshots load much faster than XML, detect them by
+				// their magic number and remember the format for write-back.
+				uint8_t magic[8];
+				caerConfigFileBinary = (read(configFileFd, magic, 8) == 8) && sshsNodeIsBinarySnapshot(magic, 8);
+				lseek(configFileFd, 0, SEEK_SET);
+
+				if (caerConfigFileBinary) {
+					sshsNodeImportSubTreeFromBinary(sshsGetNode(sshsGetGlobal(), "/"), configFileFd, true);
+				}
+				else {
+					sshsNodeImportSubTreeFromXML(sshsGetNode(sshsGetGlobal(), "/"), configFileFd, true);
+				}
 			}
 
 			close(configFileFd);
@@ -63,6 +76,49 @@ void caerConfigInit(const char *configFile, int argc, char *argv[]) {
 			}
 		}
 	}
+
+	caerConfigSnapshotDirectoryInit();
+}
+
+/**
+ * Configuration snapshots are saved next to the configuration file by default.
+ * The directory is made absolute right away, since daemonizing changes the
+ * working directory to '/'.
+ */
+static void caerConfigSnapshotDirectoryInit(void) {
+	sshsNode serverNode = sshsGetNode(sshsGetGlobal(), "/server/");
+
+	if (caerConfigFilePath != NULL) {
+		char *configDirectory = strdup(caerConfigFilePath);
+
+		if (configDirectory != NULL) {
+			// Absolute path from realpath(), so there always is a '/'.
+			char *lastSlash = strrchr(configDirectory, '/');
+			if (lastSlash != NULL) {
+				lastSlash[(lastSlash == configDirectory) ? (1) : (0)] = '\0';
+			}
+
+			sshsNodePutStringIfAbsent(serverNode, "snapshotDirectory", configDirectory);
+
+			free(configDirectory);
+		}
+	}
+
+	sshsNodePutStringIfAbsent(serverNode, "snapshotDirectory", ".");
+
+	char *snapshotDirectory = sshsNodeGetString(serverNode, "snapshotDirectory");
+	char *snapshotDirectoryAbsolute = portable_realpath(snapshotDirectory);
+
+	if (snapshotDirectoryAbsolute != NULL) {
+		sshsNodePutString(serverNode, "snapshotDirectory", snapshotDirectoryAbsolute);
+		free(snapshotDirectoryAbsolute);
+	}
+	else {
+		caerLog(CAER_LOG_WARNING, "Config", "Snapshot directory '%s' doesn't exist. Error: %d.", snapshotDirectory,
+			errno);
+	}
+
+	free(snapshotDirectory);
 }
 
 void caerConfigWriteBack(void) {
@@ -70,8 +126,16 @@ void caerConfigWriteBack(void) {
 		int configFileFd = open(caerConfigFilePath, O_WRONLY | O_TRUNC);
 
 		if (configFileFd >= 0) {
-			sshsNodeExportSubTreeToXML(sshsGetNode(sshsGetGlobal(), "/"), configFileFd, (const char *[] ) { "running",
-					"connectedClients" }, 2, (const char *[] ) { "sourceInfo" }, 1);
+			if (caerConfigFileBinary) {
+				sshsNodeExportSubTreeToBinary(sshsGetNode(sshsGetGlobal(), "/"), configFileFd, (const char *[] ) {
+						"running", "connectedClients" }, 2, (const char *[] ) { "sourceInfo", "clientStatistics",
+							"metrics" }, 3);
+			}
+			else {
+				sshsNodeExportSubTreeToXML(sshsGetNode(sshsGetGlobal(), "/"), configFileFd, (const char *[] ) {
+						"running", "connectedClients" }, 2, (const char *[] ) { "sourceInfo", "clientStatistics",
+							"metrics" }, 3);
+			}
 
 			close(configFileFd);
 		}
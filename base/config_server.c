@@ -1,6 +1,11 @@
 #include "config_server.h"
 #include <stdatomic.h>
 #include "ext/libuv.h"
+#include "ext/uthash/utlist.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #ifdef HAVE_PTHREADS
 #include "ext/c11threads_posix.h"
@@ -9,10 +14,33 @@
 #define CONFIG_SERVER_NAME "Config Server"
 #define UV_RET_CHECK_CS(RET_VAL, FUNC_NAME, CLEANUP_ACTIONS) UV_RET_CHECK(RET_VAL, CONFIG_SERVER_NAME, FUNC_NAME, CLEANUP_ACTIONS)
 
+// Maximum MSG size of a response, see below for the response format.
+#define CONFIG_SERVER_MAX_MSG_LENGTH (CAER_CONFIG_SERVER_BUFFER_SIZE - 4)
+
+struct config_server_subscription {
+	uv_stream_t *client;
+	sshsNode node;
+	struct config_server_subscription *next;
+};
+
+struct config_server_notification {
+	uv_stream_t *client;
+	uint8_t type;
+	size_t msgLength;
+	struct config_server_notification *next;
+	uint8_t msg[];
+};
+
 static struct {
 	atomic_bool running;
 	uv_async_t asyncShutdown;
+	uv_async_t asyncNotify;
 	thrd_t thread;
+	/// Active subscriptions, only ever accessed from the server thread.
+	struct config_server_subscription *subscriptions;
+	/// Notifications queued by SSHS listeners (any thread), sent out by the server thread.
+	struct config_server_notification *notifications;
+	mtx_t notificationsLock;
 } configServerThread;
 
 static void configServerConnection(uv_stream_t *server, int status);
@@ -20,6 +48,12 @@ static void configServerAlloc(uv_handle_t *client, size_t suggestedSize, uv_buf_
 static void configServerRead(uv_stream_t *client, ssize_t sizeRead, const uv_buf_t *buf);
 static void configServerShutdown(uv_shutdown_t *clientShutdown, int status);
 static void configServerAsyncShutdown(uv_async_t *asyncShutdown);
+static void configServerAsyncNotify(uv_async_t *asyncNotify);
+static bool configServerSubscribe(uv_stream_t *client, sshsNode node);
+static void configServerUnsubscribe(uv_stream_t *client, sshsNode node);
+static void configServerAttributeChanged(sshsNode node, void *userData, enum sshs_node_attribute_events event,
+	const char *changeKey, enum sshs_node_attr_value_type changeType, union sshs_node_attr_value changeValue);
+static char *configServerSnapshotPath(const char *snapshotName);
 static int caerConfigServerRunner(void *inPtr);
 static void caerConfigServerHandleRequest(uv_stream_t *client, uint8_t action, uint8_t type, const uint8_t *extra,
 	size_t extraLength, const uint8_t *node, size_t nodeLength, const uint8_t *key, size_t keyLength,
@@ -111,6 +145,9 @@ static void configServerRead(uv_stream_t *client, ssize_t sizeRead, const uv_buf
 	if (sizeRead < 0) {
 		uv_shutdown_t *clientShutdown = NULL;
 
+		// Client is going away, stop sending it notifications.
+		configServerUnsubscribe(client, NULL);
+
 		struct sockaddr_in tcpClientAddr;
 		int tcpClientAddrLength = sizeof(struct sockaddr_in);
 		char tcpClientIP[16] = { 0 };
@@ -212,21 +249,32 @@ static int caerConfigServerRunner(void *inPtr) {
 	sshsNodePutStringIfAbsent(serverNode, "ipAddress", "127.0.0.1");
 	sshsNodePutIntIfAbsent(serverNode, "portNumber", 4040);
 	sshsNodePutShortIfAbsent(serverNode, "backlogSize", 5);
+	// 'snapshotDirectory' is set up by caerConfigInit(), before daemonizing.
 
 	int retVal;
 	bool eventLoopInitialized = false;
+	bool asyncNotifyInitialized = false;
 	bool tcpServerInitialized = false;
 
 	uv_loop_t configServerLoop;
 	uv_tcp_t configServerTCP;
 
+	// Lock for the notification queue, filled by SSHS listeners from any thread.
+	// Initialized first, as the cleanup below always uses it.
+	configServerThread.notifications = NULL;
+
+	if (mtx_init(&configServerThread.notificationsLock, mtx_plain) != thrd_success) {
+		caerLog(CAER_LOG_EMERGENCY, CONFIG_SERVER_NAME, "Failed to initialize notifications lock.");
+		return (EXIT_FAILURE);
+	}
+
 	// Generate address.
 	struct sockaddr_in configServerAddress;
 
 	char *ipAddress = sshsNodeGetString(serverNode, "ipAddress");
 	retVal = uv_ip4_addr(ipAddress, sshsNodeGetInt(serverNode, "portNumber"), &configServerAddress);
-	UV_RET_CHECK_CS(retVal, "uv_ip4_addr", free(ipAddress); goto loopCleanup);
 	free(ipAddress);
+	UV_RET_CHECK_CS(retVal, "uv_ip4_addr", goto loopCleanup);
 
 	// Main event loop for handling connections.
 	retVal = uv_loop_init(&configServerLoop);
@@ -238,6 +286,11 @@ static int caerConfigServerRunner(void *inPtr) {
 	UV_RET_CHECK_CS(retVal, "uv_async_init", goto loopCleanup);
 	atomic_store(&configServerThread.running, true);
 
+	// Initialize async callback to send out attribute change notifications.
+	retVal = uv_async_init(&configServerLoop, &configServerThread.asyncNotify, &configServerAsyncNotify);
+	UV_RET_CHECK_CS(retVal, "uv_async_init", goto loopCleanup);
+	asyncNotifyInitialized = true;
+
 	// Open a TCP server socket for configuration handling.
 	// TCP chosen for reliability, which is more important here than speed.
 	retVal = uv_tcp_init(&configServerLoop, &configServerTCP);
@@ -261,6 +314,13 @@ static int caerConfigServerRunner(void *inPtr) {
 	loopCleanup: {
 		bool errorCleanup = (retVal < 0);
 
+		// Remove all SSHS listeners first, so no new notifications can arrive.
+		configServerUnsubscribe(NULL, NULL);
+
+		if (asyncNotifyInitialized) {
+			uv_close((uv_handle_t *) &configServerThread.asyncNotify, NULL);
+		}
+
 		if (tcpServerInitialized) {
 			uv_close((uv_handle_t *) &configServerTCP, NULL);
 		}
@@ -281,6 +341,8 @@ static int caerConfigServerRunner(void *inPtr) {
 		// Mark the configuration server thread as stopped.
 		atomic_store(&configServerThread.running, false);
 
+		mtx_destroy(&configServerThread.notificationsLock);
+
 		if (errorCleanup) {
 			return (EXIT_FAILURE);
 		}
@@ -363,6 +425,376 @@ static inline void caerConfigSendResponse(uv_stream_t *client, uint8_t action, u
 		"Sent back message to client: action=%" PRIu8 ", type=%" PRIu8 ", msgLength=%zu.", action, type, msgLength);
 }
 
+static bool configServerSubscribe(uv_stream_t *client, sshsNode node) {
+	// Subscribing twice to the same node is a no-op.
+	struct config_server_subscription *sub;
+	LL_FOREACH(configServerThread.subscriptions, sub)
+	{
+		if (sub->client == client && sub->node == node) {
+			return (true);
+		}
+	}
+
+	sub = malloc(sizeof(*sub));
+	if (sub == NULL) {
+		return (false);
+	}
+
+	sub->client = client;
+	sub->node = node;
+
+	LL_PREPEND(configServerThread.subscriptions, sub);
+
+	sshsNodeAddAttributeListener(node, sub, &configServerAttributeChanged);
+
+	return (true);
+}
+
+/**
+ * Remove subscriptions. NULL for client or node matches any.
+ * When all subscriptions of a client are removed, its pending
+ * notifications are discarded too, as the client may be going away.
+ *
+ * @param client client to remove subscriptions for.
+ * @param node node to remove subscriptions for.
+ */
+static void configServerUnsubscribe(uv_stream_t *client, sshsNode node) {
+	struct config_server_subscription *sub, *subTmp;
+	LL_FOREACH_SAFE(configServerThread.subscriptions, sub, subTmp)
+	{
+		if ((client == NULL || sub->client == client) && (node == NULL || sub->node == node)) {
+			// Once this returns, the listener is guaranteed not to be running anymore.
+			sshsNodeRemoveAttributeListener(sub->node, sub, &configServerAttributeChanged);
+
+			LL_DELETE(configServerThread.subscriptions, sub);
+			free(sub);
+		}
+	}
+
+	if (node == NULL) {
+		mtx_lock(&configServerThread.notificationsLock);
+
+		struct config_server_notification *notification, *notificationTmp;
+		LL_FOREACH_SAFE(configServerThread.notifications, notification, notificationTmp)
+		{
+			if (client == NULL || notification->client == client) {
+				LL_DELETE(configServerThread.notifications, notification);
+				free(notification);
+			}
+		}
+
+		mtx_unlock(&configServerThread.notificationsLock);
+	}
+}
+
+// Called by SSHS from whatever thread changed the attribute. Only queue the
+// notification here, as the client may only be written to from the server thread.
+static void configServerAttributeChanged(sshsNode node, void *userData, enum sshs_node_attribute_events event,
+	const char *changeKey, enum sshs_node_attr_value_type changeType, union sshs_node_attr_value changeValue) {
+	UNUSED_ARGUMENT(event);
+
+	struct config_server_subscription *sub = userData;
+
+	char *valueStr = sshsHelperValueToStringConverter(changeType, changeValue);
+	if (valueStr == NULL) {
+		caerLog(CAER_LOG_ERROR, CONFIG_SERVER_NAME, "Failed to allocate memory for notification value string.");
+		return;
+	}
+
+	// Notification MSG is: NODE, KEY, VALUE, all NUL terminated.
+	const char *nodePath = sshsNodeGetPath(node);
+	size_t nodePathLength = strlen(nodePath) + 1;
+	size_t keyLength = strlen(changeKey) + 1;
+	size_t valueLength = strlen(valueStr) + 1;
+	size_t msgLength = nodePathLength + keyLength + valueLength;
+
+	if (msgLength > CONFIG_SERVER_MAX_MSG_LENGTH) {
+		caerLog(CAER_LOG_WARNING, CONFIG_SERVER_NAME, "Notification for '%s%s' too big, dropped.", nodePath,
+			changeKey);
+
+		free(valueStr);
+		return;
+	}
+
+	struct config_server_notification *notification = malloc(sizeof(*notification) + msgLength);
+	if (notification == NULL) {
+		caerLog(CAER_LOG_ERROR, CONFIG_SERVER_NAME, "Failed to allocate memory for notification.");
+
+		free(valueStr);
+		return;
+	}
+
+	notification->client = sub->client;
+	notification->type = (uint8_t) changeType;
+	notification->msgLength = msgLength;
+
+	memcpy(notification->msg, nodePath, nodePathLength);
+	memcpy(notification->msg + nodePathLength, changeKey, keyLength);
+	memcpy(notification->msg + nodePathLength + keyLength, valueStr, valueLength);
+
+	free(valueStr);
+
+	mtx_lock(&configServerThread.notificationsLock);
+	LL_APPEND(configServerThread.notifications, notification);
+	mtx_unlock(&configServerThread.notificationsLock);
+
+	uv_async_send(&configServerThread.asyncNotify);
+}
+
+static void configServerAsyncNotify(uv_async_t *asyncNotify) {
+	UNUSED_ARGUMENT(asyncNotify);
+
+	// Take the whole queue, then send without holding the lock.
+	mtx_lock(&configServerThread.notificationsLock);
+
+	struct config_server_notification *notifications = configServerThread.notifications;
+	configServerThread.notifications = NULL;
+
+	mtx_unlock(&configServerThread.notificationsLock);
+
+	struct config_server_notification *notification, *notificationTmp;
+	LL_FOREACH_SAFE(notifications, notification, notificationTmp)
+	{
+		caerConfigSendResponse(notification->client, CAER_CONFIG_NOTIFY, notification->type, notification->msg,
+			notification->msgLength);
+
+		LL_DELETE(notifications, notification);
+		free(notification);
+	}
+}
+
+/**
+ * Resolve a snapshot name, as given by a client, to a file in the snapshot
+ * directory. Names are plain file names, so clients can't reach outside of
+ * that directory, and get a fixed extension, so they can't replace any
+ * other file in it either.
+ *
+ * @param snapshotName the snapshot name from the client.
+ *
+ * @return the snapshot file path, to be freed by the caller, or NULL if the
+ *         name is invalid.
+ */
+static char *configServerSnapshotPath(const char *snapshotName) {
+	size_t snapshotNameLength = strlen(snapshotName);
+
+	if (snapshotNameLength == 0 || snapshotNameLength > 255 || strchr(snapshotName, '/') != NULL
+		|| strstr(snapshotName, "..") != NULL) {
+		return (NULL);
+	}
+
+	char *snapshotDirectory = sshsNodeGetString(sshsGetNode(sshsGetGlobal(), "/server/"), "snapshotDirectory");
+	size_t snapshotDirectoryLength = strlen(snapshotDirectory);
+
+	// Directory, '/', name, extension and NUL.
+	size_t snapshotPathLength = snapshotDirectoryLength + 1 + snapshotNameLength + strlen(CAER_CONFIG_SNAPSHOT_EXTENSION)
+		+ 1;
+
+	char *snapshotPath = malloc(snapshotPathLength);
+	if (snapshotPath != NULL) {
+		snprintf(snapshotPath, snapshotPathLength, "%s/%s%s", snapshotDirectory, snapshotName,
+			CAER_CONFIG_SNAPSHOT_EXTENSION);
+	}
+
+	free(snapshotDirectory);
+
+	return (snapshotPath);
+}
+
+// Get the next NUL terminated string from a list, or NULL if none is left
+// or it is not properly terminated.
+static const char *configServerNextString(const uint8_t **data, const uint8_t *dataEnd) {
+	const uint8_t *str = *data;
+
+	if (str >= dataEnd) {
+		return (NULL);
+	}
+
+	const uint8_t *strEnd = memchr(str, '\0', (size_t) (dataEnd - str));
+	if (strEnd == NULL) {
+		return (NULL);
+	}
+
+	*data = strEnd + 1;
+
+	return ((const char *) str);
+}
+
+static bool configServerAppendString(uint8_t *msg, size_t *msgLength, const char *str) {
+	size_t strLength = strlen(str) + 1; // +1 for terminating NUL byte.
+
+	if ((*msgLength + strLength) > CONFIG_SERVER_MAX_MSG_LENGTH) {
+		return (false);
+	}
+
+	memcpy(msg + *msgLength, str, strLength);
+	*msgLength += strLength;
+
+	return (true);
+}
+
+static const char *configServerAppendAttribute(uint8_t *msg, size_t *msgLength, sshsNode node, const char *key,
+	enum sshs_node_attr_value_type type) {
+	union sshs_node_attr_value value = sshsNodeGetAttribute(node, key, type);
+
+	char *valueStr = sshsHelperValueToStringConverter(type, value);
+
+	if (type == SSHS_STRING) {
+		free(value.string);
+	}
+
+	if (valueStr == NULL) {
+		return ("Failed to allocate memory for value string.");
+	}
+
+	bool fits = configServerAppendString(msg, msgLength, key)
+		&& configServerAppendString(msg, msgLength, sshsHelperTypeToStringConverter(type))
+		&& configServerAppendString(msg, msgLength, valueStr);
+
+	free(valueStr);
+
+	if (!fits) {
+		return ("Response too big, request fewer attributes at once.");
+	}
+
+	return (NULL);
+}
+
+/**
+ * Get multiple attributes of a node in one response.
+ * Request VALUE is a list of KEY, TYPE string pairs, each NUL terminated.
+ * An empty list requests all attributes of the node.
+ * Response MSG is a list of KEY, TYPE, VALUE string triples.
+ *
+ * @return NULL on success, error message otherwise.
+ */
+static const char *configServerGetMulti(sshsNode node, const uint8_t *value, size_t valueLength, uint8_t *msg,
+	size_t *msgLength) {
+	*msgLength = 0;
+
+	if (valueLength <= 1) {
+		size_t numKeys;
+		const char **attrKeys = sshsNodeGetAttributeKeys(node, &numKeys);
+
+		if (attrKeys == NULL) {
+			return ("Node has no attributes.");
+		}
+
+		for (size_t i = 0; i < numKeys; i++) {
+			// Keys are sorted, and each appears once per type.
+			if (i > 0 && caerStrEquals(attrKeys[i], attrKeys[i - 1])) {
+				continue;
+			}
+
+			size_t numTypes;
+			enum sshs_node_attr_value_type *attrTypes = sshsNodeGetAttributeTypes(node, attrKeys[i], &numTypes);
+
+			for (size_t j = 0; j < numTypes; j++) {
+				const char *error = configServerAppendAttribute(msg, msgLength, node, attrKeys[i], attrTypes[j]);
+				if (error != NULL) {
+					free(attrTypes);
+					free(attrKeys);
+					return (error);
+				}
+			}
+
+			free(attrTypes);
+		}
+
+		free(attrKeys);
+
+		return (NULL);
+	}
+
+	const uint8_t *valueEnd = value + valueLength;
+
+	while (value < valueEnd) {
+		const char *key = configServerNextString(&value, valueEnd);
+		const char *typeStr = configServerNextString(&value, valueEnd);
+
+		if (key == NULL || typeStr == NULL) {
+			return ("Malformed attribute list, expected key and type pairs.");
+		}
+
+		enum sshs_node_attr_value_type type = sshsHelperStringToTypeConverter(typeStr);
+
+		// Only allow operations on existing attributes!
+		if (type == SSHS_UNKNOWN || !sshsNodeAttributeExists(node, key, type)) {
+			return ("Attribute of given type doesn't exist. Operations are only allowed on existing data.");
+		}
+
+		const char *error = configServerAppendAttribute(msg, msgLength, node, key, type);
+		if (error != NULL) {
+			return (error);
+		}
+	}
+
+	return (NULL);
+}
+
+/**
+ * Put multiple attributes of a node at once. Either all values are valid and
+ * get applied together, under a single hold of the node lock, or none is.
+ * Request VALUE is a list of KEY, TYPE, VALUE string triples, each NUL terminated.
+ *
+ * @return NULL on success, error message otherwise.
+ */
+static const char *configServerPutMulti(sshsNode node, const uint8_t *value, size_t valueLength) {
+	const uint8_t *valueEnd = value + valueLength;
+
+	// Count and validate the format first.
+	size_t numAttributes = 0;
+
+	for (const uint8_t *pos = value; pos < valueEnd; numAttributes++) {
+		if (configServerNextString(&pos, valueEnd) == NULL || configServerNextString(&pos, valueEnd) == NULL
+			|| configServerNextString(&pos, valueEnd) == NULL) {
+			return ("Malformed attribute list, expected key, type and value triples.");
+		}
+	}
+
+	if (numAttributes == 0) {
+		return ("No attributes given.");
+	}
+
+	const char *keys[numAttributes];
+	enum sshs_node_attr_value_type types[numAttributes];
+	union sshs_node_attr_value values[numAttributes];
+	const char *error = NULL;
+	size_t numConverted = 0;
+
+	for (const uint8_t *pos = value; numConverted < numAttributes; numConverted++) {
+		keys[numConverted] = configServerNextString(&pos, valueEnd);
+		const char *typeStr = configServerNextString(&pos, valueEnd);
+		const char *valueStr = configServerNextString(&pos, valueEnd);
+
+		types[numConverted] = sshsHelperStringToTypeConverter(typeStr);
+
+		// Only allow operations on existing attributes!
+		if (types[numConverted] == SSHS_UNKNOWN
+			|| !sshsNodeAttributeExists(node, keys[numConverted], types[numConverted])) {
+			error = "Attribute of given type doesn't exist. Operations are only allowed on existing data.";
+			break;
+		}
+
+		if (!sshsHelperStringToValueConverter(types[numConverted], valueStr, &values[numConverted])) {
+			error = "Impossible to convert value according to type.";
+			break;
+		}
+	}
+
+	if (error == NULL) {
+		sshsNodePutAttributes(node, numAttributes, keys, types, values);
+	}
+
+	// Free string copies from helper.
+	for (size_t i = 0; i < numConverted; i++) {
+		if (types[i] == SSHS_STRING) {
+			free(values[i].string);
+		}
+	}
+
+	return (error);
+}
+
 static void caerConfigServerHandleRequest(uv_stream_t *client, uint8_t action, uint8_t type, const uint8_t *extra,
 	size_t extraLength, const uint8_t *node, size_t nodeLength, const uint8_t *key, size_t keyLength,
 	const uint8_t *value, size_t valueLength) {
@@ -664,6 +1096,251 @@ static void caerConfigServerHandleRequest(uv_stream_t *client, uint8_t action, u
 			break;
 		}
 
+		case CAER_CONFIG_GET_MULTI: {
+			bool nodeExists = sshsExistsNode(configStore, (const char *) node);
+
+			// Only allow operations on existing nodes, this is for remote
+			// control, so we only manipulate what's already there!
+			if (!nodeExists) {
+				// Send back error message to client.
+				caerConfigSendError(client, "Node doesn't exist. Operations are only allowed on existing data.");
+
+				break;
+			}
+
+			// This cannot fail, since we know the node exists from above.
+			sshsNode wantedNode = sshsGetNode(configStore, (const char *) node);
+
+			uint8_t msg[CONFIG_SERVER_MAX_MSG_LENGTH];
+			size_t msgLength;
+
+			const char *error = configServerGetMulti(wantedNode, value, valueLength, msg, &msgLength);
+			if (error != NULL) {
+				// Send back error message to client.
+				caerConfigSendError(client, error);
+
+				break;
+			}
+
+			caerConfigSendResponse(client, CAER_CONFIG_GET_MULTI, SSHS_STRING, msg, msgLength);
+
+			break;
+		}
+
+		case CAER_CONFIG_PUT_MULTI: {
+			bool nodeExists = sshsExistsNode(configStore, (const char *) node);
+
+			// Only allow operations on existing nodes, this is for remote
+			// control, so we only manipulate what's already there!
+			if (!nodeExists) {
+				// Send back error message to client.
+				caerConfigSendError(client, "Node doesn't exist. Operations are only allowed on existing data.");
+
+				break;
+			}
+
+			// This cannot fail, since we know the node exists from above.
+			sshsNode wantedNode = sshsGetNode(configStore, (const char *) node);
+
+			const char *error = configServerPutMulti(wantedNode, value, valueLength);
+			if (error != NULL) {
+				// Send back error message to client.
+				caerConfigSendError(client, error);
+
+				break;
+			}
+
+			// Send back confirmation to the client.
+			caerConfigSendResponse(client, CAER_CONFIG_PUT_MULTI, SSHS_BOOL, (const uint8_t *) "true", 5);
+
+			break;
+		}
+
+		case CAER_CONFIG_SUBSCRIBE: {
+			bool nodeExists = sshsExistsNode(configStore, (const char *) node);
+
+			// Only allow operations on existing nodes, this is for remote
+			// control, so we only manipulate what's already there!
+			if (!nodeExists) {
+				// Send back error message to client.
+				caerConfigSendError(client, "Node doesn't exist. Operations are only allowed on existing data.");
+
+				break;
+			}
+
+			// This cannot fail, since we know the node exists from above.
+			sshsNode wantedNode = sshsGetNode(configStore, (const char *) node);
+
+			if (!configServerSubscribe(client, wantedNode)) {
+				// Send back error message to client.
+				caerConfigSendError(client, "Failed to allocate memory for subscription.");
+
+				break;
+			}
+
+			// Send back confirmation to the client. From now on, CAER_CONFIG_NOTIFY
+			// messages can arrive at any time, in between other responses.
+			caerConfigSendResponse(client, CAER_CONFIG_SUBSCRIBE, SSHS_BOOL, (const uint8_t *) "true", 5);
+
+			break;
+		}
+
+		case CAER_CONFIG_UNSUBSCRIBE: {
+			bool nodeExists = sshsExistsNode(configStore, (const char *) node);
+
+			// Only allow operations on existing nodes, this is for remote
+			// control, so we only manipulate what's already there!
+			if (!nodeExists) {
+				// Send back error message to client.
+				caerConfigSendError(client, "Node doesn't exist. Operations are only allowed on existing data.");
+
+				break;
+			}
+
+			// This cannot fail, since we know the node exists from above.
+			sshsNode wantedNode = sshsGetNode(configStore, (const char *) node);
+
+			configServerUnsubscribe(client, wantedNode);
+
+			// Send back confirmation to the client.
+			caerConfigSendResponse(client, CAER_CONFIG_UNSUBSCRIBE, SSHS_BOOL, (const uint8_t *) "true", 5);
+
+			break;
+		}
+
+		case CAER_CONFIG_SNAPSHOT_SAVE: {
+			bool nodeExists = sshsExistsNode(configStore, (const char *) node);
+
+			// Only allow operations on existing nodes, this is for remote
+			// control, so we only manipulate what's already there!
+			if (!nodeExists) {
+				// Send back error message to client.
+				caerConfigSendError(client, "Node doesn't exist. Operations are only allowed on existing data.");
+
+				break;
+			}
+
+			// This cannot fail, since we know the node exists from above.
+			sshsNode wantedNode = sshsGetNode(configStore, (const char *) node);
+
+			// VALUE is the snapshot name, a file in the server's snapshot directory.
+			char *snapshotPath = configServerSnapshotPath((const char *) value);
+			if (snapshotPath == NULL) {
+				// Send back error message to client.
+				caerConfigSendError(client, "Invalid snapshot name.");
+
+				break;
+			}
+
+			// Write to a new temporary file first, then replace the snapshot at once,
+			// so a failed save never leaves a truncated snapshot behind.
+			size_t snapshotPathLength = strlen(snapshotPath);
+			char *snapshotTmpPath = malloc(snapshotPathLength + 5);
+			if (snapshotTmpPath == NULL) {
+				free(snapshotPath);
+
+				// Send back error message to client.
+				caerConfigSendError(client, "Failed to allocate memory for snapshot path.");
+
+				break;
+			}
+
+			memcpy(snapshotTmpPath, snapshotPath, snapshotPathLength);
+			memcpy(snapshotTmpPath + snapshotPathLength, ".tmp", 5);
+
+			int snapshotFd = open(snapshotTmpPath, O_WRONLY | O_CREAT | O_EXCL, S_IWUSR | S_IRUSR | S_IRGRP);
+			if (snapshotFd < 0) {
+				free(snapshotTmpPath);
+				free(snapshotPath);
+
+				// Send back error message to client.
+				caerConfigSendError(client, "Failed to open snapshot file for writing.");
+
+				break;
+			}
+
+			// Same filters as for the configuration file write-back.
+			bool success = sshsNodeExportSubTreeToBinary(wantedNode, snapshotFd, (const char *[] ) { "running",
+					"connectedClients" }, 2, (const char *[] ) { "sourceInfo", "clientStatistics", "metrics" }, 3);
+
+			close(snapshotFd);
+
+			if (success) {
+				success = (rename(snapshotTmpPath, snapshotPath) == 0);
+			}
+
+			if (!success) {
+				unlink(snapshotTmpPath);
+			}
+
+			free(snapshotTmpPath);
+			free(snapshotPath);
+
+			if (!success) {
+				// Send back error message to client.
+				caerConfigSendError(client, "Failed to write snapshot file.");
+
+				break;
+			}
+
+			// Send back confirmation to the client.
+			caerConfigSendResponse(client, CAER_CONFIG_SNAPSHOT_SAVE, SSHS_BOOL, (const uint8_t *) "true", 5);
+
+			break;
+		}
+
+		case CAER_CONFIG_SNAPSHOT_LOAD: {
+			bool nodeExists = sshsExistsNode(configStore, (const char *) node);
+
+			// Only allow operations on existing nodes, this is for remote
+			// control, so we only manipulate what's already there!
+			if (!nodeExists) {
+				// Send back error message to client.
+				caerConfigSendError(client, "Node doesn't exist. Operations are only allowed on existing data.");
+
+				break;
+			}
+
+			// This cannot fail, since we know the node exists from above.
+			sshsNode wantedNode = sshsGetNode(configStore, (const char *) node);
+
+			// VALUE is the snapshot name, a file in the server's snapshot directory.
+			char *snapshotPath = configServerSnapshotPath((const char *) value);
+			if (snapshotPath == NULL) {
+				// Send back error message to client.
+				caerConfigSendError(client, "Invalid snapshot name.");
+
+				break;
+			}
+
+			int snapshotFd = open(snapshotPath, O_RDONLY);
+			free(snapshotPath);
+
+			if (snapshotFd < 0) {
+				// Send back error message to client.
+				caerConfigSendError(client, "Failed to open snapshot file for reading.");
+
+				break;
+			}
+
+			// Header and checksum are verified before anything is applied.
+			bool success = sshsNodeImportSubTreeFromBinary(wantedNode, snapshotFd, true);
+
+			close(snapshotFd);
+
+			if (!success) {
+				// Send back error message to client.
+				caerConfigSendError(client, "Failed to load snapshot file, invalid or corrupted content.");
+
+				break;
+			}
+
+			// Send back confirmation to the client.
+			caerConfigSendResponse(client, CAER_CONFIG_SNAPSHOT_LOAD, SSHS_BOOL, (const uint8_t *) "true", 5);
+
+			break;
+		}
+
 		default:
 			// Unknown action, send error back to client.
 			caerConfigSendError(client, "Unknown action.");
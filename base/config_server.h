@@ -13,6 +13,23 @@
 #define CAER_CONFIG_SERVER_BUFFER_SIZE 4096
 #define CAER_CONFIG_SERVER_HEADER_SIZE 10
 
+// Extension of snapshot files, appended to the snapshot name.
+#define CAER_CONFIG_SNAPSHOT_EXTENSION ".sshs"
+
+// Multi-operation requests (GET_MULTI, PUT_MULTI) carry their attributes
+// in VALUE, as a list of NUL terminated strings: KEY, TYPE pairs for
+// GET_MULTI (empty for all attributes of NODE), KEY, TYPE, VALUE triples
+// for PUT_MULTI. GET_MULTI responds with KEY, TYPE, VALUE triples.
+// PUT_MULTI applies either all given values, or none on error.
+// After SUBSCRIBE, the server pushes NOTIFY messages for every attribute
+// change on NODE, with MSG being NODE, KEY, VALUE and TYPE the attribute
+// type. These can arrive at any time, in between other responses.
+// SNAPSHOT_SAVE and SNAPSHOT_LOAD save or restore the sub-tree at NODE
+// as a binary SSHS snapshot, VALUE being the snapshot name. Snapshots are
+// files in the server's 'snapshotDirectory' (by default the directory of the
+// configuration file), named VALUE plus the snapshot extension. Names with
+// '/' or ".." are rejected.
+
 enum caer_config_actions {
 	CAER_CONFIG_NODE_EXISTS = 0,
 	CAER_CONFIG_ATTR_EXISTS = 1,
@@ -22,6 +39,13 @@ enum caer_config_actions {
 	CAER_CONFIG_GET_CHILDREN = 5,
 	CAER_CONFIG_GET_ATTRIBUTES = 6,
 	CAER_CONFIG_GET_TYPES = 7,
+	CAER_CONFIG_GET_MULTI = 8,
+	CAER_CONFIG_PUT_MULTI = 9,
+	CAER_CONFIG_SUBSCRIBE = 10,
+	CAER_CONFIG_UNSUBSCRIBE = 11,
+	CAER_CONFIG_NOTIFY = 12,
+	CAER_CONFIG_SNAPSHOT_SAVE = 13,
+	CAER_CONFIG_SNAPSHOT_LOAD = 14,
 };
 
 void caerConfigServerStart(void);
@@ -4,10 +4,74 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include "ext/portable_misc.h"
+#include "ext/portable_time.h"
+#include <stdarg.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifdef HAVE_PTHREADS
+#include "ext/c11threads_posix.h"
+#endif
+
+// Records per thread queue, must be a power of two.
+#define CAER_LOG_ASYNC_QUEUE_SIZE 128
+#define CAER_LOG_ASYNC_SUBSYSTEM_LENGTH 64
+#define CAER_LOG_ASYNC_MESSAGE_LENGTH 256
+// The writer collects queued messages every 10 ms.
+#define CAER_LOG_ASYNC_INTERVAL_NS 10000000L
+#define CAER_LOG_ASYNC_BATCH_SIZE (64 * 1024)
+// Rate limited call-sites get at most this many messages through per window.
+#define CAER_LOG_RATE_LIMIT_BURST 5
+#define CAER_LOG_RATE_LIMIT_WINDOW_MS 1000
+
+struct caer_log_record {
+	struct timespec time;
+	uint8_t logLevel;
+	char subSystem[CAER_LOG_ASYNC_SUBSYSTEM_LENGTH];
+	char message[CAER_LOG_ASYNC_MESSAGE_LENGTH];
+};
+
+/**
+ * Single-producer, single-consumer queue. Each logging thread owns one
+ * (the producer), the writer thread drains all of them (the consumer).
+ * Queues are never freed: when a thread exits, its queue is released and
+ * can be claimed by the next thread that starts logging.
+ */
+struct caer_log_queue {
+	atomic_size_t head;
+	atomic_size_t tail;
+	atomic_bool inUse;
+	struct caer_log_queue *next;
+	struct caer_log_record records[CAER_LOG_ASYNC_QUEUE_SIZE];
+};
 
 int CAER_LOG_FILE_FD = -1;
 
+static _Atomic(struct caer_log_queue *) logAsyncQueues = NULL;
+static _Thread_local struct caer_log_queue *logAsyncThreadQueue = NULL;
+static pthread_key_t logAsyncThreadKey;
+static atomic_bool logAsyncRunning = false;
+static bool logAsyncSuspended = false;
+static thrd_t logAsyncWriterThread;
+static atomic_int logAsyncFd1 = -1;
+static atomic_int logAsyncFd2 = -1;
+static atomic_uint_fast64_t logAsyncDroppedFull = 0;
+static atomic_uint_fast64_t logAsyncSuppressed = 0;
+static char logAsyncBatch[CAER_LOG_ASYNC_BATCH_SIZE];
+
 static void caerLogShutDownWriteBack(void);
+static void caerLogAsyncStart(void);
+static void caerLogAsyncStop(void);
+static void caerLogAsyncStartWriter(void);
+static void caerLogAsyncVA(uint8_t logLevel, const char *subSystem, uint32_t suppressed, const char *format,
+	va_list args);
+static struct caer_log_queue *caerLogAsyncGetThreadQueue(void);
+static void caerLogAsyncReleaseThreadQueue(void *queuePtr);
+static int caerLogAsyncWriter(void *unused);
+static void caerLogAsyncDrain(uint64_t *droppedReported);
+static size_t caerLogAsyncAppend(size_t batchLength, const char *line, size_t lineLength);
+static void caerLogAsyncWrite(const char *buf, size_t bufLength);
+static const char *caerLogAsyncLevelName(uint8_t logLevel);
 static void caerLogSSHSLogger(const char *msg);
 static void caerLogLevelListener(sshsNode node, void *userData, enum sshs_node_attribute_events event,
 	const char *changeKey, enum sshs_node_attr_value_type changeType, union sshs_node_attr_value changeValue);
@@ -49,7 +113,7 @@ void caerLogInit(void) {
 	free(logFile);
 
 	// Send log messages to both stderr and the log file.
-	caerLogFileDescriptorsSet(STDERR_FILENO, CAER_LOG_FILE_FD);
+	caerLogSetFileDescriptors(STDERR_FILENO, CAER_LOG_FILE_FD);
 
 	// Make sure log file gets flushed at exit time.
 	atexit(&caerLogShutDownWriteBack);
@@ -64,6 +128,9 @@ void caerLogInit(void) {
 	// set the SSHS logger to use our internal logger too.
 	sshsSetGlobalErrorLogCallback(&caerLogSSHSLogger);
 
+	// Hot paths can now use the asynchronous logger.
+	caerLogAsyncStart();
+
 	// Log sub-system initialized fully and correctly, log this.
 	caerLog(CAER_LOG_NOTICE, "Logger", "Initialization successful with log-level %" PRIu8 ".", logLevel);
 }
@@ -71,6 +138,9 @@ void caerLogInit(void) {
 static void caerLogShutDownWriteBack(void) {
 	caerLog(CAER_LOG_DEBUG, "Logger", "Shutting down ...");
 
+	// Write out whatever is still queued.
+	caerLogAsyncStop();
+
 	// Flush interactive outputs.
 	fflush(stdout);
 	fflush(stderr);
@@ -96,3 +166,336 @@ static void caerLogLevelListener(sshsNode node, void *userData, enum sshs_node_a
 		caerLog(CAER_LOG_DEBUG, "Logger", "Log-level set to %" PRIi8 ".", changeValue.ibyte);
 	}
 }
+
+void caerLogSetFileDescriptors(int fd1, int fd2) {
+	caerLogFileDescriptorsSet(fd1, fd2);
+
+	atomic_store(&logAsyncFd1, fd1);
+	atomic_store(&logAsyncFd2, fd2);
+}
+
+void caerLogAsync(uint8_t logLevel, const char *subSystem, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	caerLogAsyncVA(logLevel, subSystem, 0, format, args);
+	va_end(args);
+}
+
+void caerLogAsyncRateLimited(struct caer_log_rate_limit *site, uint8_t logLevel, const char *subSystem,
+	const char *format, ...) {
+	// Filtered messages don't count against the limit.
+	if (logLevel > caerLogLevelGet()) {
+		return;
+	}
+
+	struct timespec now;
+	portable_clock_gettime_monotonic(&now);
+
+	uint64_t nowMs = (U64T(now.tv_sec) * 1000) + U64T(now.tv_nsec / 1000000);
+
+	uint64_t windowStart = atomic_load_explicit(&site->windowStart, memory_order_relaxed);
+
+	if ((nowMs - windowStart) >= CAER_LOG_RATE_LIMIT_WINDOW_MS) {
+		// Only one thread gets to start the new window.
+		if (atomic_compare_exchange_strong(&site->windowStart, &windowStart, nowMs)) {
+			atomic_store_explicit(&site->windowCount, 0, memory_order_relaxed);
+		}
+	}
+
+	if (atomic_fetch_add_explicit(&site->windowCount, 1, memory_order_relaxed) >= CAER_LOG_RATE_LIMIT_BURST) {
+		atomic_fetch_add_explicit(&site->suppressed, 1, memory_order_relaxed);
+		atomic_fetch_add_explicit(&logAsyncSuppressed, 1, memory_order_relaxed);
+		return;
+	}
+
+	uint32_t suppressed = U32T(atomic_exchange_explicit(&site->suppressed, 0, memory_order_relaxed));
+
+	va_list args;
+	va_start(args, format);
+	caerLogAsyncVA(logLevel, subSystem, suppressed, format, args);
+	va_end(args);
+}
+
+uint64_t caerLogAsyncDropped(void) {
+	return (atomic_load(&logAsyncDroppedFull) + atomic_load(&logAsyncSuppressed));
+}
+
+static void caerLogAsyncStart(void) {
+	if (pthread_key_create(&logAsyncThreadKey, &caerLogAsyncReleaseThreadQueue) != 0) {
+		caerLog(CAER_LOG_WARNING, "Logger", "Failed to create thread key, asynchronous logging disabled.");
+		return;
+	}
+
+	caerLogAsyncStartWriter();
+}
+
+static void caerLogAsyncStartWriter(void) {
+	atomic_store(&logAsyncRunning, true);
+
+	if (thrd_create(&logAsyncWriterThread, &caerLogAsyncWriter, NULL) != thrd_success) {
+		atomic_store(&logAsyncRunning, false);
+
+		caerLog(CAER_LOG_WARNING, "Logger", "Failed to start writer thread, asynchronous logging disabled.");
+	}
+}
+
+static void caerLogAsyncStop(void) {
+	if (!atomic_exchange(&logAsyncRunning, false)) {
+		return;
+	}
+
+	// The writer drains all queues one last time before exiting.
+	thrd_join(logAsyncWriterThread, NULL);
+}
+
+void caerLogAsyncSuspend(void) {
+	logAsyncSuspended = atomic_load(&logAsyncRunning);
+
+	caerLogAsyncStop();
+}
+
+void caerLogAsyncResume(void) {
+	if (!logAsyncSuspended) {
+		return;
+	}
+
+	logAsyncSuspended = false;
+
+	caerLogAsyncStartWriter();
+}
+
+static void caerLogAsyncVA(uint8_t logLevel, const char *subSystem, uint32_t suppressed, const char *format,
+	va_list args) {
+	if (logLevel > caerLogLevelGet()) {
+		return;
+	}
+
+	struct caer_log_queue *queue = NULL;
+
+	if (atomic_load_explicit(&logAsyncRunning, memory_order_acquire)) {
+		queue = caerLogAsyncGetThreadQueue();
+	}
+
+	if (queue == NULL) {
+		// Not running (yet or anymore): log synchronously.
+		char message[CAER_LOG_ASYNC_MESSAGE_LENGTH];
+		vsnprintf(message, CAER_LOG_ASYNC_MESSAGE_LENGTH, format, args);
+
+		if (suppressed > 0) {
+			caerLog(logLevel, subSystem, "%s (%" PRIu32 " similar messages suppressed)", message, suppressed);
+		}
+		else {
+			caerLog(logLevel, subSystem, "%s", message);
+		}
+
+		return;
+	}
+
+	size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+	size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+	if ((head - tail) >= CAER_LOG_ASYNC_QUEUE_SIZE) {
+		// Full: drop instead of blocking, the writer will report it.
+		atomic_fetch_add_explicit(&logAsyncDroppedFull, 1, memory_order_relaxed);
+		return;
+	}
+
+	struct caer_log_record *record = &queue->records[head & (CAER_LOG_ASYNC_QUEUE_SIZE - 1)];
+
+	portable_clock_gettime_realtime(&record->time);
+	record->logLevel = logLevel;
+	snprintf(record->subSystem, CAER_LOG_ASYNC_SUBSYSTEM_LENGTH, "%s", subSystem);
+
+	int messageLength = vsnprintf(record->message, CAER_LOG_ASYNC_MESSAGE_LENGTH, format, args);
+
+	if ((suppressed > 0) && (messageLength >= 0) && (messageLength < CAER_LOG_ASYNC_MESSAGE_LENGTH)) {
+		snprintf(record->message + messageLength, (size_t) (CAER_LOG_ASYNC_MESSAGE_LENGTH - messageLength),
+			" (%" PRIu32 " similar messages suppressed)", suppressed);
+	}
+
+	atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+}
+
+static struct caer_log_queue *caerLogAsyncGetThreadQueue(void) {
+	if (logAsyncThreadQueue != NULL) {
+		return (logAsyncThreadQueue);
+	}
+
+	// Try to reuse a queue released by a thread that exited.
+	struct caer_log_queue *queue = atomic_load(&logAsyncQueues);
+
+	while (queue != NULL) {
+		bool expected = false;
+		if (atomic_compare_exchange_strong(&queue->inUse, &expected, true)) {
+			break;
+		}
+
+		queue = queue->next;
+	}
+
+	if (queue == NULL) {
+		queue = calloc(1, sizeof(*queue));
+		if (queue == NULL) {
+			return (NULL);
+		}
+
+		atomic_store(&queue->inUse, true);
+
+		// Lock-free push to the front of the list, the writer only ever walks it.
+		struct caer_log_queue *first = atomic_load(&logAsyncQueues);
+		do {
+			queue->next = first;
+		}
+		while (!atomic_compare_exchange_weak(&logAsyncQueues, &first, queue));
+	}
+
+	// Release the queue again when this thread exits.
+	pthread_setspecific(logAsyncThreadKey, queue);
+
+	logAsyncThreadQueue = queue;
+
+	return (queue);
+}
+
+static void caerLogAsyncReleaseThreadQueue(void *queuePtr) {
+	struct caer_log_queue *queue = queuePtr;
+
+	atomic_store_explicit(&queue->inUse, false, memory_order_release);
+}
+
+static int caerLogAsyncWriter(void *unused) {
+	UNUSED_ARGUMENT(unused);
+
+	thrd_set_name("LogWriter");
+
+	const struct timespec writeInterval = { .tv_sec = 0, .tv_nsec = CAER_LOG_ASYNC_INTERVAL_NS };
+	uint64_t droppedReported = 0;
+
+	while (atomic_load_explicit(&logAsyncRunning, memory_order_relaxed)) {
+		caerLogAsyncDrain(&droppedReported);
+
+		thrd_sleep(&writeInterval, NULL);
+	}
+
+	// Last round, nothing new should be coming in now.
+	caerLogAsyncDrain(&droppedReported);
+
+	return (EXIT_SUCCESS);
+}
+
+static void caerLogAsyncDrain(uint64_t *droppedReported) {
+	char line[CAER_LOG_ASYNC_SUBSYSTEM_LENGTH + CAER_LOG_ASYNC_MESSAGE_LENGTH + 64];
+	size_t batchLength = 0;
+
+	for (struct caer_log_queue *queue = atomic_load(&logAsyncQueues); queue != NULL; queue = queue->next) {
+		size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+		size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+
+		for (; tail != head; tail++) {
+			const struct caer_log_record *record = &queue->records[tail & (CAER_LOG_ASYNC_QUEUE_SIZE - 1)];
+
+			struct tm recordTime;
+			localtime_r(&record->time.tv_sec, &recordTime);
+
+			char timeString[32];
+			strftime(timeString, sizeof(timeString), "%Y-%m-%d %H:%M:%S", &recordTime);
+
+			int lineLength = snprintf(line, sizeof(line), "%s: %s: %s: %s\n", timeString,
+				caerLogAsyncLevelName(record->logLevel), record->subSystem, record->message);
+
+			if (lineLength > 0) {
+				batchLength = caerLogAsyncAppend(batchLength, line,
+					((size_t) lineLength < sizeof(line)) ? ((size_t) lineLength) : (sizeof(line) - 1));
+			}
+		}
+
+		// Slots can be reused by the producer now.
+		atomic_store_explicit(&queue->tail, tail, memory_order_release);
+	}
+
+	uint64_t dropped = atomic_load_explicit(&logAsyncDroppedFull, memory_order_relaxed);
+
+	if (dropped != *droppedReported) {
+		int lineLength = snprintf(line, sizeof(line), "Logger: %" PRIu64 " messages dropped, queue full.\n",
+			dropped - *droppedReported);
+
+		if (lineLength > 0) {
+			batchLength = caerLogAsyncAppend(batchLength, line, (size_t) lineLength);
+		}
+
+		*droppedReported = dropped;
+	}
+
+	if (batchLength > 0) {
+		caerLogAsyncWrite(logAsyncBatch, batchLength);
+	}
+}
+
+static size_t caerLogAsyncAppend(size_t batchLength, const char *line, size_t lineLength) {
+	if ((batchLength + lineLength) > CAER_LOG_ASYNC_BATCH_SIZE) {
+		caerLogAsyncWrite(logAsyncBatch, batchLength);
+		batchLength = 0;
+	}
+
+	memcpy(logAsyncBatch + batchLength, line, lineLength);
+
+	return (batchLength + lineLength);
+}
+
+static void caerLogAsyncWrite(const char *buf, size_t bufLength) {
+	int fds[2] = { atomic_load(&logAsyncFd1), atomic_load(&logAsyncFd2) };
+
+	for (size_t i = 0; i < 2; i++) {
+		if (fds[i] < 0) {
+			continue;
+		}
+
+		size_t written = 0;
+
+		while (written < bufLength) {
+			ssize_t result = write(fds[i], buf + written, bufLength - written);
+
+			if (result < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+
+				// Nowhere left to report this, give up on this output.
+				break;
+			}
+
+			written += (size_t) result;
+		}
+	}
+}
+
+static const char *caerLogAsyncLevelName(uint8_t logLevel) {
+	switch (logLevel) {
+		case CAER_LOG_EMERGENCY:
+			return ("EMERGENCY");
+
+		case CAER_LOG_ALERT:
+			return ("ALERT");
+
+		case CAER_LOG_CRITICAL:
+			return ("CRITICAL");
+
+		case CAER_LOG_ERROR:
+			return ("ERROR");
+
+		case CAER_LOG_WARNING:
+			return ("WARNING");
+
+		case CAER_LOG_NOTICE:
+			return ("NOTICE");
+
+		case CAER_LOG_INFO:
+			return ("INFO");
+
+		case CAER_LOG_DEBUG:
+			return ("DEBUG");
+
+		default:
+			return ("UNKNOWN");
+	}
+}
@@ -10,9 +10,85 @@
 
 #include "main.h"
 
+#include <stdatomic.h>
+
 extern int CAER_LOG_FILE_FD;
 
 void caerLogInit(void);
 void caerLogDisableConsole(void);
 
+/**
+ * Set where log messages go, for both caerLog() and the asynchronous logger.
+ * Use -1 to disable an output.
+ *
+ * @param fd1 first file descriptor, usually stderr.
+ * @param fd2 second file descriptor, usually the log file.
+ */
+void caerLogSetFileDescriptors(int fd1, int fd2);
+
+/**
+ * Per call-site rate limiting state for caerLogRateLimited().
+ * Zero-initialized static storage is a valid initial state.
+ */
+struct caer_log_rate_limit {
+	atomic_uint_fast64_t windowStart;
+	atomic_uint_fast32_t windowCount;
+	atomic_uint_fast32_t suppressed;
+};
+
+/**
+ * Asynchronous version of caerLog(). The message is formatted into a
+ * per-thread lock-free queue and written out in batches by a background
+ * thread, so calling this never does a system call. If the queue is full,
+ * the message is dropped and counted (see caerLogAsyncDropped()).
+ * Before caerLogInit() and after shutdown, this falls back to caerLog().
+ *
+ * @param logLevel the message's log level.
+ * @param subSystem the sub-system the message comes from.
+ * @param format printf-like format string.
+ */
+void caerLogAsync(uint8_t logLevel, const char *subSystem, const char *format, ...);
+/**
+ * Like caerLogAsync(), but lets through at most a handful of messages per
+ * second from the same call-site. Suppressed messages are counted, and the
+ * count is reported with the next message that gets through.
+ * Use the caerLogRateLimited() macro instead of calling this directly.
+ *
+ * @param site rate limiting state of the call-site.
+ * @param logLevel the message's log level.
+ * @param subSystem the sub-system the message comes from.
+ * @param format printf-like format string.
+ */
+void caerLogAsyncRateLimited(struct caer_log_rate_limit *site, uint8_t logLevel, const char *subSystem,
+	const char *format, ...);
+/**
+ * Get how many asynchronous log messages were dropped so far, either because
+ * a thread's queue was full or by rate limiting.
+ *
+ * @return number of dropped messages.
+ */
+uint64_t caerLogAsyncDropped(void);
+/**
+ * Stop the asynchronous log writer thread, after it wrote out everything
+ * still queued. fork() only carries over the calling thread, so this must
+ * be called before forking, and caerLogAsyncResume() in the process that
+ * continues. Meanwhile, caerLogAsync() falls back to caerLog().
+ */
+void caerLogAsyncSuspend(void);
+/**
+ * Restart the asynchronous log writer thread, if it was running when
+ * caerLogAsyncSuspend() was called.
+ */
+void caerLogAsyncResume(void);
+
+/**
+ * Rate limited, asynchronous logging for hot paths (overload conditions and
+ * the like), where logging must stay cheap and must not make things worse.
+ */
+#define caerLogRateLimited(logLevel, subSystem, ...) \
+	do { \
+		static struct caer_log_rate_limit caerLogRateLimitSite; \
+		caerLogAsyncRateLimited(&caerLogRateLimitSite, logLevel, subSystem, __VA_ARGS__); \
+	} while (0)
+
 #endif /* LOG_H_ */
@@ -23,6 +23,8 @@ struct caer_mainloop_data {
 	sshsNode mainloopNode;
 	atomic_bool running;
 	atomic_uint_fast32_t dataAvailable;
+	/// Packet containers dropped because a ring-buffer between threads was full.
+	atomic_uint_fast64_t dataDropped;
 	caerModuleData modules;
 	UT_array *memoryToFree;
 	UT_array *inputModules;
@@ -17,6 +17,9 @@
 void caerDaemonize(void) {
 	// Double fork to background, for more details take a look at:
 	// http://stackoverflow.com/questions/3095566/linux-daemonize
+	// Threads don't survive fork(), stop the log writer and restart it in the daemon.
+	caerLogAsyncSuspend();
+
 	pid_t result = fork();
 
 	// Handle errors first.
@@ -75,7 +78,9 @@ void caerDaemonize(void) {
 	}
 
 	// Disable stderr logging for caerLog(), keep only the direct logging to file there.
-	caerLogFileDescriptorsSet(-1, CAER_LOG_FILE_FD);
+	caerLogSetFileDescriptors(-1, CAER_LOG_FILE_FD);
+
+	caerLogAsyncResume();
 
 	// At this point everything should be ok and we can return!
 }
@@ -16,6 +16,7 @@
 typedef pthread_t thrd_t;
 typedef pthread_once_t once_flag;
 typedef pthread_mutex_t mtx_t;
+typedef pthread_cond_t cnd_t;
 typedef pthread_rwlock_t mtx_shared_t; // NON STANDARD!
 typedef int (*thrd_start_t)(void *);
 
@@ -190,6 +191,64 @@ static inline int mtx_unlock(mtx_t *mutex) {
 	return (thrd_success);
 }
 
+static inline int cnd_init(cnd_t *cond) {
+	int ret = pthread_cond_init(cond, NULL);
+
+	switch (ret) {
+		case 0:
+			return (thrd_success);
+
+		case ENOMEM:
+			return (thrd_nomem);
+
+		default:
+			return (thrd_error);
+	}
+}
+
+static inline void cnd_destroy(cnd_t *cond) {
+	pthread_cond_destroy(cond);
+}
+
+static inline int cnd_signal(cnd_t *cond) {
+	if (pthread_cond_signal(cond) != 0) {
+		return (thrd_error);
+	}
+
+	return (thrd_success);
+}
+
+static inline int cnd_broadcast(cnd_t *cond) {
+	if (pthread_cond_broadcast(cond) != 0) {
+		return (thrd_error);
+	}
+
+	return (thrd_success);
+}
+
+static inline int cnd_wait(cnd_t *cond, mtx_t *mutex) {
+	if (pthread_cond_wait(cond, mutex) != 0) {
+		return (thrd_error);
+	}
+
+	return (thrd_success);
+}
+
+static inline int cnd_timedwait(cnd_t *restrict cond, mtx_t *restrict mutex, const struct timespec *restrict time_point) {
+	int ret = pthread_cond_timedwait(cond, mutex, time_point);
+
+	switch (ret) {
+		case 0:
+			return (thrd_success);
+
+		case ETIMEDOUT:
+			return (thrd_timedout);
+
+		default:
+			return (thrd_error);
+	}
+}
+
 // NON STANDARD! 'int type' argument doesn't make sense here, always timed and recursive.
 static inline int mtx_shared_init(mtx_shared_t *mutex) {
 	if (pthread_rwlock_init(mutex, NULL) != 0) {
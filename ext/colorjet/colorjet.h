@@ -1,3 +1,6 @@
+#ifndef COLORJET_H_
+#define COLORJET_H_
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -8,3 +11,4 @@ typedef struct {
 
 COLOUR GetColour(double v, double vmin, double vmax);
 
+#endif /* COLORJET_H_ */
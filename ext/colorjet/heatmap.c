@@ -0,0 +1,133 @@
+#include "heatmap.h"
+
+#include <math.h>
+
+// No lookup table index is this large, forces a cell to be redrawn.
+#define HEATMAP_INDEX_INVALID UINT16_MAX
+
+heatmapRenderer heatmapRendererInit(size_t sizeX, size_t sizeY) {
+	heatmapRenderer renderer = calloc(1, sizeof(*renderer));
+	if (renderer == NULL) {
+		return (NULL);
+	}
+
+	renderer->image = calloc(sizeX * sizeY * 3, sizeof(uint16_t));
+	renderer->imageIndexes = malloc(sizeX * sizeY * sizeof(uint16_t));
+	if (renderer->image == NULL || renderer->imageIndexes == NULL) {
+		heatmapRendererFree(renderer);
+		return (NULL);
+	}
+
+	for (size_t i = 0; i < (sizeX * sizeY); i++) {
+		renderer->imageIndexes[i] = HEATMAP_INDEX_INVALID;
+	}
+
+	renderer->sizeX = sizeX;
+	renderer->sizeY = sizeY;
+
+	// No valid range yet, the first heatmapRendererSetRange() always builds the lookup table.
+	renderer->rangeMin = NAN;
+	renderer->rangeMax = NAN;
+
+	return (renderer);
+}
+
+void heatmapRendererFree(heatmapRenderer renderer) {
+	if (renderer != NULL) {
+		free(renderer->image);
+		free(renderer->imageIndexes);
+		free(renderer);
+	}
+}
+
+bool heatmapRendererSetRange(heatmapRenderer renderer, double rangeMin, double rangeMax) {
+	if (renderer->rangeMin == rangeMin && renderer->rangeMax == rangeMax) {
+		return (false);
+	}
+
+	renderer->rangeMin = rangeMin;
+	renderer->rangeMax = rangeMax;
+
+	// Sample the colour scale evenly, first and last entries are exactly the range limits.
+	double step = (rangeMax - rangeMin) / (HEATMAP_LUT_SIZE - 1);
+
+	for (size_t i = 0; i < HEATMAP_LUT_SIZE; i++) {
+		renderer->lut[i] = GetColour(rangeMin + ((double) i * step), rangeMin, rangeMax);
+	}
+
+	// An empty range maps everything to the first colour.
+	renderer->lutScale = (rangeMax > rangeMin) ? ((float) (1.0 / step)) : (0.0f);
+
+	renderer->redrawAll = true;
+
+	return (true);
+}
+
+void heatmapRendererUpdate(heatmapRenderer renderer, simple2DBufferFloat map) {
+	float rangeMin = (float) renderer->rangeMin;
+	float lutScale = renderer->lutScale;
+	bool redrawAll = renderer->redrawAll;
+	bool imageChanged = false;
+
+	for (size_t y = 0; y < renderer->sizeY; y++) {
+		for (size_t x = 0; x < renderer->sizeX; x++) {
+			// Nearest lookup table entry, clamped to the table.
+			float position = ((map->buffer2d[x][y] - rangeMin) * lutScale) + 0.5f;
+			uint16_t index;
+
+			if (position >= (float) (HEATMAP_LUT_SIZE - 1)) {
+				index = HEATMAP_LUT_SIZE - 1;
+			}
+			else if (position > 0) {
+				index = (uint16_t) position;
+			}
+			else {
+				// Below range, or NaN.
+				index = 0;
+			}
+
+			size_t cell = (y * renderer->sizeX) + x;
+
+			if (!redrawAll && renderer->imageIndexes[cell] == index) {
+				continue;
+			}
+
+			renderer->imageIndexes[cell] = index;
+
+			COLOUR col = renderer->lut[index];
+			renderer->image[(cell * 3)] = col.r;
+			renderer->image[(cell * 3) + 1] = col.g;
+			renderer->image[(cell * 3) + 2] = col.b;
+
+			imageChanged = true;
+		}
+	}
+
+	renderer->redrawAll = false;
+	renderer->imageChanged |= imageChanged;
+}
+
+caerFrameEventPacket heatmapRendererGetFrame(heatmapRenderer renderer, int16_t sourceID) {
+	if (!renderer->imageChanged) {
+		return (NULL);
+	}
+
+	int32_t sizeX = (int32_t) renderer->sizeX;
+	int32_t sizeY = (int32_t) renderer->sizeY;
+
+	caerFrameEventPacket framePacket = caerFrameEventPacketAllocate(1, sourceID, 0, sizeX, sizeY, 3);
+	if (framePacket == NULL) {
+		return (NULL);
+	}
+
+	caerFrameEvent frame = caerFrameEventPacketGetEvent(framePacket, 0);
+
+	memcpy(frame->pixels, renderer->image, renderer->sizeX * renderer->sizeY * 3 * sizeof(uint16_t));
+
+	caerFrameEventSetLengthXLengthYChannelNumber(frame, sizeX, sizeY, 3, framePacket);
+	caerFrameEventValidate(frame, framePacket);
+
+	renderer->imageChanged = false;
+
+	return (framePacket);
+}
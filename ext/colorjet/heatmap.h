@@ -0,0 +1,93 @@
+#ifndef HEATMAP_H_
+#define HEATMAP_H_
+
+#include "colorjet.h"
+#include "ext/buffers.h"
+
+#include <libcaer/events/frame.h>
+
+/// Number of colours in the lookup table, spread evenly over the value range.
+#define HEATMAP_LUT_SIZE 1024
+
+/**
+ * Renders a 2D map of values into an RGB frame with the colorjet colour scale.
+ * Colours come from a lookup table that is only rebuilt when the value range
+ * changes, and the RGB image is kept across updates, so that only cells whose
+ * colour changed are redrawn and frames are only produced when needed.
+ */
+struct heatmap_renderer {
+	/// Map size, frame width.
+	size_t sizeX;
+	/// Map size, frame height.
+	size_t sizeY;
+	/// Value mapped to the first colour of the lookup table.
+	double rangeMin;
+	/// Value mapped to the last colour of the lookup table.
+	double rangeMax;
+	/// Lookup table entries per value unit.
+	float lutScale;
+	/// Redraw all cells on the next update, the lookup table changed.
+	bool redrawAll;
+	/// The image changed since the last frame was produced.
+	bool imageChanged;
+	/// Lookup table index shown at each cell, row-major.
+	uint16_t *imageIndexes;
+	/// RGB image, row-major.
+	uint16_t *image;
+	/// Colour lookup table.
+	COLOUR lut[HEATMAP_LUT_SIZE];
+};
+
+typedef struct heatmap_renderer *heatmapRenderer;
+
+/**
+ * Allocate a new renderer for maps of the given size.
+ *
+ * @param sizeX map size in X, the frame width.
+ * @param sizeY map size in Y, the frame height.
+ *
+ * @return the renderer, or NULL on allocation failure.
+ */
+heatmapRenderer heatmapRendererInit(size_t sizeX, size_t sizeY);
+
+/**
+ * Free a renderer. Accepts NULL.
+ *
+ * @param renderer the renderer to free.
+ */
+void heatmapRendererFree(heatmapRenderer renderer);
+
+/**
+ * Set the range of values covered by the colour scale. Values outside of it
+ * are clamped. Rebuilds the lookup table only if the range actually changed.
+ *
+ * @param renderer the renderer.
+ * @param rangeMin value mapped to the lowest colour.
+ * @param rangeMax value mapped to the highest colour.
+ *
+ * @return true if the range changed and heatmapRendererUpdate() has to be called.
+ */
+bool heatmapRendererSetRange(heatmapRenderer renderer, double rangeMin, double rangeMax);
+
+/**
+ * Update the image from the map, which is indexed as map->buffer2d[x][y].
+ * Only cells whose colour changed are redrawn, unless the range changed.
+ *
+ * @param renderer the renderer.
+ * @param map the map to render, with the same size as the renderer.
+ */
+void heatmapRendererUpdate(heatmapRenderer renderer, simple2DBufferFloat map);
+
+/**
+ * Get the current image as a new frame, only if it changed since the last
+ * call. Consumers such as the visualizer keep showing the last frame.
+ *
+ * @param renderer the renderer.
+ * @param sourceID event source ID for the frame packet.
+ *
+ * @return a frame packet to be freed by the caller, or NULL if the image
+ *         did not change or on allocation failure.
+ */
+caerFrameEventPacket heatmapRendererGetFrame(heatmapRenderer renderer, int16_t sourceID);
+
+#endif /* HEATMAP_H_ */
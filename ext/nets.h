@@ -5,8 +5,17 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <unistd.h>
+#include <limits.h>
 #include <uv.h>
 
+#if !defined(OS_WINDOWS)
+#include <sys/uio.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+#endif
+
 /**
  * Write N bytes to the socket S from buffer B.
  *
@@ -84,6 +93,69 @@ static inline bool writeUntilDone(int fd, const uint8_t *buffer, size_t bytesToW
 	return (true);
 }
 
+/**
+ * Write all N buffers to the file descriptor FD, in order, using as few
+ * system calls as possible (scatter-gather I/O via writev() where available).
+ * The buffer descriptors are not modified, the data they point to is not freed.
+ *
+ * @param fd file descriptor FD.
+ * @param buffers array of buffer descriptors.
+ * @param buffersSize number of buffer descriptors in the array.
+ *
+ * @return Return true on success, false on failure.
+ */
+static inline bool writevUntilDone(int fd, const uv_buf_t *buffers, size_t buffersSize) {
+#if defined(OS_WINDOWS)
+	// No writev() on Windows, fall back to one write per buffer.
+	for (size_t i = 0; i < buffersSize; i++) {
+		if (!writeUntilDone(fd, (const uint8_t *) buffers[i].base, buffers[i].len)) {
+			return (false);
+		}
+	}
+
+	return (true);
+#else
+	if (buffersSize == 0) {
+		return (true);
+	}
+
+	struct iovec iov[buffersSize];
+
+	for (size_t i = 0; i < buffersSize; i++) {
+		iov[i].iov_base = buffers[i].base;
+		iov[i].iov_len = buffers[i].len;
+	}
+
+	size_t iovIdx = 0;
+
+	while (iovIdx < buffersSize) {
+		int iovCount = ((buffersSize - iovIdx) > IOV_MAX) ? (IOV_MAX) : ((int) (buffersSize - iovIdx));
+
+		ssize_t writeResult = writev(fd, &iov[iovIdx], iovCount);
+		if (writeResult < 0) {
+			// Error.
+			return (false);
+		}
+
+		// Skip all buffers that were fully written, then adjust
+		// the partially written one (if any) to only hold the rest.
+		size_t written = (size_t) writeResult;
+
+		while (iovIdx < buffersSize && written >= iov[iovIdx].iov_len) {
+			written -= iov[iovIdx].iov_len;
+			iovIdx++;
+		}
+
+		if (written > 0) {
+			iov[iovIdx].iov_base = ((uint8_t *) iov[iovIdx].iov_base) + written;
+			iov[iovIdx].iov_len -= written;
+		}
+	}
+
+	return (true);
+#endif
+}
+
 /**
  * Read N bytes from the file descriptor FD into buffer B.
  *
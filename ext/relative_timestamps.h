@@ -0,0 +1,93 @@
+#ifndef RELATIVE_TIMESTAMPS_H_
+#define RELATIVE_TIMESTAMPS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Per-pixel maps of event times are half the size, and so a lot faster to
+ * scan, with 32 bit timestamps. These are kept relative to a 64 bit base,
+ * plus one, so that zero can still mean "no event yet". Once relative
+ * timestamps get too large, the base moves forward and the map is shifted
+ * down by the same amount.
+ */
+
+// Relative timestamps are rebased once they get this large (~36 minutes),
+#define RELATIVE_TIMESTAMPS_REBASE_LIMIT (UINT32_C(1) << 31)
+// and then keep this much history (~18 minutes).
+#define RELATIVE_TIMESTAMPS_REBASE_KEEP (INT64_C(1) << 30)
+
+struct relative_timestamps {
+	/// Absolute timestamp of relative timestamp 1.
+	int64_t base;
+	/// Base is valid, false until the first relativeTimestampsStart().
+	bool initialized;
+};
+
+enum relative_timestamps_update {
+	/// All timestamps fit, nothing to do.
+	RELATIVE_TIMESTAMPS_FIT,
+	/// First packet, or time went backwards: clear the map, then call relativeTimestampsStart().
+	RELATIVE_TIMESTAMPS_RESTART,
+	/// The base moved forward: shift the map down with relativeTimestampsShift().
+	RELATIVE_TIMESTAMPS_SHIFT,
+};
+
+static inline void relativeTimestampsReset(struct relative_timestamps *rt) {
+	rt->base = 0;
+	rt->initialized = false;
+}
+
+static inline void relativeTimestampsStart(struct relative_timestamps *rt, int64_t firstTS) {
+	rt->base = firstTS;
+	rt->initialized = true;
+}
+
+/**
+ * Make sure all timestamps between firstTS and lastTS fit the relative
+ * 32 bit representation, and tell what needs to be done to the map if not.
+ *
+ * @param rt relative timestamps state.
+ * @param firstTS first (smallest) timestamp that is going to be stored.
+ * @param lastTS last (largest) timestamp that is going to be stored.
+ * @param shift set to the amount to shift the map down by, on RELATIVE_TIMESTAMPS_SHIFT.
+ *
+ * @return what the caller has to do to its map.
+ */
+static inline enum relative_timestamps_update relativeTimestampsUpdate(struct relative_timestamps *rt,
+	int64_t firstTS, int64_t lastTS, uint32_t *shift) {
+	if (!rt->initialized || firstTS < rt->base) {
+		return (RELATIVE_TIMESTAMPS_RESTART);
+	}
+
+	if ((uint64_t) (lastTS - rt->base) < RELATIVE_TIMESTAMPS_REBASE_LIMIT) {
+		return (RELATIVE_TIMESTAMPS_FIT);
+	}
+
+	// Entries older than the shift become zero, which is fine as any
+	// sane time window is way shorter than what is kept.
+	int64_t newBase = lastTS - RELATIVE_TIMESTAMPS_REBASE_KEEP;
+	if (newBase > firstTS) {
+		newBase = firstTS;
+	}
+
+	*shift = (uint32_t) (newBase - rt->base);
+	rt->base = newBase;
+
+	return (RELATIVE_TIMESTAMPS_SHIFT);
+}
+
+static inline void relativeTimestampsShift(uint32_t *timestamps, size_t length, uint32_t shift) {
+	// Branch-free, so the compiler can vectorize it.
+	for (size_t i = 0; i < length; i++) {
+		uint32_t timestamp = timestamps[i];
+		timestamps[i] = (timestamp > shift) ? (timestamp - shift) : (0);
+	}
+}
+
+static inline uint32_t relativeTimestampsGet(const struct relative_timestamps *rt, int64_t timestamp) {
+	return ((uint32_t) (timestamp - rt->base + 1));
+}
+
+#endif /* RELATIVE_TIMESTAMPS_H_ */
@@ -10,6 +10,7 @@
 
 // SSHS node
 typedef struct sshs_node *sshsNode;
+typedef struct sshs_node_attr *sshsNodeAttrHandle;
 
 enum sshs_node_attr_value_type {
 	SSHS_UNKNOWN = -1,
@@ -61,6 +62,8 @@ void sshsNodeRemoveAttributeListener(sshsNode node, void *userData,
 void sshsNodeRemoveAllAttributeListeners(sshsNode node);
 bool sshsNodeAttributeExists(sshsNode node, const char *key, enum sshs_node_attr_value_type type);
 union sshs_node_attr_value sshsNodeGetAttribute(sshsNode node, const char *key, enum sshs_node_attr_value_type type);
+void sshsNodePutAttributes(sshsNode node, size_t numAttributes, const char **keys,
+	const enum sshs_node_attr_value_type *types, const union sshs_node_attr_value *values); // Single lock hold.
 bool sshsNodePutBoolIfAbsent(sshsNode node, const char *key, bool value);
 void sshsNodePutBool(sshsNode node, const char *key, bool value);
 bool sshsNodeGetBool(sshsNode node, const char *key);
@@ -85,11 +88,25 @@ double sshsNodeGetDouble(sshsNode node, const char *key);
 bool sshsNodePutStringIfAbsent(sshsNode node, const char *key, const char *value);
 void sshsNodePutString(sshsNode node, const char *key, const char *value);
 char *sshsNodeGetString(sshsNode node, const char *key);
+sshsNodeAttrHandle sshsNodeGetAttributeHandle(sshsNode node, const char *key, enum sshs_node_attr_value_type type); // Not for strings.
+union sshs_node_attr_value sshsNodeAttrHandleGet(sshsNodeAttrHandle handle);
+uint32_t sshsNodeAttrHandleGetVersion(sshsNodeAttrHandle handle); // Changes on every update.
+bool sshsNodeAttrHandleGetBool(sshsNodeAttrHandle handle);
+int8_t sshsNodeAttrHandleGetByte(sshsNodeAttrHandle handle);
+int16_t sshsNodeAttrHandleGetShort(sshsNodeAttrHandle handle);
+int32_t sshsNodeAttrHandleGetInt(sshsNodeAttrHandle handle);
+int64_t sshsNodeAttrHandleGetLong(sshsNodeAttrHandle handle);
+float sshsNodeAttrHandleGetFloat(sshsNodeAttrHandle handle);
+double sshsNodeAttrHandleGetDouble(sshsNodeAttrHandle handle);
 void sshsNodeExportNodeToXML(sshsNode node, int outFd, const char **filterKeys, size_t filterKeysLength);
 void sshsNodeExportSubTreeToXML(sshsNode node, int outFd, const char **filterKeys, size_t filterKeysLength,
 	const char **filterNodes, size_t filterNodesLength);
 bool sshsNodeImportNodeFromXML(sshsNode node, int inFd, bool strict);
 bool sshsNodeImportSubTreeFromXML(sshsNode node, int inFd, bool strict);
+bool sshsNodeExportSubTreeToBinary(sshsNode node, int outFd, const char **filterKeys, size_t filterKeysLength,
+	const char **filterNodes, size_t filterNodesLength);
+bool sshsNodeImportSubTreeFromBinary(sshsNode node, int inFd, bool strict);
+bool sshsNodeIsBinarySnapshot(const uint8_t *data, size_t dataLength); // Check magic, needs 8 bytes.
 bool sshsNodeStringToNodeConverter(sshsNode node, const char *key, const char *type, const char *value);
 const char **sshsNodeGetChildNames(sshsNode node, size_t *numNames);
 const char **sshsNodeGetAttributeKeys(sshsNode node, size_t *numKeys);
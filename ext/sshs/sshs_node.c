@@ -1,6 +1,44 @@
 #include "sshs_internal.h"
 #include "ext/uthash/uthash.h"
 #include "ext/uthash/utlist.h"
+#include <stdatomic.h>
+#include <unistd.h>
+
+// Lock-free read index, insert-only open-addressing table of attributes.
+// Attributes are never removed from a node, so an entry, once published,
+// stays valid for the lifetime of the node. On growth, the previous index
+// is kept on the retired list, since readers may still be probing it.
+struct sshs_node_attr_index {
+	size_t capacity;
+	size_t count;
+	struct sshs_node_attr_index *retired;
+	_Atomic(sshsNodeAttr) entries[];
+};
+
+#define SSHS_NODE_ATTR_INDEX_MIN_CAPACITY 16
+
+// Binary snapshot format, all integers little-endian:
+// header: 8 bytes magic, u32 version, u32 CRC-32 of payload, u64 payload length.
+// payload: one node record, recursively containing its children:
+// node: string name, u32 number of attributes, attributes, u32 number of children, nodes.
+// attribute: u8 type, string key, value (1/1/2/4/8/4/8 bytes for bool to double, string).
+// string: u32 length including NUL terminator, then the bytes including the NUL.
+#define SSHS_BINARY_MAGIC "#SSHSBIN"
+#define SSHS_BINARY_MAGIC_LENGTH 8
+#define SSHS_BINARY_VERSION 1
+#define SSHS_BINARY_HEADER_LENGTH 24
+
+struct sshs_binary_buffer {
+	uint8_t *data;
+	size_t size;
+	size_t used;
+};
+
+struct sshs_binary_reader {
+	const uint8_t *data;
+	size_t size;
+	size_t pos;
+};
 
 struct sshs_node {
 	char *name;
@@ -8,6 +46,7 @@ struct sshs_node {
 	sshsNode parent;
 	sshsNode children;
 	sshsNodeAttr attributes;
+	_Atomic(struct sshs_node_attr_index *) attrIndex;
 	sshsNodeListener nodeListeners;
 	sshsNodeAttrListener attrListeners;
 	mtx_shared_t traversal_lock;
@@ -17,6 +56,8 @@ struct sshs_node {
 
 struct sshs_node_attr {
 	UT_hash_handle hh;
+	/// Sequence counter for lock-free readers, odd while value is being updated.
+	atomic_uint_fast32_t version;
 	union sshs_node_attr_value value;
 	enum sshs_node_attr_value_type value_type;
 	char key[];
@@ -42,6 +83,11 @@ static void sshsNodePutAttribute(sshsNode node, const char *key, enum sshs_node_
 static bool sshsNodeCheckAttributeValueChanged(enum sshs_node_attr_value_type type, union sshs_node_attr_value oldValue,
 	union sshs_node_attr_value newValue);
 static sshsNodeAttr *sshsNodeGetAttributes(sshsNode node, size_t *numAttributes);
+static size_t sshsNodeAttrHash(const char *key, enum sshs_node_attr_value_type type);
+static void sshsNodeAttrIndexAdd(sshsNode node, sshsNodeAttr attr);
+static sshsNodeAttr sshsNodeAttrIndexFind(sshsNode node, const char *key, enum sshs_node_attr_value_type type);
+static union sshs_node_attr_value sshsNodeAttrReadValue(sshsNodeAttr attr);
+static void sshsNodeAttrWriteValue(sshsNodeAttr attr, union sshs_node_attr_value value);
 static const char *sshsNodeXMLWhitespaceCallback(mxml_node_t *node, int where);
 static void sshsNodeToXML(sshsNode node, int outFd, bool recursive, const char **filterKeys, size_t filterKeysLength,
 	const char **filterNodes, size_t filterNodesLength);
@@ -50,6 +96,14 @@ static mxml_node_t *sshsNodeGenerateXML(sshsNode node, bool recursive, const cha
 static mxml_node_t **sshsNodeXMLFilterChildNodes(mxml_node_t *node, const char *nodeName, size_t *numChildren);
 static bool sshsNodeFromXML(sshsNode node, int inFd, bool recursive, bool strict);
 static void sshsNodeConsumeXML(sshsNode node, mxml_node_t *content, bool recursive);
+static void sshsNodeToBinary(sshsNode node, struct sshs_binary_buffer *buffer, const char **filterKeys,
+	size_t filterKeysLength, const char **filterNodes, size_t filterNodesLength);
+static bool sshsNodeFromBinary(sshsNode node, struct sshs_binary_reader *reader);
+static uint32_t sshsBinaryCRC32(const uint8_t *data, size_t dataLength);
+static void sshsBinaryReserve(struct sshs_binary_buffer *buffer, size_t length);
+static void sshsBinaryWriteU32(uint8_t *dest, uint32_t value);
+static uint32_t sshsBinaryReadU32(const uint8_t *src);
+static bool sshsBinaryGetString(struct sshs_binary_reader *reader, const char **str);
 
 sshsNode sshsNodeNew(const char *nodeName, sshsNode parent) {
 	sshsNode newNode = malloc(sizeof(*newNode));
@@ -67,6 +121,7 @@ sshsNode sshsNodeNew(const char *nodeName, sshsNode parent) {
 	newNode->parent = parent;
 	newNode->children = NULL;
 	newNode->attributes = NULL;
+	atomic_store_explicit(&newNode->attrIndex, NULL, memory_order_relaxed);
 	newNode->nodeListeners = NULL;
 	newNode->attrListeners = NULL;
 
@@ -333,26 +388,8 @@ void sshsNodeTransactionUnlock(sshsNode node) {
 }
 
 bool sshsNodeAttributeExists(sshsNode node, const char *key, enum sshs_node_attr_value_type type) {
-	size_t keyLength = strlen(key);
-	sshsNodeAttr lookupAttr = malloc(sizeof(*lookupAttr) + keyLength + 1);
-	SSHS_MALLOC_CHECK_EXIT(lookupAttr);
-	memset(lookupAttr, 0, sizeof(*lookupAttr));
-
-	lookupAttr->value_type = type;
-	strcpy(lookupAttr->key, key);
-
-	size_t fullKeyLength = offsetof(struct sshs_node_attr, key) + keyLength
-		+ 1- offsetof(struct sshs_node_attr, value_type);
-
-	mtx_shared_lock_shared(&node->node_lock);
-
-	sshsNodeAttr attr;
-	HASH_FIND(hh, node->attributes, &lookupAttr->value_type, fullKeyLength, attr);
-
-	mtx_shared_unlock_shared(&node->node_lock);
-
-	// Free lookup key again.
-	free(lookupAttr);
+	// Lock-free lookup, attributes can only ever be added, never removed.
+	sshsNodeAttr attr = sshsNodeAttrIndexFind(node, key, type);
 
 	// If attr == NULL, the specified attribute was not found.
 	if (attr == NULL) {
@@ -381,6 +418,7 @@ static bool sshsNodePutAttributeIfAbsent(sshsNode node, const char *key, enum ss
 		newAttr->value = value;
 	}
 
+	atomic_store_explicit(&newAttr->version, 0, memory_order_relaxed);
 	newAttr->value_type = type;
 	strcpy(newAttr->key, key);
 
@@ -395,6 +433,7 @@ static bool sshsNodePutAttributeIfAbsent(sshsNode node, const char *key, enum ss
 	// Only add if not present.
 	if (oldAttr == NULL) {
 		HASH_ADD(hh, node->attributes, value_type, fullKeyLength, newAttr);
+		sshsNodeAttrIndexAdd(node, newAttr);
 	}
 
 	mtx_shared_unlock_exclusive(&node->node_lock);
@@ -443,6 +482,7 @@ static void sshsNodePutAttribute(sshsNode node, const char *key, enum sshs_node_
 		newAttr->value = value;
 	}
 
+	atomic_store_explicit(&newAttr->version, 0, memory_order_relaxed);
 	newAttr->value_type = type;
 	strcpy(newAttr->key, key);
 
@@ -459,12 +499,13 @@ static void sshsNodePutAttribute(sshsNode node, const char *key, enum sshs_node_
 	// If not present, add the new one, else update the old one.
 	if (oldAttr == NULL) {
 		HASH_ADD(hh, node->attributes, value_type, fullKeyLength, newAttr);
+		sshsNodeAttrIndexAdd(node, newAttr);
 	}
 	else {
 		// Key and valueType have to be the same, so only update the value
 		// itself with the new one, and save the old one for later.
 		oldAttrValue = oldAttr->value;
-		oldAttr->value = newAttr->value;
+		sshsNodeAttrWriteValue(oldAttr, newAttr->value);
 	}
 
 	mtx_shared_unlock_exclusive(&node->node_lock);
@@ -508,6 +549,106 @@ static void sshsNodePutAttribute(sshsNode node, const char *key, enum sshs_node_
 	}
 }
 
+void sshsNodePutAttributes(sshsNode node, size_t numAttributes, const char **keys,
+	const enum sshs_node_attr_value_type *types, const union sshs_node_attr_value *values) {
+	if (numAttributes == 0) {
+		return;
+	}
+
+	sshsNodeAttr *newAttrs = malloc(numAttributes * sizeof(*newAttrs));
+	SSHS_MALLOC_CHECK_EXIT(newAttrs);
+
+	sshsNodeAttr *oldAttrs = malloc(numAttributes * sizeof(*oldAttrs));
+	SSHS_MALLOC_CHECK_EXIT(oldAttrs);
+
+	union sshs_node_attr_value *oldAttrValues = malloc(numAttributes * sizeof(*oldAttrValues));
+	SSHS_MALLOC_CHECK_EXIT(oldAttrValues);
+
+	// Prepare all new attributes first, so the lock is held as short as possible.
+	for (size_t i = 0; i < numAttributes; i++) {
+		size_t keyLength = strlen(keys[i]);
+		newAttrs[i] = malloc(sizeof(*newAttrs[i]) + keyLength + 1);
+		SSHS_MALLOC_CHECK_EXIT(newAttrs[i]);
+		memset(newAttrs[i], 0, sizeof(*newAttrs[i]));
+
+		if (types[i] == SSHS_STRING) {
+			// Make a copy of the string so we own the memory internally.
+			char *valueCopy = strdup(values[i].string);
+			SSHS_MALLOC_CHECK_EXIT(valueCopy);
+
+			newAttrs[i]->value.string = valueCopy;
+		}
+		else {
+			newAttrs[i]->value = values[i];
+		}
+
+		atomic_store_explicit(&newAttrs[i]->version, 0, memory_order_relaxed);
+		newAttrs[i]->value_type = types[i];
+		strcpy(newAttrs[i]->key, keys[i]);
+	}
+
+	// Apply all updates under one exclusive lock, so that other writers
+	// and locked readers see either none or all of them.
+	mtx_shared_lock_exclusive(&node->node_lock);
+
+	for (size_t i = 0; i < numAttributes; i++) {
+		size_t fullKeyLength = offsetof(struct sshs_node_attr, key) + strlen(keys[i])
+			+ 1- offsetof(struct sshs_node_attr, value_type);
+
+		HASH_FIND(hh, node->attributes, &newAttrs[i]->value_type, fullKeyLength, oldAttrs[i]);
+
+		// If not present, add the new one, else update the old one.
+		if (oldAttrs[i] == NULL) {
+			HASH_ADD(hh, node->attributes, value_type, fullKeyLength, newAttrs[i]);
+			sshsNodeAttrIndexAdd(node, newAttrs[i]);
+		}
+		else {
+			oldAttrValues[i] = oldAttrs[i]->value;
+			sshsNodeAttrWriteValue(oldAttrs[i], newAttrs[i]->value);
+		}
+	}
+
+	mtx_shared_unlock_exclusive(&node->node_lock);
+
+	// Listener support. Call only on change, same as for single updates.
+	mtx_shared_lock_shared(&node->node_lock);
+
+	for (size_t i = 0; i < numAttributes; i++) {
+		sshsNodeAttrListener l;
+
+		if (oldAttrs[i] == NULL) {
+			LL_FOREACH(node->attrListeners, l)
+			{
+				l->attribute_changed(node, l->userData, SSHS_ATTRIBUTE_ADDED, keys[i], types[i], values[i]);
+			}
+		}
+		else if (sshsNodeCheckAttributeValueChanged(types[i], oldAttrValues[i], values[i])) {
+			LL_FOREACH(node->attrListeners, l)
+			{
+				l->attribute_changed(node, l->userData, SSHS_ATTRIBUTE_MODIFIED, keys[i], types[i], values[i]);
+			}
+		}
+	}
+
+	mtx_shared_unlock_shared(&node->node_lock);
+
+	// Free newAttr memory, if not added to table, and the old string values,
+	// same as in sshsNodePutAttribute().
+	for (size_t i = 0; i < numAttributes; i++) {
+		if (oldAttrs[i] != NULL) {
+			if (types[i] == SSHS_STRING) {
+				free(oldAttrValues[i].string);
+			}
+
+			free(newAttrs[i]);
+		}
+	}
+
+	free(oldAttrValues);
+	free(oldAttrs);
+	free(newAttrs);
+}
+
 static bool sshsNodeCheckAttributeValueChanged(enum sshs_node_attr_value_type type, union sshs_node_attr_value oldValue,
 	union sshs_node_attr_value newValue) {
 	// Check that the two values changed, that there is a difference between then.
@@ -543,49 +684,35 @@ static bool sshsNodeCheckAttributeValueChanged(enum sshs_node_attr_value_type ty
 }
 
 union sshs_node_attr_value sshsNodeGetAttribute(sshsNode node, const char *key, enum sshs_node_attr_value_type type) {
-	size_t keyLength = strlen(key);
-	sshsNodeAttr lookupAttr = malloc(sizeof(*lookupAttr) + keyLength + 1);
-	SSHS_MALLOC_CHECK_EXIT(lookupAttr);
-	memset(lookupAttr, 0, sizeof(*lookupAttr));
-
-	lookupAttr->value_type = type;
-	strcpy(lookupAttr->key, key);
-
-	size_t fullKeyLength = offsetof(struct sshs_node_attr, key) + keyLength
-		+ 1- offsetof(struct sshs_node_attr, value_type);
-
-	mtx_shared_lock_shared(&node->node_lock);
+	union sshs_node_attr_value value = { .ilong = 0 };
 
-	sshsNodeAttr attr;
-	HASH_FIND(hh, node->attributes, &lookupAttr->value_type, fullKeyLength, attr);
+	// Lookup never takes a lock: attributes are never removed, so the
+	// pointer we get back stays valid.
+	sshsNodeAttr attr = sshsNodeAttrIndexFind(node, key, type);
 
-	// Copy the value while still holding the lock, to ensure accessing it is
-	// still possible and the value behind it valid.
-	union sshs_node_attr_value value = { .ilong = 0 };
 	if (attr != NULL) {
-		value = attr->value;
-
-		// For strings, make a copy on the heap to give out.
 		if (type == SSHS_STRING) {
-			char *valueCopy = strdup(value.string);
+			// Strings are freed by writers on update, so the copy must be
+			// made while holding the lock, to ensure the memory stays valid.
+			mtx_shared_lock_shared(&node->node_lock);
+
+			char *valueCopy = strdup(attr->value.string);
 			SSHS_MALLOC_CHECK_EXIT(valueCopy);
 
+			mtx_shared_unlock_shared(&node->node_lock);
+
 			value.string = valueCopy;
 		}
+		else {
+			// All other types fit into the value itself, so a consistent
+			// copy can be obtained lock-free.
+			value = sshsNodeAttrReadValue(attr);
+		}
 	}
 
-	mtx_shared_unlock_shared(&node->node_lock);
-
-	// Free lookup key again.
-	free(lookupAttr);
-
 	// Verify that we're getting values from a valid attribute.
 	// Valid means it already exists and has a well-defined default.
 	if (attr == NULL) {
-		if (type == SSHS_STRING) {
-			free(value.string);
-		}
-
 		char errorMsg[1024];
 		snprintf(errorMsg, 1024, "Attribute '%s' of type '%s' not present, please initialize it first.", key,
 			sshsHelperTypeToStringConverter(type));
@@ -600,6 +727,144 @@ union sshs_node_attr_value sshsNodeGetAttribute(sshsNode node, const char *key,
 	return (value);
 }
 
+static size_t sshsNodeAttrHash(const char *key, enum sshs_node_attr_value_type type) {
+	// FNV-1a over the key string, seeded with the type.
+	uint64_t hash = UINT64_C(14695981039346656037) ^ (uint64_t) type;
+
+	while (*key != '\0') {
+		hash ^= (uint8_t) *key++;
+		hash *= UINT64_C(1099511628211);
+	}
+
+	return ((size_t) hash);
+}
+
+/**
+ * Publish a newly added attribute in the lock-free read index.
+ * Must be called with the node_lock held exclusively, after the attribute
+ * has been fully initialized.
+ *
+ * @param node the node the attribute belongs to.
+ * @param attr the new attribute.
+ */
+static void sshsNodeAttrIndexAdd(sshsNode node, sshsNodeAttr attr) {
+	struct sshs_node_attr_index *index = atomic_load_explicit(&node->attrIndex, memory_order_relaxed);
+
+	// Keep the load factor at or below 1/2, so probe sequences stay short
+	// and always end at an empty slot.
+	if (index == NULL || ((index->count + 1) * 2) > index->capacity) {
+		size_t newCapacity = (index == NULL) ? (SSHS_NODE_ATTR_INDEX_MIN_CAPACITY) : (index->capacity * 2);
+
+		struct sshs_node_attr_index *newIndex = malloc(sizeof(*newIndex) + (newCapacity * sizeof(sshsNodeAttr)));
+		SSHS_MALLOC_CHECK_EXIT(newIndex);
+
+		newIndex->capacity = newCapacity;
+		newIndex->count = 0;
+		newIndex->retired = index;
+
+		for (size_t i = 0; i < newCapacity; i++) {
+			atomic_store_explicit(&newIndex->entries[i], NULL, memory_order_relaxed);
+		}
+
+		if (index != NULL) {
+			for (size_t i = 0; i < index->capacity; i++) {
+				sshsNodeAttr a = atomic_load_explicit(&index->entries[i], memory_order_relaxed);
+
+				if (a != NULL) {
+					size_t pos = sshsNodeAttrHash(a->key, a->value_type) & (newCapacity - 1);
+
+					while (atomic_load_explicit(&newIndex->entries[pos], memory_order_relaxed) != NULL) {
+						pos = (pos + 1) & (newCapacity - 1);
+					}
+
+					atomic_store_explicit(&newIndex->entries[pos], a, memory_order_relaxed);
+					newIndex->count++;
+				}
+			}
+		}
+
+		// Readers still probing the old index find everything that was in
+		// it, and will see the new one on their next lookup.
+		atomic_store_explicit(&node->attrIndex, newIndex, memory_order_release);
+		index = newIndex;
+	}
+
+	size_t pos = sshsNodeAttrHash(attr->key, attr->value_type) & (index->capacity - 1);
+
+	while (atomic_load_explicit(&index->entries[pos], memory_order_relaxed) != NULL) {
+		pos = (pos + 1) & (index->capacity - 1);
+	}
+
+	atomic_store_explicit(&index->entries[pos], attr, memory_order_release);
+	index->count++;
+}
+
+static sshsNodeAttr sshsNodeAttrIndexFind(sshsNode node, const char *key, enum sshs_node_attr_value_type type) {
+	struct sshs_node_attr_index *index = atomic_load_explicit(&node->attrIndex, memory_order_acquire);
+
+	if (index == NULL) {
+		return (NULL);
+	}
+
+	size_t pos = sshsNodeAttrHash(key, type) & (index->capacity - 1);
+
+	while (true) {
+		sshsNodeAttr attr = atomic_load_explicit(&index->entries[pos], memory_order_acquire);
+
+		if (attr == NULL) {
+			return (NULL);
+		}
+
+		if (attr->value_type == type && strcmp(attr->key, key) == 0) {
+			return (attr);
+		}
+
+		pos = (pos + 1) & (index->capacity - 1);
+	}
+}
+
+/**
+ * Get a consistent copy of an attribute's value without locking.
+ * Retries if a writer updated the value concurrently (seqlock).
+ *
+ * @param attr the attribute to read.
+ *
+ * @return a copy of the attribute's value.
+ */
+static union sshs_node_attr_value sshsNodeAttrReadValue(sshsNodeAttr attr) {
+	union sshs_node_attr_value value;
+	uint_fast32_t version;
+
+	do {
+		version = atomic_load_explicit(&attr->version, memory_order_acquire);
+
+		value = attr->value;
+
+		atomic_thread_fence(memory_order_acquire);
+	} while ((version & 0x01) != 0 || version != atomic_load_explicit(&attr->version, memory_order_relaxed));
+
+	return (value);
+}
+
+/**
+ * Update an attribute's value, so that lock-free readers never see
+ * a partially written value. Must be called with the node_lock held
+ * exclusively, which serializes writers.
+ *
+ * @param attr the attribute to update.
+ * @param value the new value.
+ */
+static void sshsNodeAttrWriteValue(sshsNodeAttr attr, union sshs_node_attr_value value) {
+	uint_fast32_t version = atomic_load_explicit(&attr->version, memory_order_relaxed);
+
+	atomic_store_explicit(&attr->version, version + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	attr->value = value;
+
+	atomic_store_explicit(&attr->version, version + 2, memory_order_release);
+}
+
 static int sshsNodeAttrCmp(const void *a, const void *b) {
 	const sshsNodeAttr *aa = a;
 	const sshsNodeAttr *bb = b;
@@ -734,6 +999,76 @@ char *sshsNodeGetString(sshsNode node, const char *key) {
 	return (sshsNodeGetAttribute(node, key, SSHS_STRING).string);
 }
 
+sshsNodeAttrHandle sshsNodeGetAttributeHandle(sshsNode node, const char *key, enum sshs_node_attr_value_type type) {
+	// Strings are freed on update, so they can't be read through a handle
+	// without taking the node lock. Use sshsNodeGetString() for those.
+	if (type == SSHS_STRING) {
+		char errorMsg[1024];
+		snprintf(errorMsg, 1024, "Attribute '%s': handles are not supported for type '%s'.", key,
+			sshsHelperTypeToStringConverter(type));
+
+		(*sshsGetGlobalErrorLogCallback())(errorMsg);
+
+		// This is a critical usage error that *must* be fixed!
+		exit(EXIT_FAILURE);
+	}
+
+	// Attributes are never removed, so the handle stays valid as long as the node does.
+	sshsNodeAttr attr = sshsNodeAttrIndexFind(node, key, type);
+
+	// Same as for sshsNodeGetAttribute(): must exist and have a default.
+	if (attr == NULL) {
+		char errorMsg[1024];
+		snprintf(errorMsg, 1024, "Attribute '%s' of type '%s' not present, please initialize it first.", key,
+			sshsHelperTypeToStringConverter(type));
+
+		(*sshsGetGlobalErrorLogCallback())(errorMsg);
+
+		// This is a critical usage error that *must* be fixed!
+		exit(EXIT_FAILURE);
+	}
+
+	return (attr);
+}
+
+union sshs_node_attr_value sshsNodeAttrHandleGet(sshsNodeAttrHandle handle) {
+	return (sshsNodeAttrReadValue(handle));
+}
+
+uint32_t sshsNodeAttrHandleGetVersion(sshsNodeAttrHandle handle) {
+	// Two per update, see sshsNodeAttrWriteValue(). Any writer in
+	// progress counts as a change too, so this is safe to poll.
+	return ((uint32_t) atomic_load_explicit(&handle->version, memory_order_acquire));
+}
+
+bool sshsNodeAttrHandleGetBool(sshsNodeAttrHandle handle) {
+	return (sshsNodeAttrReadValue(handle).boolean);
+}
+
+int8_t sshsNodeAttrHandleGetByte(sshsNodeAttrHandle handle) {
+	return (sshsNodeAttrReadValue(handle).ibyte);
+}
+
+int16_t sshsNodeAttrHandleGetShort(sshsNodeAttrHandle handle) {
+	return (sshsNodeAttrReadValue(handle).ishort);
+}
+
+int32_t sshsNodeAttrHandleGetInt(sshsNodeAttrHandle handle) {
+	return (sshsNodeAttrReadValue(handle).iint);
+}
+
+int64_t sshsNodeAttrHandleGetLong(sshsNodeAttrHandle handle) {
+	return (sshsNodeAttrReadValue(handle).ilong);
+}
+
+float sshsNodeAttrHandleGetFloat(sshsNodeAttrHandle handle) {
+	return (sshsNodeAttrReadValue(handle).ffloat);
+}
+
+double sshsNodeAttrHandleGetDouble(sshsNodeAttrHandle handle) {
+	return (sshsNodeAttrReadValue(handle).ddouble);
+}
+
 void sshsNodeExportNodeToXML(sshsNode node, int outFd, const char **filterKeys, size_t filterKeysLength) {
 	sshsNodeToXML(node, outFd, false, filterKeys, filterKeysLength, NULL, 0);
 }
@@ -743,6 +1078,480 @@ void sshsNodeExportSubTreeToXML(sshsNode node, int outFd, const char **filterKey
 	sshsNodeToXML(node, outFd, true, filterKeys, filterKeysLength, filterNodes, filterNodesLength);
 }
 
+bool sshsNodeExportSubTreeToBinary(sshsNode node, int outFd, const char **filterKeys, size_t filterKeysLength,
+	const char **filterNodes, size_t filterNodesLength) {
+	struct sshs_binary_buffer buffer = { .data = NULL, .size = 0, .used = 0 };
+
+	// Leave space for the header, filled in once the payload is complete.
+	sshsBinaryReserve(&buffer, SSHS_BINARY_HEADER_LENGTH);
+	buffer.used = SSHS_BINARY_HEADER_LENGTH;
+
+	sshsNodeToBinary(node, &buffer, filterKeys, filterKeysLength, filterNodes, filterNodesLength);
+
+	size_t payloadLength = buffer.used - SSHS_BINARY_HEADER_LENGTH;
+
+	memcpy(buffer.data, SSHS_BINARY_MAGIC, SSHS_BINARY_MAGIC_LENGTH);
+	sshsBinaryWriteU32(buffer.data + 8, SSHS_BINARY_VERSION);
+	sshsBinaryWriteU32(buffer.data + 12, sshsBinaryCRC32(buffer.data + SSHS_BINARY_HEADER_LENGTH, payloadLength));
+	sshsBinaryWriteU32(buffer.data + 16, (uint32_t) payloadLength);
+	sshsBinaryWriteU32(buffer.data + 20, (uint32_t) ((uint64_t) payloadLength >> 32));
+
+	// Write out everything, handling partial writes.
+	for (size_t written = 0; written < buffer.used;) {
+		ssize_t ret = write(outFd, buffer.data + written, buffer.used - written);
+
+		if (ret <= 0) {
+			free(buffer.data);
+			(*sshsGetGlobalErrorLogCallback())("Failed to write binary snapshot to file descriptor.");
+			return (false);
+		}
+
+		written += (size_t) ret;
+	}
+
+	free(buffer.data);
+
+	return (true);
+}
+
+bool sshsNodeImportSubTreeFromBinary(sshsNode node, int inFd, bool strict) {
+	struct sshs_binary_buffer buffer = { .data = NULL, .size = 0, .used = 0 };
+
+	// Read everything, the file descriptor may also be a pipe.
+	while (true) {
+		sshsBinaryReserve(&buffer, 64 * 1024);
+
+		ssize_t ret = read(inFd, buffer.data + buffer.used, buffer.size - buffer.used);
+
+		if (ret < 0) {
+			free(buffer.data);
+			(*sshsGetGlobalErrorLogCallback())("Failed to read binary snapshot from file descriptor.");
+			return (false);
+		}
+
+		if (ret == 0) {
+			break;
+		}
+
+		buffer.used += (size_t) ret;
+	}
+
+	// Check header for compliance.
+	if (buffer.used < SSHS_BINARY_HEADER_LENGTH
+		|| memcmp(buffer.data, SSHS_BINARY_MAGIC, SSHS_BINARY_MAGIC_LENGTH) != 0) {
+		free(buffer.data);
+		(*sshsGetGlobalErrorLogCallback())("Invalid SSHS binary snapshot content.");
+		return (false);
+	}
+
+	if (sshsBinaryReadU32(buffer.data + 8) != SSHS_BINARY_VERSION) {
+		free(buffer.data);
+		(*sshsGetGlobalErrorLogCallback())("Unsupported SSHS binary snapshot version.");
+		return (false);
+	}
+
+	uint64_t payloadLength = (uint64_t) sshsBinaryReadU32(buffer.data + 16)
+		| ((uint64_t) sshsBinaryReadU32(buffer.data + 20) << 32);
+
+	if (payloadLength != (buffer.used - SSHS_BINARY_HEADER_LENGTH)) {
+		free(buffer.data);
+		(*sshsGetGlobalErrorLogCallback())("SSHS binary snapshot is truncated.");
+		return (false);
+	}
+
+	if (sshsBinaryReadU32(buffer.data + 12)
+		!= sshsBinaryCRC32(buffer.data + SSHS_BINARY_HEADER_LENGTH, (size_t) payloadLength)) {
+		free(buffer.data);
+		(*sshsGetGlobalErrorLogCallback())("SSHS binary snapshot checksum mismatch.");
+		return (false);
+	}
+
+	struct sshs_binary_reader reader = { .data = buffer.data + SSHS_BINARY_HEADER_LENGTH, .size =
+		(size_t) payloadLength, .pos = 0 };
+
+	const char *rootNodeName;
+	if (!sshsBinaryGetString(&reader, &rootNodeName)) {
+		free(buffer.data);
+		(*sshsGetGlobalErrorLogCallback())("Invalid SSHS binary snapshot content.");
+		return (false);
+	}
+
+	// Strict mode: check if names match.
+	if (strict && strcmp(rootNodeName, sshsNodeGetName(node)) != 0) {
+		free(buffer.data);
+		(*sshsGetGlobalErrorLogCallback())("Names don't match (required in 'strict' mode).");
+		return (false);
+	}
+
+	bool success = sshsNodeFromBinary(node, &reader);
+
+	free(buffer.data);
+
+	if (!success) {
+		(*sshsGetGlobalErrorLogCallback())("Invalid SSHS binary snapshot content.");
+	}
+
+	return (success);
+}
+
+bool sshsNodeIsBinarySnapshot(const uint8_t *data, size_t dataLength) {
+	return (dataLength >= SSHS_BINARY_MAGIC_LENGTH && memcmp(data, SSHS_BINARY_MAGIC, SSHS_BINARY_MAGIC_LENGTH) == 0);
+}
+
+static uint32_t sshsBinaryCRC32(const uint8_t *data, size_t dataLength) {
+	// CRC-32 (IEEE 802.3), nibble-wise to keep the table small.
+	static const uint32_t crcTable[16] = { 0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+		0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278,
+		0xBDBDF21C };
+
+	uint32_t crc = 0xFFFFFFFF;
+
+	for (size_t i = 0; i < dataLength; i++) {
+		crc ^= data[i];
+		crc = (crc >> 4) ^ crcTable[crc & 0x0F];
+		crc = (crc >> 4) ^ crcTable[crc & 0x0F];
+	}
+
+	return (~crc);
+}
+
+static void sshsBinaryReserve(struct sshs_binary_buffer *buffer, size_t length) {
+	if ((buffer->used + length) <= buffer->size) {
+		return;
+	}
+
+	size_t newSize = (buffer->size == 0) ? (4096) : (buffer->size * 2);
+	while (newSize < (buffer->used + length)) {
+		newSize *= 2;
+	}
+
+	uint8_t *newData = realloc(buffer->data, newSize);
+	SSHS_MALLOC_CHECK_EXIT(newData);
+
+	buffer->data = newData;
+	buffer->size = newSize;
+}
+
+static void sshsBinaryWriteU32(uint8_t *dest, uint32_t value) {
+	dest[0] = (uint8_t) value;
+	dest[1] = (uint8_t) (value >> 8);
+	dest[2] = (uint8_t) (value >> 16);
+	dest[3] = (uint8_t) (value >> 24);
+}
+
+static uint32_t sshsBinaryReadU32(const uint8_t *src) {
+	return ((uint32_t) src[0] | ((uint32_t) src[1] << 8) | ((uint32_t) src[2] << 16) | ((uint32_t) src[3] << 24));
+}
+
+static void sshsBinaryPutBytes(struct sshs_binary_buffer *buffer, const void *data, size_t dataLength) {
+	sshsBinaryReserve(buffer, dataLength);
+
+	memcpy(buffer->data + buffer->used, data, dataLength);
+	buffer->used += dataLength;
+}
+
+static void sshsBinaryPutUInt(struct sshs_binary_buffer *buffer, uint64_t value, size_t bytes) {
+	sshsBinaryReserve(buffer, bytes);
+
+	for (size_t i = 0; i < bytes; i++) {
+		buffer->data[buffer->used++] = (uint8_t) (value >> (i * 8));
+	}
+}
+
+static void sshsBinaryPutString(struct sshs_binary_buffer *buffer, const char *str) {
+	size_t strLength = strlen(str) + 1; // +1 for terminating NUL byte.
+
+	sshsBinaryPutUInt(buffer, strLength, 4);
+	sshsBinaryPutBytes(buffer, str, strLength);
+}
+
+static bool sshsBinaryGetUInt(struct sshs_binary_reader *reader, uint64_t *value, size_t bytes) {
+	if ((reader->size - reader->pos) < bytes) {
+		return (false);
+	}
+
+	*value = 0;
+
+	for (size_t i = 0; i < bytes; i++) {
+		*value |= (uint64_t) reader->data[reader->pos++] << (i * 8);
+	}
+
+	return (true);
+}
+
+static bool sshsBinaryGetString(struct sshs_binary_reader *reader, const char **str) {
+	uint64_t strLength;
+	if (!sshsBinaryGetUInt(reader, &strLength, 4)) {
+		return (false);
+	}
+
+	// Must be NUL terminated, strings point directly into the read buffer.
+	if (strLength == 0 || (reader->size - reader->pos) < strLength
+		|| reader->data[reader->pos + strLength - 1] != '\0') {
+		return (false);
+	}
+
+	*str = (const char *) (reader->data + reader->pos);
+	reader->pos += (size_t) strLength;
+
+	return (true);
+}
+
+static const size_t sshsBinaryTypeSizes[] = { [SSHS_BOOL] = 1, [SSHS_BYTE] = 1, [SSHS_SHORT] = 2, [SSHS_INT] = 4,
+	[SSHS_LONG] = 8, [SSHS_FLOAT] = 4, [SSHS_DOUBLE] = 8 };
+
+static void sshsNodeToBinary(sshsNode node, struct sshs_binary_buffer *buffer, const char **filterKeys,
+	size_t filterKeysLength, const char **filterNodes, size_t filterNodesLength) {
+	sshsBinaryPutString(buffer, sshsNodeGetName(node));
+
+	size_t numAttributes;
+	sshsNodeAttr *attributes = sshsNodeGetAttributes(node, &numAttributes);
+
+	// Number of attributes is only known after filtering, fill in later.
+	size_t attributesCountPos = buffer->used;
+	sshsBinaryPutUInt(buffer, 0, 4);
+	uint32_t attributesCount = 0;
+
+	for (size_t i = 0; i < numAttributes; i++) {
+		bool isFilteredOut = false;
+
+		// Verify that the key is not filtered out.
+		for (size_t fk = 0; fk < filterKeysLength; fk++) {
+			if (strcmp(attributes[i]->key, filterKeys[fk]) == 0) {
+				// Matches, don't add this attribute.
+				isFilteredOut = true;
+				break;
+			}
+		}
+
+		if (isFilteredOut) {
+			continue;
+		}
+
+		enum sshs_node_attr_value_type type = attributes[i]->value_type;
+
+		sshsBinaryPutUInt(buffer, (uint8_t) type, 1);
+		sshsBinaryPutString(buffer, attributes[i]->key);
+
+		if (type == SSHS_STRING) {
+			// Strings need the lock to be copied safely.
+			union sshs_node_attr_value value = sshsNodeGetAttribute(node, attributes[i]->key, type);
+			sshsBinaryPutString(buffer, value.string);
+			free(value.string);
+		}
+		else {
+			union sshs_node_attr_value value = sshsNodeAttrReadValue(attributes[i]);
+			uint64_t bits = 0;
+
+			switch (type) {
+				case SSHS_BOOL:
+					bits = value.boolean;
+					break;
+
+				case SSHS_BYTE:
+					bits = (uint8_t) value.ibyte;
+					break;
+
+				case SSHS_SHORT:
+					bits = (uint16_t) value.ishort;
+					break;
+
+				case SSHS_INT:
+					bits = (uint32_t) value.iint;
+					break;
+
+				case SSHS_LONG:
+					bits = (uint64_t) value.ilong;
+					break;
+
+				case SSHS_FLOAT: {
+					uint32_t floatBits;
+					memcpy(&floatBits, &value.ffloat, sizeof(floatBits));
+					bits = floatBits;
+					break;
+				}
+
+				case SSHS_DOUBLE:
+					memcpy(&bits, &value.ddouble, sizeof(bits));
+					break;
+
+				default:
+					break;
+			}
+
+			sshsBinaryPutUInt(buffer, bits, sshsBinaryTypeSizes[type]);
+		}
+
+		attributesCount++;
+	}
+
+	free(attributes);
+
+	sshsBinaryWriteU32(buffer->data + attributesCountPos, attributesCount);
+
+	// And lastly recurse down to the children.
+	size_t numChildren;
+	sshsNode *children = sshsNodeGetChildren(node, &numChildren);
+
+	size_t childrenCountPos = buffer->used;
+	sshsBinaryPutUInt(buffer, 0, 4);
+	uint32_t childrenCount = 0;
+
+	for (size_t i = 0; i < numChildren; i++) {
+		bool isFilteredOut = false;
+
+		// Verify that the node is not filtered out.
+		for (size_t fn = 0; fn < filterNodesLength; fn++) {
+			if (strcmp(sshsNodeGetName(children[i]), filterNodes[fn]) == 0) {
+				// Matches, don't process this node.
+				isFilteredOut = true;
+				break;
+			}
+		}
+
+		if (isFilteredOut) {
+			continue;
+		}
+
+		sshsNodeToBinary(children[i], buffer, filterKeys, filterKeysLength, filterNodes, filterNodesLength);
+		childrenCount++;
+	}
+
+	free(children);
+
+	sshsBinaryWriteU32(buffer->data + childrenCountPos, childrenCount);
+}
+
+static bool sshsNodeFromBinary(sshsNode node, struct sshs_binary_reader *reader) {
+	uint64_t numAttributes;
+	if (!sshsBinaryGetUInt(reader, &numAttributes, 4)) {
+		return (false);
+	}
+
+	// Each attribute takes at least 7 bytes, reject counts that can't be right
+	// before allocating memory for them.
+	if (numAttributes > ((reader->size - reader->pos) / 7)) {
+		return (false);
+	}
+
+	if (numAttributes > 0) {
+		const char **keys = malloc((size_t) numAttributes * sizeof(*keys));
+		SSHS_MALLOC_CHECK_EXIT(keys);
+
+		enum sshs_node_attr_value_type *types = malloc((size_t) numAttributes * sizeof(*types));
+		SSHS_MALLOC_CHECK_EXIT(types);
+
+		union sshs_node_attr_value *values = malloc((size_t) numAttributes * sizeof(*values));
+		SSHS_MALLOC_CHECK_EXIT(values);
+
+		bool success = true;
+
+		for (size_t i = 0; i < numAttributes; i++) {
+			uint64_t type;
+			if (!sshsBinaryGetUInt(reader, &type, 1) || type > SSHS_STRING
+				|| !sshsBinaryGetString(reader, &keys[i])) {
+				success = false;
+				break;
+			}
+
+			types[i] = (enum sshs_node_attr_value_type) type;
+
+			if (types[i] == SSHS_STRING) {
+				// Points into the read buffer, SSHS makes its own copy.
+				const char *str;
+				if (!sshsBinaryGetString(reader, &str)) {
+					success = false;
+					break;
+				}
+
+				values[i].string = (char *) str;
+				continue;
+			}
+
+			uint64_t bits;
+			if (!sshsBinaryGetUInt(reader, &bits, sshsBinaryTypeSizes[types[i]])) {
+				success = false;
+				break;
+			}
+
+			switch (types[i]) {
+				case SSHS_BOOL:
+					values[i].boolean = (bits != 0);
+					break;
+
+				case SSHS_BYTE:
+					values[i].ibyte = (int8_t) bits;
+					break;
+
+				case SSHS_SHORT:
+					values[i].ishort = (int16_t) bits;
+					break;
+
+				case SSHS_INT:
+					values[i].iint = (int32_t) bits;
+					break;
+
+				case SSHS_LONG:
+					values[i].ilong = (int64_t) bits;
+					break;
+
+				case SSHS_FLOAT: {
+					uint32_t floatBits = (uint32_t) bits;
+					memcpy(&values[i].ffloat, &floatBits, sizeof(floatBits));
+					break;
+				}
+
+				case SSHS_DOUBLE:
+					memcpy(&values[i].ddouble, &bits, sizeof(bits));
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		// Apply all attributes of this node at once.
+		if (success) {
+			sshsNodePutAttributes(node, (size_t) numAttributes, keys, types, values);
+		}
+
+		free(values);
+		free(types);
+		free(keys);
+
+		if (!success) {
+			return (false);
+		}
+	}
+
+	uint64_t numChildren;
+	if (!sshsBinaryGetUInt(reader, &numChildren, 4)) {
+		return (false);
+	}
+
+	for (size_t i = 0; i < numChildren; i++) {
+		const char *childName;
+		if (!sshsBinaryGetString(reader, &childName)) {
+			return (false);
+		}
+
+		// Get the child node.
+		sshsNode childNode = sshsNodeGetChild(node, childName);
+
+		// If not existing, try to create.
+		if (childNode == NULL) {
+			childNode = sshsNodeAddChild(node, childName);
+		}
+
+		// And call recursively.
+		if (!sshsNodeFromBinary(childNode, reader)) {
+			return (false);
+		}
+	}
+
+	return (true);
+}
+
 #define INDENT_MAX_LEVEL 20
 #define INDENT_SPACES 4
 static char spaces[(INDENT_MAX_LEVEL * INDENT_SPACES) + 1] =
@@ -37,6 +37,7 @@
 #ifdef ENABLE_NETWORK_INPUT
 #include "modules/misc/in/net_tcp.h"
 #include "modules/misc/in/unix_socket.h"
+#include "modules/misc/in/shared_memory.h"
 #endif
 
 #ifdef ENABLE_FILE_OUTPUT
@@ -48,9 +49,13 @@
 #include "modules/misc/out/net_udp.h"
 #include "modules/misc/out/unix_socket_server.h"
 #include "modules/misc/out/unix_socket.h"
+#include "modules/misc/out/shared_memory.h"
 #endif
 
 // Common filters support.
+#ifdef ENABLE_HOTPIXELFILTER
+#include "modules/hotpixelfilter/hotpixelfilter.h"
+#endif
 #ifdef ENABLE_BAFILTER
 #include "modules/backgroundactivityfilter/backgroundactivityfilter.h"
 #endif
@@ -63,6 +68,12 @@
 #ifdef ENABLE_STATISTICS
 #include "modules/statistics/statistics.h"
 #endif
+#ifdef ENABLE_ACCUMULATOR
+#include "modules/accumulator/accumulator.h"
+#endif
+#ifdef ENABLE_OPTICALFLOW
+#include "modules/opticalflow/opticalflow.h"
+#endif
 #ifdef ENABLE_VISUALIZER
 #include "modules/visualizer/visualizer.h"
 #endif
@@ -180,8 +191,14 @@ static bool mainloop_1(void) {
 #endif
 
 	// Filters process event packets: for example to suppress certain events,
-	// like with the Background Activity Filter, which suppresses events that
-	// look to be uncorrelated with real scene changes (noise reduction).
+	// like hot pixels that fire way too often (and would only waste the time
+	// of all following filters), or like with the Background Activity Filter,
+	// which suppresses events that look to be uncorrelated with real scene
+	// changes (noise reduction).
+#ifdef ENABLE_HOTPIXELFILTER
+	caerHotPixelFilter(16, polarity);
+#endif
+
 #ifdef ENABLE_BAFILTER
 	caerBackgroundActivityFilter(2, polarity);
 #endif
@@ -189,20 +206,40 @@ static bool mainloop_1(void) {
 	// Filters can also extract information from event packets: for example
 	// to show statistics about the current event-rate.
 #ifdef ENABLE_STATISTICS
-	caerStatistics(3, (caerEventPacketHeader) polarity, 1000);
+	caerStatistics(3, container);
+#endif
+
+	// Accumulate events into decaying per-pixel surfaces, which following
+	// filters can share instead of each keeping their own.
+#ifdef ENABLE_ACCUMULATOR
+	caerAccumulatorSurfaces accumulatorSurfaces = NULL;
+	caerFrameEventPacket accumulatorFrame = NULL;
+	caerAccumulator(17, polarity, &accumulatorSurfaces, &accumulatorFrame);
+#endif
+
+	// Compute per-event normal optical flow, as Point4D events (position, velocity).
+#ifdef ENABLE_OPTICALFLOW
+	caerPoint4DEventPacket opticalFlow = NULL;
+	caerFrameEventPacket opticalFlowFrame = NULL;
+	caerOpticalFlow(18, polarity, &opticalFlow, &opticalFlowFrame);
 #endif
 
-	// Filter that counts number of people in an environment
-	// the envoironment has to have a door.. etc..
+	// Filter that tracks clusters of events, such as people moving in an
+	// environment, reported as Point4D events (position, ID, mass).
 #ifdef ENABLE_SURVEILLANCE
+	// Nothing consumes the cluster events yet, so don't have them built.
 	caerFrameEventPacket clusterFrame = NULL;
-	caerSurveillanceFilter(12, polarity, &clusterFrame);
+	caerSurveillanceFilter(12, polarity, NULL, &clusterFrame);
 #endif
 
 	// Filter that track one object by using the median position information
 #ifdef ENABLE_MEDIANTRACKER
 	caerFrameEventPacket medianFrame = NULL;
+#ifdef ENABLE_VISUALIZER
 	caerMediantrackerFilter(13, polarity, &medianFrame);
+#else
+	caerMediantrackerFilter(13, polarity, NULL);
+#endif
 #endif
 
 #ifdef ENABLE_MEANFILTER
@@ -245,6 +282,16 @@ static bool mainloop_1(void) {
 	if(freqplot != NULL){
 		caerVisualizer(70, "MeanRateFrequency", &caerVisualizerRendererFrameEvents, NULL, (caerEventPacketHeader) freqplot);
 	}
+#endif
+#ifdef ENABLE_ACCUMULATOR
+	if (accumulatorFrame != NULL) {
+		caerVisualizer(71, "Accumulator", &caerVisualizerRendererFrameEvents, NULL, (caerEventPacketHeader) accumulatorFrame);
+	}
+#endif
+#ifdef ENABLE_OPTICALFLOW
+	if (opticalFlowFrame != NULL) {
+		caerVisualizer(72, "OpticalFlow", &caerVisualizerRendererFrameEvents, NULL, (caerEventPacketHeader) opticalFlowFrame);
+	}
 #endif
 	//caerVisualizerMulti(68, "PolarityAndFrame", &caerVisualizerMultiRendererPolarityAndFrameEvents, visualizerEventHandler, container);
 #endif
@@ -261,8 +308,8 @@ static bool mainloop_1(void) {
 #ifdef ENABLE_NETWORK_OUTPUT
 	// Send polarity packets out via TCP. This is the server mode!
 	// External clients connect to cAER, and we send them the data.
-	// WARNING: slow clients can dramatically slow this and the whole
-	// processing pipeline down!
+	// Each client has its own bounded send queue, slow clients only lose
+	// their own data (see 'slowClientPolicy' and 'clientStatistics').
 #ifdef DVS128
 	caerOutputNetTCPServer(8, 2, polarity, special);
 #else
@@ -336,11 +383,15 @@ static bool mainloop_1(void) {
 #endif
 
 #if defined(ENABLE_SURVEILLANCE) && defined (ENABLE_VISUALIZER)
-	caerVisualizer(67, "ImageClusters", &caerVisualizerRendererFrameEvents, NULL, (caerEventPacketHeader) clusterFrame);
+	if (clusterFrame != NULL) {
+		caerVisualizer(67, "ImageClusters", &caerVisualizerRendererFrameEvents, NULL, (caerEventPacketHeader) clusterFrame);
+	}
 #endif
 
 #if defined(ENABLE_MEDIANTRACKER) && defined (ENABLE_VISUALIZER)
-	caerVisualizer(68, "ImageMedian", &caerVisualizerRendererFrameEvents, NULL, (caerEventPacketHeader) medianFrame);
+	if (medianFrame != NULL) {
+		caerVisualizer(68, "ImageMedian", &caerVisualizerRendererFrameEvents, NULL, (caerEventPacketHeader) medianFrame);
+	}
 #endif
 
 #if defined(ENABLE_MEANFILTER) && defined (ENABLE_VISUALIZER)
@@ -359,7 +410,7 @@ static bool mainloop_1(void) {
 #endif
 #endif
 
-#if defined(ENABLE_SURVEILLANCE) && defined(ENABLE_VISUALIZER)
+#ifdef ENABLE_SURVEILLANCE
 	free(clusterFrame);
 #endif
 
@@ -375,6 +426,15 @@ static bool mainloop_1(void) {
 	free(freqplot);
 #endif
 
+#ifdef ENABLE_ACCUMULATOR
+	free(accumulatorFrame);
+#endif
+
+#ifdef ENABLE_OPTICALFLOW
+	free(opticalFlow);
+	free(opticalFlowFrame);
+#endif
+
 	return (true); // If false is returned, processing of this loop stops.
 }
 
@@ -45,6 +45,7 @@
 #ifdef ENABLE_NETWORK_INPUT
 #include "modules/misc/in/net_tcp.h"
 #include "modules/misc/in/unix_socket.h"
+#include "modules/misc/in/shared_memory.h"
 #endif
 
 #ifdef ENABLE_FILE_OUTPUT
@@ -56,6 +57,7 @@
 #include "modules/misc/out/net_udp.h"
 #include "modules/misc/out/unix_socket_server.h"
 #include "modules/misc/out/unix_socket.h"
+#include "modules/misc/out/shared_memory.h"
 #endif
 
 #ifdef ENABLE_VISUALIZER
@@ -160,7 +162,7 @@ static bool mainloop_1(void) {
 	// Filters can also extract information from event packets: for example
 	// to show statistics about the current event-rate.
 #ifdef ENABLE_STATISTICS
-	caerStatistics(3, (caerEventPacketHeader) spike, 1000);
+	caerStatistics(3, container);
 #endif
 
 #ifdef ENABLE_MEANRATEFILTER
@@ -213,8 +215,8 @@ static bool mainloop_1(void) {
 #ifdef ENABLE_NETWORK_OUTPUT
 	// Send polarity packets out via TCP. This is the server mode!
 	// External clients connect to cAER, and we send them the data.
-	// WARNING: slow clients can dramatically slow this and the whole
-	// processing pipeline down!
+	// Each client has its own bounded send queue, slow clients only lose
+	// their own data (see 'slowClientPolicy' and 'clientStatistics').
 	caerOutputNetTCPServer(8, 2, spike, special);
 
 	// And also send them via UDP. This is fast, as it doesn't care what is on the other side.
@@ -30,6 +30,7 @@
 #ifdef ENABLE_NETWORK_INPUT
 #include "modules/misc/in/net_tcp.h"
 #include "modules/misc/in/unix_socket.h"
+#include "modules/misc/in/shared_memory.h"
 #endif
 
 #ifdef ENABLE_FILE_OUTPUT
@@ -41,6 +42,7 @@
 #include "modules/misc/out/net_udp.h"
 #include "modules/misc/out/unix_socket_server.h"
 #include "modules/misc/out/unix_socket.h"
+#include "modules/misc/out/shared_memory.h"
 #endif
 
 // Common filters support.
@@ -62,6 +64,9 @@
 #ifdef ENABLE_STEREOCALIBRATION
 #include "modules/stereocalibration/stereocalibration.h"
 #endif
+#ifdef ENABLE_STEREOMATCHING
+#include "modules/stereomatching/stereomatching.h"
+#endif
 
 static bool mainloop_twocameras(void);
 
@@ -181,6 +186,13 @@ static bool mainloop_twocameras(void) {
 	caerStereoCalibration(7, frame_cam0, frame_cam1);
 #endif
 
+	// Rectify both cameras and match their events, for depth at event rate, as
+	// Point4D events (position, disparity, depth).
+#ifdef ENABLE_STEREOMATCHING
+	caerPoint4DEventPacket depth = NULL;
+	caerStereoMatching(8, polarity_cam0, polarity_cam1, frame_cam0, frame_cam1, &depth);
+#endif
+
 	// A simple visualizer exists to show what the output looks like.
 #ifdef ENABLE_VISUALIZER
 	//caerVisualizerMulti(68, "PolarityAndFrame", &caerVisualizerMultiRendererPolarityAndFrameEvents, NULL, container_cam0);
@@ -202,6 +214,10 @@ static bool mainloop_twocameras(void) {
 	caerOutputFile(99, 4, polarity_cam1, frame_cam1, imu_cam1, special_cam1);
 #endif
 
+#ifdef ENABLE_STEREOMATCHING
+	free(depth);
+#endif
+
 	return (true); // If false is returned, processing of this loop stops.
 }
 
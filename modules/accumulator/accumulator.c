@@ -0,0 +1,442 @@
+#include "accumulator.h"
+#include "base/mainloop.h"
+#include "base/module.h"
+
+#define ACCUMULATOR_LOG2E 1.4426950408889634f
+
+enum accumulator_frame_surface {
+	ACCUMULATOR_FRAME_ACTIVITY, ACCUMULATOR_FRAME_TIME_SURFACE, ACCUMULATOR_FRAME_COUNTS,
+};
+
+struct Accumulator_state {
+	struct caer_accumulator_surfaces surfaces;
+	float *frameBuffer[2];
+	/// Counts as of the last frame, so frames don't clear the shared counts.
+	uint32_t *frameCounts;
+	int64_t lastFrameTimestamp;
+	int32_t frameInterval;
+	enum accumulator_frame_surface frameSurface;
+	float frameActivityScale;
+};
+
+typedef struct Accumulator_state *AccumulatorState;
+
+static bool caerAccumulatorInit(caerModuleData moduleData);
+static void caerAccumulatorRun(caerModuleData moduleData, size_t argsNumber, va_list args);
+static void caerAccumulatorConfig(caerModuleData moduleData);
+static void caerAccumulatorExit(caerModuleData moduleData);
+static void caerAccumulatorReset(caerModuleData moduleData, uint16_t resetCallSourceID);
+static bool allocateSurfaces(AccumulatorState state, int16_t sourceID);
+static void freeSurfaces(AccumulatorState state);
+static void resetSurfaces(AccumulatorState state);
+static void updateTimestampBase(AccumulatorState state, int64_t firstTS, int64_t lastTS);
+static caerFrameEventPacket renderFrame(caerModuleData moduleData);
+static inline int32_t accumulatorDecayLimit(float decayScale);
+static inline float accumulatorDecay(int32_t dt, int32_t dtMin, float decayScale);
+
+static struct caer_module_functions caerAccumulatorFunctions = { .moduleInit = &caerAccumulatorInit, .moduleRun =
+	&caerAccumulatorRun, .moduleConfig = &caerAccumulatorConfig, .moduleExit = &caerAccumulatorExit, .moduleReset =
+	&caerAccumulatorReset };
+
+void caerAccumulator(uint16_t moduleID, caerPolarityEventPacket polarity, caerAccumulatorSurfaces *surfaces,
+	caerFrameEventPacket *frame) {
+	// Nothing to return unless the module runs and has something.
+	*surfaces = NULL;
+	*frame = NULL;
+
+	caerModuleData moduleData = caerMainloopFindModule(moduleID, "Accumulator", CAER_MODULE_PROCESSOR);
+	if (moduleData == NULL) {
+		return;
+	}
+
+	caerModuleSM(&caerAccumulatorFunctions, moduleData, sizeof(struct Accumulator_state), 3, polarity, surfaces,
+		frame);
+}
+
+void caerAccumulatorReadActivity(caerAccumulatorSurfaces surfaces, int64_t timestamp, float *out) {
+	size_t pixels = (size_t) surfaces->sizeX * (size_t) surfaces->sizeY;
+	const uint32_t *saeOff = surfaces->sae[0];
+	const uint32_t *saeOn = surfaces->sae[1];
+	const float *activity = surfaces->activity;
+	uint32_t now = relativeTimestampsGet(&surfaces->timestamps, timestamp);
+	float decayScale = ACCUMULATOR_LOG2E / surfaces->decayTime;
+	int32_t dtMin = accumulatorDecayLimit(decayScale);
+
+	// Branch-free, so the compiler can vectorize it.
+	for (size_t i = 0; i < pixels; i++) {
+		uint32_t last = (saeOn[i] > saeOff[i]) ? (saeOn[i]) : (saeOff[i]);
+
+		out[i] = activity[i] * accumulatorDecay(I32T(last - now), dtMin, decayScale);
+	}
+}
+
+void caerAccumulatorReadTimeSurface(caerAccumulatorSurfaces surfaces, int64_t timestamp, bool polarity, float *out) {
+	size_t pixels = (size_t) surfaces->sizeX * (size_t) surfaces->sizeY;
+	const uint32_t *sae = surfaces->sae[polarity];
+	uint32_t now = relativeTimestampsGet(&surfaces->timestamps, timestamp);
+	float decayScale = ACCUMULATOR_LOG2E / surfaces->decayTime;
+	int32_t dtMin = accumulatorDecayLimit(decayScale);
+
+	// Branch-free, so the compiler can vectorize it.
+	for (size_t i = 0; i < pixels; i++) {
+		out[i] = (float) (sae[i] != 0) * accumulatorDecay(I32T(sae[i] - now), dtMin, decayScale);
+	}
+}
+
+void caerAccumulatorClearCounts(caerAccumulatorSurfaces surfaces) {
+	memset(surfaces->counts, 0, (size_t) surfaces->sizeX * (size_t) surfaces->sizeY * sizeof(uint32_t));
+}
+
+static bool caerAccumulatorInit(caerModuleData moduleData) {
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "decayTime", 50000); // in µs
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "frameInterval", 0); // in µs, 0 disables frames
+	sshsNodePutStringIfAbsent(moduleData->moduleNode, "frameSurface", "activity");
+	sshsNodePutFloatIfAbsent(moduleData->moduleNode, "frameActivityScale", 5.0f);
+
+	caerAccumulatorConfig(moduleData);
+
+	// Add config listeners last, to avoid having them dangling if Init doesn't succeed.
+	sshsNodeAddAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+
+	// Nothing that can fail here.
+	return (true);
+}
+
+static void caerAccumulatorRun(caerModuleData moduleData, size_t argsNumber, va_list args) {
+	UNUSED_ARGUMENT(argsNumber);
+
+	// Interpret variable arguments (same as above in main function).
+	caerPolarityEventPacket polarity = va_arg(args, caerPolarityEventPacket);
+	caerAccumulatorSurfaces *surfaces = va_arg(args, caerAccumulatorSurfaces *);
+	caerFrameEventPacket *frame = va_arg(args, caerFrameEventPacket *);
+
+	AccumulatorState state = moduleData->moduleState;
+
+	// Only process packets with content.
+	if (polarity == NULL || caerEventPacketHeaderGetEventNumber(&polarity->packetHeader) <= 0) {
+		// Surfaces are still valid, just didn't change.
+		if (state->surfaces.activity != NULL) {
+			*surfaces = &state->surfaces;
+		}
+
+		return;
+	}
+
+	// If the surfaces are not allocated yet, do it.
+	if (state->surfaces.activity == NULL) {
+		if (!allocateSurfaces(state, caerEventPacketHeaderGetEventSource(&polarity->packetHeader))) {
+			// Failed to allocate memory, nothing to do.
+			caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate memory for surfaces.");
+			return;
+		}
+
+		// Frames have the same size as the source, tell the visualizer.
+		sshsNode sourceInfoNode = sshsGetRelativeNode(moduleData->moduleNode, "sourceInfo/");
+		sshsNodePutShort(sourceInfoNode, "dataSizeX", state->surfaces.sizeX);
+		sshsNodePutShort(sourceInfoNode, "dataSizeY", state->surfaces.sizeY);
+	}
+
+	int32_t eventsNumber = caerEventPacketHeaderGetEventNumber(&polarity->packetHeader);
+
+	// Events in a packet are ordered by time, so first and last bound all timestamps.
+	int64_t firstTS = caerPolarityEventGetTimestamp64(caerPolarityEventPacketGetEvent(polarity, 0), polarity);
+	int64_t lastTS = caerPolarityEventGetTimestamp64(caerPolarityEventPacketGetEvent(polarity, eventsNumber - 1),
+		polarity);
+
+	updateTimestampBase(state, firstTS, lastTS);
+
+	struct caer_accumulator_surfaces *s = &state->surfaces;
+	uint32_t *sae[2] = { s->sae[0], s->sae[1] };
+	float *activity = s->activity;
+	uint32_t *counts = s->counts;
+	size_t sizeX = (size_t) s->sizeX;
+	float decayScale = ACCUMULATOR_LOG2E / s->decayTime;
+	int32_t dtMin = accumulatorDecayLimit(decayScale);
+
+	// Incremental update: decay each pixel's activity up to its new event,
+	// everything else is left alone until read.
+	CAER_POLARITY_ITERATOR_VALID_START(polarity)
+		size_t idx = ((size_t) caerPolarityEventGetY(caerPolarityIteratorElement) * sizeX)
+			+ caerPolarityEventGetX(caerPolarityIteratorElement);
+		int64_t ts = caerPolarityEventGetTimestamp64(caerPolarityIteratorElement, polarity);
+		uint32_t rel = relativeTimestampsGet(&s->timestamps, ts);
+
+		uint32_t last = (sae[1][idx] > sae[0][idx]) ? (sae[1][idx]) : (sae[0][idx]);
+
+		activity[idx] = (activity[idx] * accumulatorDecay(I32T(last - rel), dtMin, decayScale)) + 1.0f;
+		sae[caerPolarityEventGetPolarity(caerPolarityIteratorElement)][idx] = rel;
+		counts[idx]++;
+	CAER_POLARITY_ITERATOR_VALID_END
+
+	s->lastTimestamp = lastTS;
+
+	*surfaces = s;
+
+	// Frames are generated at a fixed rate in event time.
+	if (state->frameInterval > 0 && (s->lastTimestamp - state->lastFrameTimestamp) >= state->frameInterval) {
+		state->lastFrameTimestamp = s->lastTimestamp;
+
+		*frame = renderFrame(moduleData);
+	}
+}
+
+static void caerAccumulatorConfig(caerModuleData moduleData) {
+	caerModuleConfigUpdateReset(moduleData);
+
+	AccumulatorState state = moduleData->moduleState;
+
+	int32_t decayTime = sshsNodeGetInt(moduleData->moduleNode, "decayTime");
+	state->surfaces.decayTime = (decayTime > 0) ? ((float) decayTime) : (1.0f);
+
+	state->frameInterval = sshsNodeGetInt(moduleData->moduleNode, "frameInterval");
+	state->frameActivityScale = sshsNodeGetFloat(moduleData->moduleNode, "frameActivityScale");
+
+	char *frameSurface = sshsNodeGetString(moduleData->moduleNode, "frameSurface");
+
+	if (caerStrEquals(frameSurface, "timeSurface")) {
+		state->frameSurface = ACCUMULATOR_FRAME_TIME_SURFACE;
+	}
+	else if (caerStrEquals(frameSurface, "counts")) {
+		state->frameSurface = ACCUMULATOR_FRAME_COUNTS;
+	}
+	else {
+		state->frameSurface = ACCUMULATOR_FRAME_ACTIVITY;
+	}
+
+	free(frameSurface);
+}
+
+static void caerAccumulatorExit(caerModuleData moduleData) {
+	// Remove listener, which can reference invalid memory in userData.
+	sshsNodeRemoveAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+
+	AccumulatorState state = moduleData->moduleState;
+
+	// Ensure surfaces are freed.
+	freeSurfaces(state);
+}
+
+static void caerAccumulatorReset(caerModuleData moduleData, uint16_t resetCallSourceID) {
+	UNUSED_ARGUMENT(resetCallSourceID);
+
+	AccumulatorState state = moduleData->moduleState;
+
+	// Reset surfaces to all zeros (startup state).
+	resetSurfaces(state);
+}
+
+static bool allocateSurfaces(AccumulatorState state, int16_t sourceID) {
+	// Get size information from source.
+	sshsNode sourceInfoNode = caerMainloopGetSourceInfo(U16T(sourceID));
+	if (sourceInfoNode == NULL) {
+		// This should never happen, but we handle it gracefully.
+		caerLog(CAER_LOG_ERROR, __func__, "Failed to get source info to allocate surfaces.");
+		return (false);
+	}
+
+	state->surfaces.sizeX = sshsNodeGetShort(sourceInfoNode, "dvsSizeX");
+	state->surfaces.sizeY = sshsNodeGetShort(sourceInfoNode, "dvsSizeY");
+
+	size_t pixels = (size_t) state->surfaces.sizeX * (size_t) state->surfaces.sizeY;
+
+	state->surfaces.sae[0] = calloc(pixels, sizeof(uint32_t));
+	state->surfaces.sae[1] = calloc(pixels, sizeof(uint32_t));
+	state->surfaces.activity = calloc(pixels, sizeof(float));
+	state->surfaces.counts = calloc(pixels, sizeof(uint32_t));
+	state->frameBuffer[0] = calloc(pixels, sizeof(float));
+	state->frameBuffer[1] = calloc(pixels, sizeof(float));
+	state->frameCounts = calloc(pixels, sizeof(uint32_t));
+
+	if (state->surfaces.sae[0] == NULL || state->surfaces.sae[1] == NULL || state->surfaces.activity == NULL
+		|| state->surfaces.counts == NULL || state->frameBuffer[0] == NULL || state->frameBuffer[1] == NULL
+		|| state->frameCounts == NULL) {
+		freeSurfaces(state);
+		return (false);
+	}
+
+	relativeTimestampsReset(&state->surfaces.timestamps);
+	state->surfaces.lastTimestamp = 0;
+	state->lastFrameTimestamp = 0;
+
+	return (true);
+}
+
+static void freeSurfaces(AccumulatorState state) {
+	free(state->surfaces.sae[0]);
+	state->surfaces.sae[0] = NULL;
+	free(state->surfaces.sae[1]);
+	state->surfaces.sae[1] = NULL;
+	free(state->surfaces.activity);
+	state->surfaces.activity = NULL;
+	free(state->surfaces.counts);
+	state->surfaces.counts = NULL;
+
+	free(state->frameBuffer[0]);
+	state->frameBuffer[0] = NULL;
+	free(state->frameBuffer[1]);
+	state->frameBuffer[1] = NULL;
+	free(state->frameCounts);
+	state->frameCounts = NULL;
+}
+
+static void resetSurfaces(AccumulatorState state) {
+	if (state->surfaces.activity == NULL) {
+		return;
+	}
+
+	size_t pixels = (size_t) state->surfaces.sizeX * (size_t) state->surfaces.sizeY;
+
+	memset(state->surfaces.sae[0], 0, pixels * sizeof(uint32_t));
+	memset(state->surfaces.sae[1], 0, pixels * sizeof(uint32_t));
+	memset(state->surfaces.activity, 0, pixels * sizeof(float));
+	memset(state->surfaces.counts, 0, pixels * sizeof(uint32_t));
+	memset(state->frameCounts, 0, pixels * sizeof(uint32_t));
+
+	relativeTimestampsReset(&state->surfaces.timestamps);
+	state->surfaces.lastTimestamp = 0;
+	state->lastFrameTimestamp = 0;
+}
+
+/**
+ * Make sure timestamps between firstTS and lastTS fit the relative 32 bit
+ * representation, rebasing the surfaces if needed.
+ */
+static void updateTimestampBase(AccumulatorState state, int64_t firstTS, int64_t lastTS) {
+	struct caer_accumulator_surfaces *s = &state->surfaces;
+
+	uint32_t shift = 0;
+
+	switch (relativeTimestampsUpdate(&s->timestamps, firstTS, lastTS, &shift)) {
+		case RELATIVE_TIMESTAMPS_RESTART:
+			// First packet, or time went backwards without a reset: start over.
+			resetSurfaces(state);
+			relativeTimestampsStart(&s->timestamps, firstTS);
+			state->lastFrameTimestamp = firstTS;
+			break;
+
+		case RELATIVE_TIMESTAMPS_SHIFT: {
+			// Pixels older than the shift lose their timestamp, their
+			// activity has long decayed to zero.
+			size_t pixels = (size_t) s->sizeX * (size_t) s->sizeY;
+
+			relativeTimestampsShift(s->sae[0], pixels, shift);
+			relativeTimestampsShift(s->sae[1], pixels, shift);
+			break;
+		}
+
+		case RELATIVE_TIMESTAMPS_FIT:
+			break;
+	}
+}
+
+static caerFrameEventPacket renderFrame(caerModuleData moduleData) {
+	AccumulatorState state = moduleData->moduleState;
+	struct caer_accumulator_surfaces *s = &state->surfaces;
+
+	caerFrameEventPacket framePacket = caerFrameEventPacketAllocate(1, I16T(moduleData->moduleID), 0, s->sizeX,
+		s->sizeY, 1);
+	if (framePacket == NULL) {
+		return (NULL);
+	}
+
+	caerFrameEvent frameEvent = caerFrameEventPacketGetEvent(framePacket, 0);
+	uint16_t *pixels = frameEvent->pixels;
+	size_t pixelsNumber = (size_t) s->sizeX * (size_t) s->sizeY;
+	float *values = state->frameBuffer[0];
+
+	switch (state->frameSurface) {
+		case ACCUMULATOR_FRAME_ACTIVITY: {
+			caerAccumulatorReadActivity(s, s->lastTimestamp, values);
+
+			float scale = (state->frameActivityScale > 0) ? (65535.0f / state->frameActivityScale) : (65535.0f);
+
+			for (size_t i = 0; i < pixelsNumber; i++) {
+				float v = values[i] * scale;
+				pixels[i] = U16T((v < 65535.0f) ? (v) : (65535.0f));
+			}
+
+			break;
+		}
+
+		case ACCUMULATOR_FRAME_TIME_SURFACE: {
+			// ON events bright, OFF events dark, no recent activity gray.
+			float *valuesOff = state->frameBuffer[1];
+
+			caerAccumulatorReadTimeSurface(s, s->lastTimestamp, true, values);
+			caerAccumulatorReadTimeSurface(s, s->lastTimestamp, false, valuesOff);
+
+			for (size_t i = 0; i < pixelsNumber; i++) {
+				pixels[i] = U16T(32767.5f + (32767.5f * (values[i] - valuesOff[i])));
+			}
+
+			break;
+		}
+
+		case ACCUMULATOR_FRAME_COUNTS: {
+			// Counts since the last frame, normalized to the busiest pixel. The shared
+			// counts are left alone, clearing them is up to their consumers: if one did
+			// since the last frame, all of the current count is new.
+			uint32_t *counts = state->frameCounts;
+			uint32_t maxCount = 1;
+
+			for (size_t i = 0; i < pixelsNumber; i++) {
+				uint32_t count = (s->counts[i] >= counts[i]) ? (s->counts[i] - counts[i]) : (s->counts[i]);
+
+				counts[i] = s->counts[i];
+				values[i] = (float) count;
+				maxCount = (count > maxCount) ? (count) : (maxCount);
+			}
+
+			float scale = 65535.0f / (float) maxCount;
+
+			for (size_t i = 0; i < pixelsNumber; i++) {
+				pixels[i] = U16T(values[i] * scale);
+			}
+
+			break;
+		}
+	}
+
+	// Add info to the frame.
+	caerFrameEventSetLengthXLengthYChannelNumber(frameEvent, s->sizeX, s->sizeY, 1, framePacket);
+	// Validate frame.
+	caerFrameEventValidate(frameEvent, framePacket);
+
+	return (framePacket);
+}
+
+/**
+ * Time difference, in µs, past which the decay factor is below 2^-126 and
+ * treated as zero, so accumulatorDecay() never leaves the normal float range.
+ */
+static inline int32_t accumulatorDecayLimit(float decayScale) {
+	float limit = 126.0f / decayScale;
+
+	return ((limit < 2147483520.0f) ? (-(int32_t) limit) : (INT32_MIN + 128));
+}
+
+/**
+ * Fast decay factor exp(dt / decayTime) = 2^(dt * decayScale) for dt <= 0,
+ * with a relative error around 1e-4. Unlike exp2f() it's plain arithmetic,
+ * and all clamping happens on integers, so loops using it can be vectorized
+ * even without relaxed floating-point flags.
+ */
+static inline float accumulatorDecay(int32_t dt, int32_t dtMin, float decayScale) {
+	dt = (dt > 0) ? (0) : (dt);
+	dt = (dt < dtMin) ? (dtMin) : (dt);
+
+	// x is in [-126, 0], split into xi + (f - 1), with f in (0, 1].
+	float x = (float) dt * decayScale;
+	int32_t xi = (int32_t) x;
+
+	float f = (x - (float) xi) + 1.0f;
+	float p = 1.0f + (f * (0.6960656421638072f + (f * (0.224494337302845f + (f * 0.07944023841053369f)))));
+
+	// 2^(xi - 1), compensating for f being shifted up by one.
+	union {
+		int32_t i;
+		float f;
+	} exponent = { .i = (xi + 126) << 23 };
+
+	return (p * exponent.f);
+}
@@ -0,0 +1,84 @@
+#ifndef ACCUMULATOR_H_
+#define ACCUMULATOR_H_
+
+#include "main.h"
+#include "ext/relative_timestamps.h"
+
+#include <libcaer/events/polarity.h>
+#include <libcaer/events/frame.h>
+
+/**
+ * Per-pixel accumulated state, shared with other modules by pointer.
+ * All maps are row-major, sizeX * sizeY, and only valid until the next
+ * call to caerAccumulator() of the module that returned them.
+ *
+ * Decay is lazy: updates only store when a pixel last got an event, and
+ * the decay up to a given time is applied when reading, with
+ * caerAccumulatorReadActivity() and caerAccumulatorReadTimeSurface().
+ */
+struct caer_accumulator_surfaces {
+	int16_t sizeX;
+	int16_t sizeY;
+	/// Surfaces of active events, per polarity (0 = OFF, 1 = ON): last event timestamp, relative
+	/// to timestamps.base, 0 if the pixel got no event yet (see caerAccumulatorGetTimestamp()).
+	uint32_t *sae[2];
+	/// Exponentially decaying event count, as of the pixel's last event.
+	float *activity;
+	/// Events per pixel since the last clear (see caerAccumulatorClearCounts()).
+	uint32_t *counts;
+	/// Relative timestamps are 'absolute - timestamps.base + 1'.
+	struct relative_timestamps timestamps;
+	/// Timestamp of the latest event accumulated.
+	int64_t lastTimestamp;
+	/// Decay time constant, in µs.
+	float decayTime;
+};
+
+typedef struct caer_accumulator_surfaces *caerAccumulatorSurfaces;
+
+/**
+ * Accumulate polarity events into per-pixel surfaces.
+ *
+ * @param moduleID the module ID.
+ * @param polarity the polarity events to accumulate.
+ * @param surfaces returns the accumulated surfaces, NULL if not available.
+ * @param frame returns a rendering of the selected surface when the frame
+ *              interval elapsed, NULL otherwise. To be freed by the caller.
+ */
+void caerAccumulator(uint16_t moduleID, caerPolarityEventPacket polarity, caerAccumulatorSurfaces *surfaces,
+	caerFrameEventPacket *frame);
+
+/**
+ * Decayed activity of all pixels at the given time.
+ *
+ * @param surfaces the surfaces.
+ * @param timestamp time to decay to, usually surfaces->lastTimestamp.
+ * @param out sizeX * sizeY values.
+ */
+void caerAccumulatorReadActivity(caerAccumulatorSurfaces surfaces, int64_t timestamp, float *out);
+/**
+ * Exponentially decayed time surface of one polarity at the given time:
+ * 1 for an event right at 'timestamp', falling towards 0 for older ones,
+ * and 0 for pixels that never got an event.
+ *
+ * @param surfaces the surfaces.
+ * @param timestamp time to decay to, usually surfaces->lastTimestamp.
+ * @param polarity polarity of the surface to read.
+ * @param out sizeX * sizeY values.
+ */
+void caerAccumulatorReadTimeSurface(caerAccumulatorSurfaces surfaces, int64_t timestamp, bool polarity, float *out);
+/**
+ * Reset the event counts of all pixels to zero.
+ *
+ * @param surfaces the surfaces.
+ */
+void caerAccumulatorClearCounts(caerAccumulatorSurfaces surfaces);
+
+static inline int64_t caerAccumulatorGetTimestamp(caerAccumulatorSurfaces surfaces, int16_t x, int16_t y,
+	bool polarity) {
+	uint32_t rel = surfaces->sae[polarity][(y * surfaces->sizeX) + x];
+
+	return ((rel == 0) ? (-1) : (surfaces->timestamps.base + rel - 1));
+}
+
+#endif /* ACCUMULATOR_H_ */
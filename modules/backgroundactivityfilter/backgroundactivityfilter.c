@@ -8,27 +8,73 @@
 #include "backgroundactivityfilter.h"
 #include "base/mainloop.h"
 #include "base/module.h"
-#include "ext/buffers.h"
+#include "modules/misc/tiled_filter.h"
+#include "ext/ringbuffer/portable_aligned_alloc.h"
+#include "ext/relative_timestamps.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Map rows are padded to a multiple of one cache line (16 x 32 bit).
+#define BAFILTER_MAP_ALIGNMENT 64
+#define BAFILTER_MAP_ROW_ALIGN (BAFILTER_MAP_ALIGNMENT / sizeof(uint32_t))
+// Events are decoded in batches of this size before being filtered.
+#define BAFILTER_BATCH_SIZE 256
+// Tiles also get the events in a one pixel ring around them.
+#define BAFILTER_TILE_HALO 1
+
+/**
+ * Timestamp maps are stored row-major, with a border of cells all around,
+ * so that the neighbors of any pixel can be updated without bounds checks.
+ * Timestamps are stored relative to a base (see ext/relative_timestamps.h),
+ * so they fit 32 bit and zero still means "no event yet".
+ */
+struct BAFilter_map {
+	uint32_t *cells;
+	size_t stride;
+	size_t rows;
+	size_t border;
+	struct relative_timestamps timestamps;
+};
 
 struct BAFilter_state {
-	simple2DBufferLong timestampMap;
-	int32_t deltaT;
-	int8_t subSampleBy;
+	struct BAFilter_map map;
+	int16_t sourceSizeX;
+	int16_t sourceSizeY;
+	int8_t mapSubSampleBy;
+	struct caer_tiled_filter tiledFilter;
+	bool tiledFilterActive;
+	int32_t tiledThreads;
+	int16_t tiledTileSize;
+	int32_t tiledDeltaT;
+	sshsNodeAttrHandle deltaT;
+	sshsNodeAttrHandle subSampleBy;
+	sshsNodeAttrHandle numThreads;
+	sshsNodeAttrHandle tileSize;
 };
 
 typedef struct BAFilter_state *BAFilterState;
 
 static bool caerBackgroundActivityFilterInit(caerModuleData moduleData);
 static void caerBackgroundActivityFilterRun(caerModuleData moduleData, size_t argsNumber, va_list args);
-static void caerBackgroundActivityFilterConfig(caerModuleData moduleData);
 static void caerBackgroundActivityFilterExit(caerModuleData moduleData);
 static void caerBackgroundActivityFilterReset(caerModuleData moduleData, uint16_t resetCallSourceID);
-static bool allocateTimestampMap(BAFilterState state, int16_t sourceID);
+static bool updateTimestampMaps(BAFilterState state, const char *logSubSystem, int8_t subSampleBy, int32_t threads,
+	int16_t tileSize);
+static void freeTimestampMaps(BAFilterState state);
+static void filterPacket(BAFilterState state, caerPolarityEventPacket polarity, int32_t deltaT, int8_t subSampleBy);
+static void filterTile(void *statePtr, struct caer_tiled_filter_tile *tile, uint8_t *invalidate);
+static bool mapAllocate(struct BAFilter_map *map, size_t sizeX, size_t sizeY, size_t border);
+static void mapFree(struct BAFilter_map *map);
+static void mapReset(struct BAFilter_map *map);
+static void mapUpdateBase(struct BAFilter_map *map, int64_t firstTS, int64_t lastTS);
+static void decodeEventBatch(caerPolarityEvent events, size_t eventsNumber, uint32_t tsOffset,
+	int8_t subSampleBy, size_t mapStride, uint32_t *indexes, uint32_t *timestamps);
 
 static struct caer_module_functions caerBackgroundActivityFilterFunctions = { .moduleInit =
-	&caerBackgroundActivityFilterInit, .moduleRun = &caerBackgroundActivityFilterRun, .moduleConfig =
-	&caerBackgroundActivityFilterConfig, .moduleExit = &caerBackgroundActivityFilterExit, .moduleReset =
-	&caerBackgroundActivityFilterReset };
+	&caerBackgroundActivityFilterInit, .moduleRun = &caerBackgroundActivityFilterRun, .moduleConfig = NULL,
+	.moduleExit = &caerBackgroundActivityFilterExit, .moduleReset = &caerBackgroundActivityFilterReset };
 
 void caerBackgroundActivityFilter(uint16_t moduleID, caerPolarityEventPacket polarity) {
 	caerModuleData moduleData = caerMainloopFindModule(moduleID, "BAFilter", CAER_MODULE_PROCESSOR);
@@ -42,14 +88,16 @@ void caerBackgroundActivityFilter(uint16_t moduleID, caerPolarityEventPacket pol
 static bool caerBackgroundActivityFilterInit(caerModuleData moduleData) {
 	sshsNodePutIntIfAbsent(moduleData->moduleNode, "deltaT", 30000);
 	sshsNodePutByteIfAbsent(moduleData->moduleNode, "subSampleBy", 0);
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "numThreads", 1);
+	sshsNodePutShortIfAbsent(moduleData->moduleNode, "tileSize", 64);
 
 	BAFilterState state = moduleData->moduleState;
 
-	state->deltaT = sshsNodeGetInt(moduleData->moduleNode, "deltaT");
-	state->subSampleBy = sshsNodeGetByte(moduleData->moduleNode, "subSampleBy");
-
-	// Add config listeners last, to avoid having them dangling if Init doesn't succeed.
-	sshsNodeAddAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+	// Resolve configuration once, values are then read lock-free on each run.
+	state->deltaT = sshsNodeGetAttributeHandle(moduleData->moduleNode, "deltaT", SSHS_INT);
+	state->subSampleBy = sshsNodeGetAttributeHandle(moduleData->moduleNode, "subSampleBy", SSHS_BYTE);
+	state->numThreads = sshsNodeGetAttributeHandle(moduleData->moduleNode, "numThreads", SSHS_INT);
+	state->tileSize = sshsNodeGetAttributeHandle(moduleData->moduleNode, "tileSize", SSHS_SHORT);
 
 	// Nothing that can fail here.
 	return (true);
@@ -66,116 +114,373 @@ static void caerBackgroundActivityFilterRun(caerModuleData moduleData, size_t ar
 		return;
 	}
 
+	if (caerEventPacketHeaderGetEventNumber(&polarity->packetHeader) <= 0) {
+		return;
+	}
+
 	BAFilterState state = moduleData->moduleState;
 
-	// If the map is not allocated yet, do it.
-	if (state->timestampMap == NULL) {
-		if (!allocateTimestampMap(state, caerEventPacketHeaderGetEventSource(&polarity->packetHeader))) {
-			// Failed to allocate memory, nothing to do.
-			caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate memory for timestampMap.");
+	// Get current configuration, constant for the whole packet.
+	int32_t deltaT = sshsNodeAttrHandleGetInt(state->deltaT);
+	int8_t subSampleBy = sshsNodeAttrHandleGetByte(state->subSampleBy);
+	int32_t threads = sshsNodeAttrHandleGetInt(state->numThreads);
+	int16_t tileSize = sshsNodeAttrHandleGetShort(state->tileSize);
+
+	if (subSampleBy < 0 || subSampleBy > 14) {
+		subSampleBy = 0;
+	}
+
+	if (threads < 1) {
+		threads = 1;
+	}
+
+	if (tileSize < 8) {
+		tileSize = 8;
+	}
+
+	if (state->sourceSizeX == 0) {
+		// Get size information from source.
+		sshsNode sourceInfoNode = caerMainloopGetSourceInfo(
+			U16T(caerEventPacketHeaderGetEventSource(&polarity->packetHeader)));
+		if (sourceInfoNode == NULL) {
+			// This should never happen, but we handle it gracefully.
+			caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString,
+				"Failed to get source info to allocate timestamp map.");
 			return;
 		}
+
+		state->sourceSizeX = sshsNodeGetShort(sourceInfoNode, "dvsSizeX");
+		state->sourceSizeY = sshsNodeGetShort(sourceInfoNode, "dvsSizeY");
 	}
 
-	// Iterate over events and filter out ones that are not supported by other
-	// events within a certain region in the specified timeframe.
-	CAER_POLARITY_ITERATOR_VALID_START(polarity)
-		// Get values on which to operate.
-		int64_t ts = caerPolarityEventGetTimestamp64(caerPolarityIteratorElement, polarity);
-		uint16_t x = caerPolarityEventGetX(caerPolarityIteratorElement);
-		uint16_t y = caerPolarityEventGetY(caerPolarityIteratorElement);
-
-		// Apply sub-sampling.
-		x = U16T(x >> state->subSampleBy);
-		y = U16T(y >> state->subSampleBy);
-
-		// Get value from map.
-		int64_t lastTS = state->timestampMap->buffer2d[x][y];
-
-		if ((I64T(ts - lastTS) >= I64T(state->deltaT)) || (lastTS == 0)) {
-			// Filter out invalid.
-			caerPolarityEventInvalidate(caerPolarityIteratorElement, polarity);
-		}
+	// If the maps are not allocated yet, or their layout changed, (re-)do them.
+	if (!updateTimestampMaps(state, moduleData->moduleSubSystemString, subSampleBy, threads, tileSize)) {
+		// Failed to allocate memory, nothing to do.
+		caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate memory for timestampMap.");
+		return;
+	}
 
-		// Update neighboring region.
-		size_t sizeMaxX = (state->timestampMap->sizeX - 1);
-		size_t sizeMaxY = (state->timestampMap->sizeY - 1);
+	if (state->tiledFilterActive) {
+		state->tiledDeltaT = deltaT;
 
-		if (x > 0) {
-			state->timestampMap->buffer2d[x - 1][y] = ts;
-		}
-		if (x < sizeMaxX) {
-			state->timestampMap->buffer2d[x + 1][y] = ts;
-		}
+		caerTiledFilterRun(&state->tiledFilter, polarity, &filterTile, state);
+	}
+	else {
+		filterPacket(state, polarity, deltaT, subSampleBy);
+	}
+}
+
+static void caerBackgroundActivityFilterExit(caerModuleData moduleData) {
+	BAFilterState state = moduleData->moduleState;
+
+	// Ensure maps are freed.
+	freeTimestampMaps(state);
+}
 
-		if (y > 0) {
-			state->timestampMap->buffer2d[x][y - 1] = ts;
+static void caerBackgroundActivityFilterReset(caerModuleData moduleData, uint16_t resetCallSourceID) {
+	UNUSED_ARGUMENT(resetCallSourceID);
+
+	BAFilterState state = moduleData->moduleState;
+
+	// Reset timestamp maps to all zeros (startup state).
+	if (state->tiledFilterActive) {
+		for (size_t t = 0; t < state->tiledFilter.tilesNumber; t++) {
+			mapReset(state->tiledFilter.tiles[t].state);
 		}
-		if (y < sizeMaxY) {
-			state->timestampMap->buffer2d[x][y + 1] = ts;
+	}
+	else {
+		mapReset(&state->map);
+	}
+}
+
+static bool updateTimestampMaps(BAFilterState state, const char *logSubSystem, int8_t subSampleBy, int32_t threads,
+	int16_t tileSize) {
+	bool useTiles = (threads > 1);
+
+	if (state->map.cells != NULL || state->tiledFilterActive) {
+		if (state->mapSubSampleBy == subSampleBy && state->tiledFilterActive == useTiles
+			&& (!useTiles || (state->tiledThreads == threads && state->tiledTileSize == tileSize))) {
+			// Nothing changed.
+			return (true);
 		}
 
-		if (x > 0 && y > 0) {
-			state->timestampMap->buffer2d[x - 1][y - 1] = ts;
+		// Layout changed, old content doesn't apply anymore.
+		freeTimestampMaps(state);
+	}
+
+	state->mapSubSampleBy = subSampleBy;
+
+	if (!useTiles) {
+		// Size the map for the sub-sampled resolution, plus the border.
+		size_t sizeX = ((size_t) state->sourceSizeX + (1U << subSampleBy) - 1) >> subSampleBy;
+		size_t sizeY = ((size_t) state->sourceSizeY + (1U << subSampleBy) - 1) >> subSampleBy;
+
+		return (mapAllocate(&state->map, sizeX, sizeY, 1));
+	}
+
+	if (!caerTiledFilterInit(&state->tiledFilter, state->sourceSizeX, state->sourceSizeY, subSampleBy, tileSize,
+	BAFILTER_TILE_HALO, (size_t) threads, logSubSystem)) {
+		memset(&state->tiledFilter, 0, sizeof(struct caer_tiled_filter));
+		return (false);
+	}
+
+	state->tiledFilterActive = true;
+	state->tiledThreads = threads;
+	state->tiledTileSize = tileSize;
+
+	// Each tile gets its own map, with a border wide enough for the halo
+	// events and their neighbors.
+	for (size_t t = 0; t < state->tiledFilter.tilesNumber; t++) {
+		struct caer_tiled_filter_tile *tile = &state->tiledFilter.tiles[t];
+
+		tile->state = calloc(1, sizeof(struct BAFilter_map));
+		if (tile->state == NULL
+			|| !mapAllocate(tile->state, (size_t) tile->sizeX, (size_t) tile->sizeY, BAFILTER_TILE_HALO + 1)) {
+			freeTimestampMaps(state);
+			return (false);
 		}
-		if (x < sizeMaxX && y < sizeMaxY) {
-			state->timestampMap->buffer2d[x + 1][y + 1] = ts;
+	}
+
+	return (true);
+}
+
+static void freeTimestampMaps(BAFilterState state) {
+	mapFree(&state->map);
+
+	if (state->tiledFilterActive) {
+		for (size_t t = 0; t < state->tiledFilter.tilesNumber; t++) {
+			if (state->tiledFilter.tiles[t].state != NULL) {
+				mapFree(state->tiledFilter.tiles[t].state);
+				free(state->tiledFilter.tiles[t].state);
+			}
 		}
 
-		if (x > 0 && y < sizeMaxY) {
-			state->timestampMap->buffer2d[x - 1][y + 1] = ts;
+		caerTiledFilterDestroy(&state->tiledFilter);
+		memset(&state->tiledFilter, 0, sizeof(struct caer_tiled_filter));
+
+		state->tiledFilterActive = false;
+	}
+}
+
+static void filterPacket(BAFilterState state, caerPolarityEventPacket polarity, int32_t deltaT, int8_t subSampleBy) {
+	struct BAFilter_map *map = &state->map;
+	int32_t eventsNumber = caerEventPacketHeaderGetEventNumber(&polarity->packetHeader);
+
+	// Events in a packet are ordered by time, so first and last bound all timestamps.
+	mapUpdateBase(map, caerPolarityEventGetTimestamp64(caerPolarityEventPacketGetEvent(polarity, 0), polarity),
+		caerPolarityEventGetTimestamp64(caerPolarityEventPacketGetEvent(polarity, eventsNumber - 1), polarity));
+
+	// Relative timestamp of an event is its 32 bit timestamp plus this (modulo 2^32).
+	uint32_t tsOffset = U32T((I64T(caerEventPacketHeaderGetEventTSOverflow(&polarity->packetHeader)) << TS_OVERFLOW_SHIFT)
+		- map->timestamps.base + 1);
+
+	uint32_t *cells = map->cells;
+	size_t stride = map->stride;
+
+	uint32_t indexes[BAFILTER_BATCH_SIZE];
+	uint32_t timestamps[BAFILTER_BATCH_SIZE];
+
+	// Iterate over events and filter out ones that are not supported by other
+	// events within a certain region in the specified timeframe.
+	for (int32_t batchStart = 0; batchStart < eventsNumber; batchStart += BAFILTER_BATCH_SIZE) {
+		size_t batchSize = (size_t) (eventsNumber - batchStart);
+		if (batchSize > BAFILTER_BATCH_SIZE) {
+			batchSize = BAFILTER_BATCH_SIZE;
 		}
-		if (x < sizeMaxX && y > 0) {
-			state->timestampMap->buffer2d[x + 1][y - 1] = ts;
+
+		decodeEventBatch(caerPolarityEventPacketGetEvent(polarity, batchStart), batchSize, tsOffset, subSampleBy,
+			stride, indexes, timestamps);
+
+		for (size_t i = 0; i < batchSize; i++) {
+			uint32_t idx = indexes[i];
+
+			// Already invalid events are skipped (index 0 is a border cell).
+			if (idx == 0) {
+				continue;
+			}
+
+			uint32_t ts = timestamps[i];
+			uint32_t lastCellTS = cells[idx];
+
+			if ((lastCellTS == 0) || (I32T(ts - lastCellTS) >= deltaT)) {
+				// Filter out invalid.
+				caerPolarityEventInvalidate(caerPolarityEventPacketGetEvent(polarity, batchStart + (int32_t) i),
+					polarity);
+			}
+
+			// Update neighboring region, the border takes the writes that fall outside.
+			uint32_t *above = &cells[idx - stride];
+			uint32_t *below = &cells[idx + stride];
+
+			above[-1] = ts;
+			above[0] = ts;
+			above[1] = ts;
+			cells[idx - 1] = ts;
+			cells[idx + 1] = ts;
+			below[-1] = ts;
+			below[0] = ts;
+			below[1] = ts;
 		}
-	CAER_POLARITY_ITERATOR_VALID_END
+	}
 }
 
-static void caerBackgroundActivityFilterConfig(caerModuleData moduleData) {
-	caerModuleConfigUpdateReset(moduleData);
+/**
+ * Same filter as filterPacket(), on the events of a single tile. Runs on a
+ * worker thread, so it only touches the tile's own map and flags.
+ */
+static void filterTile(void *statePtr, struct caer_tiled_filter_tile *tile, uint8_t *invalidate) {
+	BAFilterState state = statePtr;
+	struct BAFilter_map *map = tile->state;
+	int32_t deltaT = state->tiledDeltaT;
 
-	BAFilterState state = moduleData->moduleState;
+	mapUpdateBase(map, tile->events[0].timestamp, tile->events[tile->eventsNumber - 1].timestamp);
 
-	state->deltaT = sshsNodeGetInt(moduleData->moduleNode, "deltaT");
-	state->subSampleBy = sshsNodeGetByte(moduleData->moduleNode, "subSampleBy");
-}
+	uint32_t *cells = map->cells;
+	size_t stride = map->stride;
+	size_t border = map->border;
+	int64_t tsBase = map->timestamps.base - 1;
 
-static void caerBackgroundActivityFilterExit(caerModuleData moduleData) {
-	// Remove listener, which can reference invalid memory in userData.
-	sshsNodeRemoveAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+	for (size_t i = 0; i < tile->eventsNumber; i++) {
+		const struct caer_tiled_filter_event *event = &tile->events[i];
 
-	BAFilterState state = moduleData->moduleState;
+		// Halo events have coordinates down to -1, which the border covers.
+		size_t idx = ((size_t) (event->y + I16T(border)) * stride) + (size_t) (event->x + I16T(border));
+		uint32_t ts = U32T(event->timestamp - tsBase);
+
+		if (!event->halo) {
+			uint32_t lastCellTS = cells[idx];
 
-	// Ensure map is freed.
-	simple2DBufferFreeLong(state->timestampMap);
+			invalidate[event->index] = ((lastCellTS == 0) || (I32T(ts - lastCellTS) >= deltaT));
+		}
+
+		uint32_t *above = &cells[idx - stride];
+		uint32_t *below = &cells[idx + stride];
+
+		above[-1] = ts;
+		above[0] = ts;
+		above[1] = ts;
+		cells[idx - 1] = ts;
+		cells[idx + 1] = ts;
+		below[-1] = ts;
+		below[0] = ts;
+		below[1] = ts;
+	}
 }
 
-static void caerBackgroundActivityFilterReset(caerModuleData moduleData, uint16_t resetCallSourceID) {
-	UNUSED_ARGUMENT(resetCallSourceID);
+static bool mapAllocate(struct BAFilter_map *map, size_t sizeX, size_t sizeY, size_t border) {
+	size_t stride = sizeX + (2 * border);
+	stride = (stride + BAFILTER_MAP_ROW_ALIGN - 1) & ~(BAFILTER_MAP_ROW_ALIGN - 1);
 
-	BAFilterState state = moduleData->moduleState;
+	map->stride = stride;
+	map->rows = sizeY + (2 * border);
+	map->border = border;
+
+	map->cells = portable_aligned_alloc(BAFILTER_MAP_ALIGNMENT, map->stride * map->rows * sizeof(uint32_t));
+	if (map->cells == NULL) {
+		return (false);
+	}
+
+	mapReset(map);
 
-	// Reset timestamp map to all zeros (startup state).
-	simple2DBufferResetLong(state->timestampMap);
+	return (true);
 }
 
-static bool allocateTimestampMap(BAFilterState state, int16_t sourceID) {
-	// Get size information from source.
-	sshsNode sourceInfoNode = caerMainloopGetSourceInfo(U16T(sourceID));
-	if (sourceInfoNode == NULL) {
-		// This should never happen, but we handle it gracefully.
-		caerLog(CAER_LOG_ERROR, __func__, "Failed to get source info to allocate timestamp map.");
-		return (false);
+static void mapFree(struct BAFilter_map *map) {
+	portable_aligned_free(map->cells);
+	map->cells = NULL;
+}
+
+static void mapReset(struct BAFilter_map *map) {
+	if (map->cells == NULL) {
+		return;
 	}
 
-	int16_t sizeX = sshsNodeGetShort(sourceInfoNode, "dvsSizeX");
-	int16_t sizeY = sshsNodeGetShort(sourceInfoNode, "dvsSizeY");
+	memset(map->cells, 0, map->stride * map->rows * sizeof(uint32_t));
+	relativeTimestampsReset(&map->timestamps);
+}
 
-	state->timestampMap = simple2DBufferInitLong((size_t) sizeX, (size_t) sizeY);
-	if (state->timestampMap == NULL) {
-		return (false);
+/**
+ * Make sure timestamps between firstTS and lastTS fit the map's relative
+ * 32 bit representation, rebasing the map if needed.
+ */
+static void mapUpdateBase(struct BAFilter_map *map, int64_t firstTS, int64_t lastTS) {
+	uint32_t shift = 0;
+
+	switch (relativeTimestampsUpdate(&map->timestamps, firstTS, lastTS, &shift)) {
+		case RELATIVE_TIMESTAMPS_RESTART:
+			// First packet, or time went backwards without a reset: start over.
+			mapReset(map);
+			relativeTimestampsStart(&map->timestamps, firstTS);
+			break;
+
+		case RELATIVE_TIMESTAMPS_SHIFT:
+			relativeTimestampsShift(map->cells, map->stride * map->rows, shift);
+			break;
+
+		case RELATIVE_TIMESTAMPS_FIT:
+			break;
 	}
+}
 
-	// TODO: size the map differently if subSampleBy is set!
-	return (true);
+/**
+ * Decode a batch of polarity events into map indexes and relative timestamps.
+ * Invalid events get index 0, which is always a border cell and never
+ * the index of a real pixel.
+ */
+static void decodeEventBatch(caerPolarityEvent events, size_t eventsNumber, uint32_t tsOffset,
+	int8_t subSampleBy, size_t mapStride, uint32_t *indexes, uint32_t *timestamps) {
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	// Four events per iteration: deinterleave data and timestamp words, then
+	// extract addresses and compute indexes with 32 bit lane arithmetic.
+	const __m128i subSampleShift = _mm_cvtsi32_si128(subSampleBy);
+	const __m128i addrMask = _mm_set1_epi32(POLARITY_X_ADDR_MASK);
+	const __m128i validMask = _mm_set1_epi32(VALID_MARK_MASK);
+	const __m128i one = _mm_set1_epi32(1);
+	const __m128i stride = _mm_set1_epi32((int32_t) mapStride);
+	const __m128i offset = _mm_set1_epi32((int32_t) tsOffset);
+
+	for (; (i + 4) <= eventsNumber; i += 4) {
+		__m128 lo = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) &events[i]));
+		__m128 hi = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) &events[i + 2]));
+
+		__m128i data = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i ts = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+
+		__m128i x = _mm_and_si128(_mm_srli_epi32(data, POLARITY_X_ADDR_SHIFT), addrMask);
+		__m128i y = _mm_and_si128(_mm_srli_epi32(data, POLARITY_Y_ADDR_SHIFT), addrMask);
+
+		x = _mm_add_epi32(_mm_srl_epi32(x, subSampleShift), one);
+		y = _mm_add_epi32(_mm_srl_epi32(y, subSampleShift), one);
+
+		// SSE2 has no 32 bit low multiply, do even and odd lanes separately.
+		__m128i rowEven = _mm_mul_epu32(y, stride);
+		__m128i rowOdd = _mm_mul_epu32(_mm_srli_si128(y, 4), stride);
+		__m128i row = _mm_unpacklo_epi32(_mm_shuffle_epi32(rowEven, _MM_SHUFFLE(0, 0, 2, 0)),
+			_mm_shuffle_epi32(rowOdd, _MM_SHUFFLE(0, 0, 2, 0)));
+
+		// Zero the index of invalid events.
+		__m128i valid = _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(data, validMask));
+		__m128i idx = _mm_and_si128(_mm_add_epi32(row, x), valid);
+
+		_mm_storeu_si128((__m128i *) &indexes[i], idx);
+		_mm_storeu_si128((__m128i *) &timestamps[i], _mm_add_epi32(ts, offset));
+	}
+#endif
+
+	for (; i < eventsNumber; i++) {
+		caerPolarityEvent event = &events[i];
+
+		if (!caerPolarityEventIsValid(event)) {
+			indexes[i] = 0;
+			continue;
+		}
+
+		size_t x = (size_t) (caerPolarityEventGetX(event) >> subSampleBy) + 1;
+		size_t y = (size_t) (caerPolarityEventGetY(event) >> subSampleBy) + 1;
+
+		indexes[i] = U32T((y * mapStride) + x);
+		timestamps[i] = U32T(caerPolarityEventGetTimestamp(event)) + tsOffset;
+	}
 }
@@ -378,37 +378,87 @@ bool Calibration::loadUndistortMatrices(void) {
 			Matx33d::eye(), undistortCameraMatrix);
 	}
 
-	// Convert undistortEventOutputMap to integer from float for faster calculations later on.
-	undistortEventMap.clear();
-	undistortEventMap.reserve(settings->imageWidth * settings->imageHeigth);
+	// Convert undistortEventOutputMap to a lookup table of integer coordinates, so that
+	// undistorting an event is just one table load.
+	undistortEventLUTWidth = settings->imageWidth;
+	undistortEventLUTHeigth = settings->imageHeigth;
+
+	undistortEventLUT.clear();
+	undistortEventLUT.reserve(undistortEventOutputMap.size());
 
 	for (size_t i = 0; i < undistortEventOutputMap.size(); i++) {
-		undistortEventMap.push_back(undistortEventOutputMap.at(i));
+		int x = cvRound(undistortEventOutputMap[i].x);
+		int y = cvRound(undistortEventOutputMap[i].y);
+
+		// Check that new coordinates are still within view boundary.
+		if (x < 0 || x >= (int) undistortEventLUTWidth || y < 0 || y >= (int) undistortEventLUTHeigth) {
+			undistortEventLUT.push_back(UNDISTORT_EVENT_INVALID);
+		}
+		else {
+			undistortEventLUT.push_back((uint32_t) ((x << 16) | y));
+		}
 	}
 
+	// The last input frame copy is of no use with new maps.
+	undistortFrameInput.release();
+
 	return (true);
 }
 
-void Calibration::undistortEvent(caerPolarityEvent polarity, caerPolarityEventPacket polarityPacket) {
-	if (polarity == NULL || !caerPolarityEventIsValid(polarity) || polarityPacket == NULL) {
+void Calibration::undistortEvents(caerPolarityEventPacket polarityPacket) {
+	if (polarityPacket == NULL || undistortEventLUT.empty()) {
 		return;
 	}
 
-	// Get new coordinates at which event shall be remapped.
-	size_t mapIdx = (caerPolarityEventGetY(polarity) * settings->imageWidth) + caerPolarityEventGetX(polarity);
-	Point2i eventUndistort = undistortEventMap.at(mapIdx);
+	const uint32_t *lut = undistortEventLUT.data();
+	const uint32_t lutWidth = undistortEventLUTWidth;
+	const uint32_t lutHeigth = undistortEventLUTHeigth;
 
-	// Check that new coordinates are still within view boundary. If not, keep old ones and invalidate event.
-	if (eventUndistort.x < 0 || eventUndistort.x >= (int) settings->imageWidth || eventUndistort.y < 0
-		|| eventUndistort.y >= (int) settings->imageHeigth) {
-		caerPolarityEventInvalidate(polarity, polarityPacket);
+	CAER_POLARITY_ITERATOR_VALID_START(polarityPacket)
+		uint32_t x = caerPolarityEventGetX(caerPolarityIteratorElement);
+		uint32_t y = caerPolarityEventGetY(caerPolarityIteratorElement);
+
+		// Events outside the calibrated view, or remapped out of it, are invalidated.
+		uint32_t coordinates =
+			(x < lutWidth && y < lutHeigth) ? (lut[(y * lutWidth) + x]) : (UNDISTORT_EVENT_INVALID);
+
+		if (coordinates == UNDISTORT_EVENT_INVALID) {
+			caerPolarityEventInvalidate(caerPolarityIteratorElement, polarityPacket);
+		}
+		else {
+			// Else use new, remapped coordinates.
+			caerPolarityEventSetX(caerPolarityIteratorElement, (uint16_t) (coordinates >> 16));
+			caerPolarityEventSetY(caerPolarityIteratorElement, (uint16_t) (coordinates & 0xFFFF));
+		}
+	CAER_POLARITY_ITERATOR_VALID_END
+}
+
+/**
+ * Remaps a band of rows of the output frame, so remap() can be split
+ * over all available threads.
+ */
+class UndistortFrameRows: public ParallelLoopBody {
+public:
+	UndistortFrameRows(const Mat& inputFrame, const Mat& outputFrame, const Mat& map1, const Mat& map2) :
+		input(inputFrame),
+		output(outputFrame),
+		remap1(map1),
+		remap2(map2) {
 	}
-	else {
-		// Else use new, remapped coordinates.
-		caerPolarityEventSetX(polarity, eventUndistort.x);
-		caerPolarityEventSetY(polarity, eventUndistort.y);
+
+	void operator()(const Range& rows) const {
+		// Writes directly into the output frame, as the sizes match.
+		Mat outputRows = output.rowRange(rows);
+
+		remap(input, outputRows, remap1.rowRange(rows), remap2.rowRange(rows), INTER_CUBIC, BORDER_CONSTANT);
 	}
-}
+
+private:
+	const Mat& input;
+	Mat output;
+	const Mat& remap1;
+	const Mat& remap2;
+};
 
 void Calibration::undistortFrame(caerFrameEvent frame) {
 	if (frame == NULL || !caerFrameEventIsValid(frame)) {
@@ -416,8 +466,17 @@ void Calibration::undistortFrame(caerFrameEvent frame) {
 	}
 
 	Size frameSize(caerFrameEventGetLengthX(frame), caerFrameEventGetLengthY(frame));
+
+	// The maps only fit frames of the calibrated size.
+	if (frameSize != undistortRemap1.size()) {
+		return;
+	}
+
 	Mat view(frameSize, CV_16UC(caerFrameEventGetChannelNumber(frame)), caerFrameEventGetPixelArrayUnsafe(frame));
-	Mat inputView = view.clone();
 
-	remap(inputView, view, undistortRemap1, undistortRemap2, INTER_CUBIC, BORDER_CONSTANT);
+	// Reuses the buffer from the last frame, as long as size and type stay the same.
+	view.copyTo(undistortFrameInput);
+
+	parallel_for_(Range(0, frameSize.height),
+		UndistortFrameRows(undistortFrameInput, view, undistortRemap1, undistortRemap2), getNumThreads());
 }
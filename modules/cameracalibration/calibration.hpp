@@ -15,6 +15,9 @@
 #include <opencv2/imgproc.hpp>
 #include <opencv2/calib3d.hpp>
 
+// Marks pixels that are undistorted to outside of the view.
+#define UNDISTORT_EVENT_INVALID UINT32_MAX
+
 using namespace cv;
 using namespace std;
 
@@ -28,7 +31,7 @@ public:
 	bool runCalibrationAndSave(double *totalAvgError);
 
 	bool loadUndistortMatrices(void);
-	void undistortEvent(caerPolarityEvent polarity, caerPolarityEventPacket polarityPacket);
+	void undistortEvents(caerPolarityEventPacket polarityPacket);
 	void undistortFrame(caerFrameEvent frame);
 
 private:
@@ -40,9 +43,16 @@ private:
 	Mat cameraMatrix;
 	Mat distCoeffs;
 
-	vector<Point2i> undistortEventMap;
+	// Undistorted event coordinates per pixel, packed as (x << 16) | y, or
+	// UNDISTORT_EVENT_INVALID if the pixel falls outside the view.
+	vector<uint32_t> undistortEventLUT;
+	uint32_t undistortEventLUTWidth = 0;
+	uint32_t undistortEventLUTHeigth = 0;
+
+	// Fixed-point maps for frame remap(), and a copy of the input frame, kept across frames.
 	Mat undistortRemap1;
 	Mat undistortRemap2;
+	Mat undistortFrameInput;
 
 	double computeReprojectionErrors(const vector<vector<Point3f> >& objectPoints,
 		const vector<vector<Point2f> >& imagePoints, const vector<Mat>& rvecs, const vector<Mat>& tvecs,
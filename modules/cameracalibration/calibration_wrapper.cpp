@@ -69,13 +69,12 @@ bool calibration_loadUndistortMatrices(Calibration *calibClass) {
 	}
 }
 
-void calibration_undistortEvent(Calibration *calibClass, caerPolarityEvent polarity,
-	caerPolarityEventPacket polarityPacket) {
+void calibration_undistortEvents(Calibration *calibClass, caerPolarityEventPacket polarityPacket) {
 	try {
-		calibClass->undistortEvent(polarity, polarityPacket);
+		calibClass->undistortEvents(polarityPacket);
 	}
 	catch (const std::exception& ex) {
-		caerLog(CAER_LOG_ERROR, "calibration_undistortEvent()", "Failed with C++ exception: %s", ex.what());
+		caerLog(CAER_LOG_ERROR, "calibration_undistortEvents()", "Failed with C++ exception: %s", ex.what());
 	}
 }
 
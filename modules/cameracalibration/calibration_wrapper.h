@@ -16,8 +16,7 @@ bool calibration_findNewPoints(Calibration *calibClass, caerFrameEvent frame);
 size_t calibration_foundPoints(Calibration *calibClass);
 bool calibration_runCalibrationAndSave(Calibration *calibClass, double *totalAvgError);
 bool calibration_loadUndistortMatrices(Calibration *calibClass);
-void calibration_undistortEvent(Calibration *calibClass, caerPolarityEvent polarity,
-	caerPolarityEventPacket polarityPacket);
+void calibration_undistortEvents(Calibration *calibClass, caerPolarityEventPacket polarityPacket);
 void calibration_undistortFrame(Calibration *calibClass, caerFrameEvent frame);
 
 #ifdef __cplusplus
@@ -14,6 +14,8 @@ struct DvsToDynapse_state {
 	sshsNode eventSourceConfigNode;
 	bool doMapping;
 	int chipId;
+	sshsNodeAttrHandle doMappingHandle;
+	sshsNodeAttrHandle chipIdHandle;
 };
 
 typedef struct DvsToDynapse_state *DvsToDynapseState;
@@ -25,9 +27,8 @@ static void caerDvsToDynapseExit(caerModuleData moduleData);
 static void caerDvsToDynapseReset(caerModuleData moduleData, uint16_t resetCallSourceID);
 
 static struct caer_module_functions caerDvsToDynapseFunctions = { .moduleInit =
-	&caerDvsToDynapseInit, .moduleRun = &caerDvsToDynapseRun, .moduleConfig =
-	&caerDvsToDynapseConfig, .moduleExit = &caerDvsToDynapseExit, .moduleReset =
-	&caerDvsToDynapseReset };
+	&caerDvsToDynapseInit, .moduleRun = &caerDvsToDynapseRun, .moduleConfig = NULL,
+	.moduleExit = &caerDvsToDynapseExit, .moduleReset = &caerDvsToDynapseReset };
 
 void caerDvsToDynapse(uint16_t moduleID,  int16_t eventSourceID, caerSpikeEventPacket spike, caerPolarityEventPacket polarity) {
 	caerModuleData moduleData = caerMainloopFindModule(moduleID, "DvsToDynapse", CAER_MODULE_PROCESSOR);
@@ -45,8 +46,9 @@ static bool caerDvsToDynapseInit(caerModuleData moduleData) {
 
 	DvsToDynapseState state = moduleData->moduleState;
 
-	// Add config listeners last, to avoid having them dangling if Init doesn't succeed.
-	sshsNodeAddAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+	// Resolve configuration once, values are then refreshed lock-free on each run.
+	state->doMappingHandle = sshsNodeGetAttributeHandle(moduleData->moduleNode, "doMapping", SSHS_BOOL);
+	state->chipIdHandle = sshsNodeGetAttributeHandle(moduleData->moduleNode, "chipId", SSHS_INT);
 
 	sshsNode sourceInfoNode = sshsGetRelativeNode(moduleData->moduleNode, "sourceInfo/");
 	if (!sshsNodeAttributeExists(sourceInfoNode, "dataSizeX", SSHS_SHORT)) { //to do for visualizer change name of field to a more generic one
@@ -54,8 +56,7 @@ static bool caerDvsToDynapseInit(caerModuleData moduleData) {
 		sshsNodePutShort(sourceInfoNode, "dataSizeY", DYNAPSE_X4BOARD_NEUY);
 	}
 
-	state->doMapping = sshsNodeGetBool(moduleData->moduleNode, "doMapping");
-	state->chipId = sshsNodeGetInt(moduleData->moduleNode, "chipId");
+	caerDvsToDynapseConfig(moduleData);
 
 
 	// Nothing that can fail here.
@@ -201,19 +202,14 @@ static void caerDvsToDynapseRun(caerModuleData moduleData, size_t argsNumber, va
 }
 
 static void caerDvsToDynapseConfig(caerModuleData moduleData) {
-	caerModuleConfigUpdateReset(moduleData);
-
 	DvsToDynapseState state = moduleData->moduleState;
-	state->doMapping = sshsNodeGetBool(moduleData->moduleNode, "doMapping");
-	state->chipId = sshsNodeGetInt(moduleData->moduleNode, "chipId");
+	state->doMapping = sshsNodeAttrHandleGetBool(state->doMappingHandle);
+	state->chipId = sshsNodeAttrHandleGetInt(state->chipIdHandle);
 
 
 }
 
 static void caerDvsToDynapseExit(caerModuleData moduleData) {
-	// Remove listener, which can reference invalid memory in userData.
-	sshsNodeRemoveAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
-
 	DvsToDynapseState state = moduleData->moduleState;
 
 
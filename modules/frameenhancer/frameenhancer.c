@@ -5,6 +5,17 @@
 #ifdef ENABLE_FRAMEENHANCER_OPENCV
 	#include <libcaer/frame_utils_opencv.h>
 #endif
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Type number of the fused, allocation-free implementation, the same for all three operations.
+#define FAST_TYPE 10
+
+// White balance gains are limited, so an almost empty channel doesn't just amplify noise.
+#define FAST_WHITEBALANCE_MAX_GAIN 16.0f
 
 struct FrameEnhancer_state {
 	bool doDemosaic;
@@ -13,6 +24,18 @@ struct FrameEnhancer_state {
 	int contrastType;
 	bool doWhiteBalance;
 	int whiteBalanceType;
+	/// Output of the fast demosaic, kept and reused across runs.
+	caerFrameEventPacket fastFrame;
+};
+
+/**
+ * Linear map applied to each channel by the fast path, to do white balance
+ * and contrast in the same pass: out = (in * scale) + offset, clamped.
+ */
+struct fast_channel_maps {
+	bool identity;
+	float scale[4];
+	float offset[4];
 };
 
 typedef struct FrameEnhancer_state *FrameEnhancerState;
@@ -21,6 +44,9 @@ static bool caerFrameEnhancerInit(caerModuleData moduleData);
 static void caerFrameEnhancerRun(caerModuleData moduleData, size_t argsNumber, va_list args);
 static void caerFrameEnhancerConfig(caerModuleData moduleData);
 static void caerFrameEnhancerExit(caerModuleData moduleData);
+static caerFrameEventPacket fastDemosaic(FrameEnhancerState state, caerFrameEventPacket frame, bool doWhiteBalance,
+	bool doContrast);
+static void fastEnhance(caerFrameEventPacket frame, bool doWhiteBalance, bool doContrast);
 
 static struct caer_module_functions caerFrameEnhancerFunctions = { .moduleInit = &caerFrameEnhancerInit, .moduleRun =
 	&caerFrameEnhancerRun, .moduleConfig = &caerFrameEnhancerConfig, .moduleExit = &caerFrameEnhancerExit };
@@ -49,9 +75,9 @@ static bool caerFrameEnhancerInit(caerModuleData moduleData) {
 	sshsNodePutStringIfAbsent(moduleData->moduleNode, "contrastType", "opencv_normalization");
 	sshsNodePutStringIfAbsent(moduleData->moduleNode, "whiteBalanceType", "opencv_grayworld");
 #else
-	sshsNodePutStringIfAbsent(moduleData->moduleNode, "demosaicType", "standard");
-	sshsNodePutStringIfAbsent(moduleData->moduleNode, "contrastType", "standard");
-	sshsNodePutStringIfAbsent(moduleData->moduleNode, "whiteBalanceType", "standard");
+	sshsNodePutStringIfAbsent(moduleData->moduleNode, "demosaicType", "fast");
+	sshsNodePutStringIfAbsent(moduleData->moduleNode, "contrastType", "fast");
+	sshsNodePutStringIfAbsent(moduleData->moduleNode, "whiteBalanceType", "fast");
 #endif
 
 	// Initialize configuration.
@@ -78,7 +104,30 @@ static void caerFrameEnhancerRun(caerModuleData moduleData, size_t argsNumber, v
 
 	FrameEnhancerState state = moduleData->moduleState;
 
-	if (state->doDemosaic) {
+	// Operations set to the fast type are done together, in the demosaic pass if that's fast too.
+	bool fastDemosaicOn = (state->doDemosaic && state->demosaicType == FAST_TYPE);
+	bool fastWhiteBalanceOn = (state->doWhiteBalance && state->whiteBalanceType == FAST_TYPE);
+	bool fastContrastOn = (state->doContrast && state->contrastType == FAST_TYPE);
+
+	if (fastDemosaicOn) {
+		caerFrameEventPacket fastFrame = fastDemosaic(state, frame, fastWhiteBalanceOn, fastContrastOn);
+
+		if (fastFrame != NULL) {
+			// Owned by this module and reused, freed on exit.
+			*enhancedFrame = fastFrame;
+		}
+		else {
+			// Colour filter not supported by the fast path.
+			*enhancedFrame = caerFrameUtilsDemosaic(frame);
+			caerMainloopFreeAfterLoop(&free, *enhancedFrame);
+
+			if (*enhancedFrame != NULL && (fastWhiteBalanceOn || fastContrastOn)) {
+				fastEnhance(*enhancedFrame, fastWhiteBalanceOn, fastContrastOn);
+			}
+		}
+	}
+
+	if (state->doDemosaic && !fastDemosaicOn) {
 #ifdef ENABLE_FRAMEENHANCER_OPENCV
 		switch (state->demosaicType) {
 			case 0:
@@ -102,7 +151,12 @@ static void caerFrameEnhancerRun(caerModuleData moduleData, size_t argsNumber, v
 		caerMainloopFreeAfterLoop(&free, *enhancedFrame);
 	}
 
-	if (state->doWhiteBalance) {
+	// Demosaicing can fail and leave no frame to enhance.
+	if (*enhancedFrame != NULL && !fastDemosaicOn && (fastWhiteBalanceOn || fastContrastOn)) {
+		fastEnhance(*enhancedFrame, fastWhiteBalanceOn, fastContrastOn);
+	}
+
+	if (state->doWhiteBalance && !fastWhiteBalanceOn) {
 #ifdef ENABLE_FRAMEENHANCER_OPENCV
 		switch (state->whiteBalanceType) {
 			case 0:
@@ -122,7 +176,7 @@ static void caerFrameEnhancerRun(caerModuleData moduleData, size_t argsNumber, v
 #endif
 	}
 
-	if (state->doContrast) {
+	if (state->doContrast && !fastContrastOn) {
 #ifdef ENABLE_FRAMEENHANCER_OPENCV
 		switch (state->contrastType) {
 			case 0:
@@ -162,6 +216,9 @@ static void caerFrameEnhancerConfig(caerModuleData moduleData) {
 	else if (caerStrEquals(demosaicType, "opencv_edge_aware")) {
 		state->demosaicType = 2;
 	}
+	else if (caerStrEquals(demosaicType, "fast")) {
+		state->demosaicType = FAST_TYPE;
+	}
 	else {
 		// Standard, non-OpenCV method.
 		state->demosaicType = 0;
@@ -182,6 +239,9 @@ static void caerFrameEnhancerConfig(caerModuleData moduleData) {
 	else if (caerStrEquals(contrastType, "opencv_clahe")) {
 		state->contrastType = 3;
 	}
+	else if (caerStrEquals(contrastType, "fast")) {
+		state->contrastType = FAST_TYPE;
+	}
 	else {
 		// Standard, non-OpenCV method.
 		state->contrastType = 0;
@@ -199,6 +259,9 @@ static void caerFrameEnhancerConfig(caerModuleData moduleData) {
 	else if (caerStrEquals(whiteBalanceType, "opencv_grayworld")) {
 		state->whiteBalanceType = 2;
 	}
+	else if (caerStrEquals(whiteBalanceType, "fast")) {
+		state->whiteBalanceType = FAST_TYPE;
+	}
 	else {
 		// Standard, non-OpenCV method.
 		state->whiteBalanceType = 0;
@@ -210,4 +273,520 @@ static void caerFrameEnhancerConfig(caerModuleData moduleData) {
 static void caerFrameEnhancerExit(caerModuleData moduleData) {
 	// Remove listener, which can reference invalid memory in userData.
 	sshsNodeRemoveAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+
+	FrameEnhancerState state = moduleData->moduleState;
+
+	free(state->fastFrame);
+	state->fastFrame = NULL;
+}
+
+static inline uint16_t fastMapValue(uint16_t value, float scale, float offset) {
+	float mapped = ((float) value * scale) + offset;
+	mapped = (mapped > 0.0f) ? (mapped) : (0.0f);
+	mapped = (mapped < 65535.0f) ? (mapped) : (65535.0f);
+
+	return ((uint16_t) lrintf(mapped));
+}
+
+#if defined(__SSE2__)
+/**
+ * Map eight values at once, with separate scale and offset for the lower
+ * and upper four lanes. Gives the same results as fastMapValue().
+ */
+static inline __m128i fastMapSSE2(__m128i values, __m128 scaleLow, __m128 offsetLow, __m128 scaleHigh,
+	__m128 offsetHigh) {
+	__m128i zero = _mm_setzero_si128();
+	__m128 minimum = _mm_setzero_ps();
+	__m128 maximum = _mm_set1_ps(65535.0f);
+
+	__m128 low = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(values, zero)), scaleLow), offsetLow);
+	__m128 high = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(values, zero)), scaleHigh), offsetHigh);
+
+	low = _mm_min_ps(_mm_max_ps(low, minimum), maximum);
+	high = _mm_min_ps(_mm_max_ps(high, minimum), maximum);
+
+	// SSE2 can only pack with signed saturation: shift into the signed range and back.
+	__m128i bias = _mm_set1_epi32(32768);
+	__m128i packed = _mm_packs_epi32(_mm_sub_epi32(_mm_cvtps_epi32(low), bias),
+		_mm_sub_epi32(_mm_cvtps_epi32(high), bias));
+
+	return (_mm_xor_si128(packed, _mm_set1_epi16(INT16_MIN)));
+}
+
+static inline __m128i fastSelectSSE2(__m128i mask, __m128i a, __m128i b) {
+	return (_mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)));
+}
+#endif
+
+/**
+ * Compute the channel maps from per-channel statistics. Gray world white
+ * balance scales each colour channel so that its mean becomes the mean of
+ * all colour channels, then contrast normalization stretches the range
+ * common to all colour channels to the full 16 bit range.
+ */
+static void fastChannelMaps(struct fast_channel_maps *maps, size_t colorChannels, const uint64_t sum[3],
+	const uint64_t count[3], const uint16_t min[3], const uint16_t max[3], bool doWhiteBalance, bool doContrast) {
+	float gain[3] = { 1.0f, 1.0f, 1.0f };
+
+	if (doWhiteBalance && colorChannels == 3) {
+		float mean[3];
+		float gray = 0.0f;
+
+		for (size_t c = 0; c < 3; c++) {
+			mean[c] = (count[c] == 0) ? (0.0f) : ((float) sum[c] / (float) count[c]);
+			gray += mean[c] / 3.0f;
+		}
+
+		for (size_t c = 0; c < 3; c++) {
+			gain[c] = (mean[c] > 0.0f) ? (gray / mean[c]) : (1.0f);
+			gain[c] = (gain[c] < FAST_WHITEBALANCE_MAX_GAIN) ? (gain[c]) : (FAST_WHITEBALANCE_MAX_GAIN);
+		}
+	}
+
+	float low = 65535.0f * FAST_WHITEBALANCE_MAX_GAIN;
+	float high = 0.0f;
+
+	for (size_t c = 0; c < colorChannels; c++) {
+		low = ((float) min[c] * gain[c] < low) ? ((float) min[c] * gain[c]) : (low);
+		high = ((float) max[c] * gain[c] > high) ? ((float) max[c] * gain[c]) : (high);
+	}
+
+	// Alpha and unused channels stay as they are.
+	for (size_t c = 0; c < 4; c++) {
+		maps->scale[c] = (c < colorChannels) ? (gain[c]) : (1.0f);
+		maps->offset[c] = 0.0f;
+	}
+
+	if (doContrast && high > low) {
+		float stretch = 65535.0f / (high - low);
+
+		for (size_t c = 0; c < colorChannels; c++) {
+			maps->scale[c] *= stretch;
+			maps->offset[c] = -low * stretch;
+		}
+	}
+
+	maps->identity = true;
+
+	for (size_t c = 0; c < colorChannels; c++) {
+		if (maps->scale[c] != 1.0f || maps->offset[c] != 0.0f) {
+			maps->identity = false;
+		}
+	}
+}
+
+/**
+ * Apply the channel maps in-place to interleaved pixels with 1, 3 or 4 channels.
+ */
+static void fastApplyMaps(uint16_t *pixels, size_t valuesNumber, size_t channels,
+	const struct fast_channel_maps *maps) {
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	// The channel pattern repeats every 12 values for 1, 3 and 4 channels,
+	// so 24 values (three vectors) always start at channel 0.
+	float laneScale[12];
+	float laneOffset[12];
+
+	for (size_t lane = 0; lane < 12; lane++) {
+		laneScale[lane] = maps->scale[lane % channels];
+		laneOffset[lane] = maps->offset[lane % channels];
+	}
+
+	__m128 scale[3] = { _mm_loadu_ps(&laneScale[0]), _mm_loadu_ps(&laneScale[4]), _mm_loadu_ps(&laneScale[8]) };
+	__m128 offset[3] = { _mm_loadu_ps(&laneOffset[0]), _mm_loadu_ps(&laneOffset[4]), _mm_loadu_ps(&laneOffset[8]) };
+
+	for (; (i + 24) <= valuesNumber; i += 24) {
+		for (size_t j = 0; j < 3; j++) {
+			__m128i *vector = (__m128i *) (void *) &pixels[i + (j * 8)];
+
+			// Values 8j to 8j+7, so lanes start at (2j % 3) * 4 and ((2j + 1) % 3) * 4 of the pattern.
+			size_t low = (2 * j) % 3;
+			size_t high = ((2 * j) + 1) % 3;
+
+			_mm_storeu_si128(vector,
+				fastMapSSE2(_mm_loadu_si128(vector), scale[low], offset[low], scale[high], offset[high]));
+		}
+	}
+#endif
+
+	for (; i < valuesNumber; i++) {
+		pixels[i] = fastMapValue(pixels[i], maps->scale[i % channels], maps->offset[i % channels]);
+	}
+}
+
+/**
+ * White balance and contrast for one frame, in-place, as a statistics and
+ * a mapping pass. Grayscale frames only get contrast normalization.
+ */
+static void fastEnhanceFrame(caerFrameEvent frame, bool doWhiteBalance, bool doContrast) {
+	size_t channels = (size_t) caerFrameEventGetChannelNumber(frame);
+	size_t colorChannels = (channels >= 3) ? (3) : (1);
+	size_t valuesNumber = (size_t) caerFrameEventGetLengthX(frame) * (size_t) caerFrameEventGetLengthY(frame)
+		* channels;
+	uint16_t *pixels = caerFrameEventGetPixelArrayUnsafe(frame);
+
+	uint64_t sum[3] = { 0, 0, 0 };
+	uint16_t min[3] = { UINT16_MAX, UINT16_MAX, UINT16_MAX };
+	uint16_t max[3] = { 0, 0, 0 };
+
+	for (size_t i = 0; i < valuesNumber; i += channels) {
+		for (size_t c = 0; c < colorChannels; c++) {
+			uint16_t value = pixels[i + c];
+
+			sum[c] += value;
+			min[c] = (value < min[c]) ? (value) : (min[c]);
+			max[c] = (value > max[c]) ? (value) : (max[c]);
+		}
+	}
+
+	uint64_t pixelsNumber = valuesNumber / channels;
+	uint64_t count[3] = { pixelsNumber, pixelsNumber, pixelsNumber };
+
+	struct fast_channel_maps maps;
+	fastChannelMaps(&maps, colorChannels, sum, count, min, max, doWhiteBalance, doContrast);
+
+	if (!maps.identity) {
+		fastApplyMaps(pixels, valuesNumber, channels, &maps);
+	}
+}
+
+static void fastEnhance(caerFrameEventPacket frame, bool doWhiteBalance, bool doContrast) {
+	CAER_FRAME_ITERATOR_VALID_START(frame)
+		fastEnhanceFrame(caerFrameIteratorElement, doWhiteBalance, doContrast);
+	CAER_FRAME_ITERATOR_VALID_END
+}
+
+/**
+ * Position of the red pixel in the 2x2 Bayer pattern. Patterns with white
+ * pixels are not supported by the fast path.
+ */
+static bool bayerRedPosition(enum caer_frame_event_color_filter colorFilter, int32_t *redX, int32_t *redY) {
+	switch (colorFilter) {
+		case RGBG:
+			*redX = 0;
+			*redY = 0;
+			return (true);
+
+		case GRGB:
+			*redX = 1;
+			*redY = 0;
+			return (true);
+
+		case GBGR:
+			*redX = 0;
+			*redY = 1;
+			return (true);
+
+		case BGRG:
+			*redX = 1;
+			*redY = 1;
+			return (true);
+
+		default:
+			return (false);
+	}
+}
+
+/**
+ * Per-colour statistics directly on the Bayer pattern. Bilinear interpolation
+ * only averages pixels of the same colour, so the demosaiced channels have
+ * the same range and about the same mean.
+ */
+static void bayerStatistics(const uint16_t *pixels, int32_t lengthX, int32_t lengthY, int32_t redX, int32_t redY,
+	uint64_t sum[3], uint64_t count[3], uint16_t min[3], uint16_t max[3]) {
+	for (size_t c = 0; c < 3; c++) {
+		sum[c] = 0;
+		count[c] = 0;
+		min[c] = UINT16_MAX;
+		max[c] = 0;
+	}
+
+	for (int32_t y = 0; y < lengthY; y++) {
+		const uint16_t *row = pixels + ((size_t) y * (size_t) lengthX);
+
+		// Red rows alternate red and green, blue rows green and blue.
+		bool redRow = (((y ^ redY) & 1) == 0);
+		size_t colors[2] = { (redRow) ? (0) : (1), (redRow) ? (1) : (2) };
+
+		for (int32_t x = 0; x < lengthX; x++) {
+			size_t c = colors[(x ^ redX) & 1];
+			uint16_t value = row[x];
+
+			sum[c] += value;
+			count[c]++;
+			min[c] = (value < min[c]) ? (value) : (min[c]);
+			max[c] = (value > max[c]) ? (value) : (max[c]);
+		}
+	}
+}
+
+static inline uint16_t average(uint16_t a, uint16_t b) {
+	// Rounds up, like _mm_avg_epu16().
+	return ((uint16_t) (((uint32_t) a + (uint32_t) b + 1) >> 1));
+}
+
+/**
+ * Bilinear demosaic of one pixel. At the borders, the pattern is mirrored
+ * around the pixel, as neighbours at distance one have the same colour.
+ */
+static inline void demosaicPixel(const uint16_t *pixels, int32_t lengthX, int32_t lengthY, int32_t x, int32_t y,
+	int32_t redX, int32_t redY, uint16_t rgb[3]) {
+	int32_t left = (x > 0) ? (x - 1) : (x + 1);
+	int32_t right = (x < (lengthX - 1)) ? (x + 1) : (x - 1);
+	int32_t up = (y > 0) ? (y - 1) : (y + 1);
+	int32_t down = (y < (lengthY - 1)) ? (y + 1) : (y - 1);
+
+	const uint16_t *rowUp = pixels + ((size_t) up * (size_t) lengthX);
+	const uint16_t *row = pixels + ((size_t) y * (size_t) lengthX);
+	const uint16_t *rowDown = pixels + ((size_t) down * (size_t) lengthX);
+
+	uint16_t center = row[x];
+	uint16_t horizontal = average(row[left], row[right]);
+	uint16_t vertical = average(rowUp[x], rowDown[x]);
+	uint16_t cross = average(horizontal, vertical);
+	uint16_t diagonal = average(average(rowUp[left], rowUp[right]), average(rowDown[left], rowDown[right]));
+
+	bool evenX = (((x ^ redX) & 1) == 0);
+
+	if (((y ^ redY) & 1) == 0) {
+		// Red and green row.
+		rgb[0] = (evenX) ? (center) : (horizontal);
+		rgb[1] = (evenX) ? (cross) : (center);
+		rgb[2] = (evenX) ? (diagonal) : (vertical);
+	}
+	else {
+		// Green and blue row.
+		rgb[0] = (evenX) ? (vertical) : (diagonal);
+		rgb[1] = (evenX) ? (center) : (cross);
+		rgb[2] = (evenX) ? (horizontal) : (center);
+	}
+}
+
+#if defined(__SSE2__)
+/**
+ * Demosaic and map eight pixels at a time, starting at x, for rows that
+ * aren't the first or last one. Stops before the last pixel of the row,
+ * which needs mirroring.
+ *
+ * @return the first pixel that was not done.
+ */
+static int32_t demosaicRowSSE2(const uint16_t *pixels, uint16_t *outRow, int32_t lengthX, int32_t x, int32_t y,
+	int32_t redX, int32_t redY, const struct fast_channel_maps *maps) {
+	const uint16_t *row = pixels + ((size_t) y * (size_t) lengthX);
+	const uint16_t *rowUp = row - lengthX;
+	const uint16_t *rowDown = row + lengthX;
+
+	// x only advances by 8, so the lanes with the red column's parity stay the same.
+	__m128i evenLanes =
+		(((x ^ redX) & 1) == 0) ?
+			(_mm_set_epi16(0, -1, 0, -1, 0, -1, 0, -1)) : (_mm_set_epi16(-1, 0, -1, 0, -1, 0, -1, 0));
+	bool redRow = (((y ^ redY) & 1) == 0);
+
+	__m128 scale[3], offset[3];
+	for (size_t c = 0; c < 3; c++) {
+		scale[c] = _mm_set1_ps(maps->scale[c]);
+		offset[c] = _mm_set1_ps(maps->offset[c]);
+	}
+
+	for (; (x + 8) < lengthX; x += 8) {
+		__m128i center = _mm_loadu_si128((const __m128i *) (const void *) &row[x]);
+		__m128i left = _mm_loadu_si128((const __m128i *) (const void *) &row[x - 1]);
+		__m128i right = _mm_loadu_si128((const __m128i *) (const void *) &row[x + 1]);
+		__m128i up = _mm_loadu_si128((const __m128i *) (const void *) &rowUp[x]);
+		__m128i upLeft = _mm_loadu_si128((const __m128i *) (const void *) &rowUp[x - 1]);
+		__m128i upRight = _mm_loadu_si128((const __m128i *) (const void *) &rowUp[x + 1]);
+		__m128i down = _mm_loadu_si128((const __m128i *) (const void *) &rowDown[x]);
+		__m128i downLeft = _mm_loadu_si128((const __m128i *) (const void *) &rowDown[x - 1]);
+		__m128i downRight = _mm_loadu_si128((const __m128i *) (const void *) &rowDown[x + 1]);
+
+		__m128i horizontal = _mm_avg_epu16(left, right);
+		__m128i vertical = _mm_avg_epu16(up, down);
+		__m128i cross = _mm_avg_epu16(horizontal, vertical);
+		__m128i diagonal = _mm_avg_epu16(_mm_avg_epu16(upLeft, upRight), _mm_avg_epu16(downLeft, downRight));
+
+		__m128i rgb[3];
+
+		if (redRow) {
+			rgb[0] = fastSelectSSE2(evenLanes, center, horizontal);
+			rgb[1] = fastSelectSSE2(evenLanes, cross, center);
+			rgb[2] = fastSelectSSE2(evenLanes, diagonal, vertical);
+		}
+		else {
+			rgb[0] = fastSelectSSE2(evenLanes, vertical, diagonal);
+			rgb[1] = fastSelectSSE2(evenLanes, center, cross);
+			rgb[2] = fastSelectSSE2(evenLanes, horizontal, center);
+		}
+
+		uint16_t planes[3][8];
+
+		for (size_t c = 0; c < 3; c++) {
+			if (!maps->identity) {
+				rgb[c] = fastMapSSE2(rgb[c], scale[c], offset[c], scale[c], offset[c]);
+			}
+
+			_mm_storeu_si128((__m128i *) (void *) planes[c], rgb[c]);
+		}
+
+		// Interleave into RGB.
+		uint16_t *out = outRow + ((size_t) x * 3);
+
+		for (size_t i = 0; i < 8; i++) {
+			out[(i * 3)] = planes[0][i];
+			out[(i * 3) + 1] = planes[1][i];
+			out[(i * 3) + 2] = planes[2][i];
+		}
+	}
+
+	return (x);
+}
+#endif
+
+static void demosaicFrame(const uint16_t *pixels, uint16_t *outPixels, int32_t lengthX, int32_t lengthY,
+	int32_t redX, int32_t redY, const struct fast_channel_maps *maps) {
+	for (int32_t y = 0; y < lengthY; y++) {
+		uint16_t *outRow = outPixels + ((size_t) y * (size_t) lengthX * 3);
+		int32_t x = 0;
+
+#if defined(__SSE2__)
+		if (y > 0 && y < (lengthY - 1)) {
+			uint16_t rgb[3];
+			demosaicPixel(pixels, lengthX, lengthY, 0, y, redX, redY, rgb);
+
+			for (size_t c = 0; c < 3; c++) {
+				outRow[c] = (maps->identity) ? (rgb[c]) : (fastMapValue(rgb[c], maps->scale[c], maps->offset[c]));
+			}
+
+			x = demosaicRowSSE2(pixels, outRow, lengthX, 1, y, redX, redY, maps);
+		}
+#endif
+
+		for (; x < lengthX; x++) {
+			uint16_t rgb[3];
+			demosaicPixel(pixels, lengthX, lengthY, x, y, redX, redY, rgb);
+
+			for (size_t c = 0; c < 3; c++) {
+				outRow[((size_t) x * 3) + c] =
+					(maps->identity) ? (rgb[c]) : (fastMapValue(rgb[c], maps->scale[c], maps->offset[c]));
+			}
+		}
+	}
+}
+
+/**
+ * Demosaic all valid frames with a bilinear filter, with white balance and
+ * contrast in the same pass, into a packet that is kept and reused as long
+ * as the input frames keep their size. Frames that aren't colour Bayer
+ * frames are copied and enhanced in-place instead.
+ *
+ * @return the demosaiced frames, owned by the module, or NULL if the fast
+ *         path doesn't support the input.
+ */
+static caerFrameEventPacket fastDemosaic(FrameEnhancerState state, caerFrameEventPacket frame, bool doWhiteBalance,
+	bool doContrast) {
+	// Bail out early for unsupported frames, the standard path then does all of them.
+	CAER_FRAME_ITERATOR_VALID_START(frame)
+		enum caer_frame_event_color_filter colorFilter = caerFrameEventGetColorFilter(caerFrameIteratorElement);
+		int32_t redX, redY;
+
+		if (caerFrameEventGetChannelNumber(caerFrameIteratorElement) == GRAYSCALE && colorFilter != MONO
+			&& (!bayerRedPosition(colorFilter, &redX, &redY) || caerFrameEventGetLengthX(caerFrameIteratorElement) < 2
+				|| caerFrameEventGetLengthY(caerFrameIteratorElement) < 2)) {
+			return (NULL);
+		}
+	CAER_FRAME_ITERATOR_VALID_END
+
+	int32_t framesNumber = caerEventPacketHeaderGetEventValid(&frame->packetHeader);
+	if (framesNumber == 0) {
+		return (frame);
+	}
+
+	// Room for all pixels of the input as RGB.
+	size_t pixelsMax = ((size_t) caerEventPacketHeaderGetEventSize(&frame->packetHeader)
+		- sizeof(struct caer_frame_event)) / sizeof(uint16_t);
+	int32_t eventSize = I32T(sizeof(struct caer_frame_event) + (pixelsMax * 3 * sizeof(uint16_t)));
+
+	if (state->fastFrame != NULL
+		&& (caerEventPacketHeaderGetEventCapacity(&state->fastFrame->packetHeader) < framesNumber
+			|| caerEventPacketHeaderGetEventSize(&state->fastFrame->packetHeader) != eventSize)) {
+		free(state->fastFrame);
+		state->fastFrame = NULL;
+	}
+
+	if (state->fastFrame == NULL) {
+		state->fastFrame = caerFrameEventPacketAllocate(framesNumber,
+			caerEventPacketHeaderGetEventSource(&frame->packetHeader),
+			caerEventPacketHeaderGetEventTSOverflow(&frame->packetHeader), I32T(pixelsMax), 1, RGB);
+		if (state->fastFrame == NULL) {
+			return (NULL);
+		}
+	}
+	else {
+		caerEventPacketHeaderSetEventSource(&state->fastFrame->packetHeader,
+			caerEventPacketHeaderGetEventSource(&frame->packetHeader));
+		caerEventPacketHeaderSetEventTSOverflow(&state->fastFrame->packetHeader,
+			caerEventPacketHeaderGetEventTSOverflow(&frame->packetHeader));
+		caerEventPacketHeaderSetEventNumber(&state->fastFrame->packetHeader, 0);
+		caerEventPacketHeaderSetEventValid(&state->fastFrame->packetHeader, 0);
+	}
+
+	int32_t outIndex = 0;
+
+	CAER_FRAME_ITERATOR_VALID_START(frame)
+		caerFrameEvent inFrame = caerFrameIteratorElement;
+		caerFrameEvent outFrame = caerFrameEventPacketGetEvent(state->fastFrame, outIndex++);
+
+		// Reused, clear what's left from the last run, valid mark included.
+		memset(outFrame, 0, sizeof(struct caer_frame_event));
+
+		caerFrameEventSetTSStartOfFrame(outFrame, caerFrameEventGetTSStartOfFrame(inFrame));
+		caerFrameEventSetTSEndOfFrame(outFrame, caerFrameEventGetTSEndOfFrame(inFrame));
+		caerFrameEventSetTSStartOfExposure(outFrame, caerFrameEventGetTSStartOfExposure(inFrame));
+		caerFrameEventSetTSEndOfExposure(outFrame, caerFrameEventGetTSEndOfExposure(inFrame));
+		caerFrameEventSetPositionX(outFrame, caerFrameEventGetPositionX(inFrame));
+		caerFrameEventSetPositionY(outFrame, caerFrameEventGetPositionY(inFrame));
+		caerFrameEventSetROIIdentifier(outFrame, caerFrameEventGetROIIdentifier(inFrame));
+
+		int32_t lengthX = caerFrameEventGetLengthX(inFrame);
+		int32_t lengthY = caerFrameEventGetLengthY(inFrame);
+		int32_t redX, redY;
+
+		if (caerFrameEventGetChannelNumber(inFrame) == GRAYSCALE
+			&& bayerRedPosition(caerFrameEventGetColorFilter(inFrame), &redX, &redY)) {
+			caerFrameEventSetColorFilter(outFrame, MONO);
+			caerFrameEventSetLengthXLengthYChannelNumber(outFrame, lengthX, lengthY, RGB, state->fastFrame);
+
+			const uint16_t *pixels = caerFrameEventGetPixelArrayUnsafe(inFrame);
+			struct fast_channel_maps maps = { .identity = true };
+
+			if (doWhiteBalance || doContrast) {
+				uint64_t sum[3], count[3];
+				uint16_t min[3], max[3];
+
+				bayerStatistics(pixels, lengthX, lengthY, redX, redY, sum, count, min, max);
+				fastChannelMaps(&maps, 3, sum, count, min, max, doWhiteBalance, doContrast);
+			}
+
+			demosaicFrame(pixels, caerFrameEventGetPixelArrayUnsafe(outFrame), lengthX, lengthY, redX, redY, &maps);
+		}
+		else {
+			// Nothing to demosaic, keep as is.
+			caerFrameEventSetColorFilter(outFrame, caerFrameEventGetColorFilter(inFrame));
+			caerFrameEventSetLengthXLengthYChannelNumber(outFrame, lengthX, lengthY,
+				caerFrameEventGetChannelNumber(inFrame), state->fastFrame);
+
+			memcpy(caerFrameEventGetPixelArrayUnsafe(outFrame), caerFrameEventGetPixelArrayUnsafe(inFrame),
+				caerFrameEventGetPixelsSize(inFrame));
+
+			if (doWhiteBalance || doContrast) {
+				fastEnhanceFrame(outFrame, doWhiteBalance, doContrast);
+			}
+		}
+
+		caerFrameEventValidate(outFrame, state->fastFrame);
+	CAER_FRAME_ITERATOR_VALID_END
+
+	caerEventPacketHeaderSetEventNumber(&state->fastFrame->packetHeader, outIndex);
+
+	return (state->fastFrame);
 }
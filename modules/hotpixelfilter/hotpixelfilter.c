@@ -0,0 +1,385 @@
+#include "hotpixelfilter.h"
+#include "base/mainloop.h"
+#include "base/module.h"
+
+// Longest "x,y;" entry in the hot pixel list, with 16 bit coordinates.
+#define HOTPIXEL_ENTRY_MAX_LENGTH 12
+
+/**
+ * Per-pixel state is a single timestamp: events arriving before it are
+ * dropped. Accepted events push it forward by the refractory period, hot
+ * pixels have it set to INT64_MAX, so both checks are one load and one
+ * compare per event.
+ */
+struct HotPixelFilter_state {
+	int64_t *blockedUntil;
+	int16_t sizeX;
+	int16_t sizeY;
+	size_t *hotPixels;
+	size_t hotPixelsCount;
+	bool hotPixelsUpdate;
+	uint32_t *learnCounts;
+	bool learning;
+	int64_t learnStart;
+	int32_t learnTime;
+	int32_t learnRate;
+	sshsNodeAttrHandle refractoryPeriod;
+};
+
+typedef struct HotPixelFilter_state *HotPixelFilterState;
+
+static bool caerHotPixelFilterInit(caerModuleData moduleData);
+static void caerHotPixelFilterRun(caerModuleData moduleData, size_t argsNumber, va_list args);
+static void caerHotPixelFilterConfig(caerModuleData moduleData);
+static void caerHotPixelFilterExit(caerModuleData moduleData);
+static void caerHotPixelFilterReset(caerModuleData moduleData, uint16_t resetCallSourceID);
+static bool allocatePixelMaps(HotPixelFilterState state, int16_t sourceID);
+static void loadHotPixels(caerModuleData moduleData);
+static void learnHotPixels(caerModuleData moduleData, caerPolarityEventPacket polarity);
+static void storeHotPixels(caerModuleData moduleData, int64_t learnDuration);
+
+static struct caer_module_functions caerHotPixelFilterFunctions = { .moduleInit = &caerHotPixelFilterInit,
+	.moduleRun = &caerHotPixelFilterRun, .moduleConfig = &caerHotPixelFilterConfig, .moduleExit =
+		&caerHotPixelFilterExit, .moduleReset = &caerHotPixelFilterReset };
+
+void caerHotPixelFilter(uint16_t moduleID, caerPolarityEventPacket polarity) {
+	caerModuleData moduleData = caerMainloopFindModule(moduleID, "HotPixelFilter", CAER_MODULE_PROCESSOR);
+	if (moduleData == NULL) {
+		return;
+	}
+
+	caerModuleSM(&caerHotPixelFilterFunctions, moduleData, sizeof(struct HotPixelFilter_state), 1, polarity);
+}
+
+static bool caerHotPixelFilterInit(caerModuleData moduleData) {
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "refractoryPeriod", 1000); // in µs
+	sshsNodePutBoolIfAbsent(moduleData->moduleNode, "learnHotPixels", false);
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "learnTime", 2000000); // in µs
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "learnRate", 200); // in Hz
+	sshsNodePutStringIfAbsent(moduleData->moduleNode, "hotPixels", ""); // "x,y;x,y;..."
+
+	HotPixelFilterState state = moduleData->moduleState;
+
+	// Resolve configuration once, values are then read lock-free on each run.
+	state->refractoryPeriod = sshsNodeGetAttributeHandle(moduleData->moduleNode, "refractoryPeriod", SSHS_INT);
+
+	// Hot pixel list is applied once the pixel maps exist.
+	state->hotPixelsUpdate = true;
+
+	// Never start up learning, that's an explicit user action.
+	sshsNodePutBool(moduleData->moduleNode, "learnHotPixels", false);
+
+	// Add config listeners last, to avoid having them dangling if Init doesn't succeed.
+	sshsNodeAddAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+
+	// Nothing that can fail here.
+	return (true);
+}
+
+static void caerHotPixelFilterRun(caerModuleData moduleData, size_t argsNumber, va_list args) {
+	UNUSED_ARGUMENT(argsNumber);
+
+	// Interpret variable arguments (same as above in main function).
+	caerPolarityEventPacket polarity = va_arg(args, caerPolarityEventPacket);
+
+	// Only process packets with content.
+	if (polarity == NULL) {
+		return;
+	}
+
+	HotPixelFilterState state = moduleData->moduleState;
+
+	// If the maps are not allocated yet, do it.
+	if (state->blockedUntil == NULL) {
+		if (!allocatePixelMaps(state, caerEventPacketHeaderGetEventSource(&polarity->packetHeader))) {
+			// Failed to allocate memory, nothing to do.
+			caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate memory for pixel maps.");
+			return;
+		}
+	}
+
+	if (state->hotPixelsUpdate) {
+		loadHotPixels(moduleData);
+	}
+
+	// Learning looks at the unfiltered input, hot pixels included.
+	if (state->learning) {
+		learnHotPixels(moduleData, polarity);
+	}
+
+	int64_t refractoryPeriod = sshsNodeAttrHandleGetInt(state->refractoryPeriod);
+	if (refractoryPeriod < 0) {
+		refractoryPeriod = 0;
+	}
+
+	int64_t *blockedUntil = state->blockedUntil;
+	int16_t sizeX = state->sizeX;
+
+	CAER_POLARITY_ITERATOR_VALID_START(polarity)
+		size_t idx = ((size_t) caerPolarityEventGetY(caerPolarityIteratorElement) * (size_t) sizeX)
+			+ caerPolarityEventGetX(caerPolarityIteratorElement);
+		int64_t ts = caerPolarityEventGetTimestamp64(caerPolarityIteratorElement, polarity);
+
+		int64_t blocked = blockedUntil[idx];
+		bool pass = (ts >= blocked);
+
+		// Only accepted events start a new refractory period.
+		blockedUntil[idx] = (pass) ? (ts + refractoryPeriod) : (blocked);
+
+		if (!pass) {
+			caerPolarityEventInvalidate(caerPolarityIteratorElement, polarity);
+		}
+	CAER_POLARITY_ITERATOR_VALID_END
+}
+
+static void caerHotPixelFilterConfig(caerModuleData moduleData) {
+	caerModuleConfigUpdateReset(moduleData);
+
+	HotPixelFilterState state = moduleData->moduleState;
+
+	// The list might have been edited by hand, re-apply it.
+	state->hotPixelsUpdate = true;
+
+	bool learn = sshsNodeGetBool(moduleData->moduleNode, "learnHotPixels");
+
+	if (learn && !state->learning) {
+		state->learnTime = sshsNodeGetInt(moduleData->moduleNode, "learnTime");
+		state->learnRate = sshsNodeGetInt(moduleData->moduleNode, "learnRate");
+		state->learnStart = -1;
+		state->learning = true;
+
+		caerLog(CAER_LOG_INFO, moduleData->moduleSubSystemString, "Learning hot pixels for %" PRIi32 " us.",
+			state->learnTime);
+	}
+	else if (!learn && state->learning) {
+		// Aborted by user, keep the current list.
+		state->learning = false;
+
+		free(state->learnCounts);
+		state->learnCounts = NULL;
+	}
+}
+
+static void caerHotPixelFilterExit(caerModuleData moduleData) {
+	// Remove listener, which can reference invalid memory in userData.
+	sshsNodeRemoveAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+
+	HotPixelFilterState state = moduleData->moduleState;
+
+	// Ensure maps are freed.
+	free(state->blockedUntil);
+	state->blockedUntil = NULL;
+
+	free(state->hotPixels);
+	state->hotPixels = NULL;
+	state->hotPixelsCount = 0;
+
+	free(state->learnCounts);
+	state->learnCounts = NULL;
+	state->learning = false;
+}
+
+static void caerHotPixelFilterReset(caerModuleData moduleData, uint16_t resetCallSourceID) {
+	UNUSED_ARGUMENT(resetCallSourceID);
+
+	HotPixelFilterState state = moduleData->moduleState;
+
+	if (state->blockedUntil == NULL) {
+		return;
+	}
+
+	// Time restarts, so do refractory periods. Hot pixels stay hot.
+	memset(state->blockedUntil, 0, (size_t) state->sizeX * (size_t) state->sizeY * sizeof(int64_t));
+
+	for (size_t i = 0; i < state->hotPixelsCount; i++) {
+		state->blockedUntil[state->hotPixels[i]] = INT64_MAX;
+	}
+
+	// A learning window can't span a time reset, start it over.
+	state->learnStart = -1;
+
+	if (state->learnCounts != NULL) {
+		memset(state->learnCounts, 0, (size_t) state->sizeX * (size_t) state->sizeY * sizeof(uint32_t));
+	}
+}
+
+static bool allocatePixelMaps(HotPixelFilterState state, int16_t sourceID) {
+	// Get size information from source.
+	sshsNode sourceInfoNode = caerMainloopGetSourceInfo(U16T(sourceID));
+	if (sourceInfoNode == NULL) {
+		// This should never happen, but we handle it gracefully.
+		caerLog(CAER_LOG_ERROR, __func__, "Failed to get source info to allocate pixel maps.");
+		return (false);
+	}
+
+	state->sizeX = sshsNodeGetShort(sourceInfoNode, "dvsSizeX");
+	state->sizeY = sshsNodeGetShort(sourceInfoNode, "dvsSizeY");
+
+	state->blockedUntil = calloc((size_t) state->sizeX * (size_t) state->sizeY, sizeof(int64_t));
+	if (state->blockedUntil == NULL) {
+		return (false);
+	}
+
+	return (true);
+}
+
+/**
+ * Parse the 'hotPixels' attribute and apply it to the pixel map, replacing
+ * the previous list. Invalid or out of range entries are skipped.
+ */
+static void loadHotPixels(caerModuleData moduleData) {
+	HotPixelFilterState state = moduleData->moduleState;
+
+	state->hotPixelsUpdate = false;
+
+	// Un-block the old hot pixels.
+	for (size_t i = 0; i < state->hotPixelsCount; i++) {
+		state->blockedUntil[state->hotPixels[i]] = 0;
+	}
+
+	state->hotPixelsCount = 0;
+
+	char *hotPixelsString = sshsNodeGetString(moduleData->moduleNode, "hotPixels");
+
+	// Each entry has at least three characters, that bounds the list size.
+	size_t maxEntries = (strlen(hotPixelsString) / 3) + 1;
+
+	size_t *newHotPixels = realloc(state->hotPixels, maxEntries * sizeof(size_t));
+	if (newHotPixels == NULL) {
+		free(hotPixelsString);
+
+		caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate memory for hot pixel list.");
+		return;
+	}
+
+	state->hotPixels = newHotPixels;
+
+	const char *entry = hotPixelsString;
+
+	while (*entry != '\0') {
+		char *end;
+
+		long x = strtol(entry, &end, 10);
+		if (end == entry || *end != ',') {
+			break;
+		}
+
+		entry = end + 1;
+
+		long y = strtol(entry, &end, 10);
+		if (end == entry) {
+			break;
+		}
+
+		if (x >= 0 && x < state->sizeX && y >= 0 && y < state->sizeY) {
+			size_t idx = ((size_t) y * (size_t) state->sizeX) + (size_t) x;
+
+			state->hotPixels[state->hotPixelsCount++] = idx;
+			state->blockedUntil[idx] = INT64_MAX;
+		}
+		else {
+			caerLog(CAER_LOG_WARNING, moduleData->moduleSubSystemString, "Ignoring out of range hot pixel %ld,%ld.",
+				x, y);
+		}
+
+		entry = (*end == ';') ? (end + 1) : (end);
+	}
+
+	if (*entry != '\0') {
+		caerLog(CAER_LOG_WARNING, moduleData->moduleSubSystemString,
+			"Malformed hot pixel list, ignoring everything from '%s' on.", entry);
+	}
+
+	free(hotPixelsString);
+
+	caerLog(CAER_LOG_DEBUG, moduleData->moduleSubSystemString, "Applied %zu hot pixels.", state->hotPixelsCount);
+}
+
+static void learnHotPixels(caerModuleData moduleData, caerPolarityEventPacket polarity) {
+	HotPixelFilterState state = moduleData->moduleState;
+
+	if (state->learnCounts == NULL) {
+		state->learnCounts = calloc((size_t) state->sizeX * (size_t) state->sizeY, sizeof(uint32_t));
+		if (state->learnCounts == NULL) {
+			caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString,
+				"Failed to allocate memory for hot pixel learning.");
+			return;
+		}
+	}
+
+	uint32_t *learnCounts = state->learnCounts;
+	int16_t sizeX = state->sizeX;
+	int64_t learnEnd = (state->learnStart < 0) ? (INT64_MAX) : (state->learnStart + state->learnTime);
+	int64_t lastTS = -1;
+
+	CAER_POLARITY_ITERATOR_VALID_START(polarity)
+		lastTS = caerPolarityEventGetTimestamp64(caerPolarityIteratorElement, polarity);
+
+		if (state->learnStart < 0) {
+			state->learnStart = lastTS;
+			learnEnd = lastTS + state->learnTime;
+		}
+
+		if (lastTS >= learnEnd) {
+			break;
+		}
+
+		learnCounts[((size_t) caerPolarityEventGetY(caerPolarityIteratorElement) * (size_t) sizeX)
+			+ caerPolarityEventGetX(caerPolarityIteratorElement)]++;
+	CAER_POLARITY_ITERATOR_VALID_END
+
+	if (lastTS >= learnEnd) {
+		storeHotPixels(moduleData, lastTS - state->learnStart);
+
+		free(state->learnCounts);
+		state->learnCounts = NULL;
+		state->learning = false;
+
+		sshsNodePutBool(moduleData->moduleNode, "learnHotPixels", false);
+	}
+}
+
+/**
+ * Turn the learned event counts into the 'hotPixels' attribute, so the
+ * list is saved with the rest of the configuration, and apply it.
+ */
+static void storeHotPixels(caerModuleData moduleData, int64_t learnDuration) {
+	HotPixelFilterState state = moduleData->moduleState;
+
+	size_t pixels = (size_t) state->sizeX * (size_t) state->sizeY;
+
+	// Rate threshold converted to events over the learning window.
+	uint64_t threshold = (U64T(state->learnRate) * U64T(learnDuration)) / 1000000;
+
+	size_t hotCount = 0;
+
+	for (size_t i = 0; i < pixels; i++) {
+		hotCount += (state->learnCounts[i] > threshold);
+	}
+
+	char *hotPixelsString = malloc((hotCount * HOTPIXEL_ENTRY_MAX_LENGTH) + 1);
+	if (hotPixelsString == NULL) {
+		caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate memory for hot pixel list.");
+		return;
+	}
+
+	size_t length = 0;
+	hotPixelsString[0] = '\0';
+
+	for (size_t i = 0; i < pixels; i++) {
+		if (state->learnCounts[i] > threshold) {
+			length += (size_t) snprintf(hotPixelsString + length, HOTPIXEL_ENTRY_MAX_LENGTH + 1, "%zu,%zu;",
+				i % (size_t) state->sizeX, i / (size_t) state->sizeX);
+		}
+	}
+
+	sshsNodePutString(moduleData->moduleNode, "hotPixels", hotPixelsString);
+
+	free(hotPixelsString);
+
+	caerLog(CAER_LOG_INFO, moduleData->moduleSubSystemString,
+		"Learned %zu hot pixels (above %" PRIi32 " Hz over %" PRIi64 " us).", hotCount, state->learnRate,
+		learnDuration);
+
+	loadHotPixels(moduleData);
+}
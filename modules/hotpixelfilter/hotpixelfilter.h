@@ -0,0 +1,10 @@
+#ifndef HOTPIXELFILTER_H_
+#define HOTPIXELFILTER_H_
+
+#include "main.h"
+
+#include <libcaer/events/polarity.h>
+
+void caerHotPixelFilter(uint16_t moduleID, caerPolarityEventPacket polarity);
+
+#endif /* HOTPIXELFILTER_H_ */
@@ -43,6 +43,7 @@ static void createShiftedSourceBiasSetting(sshsNode biasNode, const char *biasNa
 	const char *operatingMode, const char *voltageLevel);
 static uint16_t generateShiftedSourceBiasParent(sshsNode biasNode, const char *biasName);
 static uint16_t generateShiftedSourceBias(sshsNode biasNode);
+static bool davisConfigSet(void *device, int8_t modAddr, uint8_t paramAddr, uint32_t param);
 
 static inline const char *chipIDToName(int16_t chipID, bool withEndSlash) {
 	switch (chipID) {
@@ -176,6 +177,16 @@ bool caerInputDAVISInit(caerModuleData moduleData, uint16_t deviceType) {
 
 	caerModuleSetSubSystemString(moduleData, subSystemString);
 
+	// Bias and chip configuration changes are coalesced before going out over USB.
+	if (!caerDeviceConfigQueueInit(&state->configQueue, state->deviceState, &davisConfigSet, -1, 0,
+		moduleData->moduleSubSystemString)) {
+		caerDeviceClose((caerDeviceHandle *) &state->deviceState);
+
+		return (false);
+	}
+
+	caerDeviceConfigQueueAttachConfig(&state->configQueue, moduleData->moduleNode);
+
 	// Ensure good defaults for data acquisition settings.
 	// No blocking behavior due to mainloop notification, and no auto-start of
 	// all producers to ensure cAER settings are respected.
@@ -196,6 +207,9 @@ bool caerInputDAVISInit(caerModuleData moduleData, uint16_t deviceType) {
 
 	if (!ret) {
 		// Failed to start data acquisition, close device and exit.
+		caerDeviceConfigQueueDetachConfig(&state->configQueue, moduleData->moduleNode);
+		caerDeviceConfigQueueDestroy(&state->configQueue);
+
 		caerDeviceClose((caerDeviceHandle *) &moduleData->moduleState);
 
 		return (false);
@@ -292,6 +306,11 @@ void caerInputDAVISExit(caerModuleData moduleData) {
 		free(biasNodes);
 	}
 
+	// Send out any change still waiting for its debounce window.
+	caerDeviceConfigQueueDetachConfig(&state->configQueue, moduleData->moduleNode);
+	caerDeviceConfigQueueFlush(&state->configQueue, true);
+	caerDeviceConfigQueueDestroy(&state->configQueue);
+
 	caerDeviceDataStop((caerDeviceHandle) state->deviceState);
 
 	caerDeviceClose((caerDeviceHandle *) &state->deviceState);
@@ -710,6 +729,7 @@ static void sendDefaultConfiguration(caerModuleData moduleData, struct caer_davi
 	// Send cAER configuration to libcaer and device.
 	biasConfigSend(sshsGetRelativeNode(deviceConfigNode, "bias/"), moduleData, devInfo);
 	chipConfigSend(sshsGetRelativeNode(deviceConfigNode, "chip/"), moduleData, devInfo);
+	caerDeviceConfigQueueFlush(&((caerInputDAVISState) moduleData->moduleState)->configQueue, true);
 	systemConfigSend(sshsGetRelativeNode(moduleData->moduleNode, "system/"), moduleData);
 	usbConfigSend(sshsGetRelativeNode(deviceConfigNode, "usb/"), moduleData);
 	muxConfigSend(sshsGetRelativeNode(deviceConfigNode, "multiplexer/"), moduleData);
@@ -719,6 +739,10 @@ static void sendDefaultConfiguration(caerModuleData moduleData, struct caer_davi
 	extInputConfigSend(sshsGetRelativeNode(deviceConfigNode, "externalInput/"), moduleData, devInfo);
 }
 
+static bool davisConfigSet(void *device, int8_t modAddr, uint8_t paramAddr, uint32_t param) {
+	return (caerDeviceConfigSet(device, modAddr, paramAddr, param));
+}
+
 static void mainloopDataNotifyIncrease(void *p) {
 	caerMainloopData mainloopData = p;
 
@@ -744,203 +768,203 @@ static void biasConfigSend(sshsNode node, caerModuleData moduleData, struct caer
 	caerInputDAVISState state = (caerInputDAVISState) moduleData->moduleState;
 	// All chips of a kind have the same bias address for the same bias!
 	if (IS_DAVIS240(devInfo->chipID)) {
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_DIFFBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_DIFFBN,
 			generateCoarseFineBiasParent(node, "DiffBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_ONBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_ONBN,
 			generateCoarseFineBiasParent(node, "OnBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_OFFBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_OFFBN,
 			generateCoarseFineBiasParent(node, "OffBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSCASEPC,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSCASEPC,
 			generateCoarseFineBiasParent(node, "ApsCasEpc"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_DIFFCASBNC,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_DIFFCASBNC,
 			generateCoarseFineBiasParent(node, "DiffCasBnc"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSROSFBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSROSFBN,
 			generateCoarseFineBiasParent(node, "ApsROSFBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_LOCALBUFBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_LOCALBUFBN,
 			generateCoarseFineBiasParent(node, "LocalBufBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PIXINVBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PIXINVBN,
 			generateCoarseFineBiasParent(node, "PixInvBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PRBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PRBP,
 			generateCoarseFineBiasParent(node, "PrBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PRSFBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PRSFBP,
 			generateCoarseFineBiasParent(node, "PrSFBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_REFRBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_REFRBP,
 			generateCoarseFineBiasParent(node, "RefrBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPDBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPDBN,
 			generateCoarseFineBiasParent(node, "AEPdBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_LCOLTIMEOUTBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_LCOLTIMEOUTBN,
 			generateCoarseFineBiasParent(node, "LcolTimeoutBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPUXBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPUXBP,
 			generateCoarseFineBiasParent(node, "AEPuXBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPUYBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPUYBP,
 			generateCoarseFineBiasParent(node, "AEPuYBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_IFTHRBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_IFTHRBN,
 			generateCoarseFineBiasParent(node, "IFThrBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_IFREFRBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_IFREFRBN,
 			generateCoarseFineBiasParent(node, "IFRefrBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PADFOLLBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PADFOLLBN,
 			generateCoarseFineBiasParent(node, "PadFollBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSOVERFLOWLEVELBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSOVERFLOWLEVELBN,
 			generateCoarseFineBiasParent(node, "ApsOverflowLevelBn"));
 
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_BIASBUFFER,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_BIASBUFFER,
 			generateCoarseFineBiasParent(node, "BiasBuffer"));
 
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_SSP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_SSP,
 			generateShiftedSourceBiasParent(node, "SSP"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_SSN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_SSN,
 			generateShiftedSourceBiasParent(node, "SSN"));
 	}
 
 	if (IS_DAVIS128(devInfo->chipID) || IS_DAVIS208(devInfo->chipID) || IS_DAVIS346(devInfo->chipID)
 	|| IS_DAVIS640(devInfo->chipID)) {
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSOVERFLOWLEVEL,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSOVERFLOWLEVEL,
 			generateVDACBiasParent(node, "ApsOverflowLevel"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSCAS,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSCAS,
 			generateVDACBiasParent(node, "ApsCas"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCREFHIGH,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCREFHIGH,
 			generateVDACBiasParent(node, "AdcRefHigh"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCREFLOW,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCREFLOW,
 			generateVDACBiasParent(node, "AdcRefLow"));
 
 		if (IS_DAVIS346(devInfo->chipID) || IS_DAVIS640(devInfo->chipID)) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS346_CONFIG_BIAS_ADCTESTVOLTAGE,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS346_CONFIG_BIAS_ADCTESTVOLTAGE,
 				generateVDACBiasParent(node, "AdcTestVoltage"));
 		}
 
 		if (IS_DAVIS208(devInfo->chipID)) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_RESETHIGHPASS,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_RESETHIGHPASS,
 				generateVDACBiasParent(node, "ResetHighPass"));
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REFSS,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REFSS,
 				generateVDACBiasParent(node, "RefSS"));
 
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REGBIASBP,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REGBIASBP,
 				generateCoarseFineBiasParent(node, "RegBiasBp"));
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REFSSBN,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REFSSBN,
 				generateCoarseFineBiasParent(node, "RefSSBn"));
 		}
 
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_LOCALBUFBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_LOCALBUFBN,
 			generateCoarseFineBiasParent(node, "LocalBufBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PADFOLLBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PADFOLLBN,
 			generateCoarseFineBiasParent(node, "PadFollBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_DIFFBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_DIFFBN,
 			generateCoarseFineBiasParent(node, "DiffBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ONBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ONBN,
 			generateCoarseFineBiasParent(node, "OnBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_OFFBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_OFFBN,
 			generateCoarseFineBiasParent(node, "OffBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PIXINVBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PIXINVBN,
 			generateCoarseFineBiasParent(node, "PixInvBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PRBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PRBP,
 			generateCoarseFineBiasParent(node, "PrBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PRSFBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PRSFBP,
 			generateCoarseFineBiasParent(node, "PrSFBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_REFRBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_REFRBP,
 			generateCoarseFineBiasParent(node, "RefrBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_READOUTBUFBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_READOUTBUFBP,
 			generateCoarseFineBiasParent(node, "ReadoutBufBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSROSFBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSROSFBN,
 			generateCoarseFineBiasParent(node, "ApsROSFBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCCOMPBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCCOMPBP,
 			generateCoarseFineBiasParent(node, "AdcCompBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_COLSELLOWBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_COLSELLOWBN,
 			generateCoarseFineBiasParent(node, "ColSelLowBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_DACBUFBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_DACBUFBP,
 			generateCoarseFineBiasParent(node, "DACBufBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_LCOLTIMEOUTBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_LCOLTIMEOUTBN,
 			generateCoarseFineBiasParent(node, "LcolTimeoutBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPDBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPDBN,
 			generateCoarseFineBiasParent(node, "AEPdBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPUXBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPUXBP,
 			generateCoarseFineBiasParent(node, "AEPuXBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPUYBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPUYBP,
 			generateCoarseFineBiasParent(node, "AEPuYBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_IFREFRBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_IFREFRBN,
 			generateCoarseFineBiasParent(node, "IFRefrBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_IFTHRBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_IFTHRBN,
 			generateCoarseFineBiasParent(node, "IFThrBn"));
 
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_BIASBUFFER,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_BIASBUFFER,
 			generateCoarseFineBiasParent(node, "BiasBuffer"));
 
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_SSP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_SSP,
 			generateShiftedSourceBiasParent(node, "SSP"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_SSN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_SSN,
 			generateShiftedSourceBiasParent(node, "SSN"));
 	}
 
 	if (IS_DAVISRGB(devInfo->chipID)) {
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_APSCAS,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_APSCAS,
 			generateVDACBiasParent(node, "ApsCas"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_OVG1LO,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_OVG1LO,
 			generateVDACBiasParent(node, "OVG1Lo"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_OVG2LO,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_OVG2LO,
 			generateVDACBiasParent(node, "OVG2Lo"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_TX2OVG2HI,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_TX2OVG2HI,
 			generateVDACBiasParent(node, "TX2OVG2Hi"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_GND07,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_GND07,
 			generateVDACBiasParent(node, "Gnd07"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCTESTVOLTAGE,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCTESTVOLTAGE,
 			generateVDACBiasParent(node, "AdcTestVoltage"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCREFHIGH,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCREFHIGH,
 			generateVDACBiasParent(node, "AdcRefHigh"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCREFLOW,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCREFLOW,
 			generateVDACBiasParent(node, "AdcRefLow"));
 
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_IFREFRBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_IFREFRBN,
 			generateCoarseFineBiasParent(node, "IFRefrBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_IFTHRBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_IFTHRBN,
 			generateCoarseFineBiasParent(node, "IFThrBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_LOCALBUFBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_LOCALBUFBN,
 			generateCoarseFineBiasParent(node, "LocalBufBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PADFOLLBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PADFOLLBN,
 			generateCoarseFineBiasParent(node, "PadFollBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PIXINVBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PIXINVBN,
 			generateCoarseFineBiasParent(node, "PixInvBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_DIFFBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_DIFFBN,
 			generateCoarseFineBiasParent(node, "DiffBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ONBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ONBN,
 			generateCoarseFineBiasParent(node, "OnBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_OFFBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_OFFBN,
 			generateCoarseFineBiasParent(node, "OffBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PRBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PRBP,
 			generateCoarseFineBiasParent(node, "PrBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PRSFBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PRSFBP,
 			generateCoarseFineBiasParent(node, "PrSFBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_REFRBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_REFRBP,
 			generateCoarseFineBiasParent(node, "RefrBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ARRAYBIASBUFFERBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ARRAYBIASBUFFERBN,
 			generateCoarseFineBiasParent(node, "ArrayBiasBufferBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ARRAYLOGICBUFFERBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ARRAYLOGICBUFFERBN,
 			generateCoarseFineBiasParent(node, "ArrayLogicBufferBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_FALLTIMEBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_FALLTIMEBN,
 			generateCoarseFineBiasParent(node, "FalltimeBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_RISETIMEBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_RISETIMEBP,
 			generateCoarseFineBiasParent(node, "RisetimeBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_READOUTBUFBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_READOUTBUFBP,
 			generateCoarseFineBiasParent(node, "ReadoutBufBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_APSROSFBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_APSROSFBN,
 			generateCoarseFineBiasParent(node, "ApsROSFBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCCOMPBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCCOMPBP,
 			generateCoarseFineBiasParent(node, "AdcCompBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_DACBUFBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_DACBUFBP,
 			generateCoarseFineBiasParent(node, "DACBufBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_LCOLTIMEOUTBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_LCOLTIMEOUTBN,
 			generateCoarseFineBiasParent(node, "LcolTimeoutBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_AEPDBN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_AEPDBN,
 			generateCoarseFineBiasParent(node, "AEPdBn"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_AEPUXBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_AEPUXBP,
 			generateCoarseFineBiasParent(node, "AEPuXBp"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_AEPUYBP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_AEPUYBP,
 			generateCoarseFineBiasParent(node, "AEPuYBp"));
 
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_BIASBUFFER,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_BIASBUFFER,
 			generateCoarseFineBiasParent(node, "BiasBuffer"));
 
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_SSP,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_SSP,
 			generateShiftedSourceBiasParent(node, "SSP"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_SSN,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_SSN,
 			generateShiftedSourceBiasParent(node, "SSN"));
 	}
 }
@@ -962,91 +986,91 @@ static void biasConfigListener(sshsNode node, void *userData, enum sshs_node_att
 
 		if (IS_DAVIS240(devInfo.chipID)) {
 			if (caerStrEquals(nodeName, "DiffBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_DIFFBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_DIFFBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "OnBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_ONBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_ONBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "OffBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_OFFBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_OFFBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "ApsCasEpc")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSCASEPC,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSCASEPC,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "DiffCasBnc")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_DIFFCASBNC,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_DIFFCASBNC,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "ApsROSFBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSROSFBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSROSFBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "LocalBufBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_LOCALBUFBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_LOCALBUFBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "PixInvBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PIXINVBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PIXINVBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "PrBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PRBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PRBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "PrSFBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PRSFBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PRSFBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "RefrBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_REFRBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_REFRBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AEPdBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPDBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPDBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "LcolTimeoutBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_LCOLTIMEOUTBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_LCOLTIMEOUTBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AEPuXBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPUXBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPUXBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AEPuYBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPUYBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_AEPUYBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "IFThrBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_IFTHRBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_IFTHRBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "IFRefrBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_IFREFRBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_IFREFRBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "PadFollBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PADFOLLBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_PADFOLLBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "ApsOverflowLevelBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSOVERFLOWLEVELBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_APSOVERFLOWLEVELBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "BiasBuffer")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_BIASBUFFER,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_BIASBUFFER,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "SSP")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_SSP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_SSP,
 					generateShiftedSourceBias(node));
 			}
 			else if (caerStrEquals(nodeName, "SSP")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_SSN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS240_CONFIG_BIAS_SSN,
 					generateShiftedSourceBias(node));
 			}
 		}
@@ -1054,271 +1078,271 @@ static void biasConfigListener(sshsNode node, void *userData, enum sshs_node_att
 		if (IS_DAVIS128(devInfo.chipID) || IS_DAVIS208(devInfo.chipID) || IS_DAVIS346(devInfo.chipID)
 		|| IS_DAVIS640(devInfo.chipID)) {
 			if (caerStrEquals(nodeName, "ApsOverflowLevel")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSOVERFLOWLEVEL,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSOVERFLOWLEVEL,
 					generateVDACBias(node));
 			}
 			else if (caerStrEquals(nodeName, "ApsCas")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSCAS,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSCAS,
 					generateVDACBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AdcRefHigh")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCREFHIGH,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCREFHIGH,
 					generateVDACBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AdcRefLow")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCREFLOW,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCREFLOW,
 					generateVDACBias(node));
 			}
 			else if ((IS_DAVIS346(devInfo.chipID) || IS_DAVIS640(devInfo.chipID))
 				&& caerStrEquals(nodeName, "AdcTestVoltage")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS346_CONFIG_BIAS_ADCTESTVOLTAGE,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS346_CONFIG_BIAS_ADCTESTVOLTAGE,
 					generateVDACBias(node));
 			}
 			else if ((IS_DAVIS208(devInfo.chipID)) && caerStrEquals(nodeName, "ResetHighPass")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_RESETHIGHPASS,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_RESETHIGHPASS,
 					generateVDACBias(node));
 			}
 			else if ((IS_DAVIS208(devInfo.chipID)) && caerStrEquals(nodeName, "RefSS")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REFSS,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REFSS,
 					generateVDACBias(node));
 			}
 			else if ((IS_DAVIS208(devInfo.chipID)) && caerStrEquals(nodeName, "RegBiasBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REGBIASBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REGBIASBP,
 					generateCoarseFineBias(node));
 			}
 			else if ((IS_DAVIS208(devInfo.chipID)) && caerStrEquals(nodeName, "RefSSBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REFSSBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS208_CONFIG_BIAS_REFSSBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "LocalBufBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_LOCALBUFBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_LOCALBUFBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "PadFollBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PADFOLLBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PADFOLLBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "DiffBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_DIFFBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_DIFFBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "OnBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ONBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ONBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "OffBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_OFFBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_OFFBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "PixInvBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PIXINVBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PIXINVBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "PrBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PRBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PRBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "PrSFBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PRSFBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_PRSFBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "RefrBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_REFRBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_REFRBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "ReadoutBufBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_READOUTBUFBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_READOUTBUFBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "ApsROSFBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSROSFBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_APSROSFBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AdcCompBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCCOMPBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_ADCCOMPBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "ColSelLowBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_COLSELLOWBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_COLSELLOWBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "DACBufBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_DACBUFBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_DACBUFBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "LcolTimeoutBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_LCOLTIMEOUTBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_LCOLTIMEOUTBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AEPdBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPDBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPDBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AEPuXBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPUXBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPUXBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AEPuYBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPUYBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_AEPUYBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "IFRefrBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_IFREFRBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_IFREFRBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "IFThrBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_IFTHRBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_IFTHRBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "BiasBuffer")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_BIASBUFFER,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_BIASBUFFER,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "SSP")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_SSP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_SSP,
 					generateShiftedSourceBias(node));
 			}
 			else if (caerStrEquals(nodeName, "SSN")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_SSN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVIS128_CONFIG_BIAS_SSN,
 					generateShiftedSourceBias(node));
 			}
 		}
 
 		if (IS_DAVISRGB(devInfo.chipID)) {
 			if (caerStrEquals(nodeName, "ApsCas")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_APSCAS,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_APSCAS,
 					generateVDACBias(node));
 			}
 			else if (caerStrEquals(nodeName, "OVG1Lo")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_OVG1LO,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_OVG1LO,
 					generateVDACBias(node));
 			}
 			else if (caerStrEquals(nodeName, "OVG2Lo")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_OVG2LO,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_OVG2LO,
 					generateVDACBias(node));
 			}
 			else if (caerStrEquals(nodeName, "TX2OVG2Hi")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_TX2OVG2HI,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_TX2OVG2HI,
 					generateVDACBias(node));
 			}
 			else if (caerStrEquals(nodeName, "Gnd07")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_GND07,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_GND07,
 					generateVDACBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AdcTestVoltage")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCTESTVOLTAGE,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCTESTVOLTAGE,
 					generateVDACBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AdcRefHigh")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCREFHIGH,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCREFHIGH,
 					generateVDACBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AdcRefLow")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCREFLOW,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCREFLOW,
 					generateVDACBias(node));
 			}
 			else if (caerStrEquals(nodeName, "IFRefrBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_IFREFRBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_IFREFRBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "IFThrBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_IFTHRBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_IFTHRBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "LocalBufBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_LOCALBUFBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_LOCALBUFBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "PadFollBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PADFOLLBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PADFOLLBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "PixInvBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PIXINVBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PIXINVBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "DiffBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_DIFFBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_DIFFBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "OnBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ONBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ONBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "OffBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_OFFBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_OFFBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "PrBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PRBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PRBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "PrSFBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PRSFBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_PRSFBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "RefrBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_REFRBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_REFRBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "ArrayBiasBufferBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ARRAYBIASBUFFERBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ARRAYBIASBUFFERBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "ArrayLogicBufferBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ARRAYLOGICBUFFERBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ARRAYLOGICBUFFERBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "FalltimeBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_FALLTIMEBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_FALLTIMEBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "RisetimeBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_RISETIMEBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_RISETIMEBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "ReadoutBufBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_READOUTBUFBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_READOUTBUFBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "ApsROSFBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_APSROSFBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_APSROSFBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AdcCompBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCCOMPBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_ADCCOMPBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "DACBufBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_DACBUFBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_DACBUFBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "LcolTimeoutBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_LCOLTIMEOUTBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_LCOLTIMEOUTBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AEPdBn")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_AEPDBN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_AEPDBN,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AEPuXBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_AEPUXBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_AEPUXBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "AEPuYBp")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_AEPUYBP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_AEPUYBP,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "BiasBuffer")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_BIASBUFFER,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_BIASBUFFER,
 					generateCoarseFineBias(node));
 			}
 			else if (caerStrEquals(nodeName, "SSP")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_SSP,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_SSP,
 					generateShiftedSourceBias(node));
 			}
 			else if (caerStrEquals(nodeName, "SSN")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_SSN,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_BIAS, DAVISRGB_CONFIG_BIAS_SSN,
 					generateShiftedSourceBias(node));
 			}
 		}
@@ -1328,69 +1352,69 @@ static void biasConfigListener(sshsNode node, void *userData, enum sshs_node_att
 static void chipConfigSend(sshsNode node, caerModuleData moduleData, struct caer_davis_info *devInfo) {
 	caerInputDAVISState state = (caerInputDAVISState) moduleData->moduleState;
 	// All chips have the same parameter address for the same setting!
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX0,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX0,
 		U32T(sshsNodeGetByte(node, "DigitalMux0")));
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX1,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX1,
 		U32T(sshsNodeGetByte(node, "DigitalMux1")));
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX2,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX2,
 		U32T(sshsNodeGetByte(node, "DigitalMux2")));
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX3,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX3,
 		U32T(sshsNodeGetByte(node, "DigitalMux3")));
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX0,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX0,
 		U32T(sshsNodeGetByte(node, "AnalogMux0")));
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX1,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX1,
 		U32T(sshsNodeGetByte(node, "AnalogMux1")));
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX2,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX2,
 		U32T(sshsNodeGetByte(node, "AnalogMux2")));
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_BIASMUX0,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_BIASMUX0,
 		U32T(sshsNodeGetByte(node, "BiasMux0")));
 
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_RESETCALIBNEURON,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_RESETCALIBNEURON,
 		sshsNodeGetBool(node, "ResetCalibNeuron"));
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_TYPENCALIBNEURON,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_TYPENCALIBNEURON,
 		sshsNodeGetBool(node, "TypeNCalibNeuron"));
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_RESETTESTPIXEL,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_RESETTESTPIXEL,
 		sshsNodeGetBool(node, "ResetTestPixel"));
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_AERNAROW,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_AERNAROW,
 		sshsNodeGetBool(node, "AERnArow"));
-	caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_USEAOUT,
+	caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_USEAOUT,
 		sshsNodeGetBool(node, "UseAOut"));
 
 	if (IS_DAVIS240A(devInfo->chipID) || IS_DAVIS240B(devInfo->chipID)) {
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS240_CONFIG_CHIP_SPECIALPIXELCONTROL,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS240_CONFIG_CHIP_SPECIALPIXELCONTROL,
 			sshsNodeGetBool(node, "SpecialPixelControl"));
 	}
 
 	if (IS_DAVIS128(devInfo->chipID) || IS_DAVIS208(devInfo->chipID) || IS_DAVIS346(devInfo->chipID)
 	|| IS_DAVIS640(devInfo->chipID) || IS_DAVISRGB(devInfo->chipID)) {
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_SELECTGRAYCOUNTER,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_SELECTGRAYCOUNTER,
 			sshsNodeGetBool(node, "SelectGrayCounter"));
 	}
 
 	if (IS_DAVIS346(devInfo->chipID) || IS_DAVIS640(devInfo->chipID) || IS_DAVISRGB(devInfo->chipID)) {
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS346_CONFIG_CHIP_TESTADC,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS346_CONFIG_CHIP_TESTADC,
 			sshsNodeGetBool(node, "TestADC"));
 	}
 
 	if (IS_DAVIS208(devInfo->chipID)) {
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTPREAMPAVG,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTPREAMPAVG,
 			sshsNodeGetBool(node, "SelectPreAmpAvg"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTBIASREFSS,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTBIASREFSS,
 			sshsNodeGetBool(node, "SelectBiasRefSS"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTSENSE,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTSENSE,
 			sshsNodeGetBool(node, "SelectSense"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTPOSFB,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTPOSFB,
 			sshsNodeGetBool(node, "SelectPosFb"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTHIGHPASS,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTHIGHPASS,
 			sshsNodeGetBool(node, "SelectHighPass"));
 	}
 
 	if (IS_DAVISRGB(devInfo->chipID)) {
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVISRGB_CONFIG_CHIP_ADJUSTOVG1LO,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVISRGB_CONFIG_CHIP_ADJUSTOVG1LO,
 			sshsNodeGetBool(node, "AdjustOVG1Lo"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVISRGB_CONFIG_CHIP_ADJUSTOVG2LO,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVISRGB_CONFIG_CHIP_ADJUSTOVG2LO,
 			sshsNodeGetBool(node, "AdjustOVG2Lo"));
-		caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVISRGB_CONFIG_CHIP_ADJUSTTX2OVG2HI,
+		caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVISRGB_CONFIG_CHIP_ADJUSTTX2OVG2HI,
 			sshsNodeGetBool(node, "AdjustTX2OVG2Hi"));
 	}
 }
@@ -1406,108 +1430,108 @@ static void chipConfigListener(sshsNode node, void *userData, enum sshs_node_att
 
 	if (event == SSHS_ATTRIBUTE_MODIFIED) {
 		if (changeType == SSHS_BYTE && caerStrEquals(changeKey, "DigitalMux0")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX0,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX0,
 				U32T(changeValue.ibyte));
 		}
 		else if (changeType == SSHS_BYTE && caerStrEquals(changeKey, "DigitalMux1")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX1,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX1,
 				U32T(changeValue.ibyte));
 		}
 		else if (changeType == SSHS_BYTE && caerStrEquals(changeKey, "DigitalMux2")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX2,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX2,
 				U32T(changeValue.ibyte));
 		}
 		else if (changeType == SSHS_BYTE && caerStrEquals(changeKey, "DigitalMux3")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX3,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_DIGITALMUX3,
 				U32T(changeValue.ibyte));
 		}
 		else if (changeType == SSHS_BYTE && caerStrEquals(changeKey, "AnalogMux0")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX0,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX0,
 				U32T(changeValue.ibyte));
 		}
 		else if (changeType == SSHS_BYTE && caerStrEquals(changeKey, "AnalogMux1")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX1,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX1,
 				U32T(changeValue.ibyte));
 		}
 		else if (changeType == SSHS_BYTE && caerStrEquals(changeKey, "AnalogMux2")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX2,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_ANALOGMUX2,
 				U32T(changeValue.ibyte));
 		}
 		else if (changeType == SSHS_BYTE && caerStrEquals(changeKey, "BiasMux0")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_BIASMUX0,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_BIASMUX0,
 				U32T(changeValue.ibyte));
 		}
 		else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "ResetCalibNeuron")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_RESETCALIBNEURON,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_RESETCALIBNEURON,
 				changeValue.boolean);
 		}
 		else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "TypeNCalibNeuron")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_TYPENCALIBNEURON,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_TYPENCALIBNEURON,
 				changeValue.boolean);
 		}
 		else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "ResetTestPixel")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_RESETTESTPIXEL,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_RESETTESTPIXEL,
 				changeValue.boolean);
 		}
 		else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "AERnArow")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_AERNAROW,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_AERNAROW,
 				changeValue.boolean);
 		}
 		else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "UseAOut")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_USEAOUT,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_USEAOUT,
 				changeValue.boolean);
 		}
 		else if ((IS_DAVIS240A(devInfo.chipID) || IS_DAVIS240B(devInfo.chipID)) && changeType == SSHS_BOOL
 			&& caerStrEquals(changeKey, "SpecialPixelControl")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS240_CONFIG_CHIP_SPECIALPIXELCONTROL,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS240_CONFIG_CHIP_SPECIALPIXELCONTROL,
 				changeValue.boolean);
 		}
 		else if ((IS_DAVIS128(devInfo.chipID) || IS_DAVIS208(devInfo.chipID) || IS_DAVIS346(devInfo.chipID)
 			|| IS_DAVIS640(devInfo.chipID) || IS_DAVISRGB(devInfo.chipID)) && changeType == SSHS_BOOL
 			&& caerStrEquals(changeKey, "SelectGrayCounter")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_SELECTGRAYCOUNTER,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS128_CONFIG_CHIP_SELECTGRAYCOUNTER,
 				changeValue.boolean);
 		}
 		else if ((IS_DAVIS346(devInfo.chipID) || IS_DAVIS640(devInfo.chipID) || IS_DAVISRGB(devInfo.chipID))
 			&& changeType == SSHS_BOOL && caerStrEquals(changeKey, "TestADC")) {
-			caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS346_CONFIG_CHIP_TESTADC,
+			caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS346_CONFIG_CHIP_TESTADC,
 				changeValue.boolean);
 		}
 
 		if (IS_DAVIS208(devInfo.chipID)) {
 			if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "SelectPreAmpAvg")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTPREAMPAVG,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTPREAMPAVG,
 					changeValue.boolean);
 			}
 			else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "SelectBiasRefSS")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTBIASREFSS,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTBIASREFSS,
 					changeValue.boolean);
 			}
 			else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "SelectSense")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTSENSE,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTSENSE,
 					changeValue.boolean);
 			}
 			else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "SelectPosFb")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTPOSFB,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTPOSFB,
 					changeValue.boolean);
 			}
 			else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "SelectHighPass")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTHIGHPASS,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVIS208_CONFIG_CHIP_SELECTHIGHPASS,
 					changeValue.boolean);
 			}
 		}
 
 		if (IS_DAVISRGB(devInfo.chipID)) {
 			if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "AdjustOVG1Lo")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVISRGB_CONFIG_CHIP_ADJUSTOVG1LO,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVISRGB_CONFIG_CHIP_ADJUSTOVG1LO,
 					changeValue.boolean);
 			}
 			else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "AdjustOVG2Lo")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVISRGB_CONFIG_CHIP_ADJUSTOVG2LO,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVISRGB_CONFIG_CHIP_ADJUSTOVG2LO,
 					changeValue.boolean);
 			}
 			else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "AdjustTX2OVG2Hi")) {
-				caerDeviceConfigSet(state->deviceState, DAVIS_CONFIG_CHIP, DAVISRGB_CONFIG_CHIP_ADJUSTTX2OVG2HI,
+				caerDeviceConfigQueueSet(&state->configQueue, DAVIS_CONFIG_CHIP, DAVISRGB_CONFIG_CHIP_ADJUSTTX2OVG2HI,
 					changeValue.boolean);
 			}
 		}
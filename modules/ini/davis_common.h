@@ -4,12 +4,14 @@
 #include "main.h"
 #include "base/mainloop.h"
 #include "base/module.h"
+#include "device_config_queue.h"
 
 #include <libcaer/devices/davis.h>
 
 struct caer_input_davis_state {
 	caerDeviceHandle deviceState;
 	sshsNode eventSourceConfigNode;
+	struct caer_device_config_queue configQueue;
 };
 
 typedef struct caer_input_davis_state *caerInputDAVISState;
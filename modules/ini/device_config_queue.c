@@ -0,0 +1,429 @@
+#include "device_config_queue.h"
+#include "ext/portable_time.h"
+#include "ext/uthash/uthash.h"
+
+// Continuously changing registers still get sent after this many debounce windows.
+#define DEVICE_CONFIG_QUEUE_MAX_DELAY_FACTOR 4
+
+struct caer_device_config_queue_key {
+	int16_t select;
+	int8_t modAddr;
+	uint8_t paramAddr;
+	uint32_t key;
+};
+
+struct caer_device_config_queue_entry {
+	struct caer_device_config_queue_key key;
+	uint32_t value;
+	UT_hash_handle hh;
+};
+
+static int deviceConfigQueueFlusherThread(void *queuePtr);
+static uint64_t deviceConfigQueueElapsedUs(const struct timespec *since, const struct timespec *now);
+static uint64_t deviceConfigQueueDelayUs(caerDeviceConfigQueue queue, const struct timespec *now);
+static int deviceConfigQueueCompareSelect(struct caer_device_config_queue_entry *a,
+	struct caer_device_config_queue_entry *b);
+static void deviceConfigQueueFreeTable(struct caer_device_config_queue_entry **table);
+static void deviceConfigQueueConfigListener(sshsNode node, void *userData, enum sshs_node_attribute_events event,
+	const char *changeKey, enum sshs_node_attr_value_type changeType, union sshs_node_attr_value changeValue);
+
+bool caerDeviceConfigQueueInit(caerDeviceConfigQueue queue, void *device, caerDeviceConfigSetter configSet,
+	int8_t selectModAddr, uint8_t selectParamAddr, const char *logSubSystem) {
+	queue->device = device;
+	queue->configSet = configSet;
+	queue->selectModAddr = selectModAddr;
+	queue->selectParamAddr = selectParamAddr;
+
+	queue->pending = NULL;
+	queue->sent = NULL;
+
+	snprintf(queue->logSubSystem, sizeof(queue->logSubSystem), "%s", logSubSystem);
+
+	atomic_store(&queue->debounceUs, 0);
+	atomic_store(&queue->diffLastSent, true);
+	atomic_store(&queue->hasPending, false);
+
+	if (mtx_init(&queue->pendingLock, mtx_plain) != thrd_success) {
+		caerLog(CAER_LOG_ERROR, queue->logSubSystem, "Failed to initialize config queue lock.");
+		return (false);
+	}
+
+	if (cnd_init(&queue->pendingSignal) != thrd_success) {
+		mtx_destroy(&queue->pendingLock);
+
+		caerLog(CAER_LOG_ERROR, queue->logSubSystem, "Failed to initialize config queue condition.");
+		return (false);
+	}
+
+	if (mtx_init(&queue->flushLock, mtx_plain) != thrd_success) {
+		cnd_destroy(&queue->pendingSignal);
+		mtx_destroy(&queue->pendingLock);
+
+		caerLog(CAER_LOG_ERROR, queue->logSubSystem, "Failed to initialize config queue lock.");
+		return (false);
+	}
+
+	if (mtx_init(&queue->deviceLock, mtx_recursive) != thrd_success) {
+		mtx_destroy(&queue->flushLock);
+		cnd_destroy(&queue->pendingSignal);
+		mtx_destroy(&queue->pendingLock);
+
+		caerLog(CAER_LOG_ERROR, queue->logSubSystem, "Failed to initialize config queue lock.");
+		return (false);
+	}
+
+	atomic_store(&queue->running, true);
+
+	if (thrd_create(&queue->flusherThread, &deviceConfigQueueFlusherThread, queue) != thrd_success) {
+		mtx_destroy(&queue->deviceLock);
+		mtx_destroy(&queue->flushLock);
+		cnd_destroy(&queue->pendingSignal);
+		mtx_destroy(&queue->pendingLock);
+
+		caerLog(CAER_LOG_ERROR, queue->logSubSystem, "Failed to start config queue flusher thread.");
+		return (false);
+	}
+
+	queue->flusherStarted = true;
+
+	return (true);
+}
+
+void caerDeviceConfigQueueDestroy(caerDeviceConfigQueue queue) {
+	if (!queue->flusherStarted) {
+		return;
+	}
+
+	atomic_store(&queue->running, false);
+
+	// Wake up the flusher, it may be waiting for new writes.
+	mtx_lock(&queue->pendingLock);
+	cnd_signal(&queue->pendingSignal);
+	mtx_unlock(&queue->pendingLock);
+
+	if (thrd_join(queue->flusherThread, NULL) != thrd_success) {
+		caerLog(CAER_LOG_ERROR, queue->logSubSystem, "Failed to join config queue flusher thread.");
+	}
+
+	queue->flusherStarted = false;
+
+	deviceConfigQueueFreeTable(&queue->pending);
+	deviceConfigQueueFreeTable(&queue->sent);
+
+	mtx_destroy(&queue->deviceLock);
+	mtx_destroy(&queue->flushLock);
+	cnd_destroy(&queue->pendingSignal);
+	mtx_destroy(&queue->pendingLock);
+}
+
+void caerDeviceConfigQueueEnqueue(caerDeviceConfigQueue queue, int16_t select, int8_t modAddr, uint8_t paramAddr,
+	uint32_t key, uint32_t value) {
+	struct caer_device_config_queue_key entryKey;
+	memset(&entryKey, 0, sizeof(entryKey));
+
+	entryKey.select = select;
+	entryKey.modAddr = modAddr;
+	entryKey.paramAddr = paramAddr;
+	entryKey.key = key;
+
+	mtx_lock(&queue->pendingLock);
+
+	struct timespec now;
+	portable_clock_gettime_monotonic(&now);
+
+	if (queue->pending == NULL) {
+		queue->firstEnqueue = now;
+	}
+
+	struct caer_device_config_queue_entry *entry = NULL;
+	HASH_FIND(hh, queue->pending, &entryKey, sizeof(entryKey), entry);
+
+	if (entry != NULL) {
+		// Coalesce: the newer value wins, the write keeps its original position.
+		entry->value = value;
+	}
+	else {
+		entry = malloc(sizeof(*entry));
+		if (entry == NULL) {
+			mtx_unlock(&queue->pendingLock);
+
+			caerLog(CAER_LOG_CRITICAL, queue->logSubSystem,
+				"Failed to allocate memory for config write (mod %" PRIi8 ", param %" PRIu8 ").", modAddr, paramAddr);
+			return;
+		}
+
+		entry->key = entryKey;
+		entry->value = value;
+
+		HASH_ADD(hh, queue->pending, key, sizeof(entry->key), entry);
+	}
+
+	queue->lastEnqueue = now;
+
+	atomic_store(&queue->hasPending, true);
+
+	// The flusher thread picks the new deadline up.
+	cnd_signal(&queue->pendingSignal);
+
+	mtx_unlock(&queue->pendingLock);
+}
+
+size_t caerDeviceConfigQueueFlush(caerDeviceConfigQueue queue, bool force) {
+	mtx_lock(&queue->flushLock);
+
+	// Take the whole pending batch, new writes can be enqueued while we talk to the device.
+	mtx_lock(&queue->pendingLock);
+
+	if (queue->pending == NULL) {
+		mtx_unlock(&queue->pendingLock);
+		mtx_unlock(&queue->flushLock);
+		return (0);
+	}
+
+	if (!force) {
+		struct timespec now;
+		portable_clock_gettime_monotonic(&now);
+
+		if (deviceConfigQueueDelayUs(queue, &now) > 0) {
+			mtx_unlock(&queue->pendingLock);
+			mtx_unlock(&queue->flushLock);
+			return (0);
+		}
+	}
+
+	struct caer_device_config_queue_entry *batch = queue->pending;
+	queue->pending = NULL;
+
+	atomic_store(&queue->hasPending, false);
+
+	mtx_unlock(&queue->pendingLock);
+
+	// Group by selection, keeping enqueue order inside each group (merge sort is stable).
+	HASH_SRT(hh, batch, deviceConfigQueueCompareSelect);
+
+	bool diffLastSent = atomic_load(&queue->diffLastSent);
+
+	bool deviceLocked = false;
+	bool selectKnown = false;
+	int16_t currentSelect = 0;
+	size_t writes = 0;
+
+	struct caer_device_config_queue_entry *entry, *tmp;
+	HASH_ITER(hh, batch, entry, tmp) {
+		HASH_DEL(batch, entry);
+
+		// Hold the device for a whole selection group, so that direct writers can't
+		// change the selection under us. They may have changed it before, so always
+		// select again at the start of a group.
+		if (!deviceLocked || (currentSelect != entry->key.select)) {
+			if (deviceLocked) {
+				mtx_unlock(&queue->deviceLock);
+			}
+
+			mtx_lock(&queue->deviceLock);
+
+			deviceLocked = true;
+			selectKnown = false;
+			currentSelect = entry->key.select;
+		}
+
+		struct caer_device_config_queue_entry *last = NULL;
+		HASH_FIND(hh, queue->sent, &entry->key, sizeof(entry->key), last);
+
+		if (diffLastSent && (last != NULL) && (last->value == entry->value)) {
+			// Device already has this value.
+			free(entry);
+			continue;
+		}
+
+		bool success = true;
+
+		if ((queue->selectModAddr >= 0) && (entry->key.select != CAER_DEVICE_CONFIG_QUEUE_NO_SELECT)
+			&& (!selectKnown)) {
+			success = (*queue->configSet)(queue->device, queue->selectModAddr, queue->selectParamAddr,
+				(uint32_t) entry->key.select);
+
+			if (success) {
+				selectKnown = true;
+				writes++;
+			}
+			else {
+				selectKnown = false;
+
+				caerLog(CAER_LOG_CRITICAL, queue->logSubSystem, "Failed to select sub-device %" PRIi16 ".",
+					entry->key.select);
+			}
+		}
+
+		if (success) {
+			success = (*queue->configSet)(queue->device, entry->key.modAddr, entry->key.paramAddr, entry->value);
+
+			if (success) {
+				writes++;
+			}
+			else {
+				caerLog(CAER_LOG_CRITICAL, queue->logSubSystem,
+					"Failed to send config (mod %" PRIi8 ", param %" PRIu8 ", value %" PRIu32 ").", entry->key.modAddr,
+					entry->key.paramAddr, entry->value);
+			}
+		}
+
+		if (success) {
+			// Remember what the device has now.
+			if (last != NULL) {
+				last->value = entry->value;
+				free(entry);
+			}
+			else {
+				HASH_ADD(hh, queue->sent, key, sizeof(entry->key), entry);
+			}
+		}
+		else {
+			// Device state for this register is unknown now.
+			if (last != NULL) {
+				HASH_DEL(queue->sent, last);
+				free(last);
+			}
+
+			free(entry);
+		}
+	}
+
+	if (deviceLocked) {
+		mtx_unlock(&queue->deviceLock);
+	}
+
+	mtx_unlock(&queue->flushLock);
+
+	return (writes);
+}
+
+void caerDeviceConfigQueueInvalidate(caerDeviceConfigQueue queue) {
+	mtx_lock(&queue->deviceLock);
+
+	deviceConfigQueueFreeTable(&queue->sent);
+
+	mtx_unlock(&queue->deviceLock);
+}
+
+void caerDeviceConfigQueueAttachConfig(caerDeviceConfigQueue queue, sshsNode node) {
+	sshsNodePutIntIfAbsent(node, "configDebounceUs", 1000);
+	sshsNodePutBoolIfAbsent(node, "configDiffLastSent", true);
+
+	int32_t debounceUs = sshsNodeGetInt(node, "configDebounceUs");
+	caerDeviceConfigQueueSetDebounce(queue, (debounceUs > 0) ? (U32T(debounceUs)) : (0));
+	caerDeviceConfigQueueSetDiffLastSent(queue, sshsNodeGetBool(node, "configDiffLastSent"));
+
+	sshsNodeAddAttributeListener(node, queue, &deviceConfigQueueConfigListener);
+}
+
+void caerDeviceConfigQueueDetachConfig(caerDeviceConfigQueue queue, sshsNode node) {
+	sshsNodeRemoveAttributeListener(node, queue, &deviceConfigQueueConfigListener);
+}
+
+static void deviceConfigQueueConfigListener(sshsNode node, void *userData, enum sshs_node_attribute_events event,
+	const char *changeKey, enum sshs_node_attr_value_type changeType, union sshs_node_attr_value changeValue) {
+	UNUSED_ARGUMENT(node);
+
+	caerDeviceConfigQueue queue = userData;
+
+	if (event == SSHS_ATTRIBUTE_MODIFIED) {
+		if (changeType == SSHS_INT && caerStrEquals(changeKey, "configDebounceUs")) {
+			caerDeviceConfigQueueSetDebounce(queue, (changeValue.iint > 0) ? (U32T(changeValue.iint)) : (0));
+		}
+		else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "configDiffLastSent")) {
+			caerDeviceConfigQueueSetDiffLastSent(queue, changeValue.boolean);
+		}
+	}
+}
+
+static int deviceConfigQueueFlusherThread(void *queuePtr) {
+	caerDeviceConfigQueue queue = queuePtr;
+
+	thrd_set_name("DeviceConfigQueue");
+
+	mtx_lock(&queue->pendingLock);
+
+	while (atomic_load_explicit(&queue->running, memory_order_relaxed)) {
+		if (queue->pending == NULL) {
+			// Idle: sleep until the next write, or shutdown.
+			cnd_wait(&queue->pendingSignal, &queue->pendingLock);
+			continue;
+		}
+
+		struct timespec now;
+		portable_clock_gettime_monotonic(&now);
+
+		uint64_t delayUs = deviceConfigQueueDelayUs(queue, &now);
+
+		if (delayUs > 0) {
+			// Sleep until the deadline, new writes wake us up early to recompute it.
+			struct timespec deadline;
+			portable_clock_gettime_realtime(&deadline);
+
+			deadline.tv_sec += (time_t) (delayUs / 1000000);
+			deadline.tv_nsec += (long) ((delayUs % 1000000) * 1000);
+
+			if (deadline.tv_nsec >= 1000000000L) {
+				deadline.tv_sec++;
+				deadline.tv_nsec -= 1000000000L;
+			}
+
+			cnd_timedwait(&queue->pendingSignal, &queue->pendingLock, &deadline);
+			continue;
+		}
+
+		// Flush takes the locks in its own order.
+		mtx_unlock(&queue->pendingLock);
+
+		caerDeviceConfigQueueFlush(queue, false);
+
+		mtx_lock(&queue->pendingLock);
+	}
+
+	mtx_unlock(&queue->pendingLock);
+
+	return (EXIT_SUCCESS);
+}
+
+static uint64_t deviceConfigQueueElapsedUs(const struct timespec *since, const struct timespec *now) {
+	int64_t elapsedNs = (I64T(now->tv_sec - since->tv_sec) * 1000000000LL) + I64T(now->tv_nsec - since->tv_nsec);
+
+	return ((elapsedNs > 0) ? (U64T(elapsedNs / 1000)) : (0));
+}
+
+/**
+ * Time left until the pending writes are due, 0 if they are due now.
+ * Waits for changes to settle, but doesn't starve registers that keep changing.
+ * Must be called with pendingLock held and writes pending.
+ */
+static uint64_t deviceConfigQueueDelayUs(caerDeviceConfigQueue queue, const struct timespec *now) {
+	uint64_t debounceUs = atomic_load(&queue->debounceUs);
+	uint64_t maxDelayUs = debounceUs * DEVICE_CONFIG_QUEUE_MAX_DELAY_FACTOR;
+
+	uint64_t sinceLastUs = deviceConfigQueueElapsedUs(&queue->lastEnqueue, now);
+	uint64_t sinceFirstUs = deviceConfigQueueElapsedUs(&queue->firstEnqueue, now);
+
+	if (sinceLastUs >= debounceUs || sinceFirstUs >= maxDelayUs) {
+		return (0);
+	}
+
+	uint64_t settleUs = debounceUs - sinceLastUs;
+	uint64_t starveUs = maxDelayUs - sinceFirstUs;
+
+	return ((settleUs < starveUs) ? (settleUs) : (starveUs));
+}
+
+static int deviceConfigQueueCompareSelect(struct caer_device_config_queue_entry *a,
+	struct caer_device_config_queue_entry *b) {
+	return ((a->key.select > b->key.select) - (a->key.select < b->key.select));
+}
+
+static void deviceConfigQueueFreeTable(struct caer_device_config_queue_entry **table) {
+	struct caer_device_config_queue_entry *entry, *tmp;
+
+	HASH_ITER(hh, *table, entry, tmp) {
+		HASH_DEL(*table, entry);
+		free(entry);
+	}
+}
@@ -0,0 +1,181 @@
+#ifndef DEVICE_CONFIG_QUEUE_H_
+#define DEVICE_CONFIG_QUEUE_H_
+
+#include "main.h"
+
+#ifdef HAVE_PTHREADS
+#include "ext/c11threads_posix.h"
+#endif
+
+#include <stdatomic.h>
+#include <time.h>
+
+/**
+ * Coalescing queue for device register writes.
+ *
+ * Configuration listeners don't talk to the device directly anymore, they
+ * enqueue the register write they intend to do. Writes to the same register
+ * replace each other while waiting in the queue, so a slider dragged across
+ * a hundred values results in a single USB transfer. A flusher thread sends
+ * the pending writes once no new write arrived for the configured debounce
+ * window, grouped by sub-device selection (f.e. the Dynap-se chip ID), so
+ * that the selection register is written only once per group. Optionally,
+ * writes that would set a register to the value it already got last time
+ * are skipped entirely.
+ *
+ * The actual write goes through a caerDeviceConfigSetter, so the queue can
+ * be driven against a stand-in device that just records the writes.
+ *
+ * Code that still writes to the device directly, using the same selection
+ * register, must hold the device lock (caerDeviceConfigQueueLockDevice())
+ * around each selection and the writes that depend on it, else the flusher
+ * may change the selection in between.
+ */
+
+/// Use as 'select' argument if the register doesn't need any sub-device selection.
+#define CAER_DEVICE_CONFIG_QUEUE_NO_SELECT (-1)
+
+/**
+ * Function used to write a register to the device. Same signature as
+ * caerDeviceConfigSet(), with the device handle passed in opaquely.
+ */
+typedef bool (*caerDeviceConfigSetter)(void *device, int8_t modAddr, uint8_t paramAddr, uint32_t param);
+
+struct caer_device_config_queue_entry;
+
+struct caer_device_config_queue {
+	/// Device handle, passed as-is to configSet.
+	void *device;
+	/// Function doing the actual register write.
+	caerDeviceConfigSetter configSet;
+	/// Register used to select a sub-device before writing; selectModAddr < 0 disables selection.
+	int8_t selectModAddr;
+	uint8_t selectParamAddr;
+	/// Protects the pending table and its timestamps.
+	mtx_t pendingLock;
+	/// Wakes up the flusher thread on new writes and on shutdown, used with pendingLock.
+	cnd_t pendingSignal;
+	struct caer_device_config_queue_entry *pending;
+	struct timespec firstEnqueue;
+	struct timespec lastEnqueue;
+	/// Serializes flushes.
+	mtx_t flushLock;
+	/// Held around each selection group sent to the device, protects the last-sent table. Recursive.
+	mtx_t deviceLock;
+	struct caer_device_config_queue_entry *sent;
+	/// Debounce window in microseconds, 0 flushes as soon as the flusher wakes up.
+	atomic_uint_fast32_t debounceUs;
+	/// Skip writes whose value matches what was last sent to the same register.
+	atomic_bool diffLastSent;
+	atomic_bool hasPending;
+	atomic_bool running;
+	bool flusherStarted;
+	thrd_t flusherThread;
+	/// Sub-system string for log messages.
+	char logSubSystem[64];
+};
+
+typedef struct caer_device_config_queue *caerDeviceConfigQueue;
+
+/**
+ * Initialize a configuration queue and start its flusher thread.
+ *
+ * @param queue the queue to initialize, must be zeroed memory.
+ * @param device device handle to pass to configSet.
+ * @param configSet function doing the actual register write.
+ * @param selectModAddr module address of the sub-device selection register,
+ *                      or a negative value if the device has none.
+ * @param selectParamAddr parameter address of the sub-device selection register.
+ * @param logSubSystem sub-system string for log messages.
+ *
+ * @return true on success, false if the flusher thread couldn't be started.
+ */
+bool caerDeviceConfigQueueInit(caerDeviceConfigQueue queue, void *device, caerDeviceConfigSetter configSet,
+	int8_t selectModAddr, uint8_t selectParamAddr, const char *logSubSystem);
+/**
+ * Stop the flusher thread and free all memory held by the queue.
+ * Pending writes are discarded, call caerDeviceConfigQueueFlush() first to send them.
+ *
+ * @param queue the queue to destroy.
+ */
+void caerDeviceConfigQueueDestroy(caerDeviceConfigQueue queue);
+/**
+ * Enqueue a register write, replacing any pending write to the same register.
+ *
+ * @param queue the queue.
+ * @param select sub-device to select before writing, or CAER_DEVICE_CONFIG_QUEUE_NO_SELECT.
+ * @param modAddr module address.
+ * @param paramAddr parameter address.
+ * @param key further distinguishes registers multiplexed onto the same
+ *            modAddr/paramAddr (f.e. the bias address of Dynap-se chip content
+ *            writes), 0 if not needed.
+ * @param value value to write.
+ */
+void caerDeviceConfigQueueEnqueue(caerDeviceConfigQueue queue, int16_t select, int8_t modAddr, uint8_t paramAddr,
+	uint32_t key, uint32_t value);
+/**
+ * Send pending writes to the device, in enqueue order, grouped by selection.
+ *
+ * @param queue the queue.
+ * @param force send right away, ignoring the debounce window.
+ *
+ * @return number of register writes actually sent, including selections.
+ */
+size_t caerDeviceConfigQueueFlush(caerDeviceConfigQueue queue, bool force);
+/**
+ * Forget what was last sent to the device, so that the next write to any
+ * register goes out even if the value didn't change. Use this whenever the
+ * device state might have been changed outside of the queue (reset, bulk
+ * programming, ...). Can be called while holding the device lock.
+ *
+ * @param queue the queue.
+ */
+void caerDeviceConfigQueueInvalidate(caerDeviceConfigQueue queue);
+/**
+ * Expose the queue settings as 'configDebounceUs' and 'configDiffLastSent'
+ * attributes of the given node, and keep the queue updated on changes.
+ *
+ * @param queue the queue.
+ * @param node the node to hold the settings, usually the module node.
+ */
+void caerDeviceConfigQueueAttachConfig(caerDeviceConfigQueue queue, sshsNode node);
+/**
+ * Stop following the settings attached by caerDeviceConfigQueueAttachConfig().
+ *
+ * @param queue the queue.
+ * @param node the node passed to caerDeviceConfigQueueAttachConfig().
+ */
+void caerDeviceConfigQueueDetachConfig(caerDeviceConfigQueue queue, sshsNode node);
+
+static inline void caerDeviceConfigQueueSet(caerDeviceConfigQueue queue, int8_t modAddr, uint8_t paramAddr,
+	uint32_t value) {
+	caerDeviceConfigQueueEnqueue(queue, CAER_DEVICE_CONFIG_QUEUE_NO_SELECT, modAddr, paramAddr, 0, value);
+}
+
+/**
+ * Take exclusive access to the device, to write a selection and the registers
+ * depending on it without the flusher interfering. Can be nested.
+ *
+ * @param queue the queue.
+ */
+static inline void caerDeviceConfigQueueLockDevice(caerDeviceConfigQueue queue) {
+	mtx_lock(&queue->deviceLock);
+}
+
+static inline void caerDeviceConfigQueueUnlockDevice(caerDeviceConfigQueue queue) {
+	mtx_unlock(&queue->deviceLock);
+}
+
+static inline void caerDeviceConfigQueueSetDebounce(caerDeviceConfigQueue queue, uint32_t debounceUs) {
+	atomic_store(&queue->debounceUs, debounceUs);
+}
+
+static inline void caerDeviceConfigQueueSetDiffLastSent(caerDeviceConfigQueue queue, bool diffLastSent) {
+	atomic_store(&queue->diffLastSent, diffLastSent);
+}
+
+static inline bool caerDeviceConfigQueueHasPending(caerDeviceConfigQueue queue) {
+	return (atomic_load(&queue->hasPending));
+}
+
+#endif /* DEVICE_CONFIG_QUEUE_H_ */
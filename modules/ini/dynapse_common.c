@@ -41,26 +41,40 @@ static void updateLowPowerBiases(caerModuleData moduleData,
 static void updateSilentBiases(caerModuleData moduleData,
 		struct caer_dynapse_info *devInfo, int chipid);
 static char *int2bin(int a);
-static bool EnableStimuliGen(caerModuleData moduleData, int16_t eventSourceID);
-static bool DisableStimuliGen(caerModuleData moduleData, int16_t eventSourceID);
+static bool dynapseConfigSet(void *device, int8_t modAddr, uint8_t paramAddr,
+		uint32_t param);
+static int16_t chipNameToID(const char *chipName);
+static void biasConfigEnqueue(caerModuleData moduleData, int16_t chipId,
+		uint32_t value);
+
+static bool dynapseConfigSet(void *device, int8_t modAddr, uint8_t paramAddr,
+		uint32_t param) {
+	return (caerDeviceConfigSet(device, modAddr, paramAddr, param));
+}
 
-bool EnableStimuliGen(caerModuleData moduleData, int16_t eventSourceID) {
-	sshsNode deviceConfigNode = sshsGetRelativeNode(moduleData->moduleNode,
-			chipIDToName(DYNAPSE_CHIP_DYNAPSE, true));
-	sshsNode spikeNode = sshsGetRelativeNode(deviceConfigNode, "spikeGen/");
+static int16_t chipNameToID(const char *chipName) {
+	if (caerStrEquals(chipName, "DYNAPSE_CONFIG_DYNAPSE_U0")) {
+		return (DYNAPSE_CONFIG_DYNAPSE_U0);
+	} else if (caerStrEquals(chipName, "DYNAPSE_CONFIG_DYNAPSE_U1")) {
+		return (DYNAPSE_CONFIG_DYNAPSE_U1);
+	} else if (caerStrEquals(chipName, "DYNAPSE_CONFIG_DYNAPSE_U2")) {
+		return (DYNAPSE_CONFIG_DYNAPSE_U2);
+	} else if (caerStrEquals(chipName, "DYNAPSE_CONFIG_DYNAPSE_U3")) {
+		return (DYNAPSE_CONFIG_DYNAPSE_U3);
+	}
 
-	sshsNodePutBool(spikeNode, "doStimPrimitiveBias", true);
-	return (true);
+	return (-1);
 }
 
-bool DisableStimuliGen(caerModuleData moduleData, int16_t eventSourceID) {
-
-	sshsNode deviceConfigNode = sshsGetRelativeNode(moduleData->moduleNode,
-			chipIDToName(DYNAPSE_CHIP_DYNAPSE, true));
-	sshsNode spikeNode = sshsGetRelativeNode(deviceConfigNode, "spikeGen/");
+static void biasConfigEnqueue(caerModuleData moduleData, int16_t chipId,
+		uint32_t value) {
+	caerInputDynapseState state = moduleData->moduleState;
 
-	sshsNodePutBool(spikeNode, "doStimPrimitiveBias", false);
-	return (true);
+	// The bias address (bits 18 and up) identifies the register behind
+	// DYNAPSE_CONFIG_CHIP_CONTENT, so repeated writes to one bias coalesce.
+	caerDeviceConfigQueueEnqueue(&state->configQueue, chipId,
+			DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_CONTENT, value >> 18,
+			value);
 }
 
 const char *chipIDToName(int16_t chipID, bool withEndSlash) {
@@ -218,7 +232,8 @@ static void sramConfigListener(sshsNode node, void *userData,
 			bool sy = sshsNodeGetBool(node, "sy");
 			uint32_t virtual_core_id = sshsNodeGetInt(node, "virtual_core_id");
 
-			// select chip
+			// select chip, holding the device so the config queue can't change it
+			caerDeviceConfigQueueLockDevice(&state->configQueue);
 			caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
 					DYNAPSE_CONFIG_CHIP_ID, chipid);
 
@@ -230,6 +245,7 @@ static void sramConfigListener(sshsNode node, void *userData,
 					bits);
 			caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
 					DYNAPSE_CONFIG_CHIP_CONTENT, bits);
+			caerDeviceConfigQueueUnlockDevice(&state->configQueue);
 		}
 	}
 }
@@ -254,7 +270,8 @@ static void camConfigListener(sshsNode node, void *userData,
 				uint32_t address = sshsNodeGetInt(node, "address");
 				bool ei = sshsNodeGetBool(node, "ei");
 				bool fs = sshsNodeGetBool(node, "fs");
-				// select chip
+				// select chip, holding the device so the config queue can't change it
+				caerDeviceConfigQueueLockDevice(&state->configQueue);
 				caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
 				DYNAPSE_CONFIG_CHIP_ID, chipid);
 				// compose bit address
@@ -268,6 +285,7 @@ static void camConfigListener(sshsNode node, void *userData,
 					caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
 					DYNAPSE_CONFIG_CHIP_CONTENT, bits);
 				}
+				caerDeviceConfigQueueUnlockDevice(&state->configQueue);
 
 			}
 
@@ -487,10 +505,8 @@ static void updateCoarseFineBiasSetting(caerModuleData moduleData,
 
 	uint32_t value = generateCoarseFineBiasParent(biasConfigNode, nodeName);
 
-	// finally send configuration via USB
-	caerDeviceConfigSet(
-			((caerInputDynapseState) moduleData->moduleState)->deviceState,
-			DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_CONTENT, value);
+	// queue for sending, callers flush once all biases are updated
+	biasConfigEnqueue(moduleData, I16T(chipid), value);
 
 }
 
@@ -536,67 +552,18 @@ static void biasConfigListener(sshsNode node, void *userData,
 		const char *nodeParent = sshsNodeGetName(parent);
 		sshsNode grandparent = sshsNodeGetParent(parent);
 		const char *nodeGrandParent = sshsNodeGetName(grandparent);
-		uint32_t value = generateCoarseFineBiasParent(node, nodeName);
-
-		DisableStimuliGen(moduleData, 1);
-
-		if (caerStrEquals(nodeGrandParent, "DYNAPSE_CONFIG_DYNAPSE_U0")) {
-			int retval =
-					caerDeviceConfigSet(
-							((caerInputDynapseState) moduleData->moduleState)->deviceState,
-							DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_ID,
-							DYNAPSE_CONFIG_DYNAPSE_U0);
-			if (retval == false) {
-				caerLog(CAER_LOG_CRITICAL, moduleData->moduleSubSystemString,
-						"failed to set DYNAPSE_CONFIG_CHIP_ID to DYNAPSE_CONFIG_DYNAPSE_U0");
-			}
-		} else if (caerStrEquals(nodeGrandParent,
-				"DYNAPSE_CONFIG_DYNAPSE_U1")) {
-			int retval =
-					caerDeviceConfigSet(
-							((caerInputDynapseState) moduleData->moduleState)->deviceState,
-							DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_ID,
-							DYNAPSE_CONFIG_DYNAPSE_U1);
-			if (retval == false) {
-				caerLog(CAER_LOG_CRITICAL, moduleData->moduleSubSystemString,
-						"failed to set DYNAPSE_CONFIG_CHIP_ID to DYNAPSE_CONFIG_DYNAPSE_U1");
-			}
-		} else if (caerStrEquals(nodeGrandParent,
-				"DYNAPSE_CONFIG_DYNAPSE_U2")) {
-			int retval =
-					caerDeviceConfigSet(
-							((caerInputDynapseState) moduleData->moduleState)->deviceState,
-							DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_ID,
-							DYNAPSE_CONFIG_DYNAPSE_U2);
-			if (retval == false) {
-				caerLog(CAER_LOG_CRITICAL, moduleData->moduleSubSystemString,
-						"failed to set DYNAPSE_CONFIG_CHIP_ID to DYNAPSE_CONFIG_DYNAPSE_U2");
-			}
-		} else if (caerStrEquals(nodeGrandParent,
-				"DYNAPSE_CONFIG_DYNAPSE_U3")) {
-			int retval =
-					caerDeviceConfigSet(
-							((caerInputDynapseState) moduleData->moduleState)->deviceState,
-							DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_ID,
-							DYNAPSE_CONFIG_DYNAPSE_U3);
-			if (retval == false) {
-				caerLog(CAER_LOG_CRITICAL, moduleData->moduleSubSystemString,
-						"failed to set DYNAPSE_CONFIG_CHIP_ID to DYNAPSE_CONFIG_DYNAPSE_U3");
-			}
+		int16_t chipId = chipNameToID(nodeGrandParent);
+		if (chipId < 0) {
+			caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString,
+					"bias %s/%s belongs to unknown chip %s", nodeParent,
+					nodeName, nodeGrandParent);
+			return;
 		}
 
-		// finally send configuration via USB
-		int retval = caerDeviceConfigSet(
-				((caerInputDynapseState) moduleData->moduleState)->deviceState,
-				DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_CONTENT, value);
-
-		EnableStimuliGen(moduleData, 1);
-
-		if (retval == false) {
-			caerLog(CAER_LOG_CRITICAL, moduleData->moduleSubSystemString,
-					"failed to set bias");
-		}
+		uint32_t value = generateCoarseFineBiasParent(node, nodeName);
 
+		// sent by the config queue flusher, together with other changes
+		biasConfigEnqueue(moduleData, chipId, value);
 	}
 
 }
@@ -2228,6 +2195,18 @@ bool caerInputDYNAPSEInit(caerModuleData moduleData, uint16_t deviceType) {
 
 	caerModuleSetSubSystemString(moduleData, subSystemString);
 
+	// Bias changes go through a coalescing queue, selecting each chip once per batch.
+	if (!caerDeviceConfigQueueInit(&state->configQueue, state->deviceState,
+			&dynapseConfigSet, DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_ID,
+			moduleData->moduleSubSystemString)) {
+		caerDeviceClose((caerDeviceHandle *) &state->deviceState);
+
+		return (false);
+	}
+
+	caerDeviceConfigQueueAttachConfig(&state->configQueue,
+			moduleData->moduleNode);
+
 	// Let's turn on blocking data-get mode to avoid wasting resources.
 	caerDeviceConfigSet(state->deviceState, CAER_HOST_CONFIG_DATAEXCHANGE,
 			CAER_HOST_CONFIG_DATAEXCHANGE_BLOCKING,
@@ -2252,19 +2231,15 @@ bool caerInputDYNAPSEInit(caerModuleData moduleData, uint16_t deviceType) {
 	createDefaultConfiguration(moduleData, &dynapse_info,
 			DYNAPSE_CONFIG_DYNAPSE_U3);
 
-	// Update silent biases
-	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
-			DYNAPSE_CONFIG_CHIP_ID, DYNAPSE_CONFIG_DYNAPSE_U0);
+	// Update silent biases, sent as one batch (chip selection is done by the queue)
 	updateSilentBiases(moduleData, &dynapse_info, DYNAPSE_CONFIG_DYNAPSE_U0);
-	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
-			DYNAPSE_CONFIG_CHIP_ID, DYNAPSE_CONFIG_DYNAPSE_U1);
 	updateSilentBiases(moduleData, &dynapse_info, DYNAPSE_CONFIG_DYNAPSE_U1);
-	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
-			DYNAPSE_CONFIG_CHIP_ID, DYNAPSE_CONFIG_DYNAPSE_U2);
 	updateSilentBiases(moduleData, &dynapse_info, DYNAPSE_CONFIG_DYNAPSE_U2);
-	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
-			DYNAPSE_CONFIG_CHIP_ID, DYNAPSE_CONFIG_DYNAPSE_U3);
 	updateSilentBiases(moduleData, &dynapse_info, DYNAPSE_CONFIG_DYNAPSE_U3);
+	caerDeviceConfigQueueFlush(&state->configQueue, true);
+
+	// Chips are selected directly from here on, keep the config queue out.
+	caerDeviceConfigQueueLockDevice(&state->configQueue);
 
 	// Clear SRAM --> DYNAPSE_CONFIG_DYNAPSE_U0
 	caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString,
@@ -2346,22 +2321,18 @@ bool caerInputDYNAPSEInit(caerModuleData moduleData, uint16_t deviceType) {
 	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CLEAR_CAM, 0, 0);
 	caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString, " Done.\n");
 
-	//  DYNAPSE_CONFIG_DYNAPSE_U0
-	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
-			DYNAPSE_CONFIG_CHIP_ID, DYNAPSE_CONFIG_DYNAPSE_U0);
+	// The chips were cleared behind the queue's back, resend everything.
+	caerDeviceConfigQueueInvalidate(&state->configQueue);
+	caerDeviceConfigQueueUnlockDevice(&state->configQueue);
+
+	// Low power biases for all chips, again as one batch
 	updateLowPowerBiases(moduleData, &dynapse_info, DYNAPSE_CONFIG_DYNAPSE_U0);
-	//  DYNAPSE_CONFIG_DYNAPSE_U1
-	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
-			DYNAPSE_CONFIG_CHIP_ID, DYNAPSE_CONFIG_DYNAPSE_U1);
 	updateLowPowerBiases(moduleData, &dynapse_info, DYNAPSE_CONFIG_DYNAPSE_U1);
-	// DYNAPSE_CONFIG_DYNAPSE_U2
-	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
-			DYNAPSE_CONFIG_CHIP_ID, DYNAPSE_CONFIG_DYNAPSE_U2);
 	updateLowPowerBiases(moduleData, &dynapse_info, DYNAPSE_CONFIG_DYNAPSE_U2);
-	// DYNAPSE_CONFIG_DYNAPSE_U3
-	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
-			DYNAPSE_CONFIG_CHIP_ID, DYNAPSE_CONFIG_DYNAPSE_U3);
 	updateLowPowerBiases(moduleData, &dynapse_info, DYNAPSE_CONFIG_DYNAPSE_U3);
+	caerDeviceConfigQueueFlush(&state->configQueue, true);
+
+	caerDeviceConfigQueueLockDevice(&state->configQueue);
 
 	// Configure SRAM for Monitoring--> DYNAPSE_CONFIG_DYNAPSE_U0
 	caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString,
@@ -2407,6 +2378,8 @@ bool caerInputDYNAPSEInit(caerModuleData moduleData, uint16_t deviceType) {
 			DYNAPSE_CONFIG_DYNAPSE_U3, 0);
 	caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString, " Done.\n");
 
+	caerDeviceConfigQueueUnlockDevice(&state->configQueue);
+
 	// Device related configuration has its own sub-node DYNAPSEFX2
 	sshsNode deviceConfigNode = sshsGetRelativeNode(moduleData->moduleNode,
 			chipIDToName(DYNAPSE_CHIP_DYNAPSE, true));
@@ -2514,6 +2487,9 @@ bool caerInputDYNAPSEInit(caerModuleData moduleData, uint16_t deviceType) {
 	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_AER,
 			DYNAPSE_CONFIG_AER_RUN, true);
 
+	// The spike generator is running now, it selects chips too.
+	caerDeviceConfigQueueLockDevice(&state->configQueue);
+
 	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_CHIP,
 			DYNAPSE_CONFIG_CHIP_ID, DYNAPSE_CONFIG_DYNAPSE_U0);
 	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_MONITOR_NEU, 0, 0); // core 0 neuron 0
@@ -2542,6 +2518,8 @@ bool caerInputDYNAPSEInit(caerModuleData moduleData, uint16_t deviceType) {
 	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_MONITOR_NEU, 2, 60); // core 2 neuron 10
 	caerDeviceConfigSet(state->deviceState, DYNAPSE_CONFIG_MONITOR_NEU, 3, 105); // core 3 neuron 20
 
+	caerDeviceConfigQueueUnlockDevice(&state->configQueue);
+
 	// Start data acquisition.
 	bool ret = caerDeviceDataStart(state->deviceState,
 			&mainloopDataNotifyIncrease, &mainloopDataNotifyDecrease,
@@ -2550,6 +2528,12 @@ bool caerInputDYNAPSEInit(caerModuleData moduleData, uint16_t deviceType) {
 
 	if (!ret) {
 		// Failed to start data acquisition, close device and exit.
+		caerGenSpikeExit(moduleData);
+
+		caerDeviceConfigQueueDetachConfig(&state->configQueue,
+				moduleData->moduleNode);
+		caerDeviceConfigQueueDestroy(&state->configQueue);
+
 		caerDeviceClose((caerDeviceHandle *) &state->deviceState);
 
 		return (false);
@@ -2566,6 +2550,17 @@ void caerInputDYNAPSEExit(caerModuleData moduleData) {
 	sshsNode deviceConfigNode = sshsGetRelativeNode(moduleData->moduleNode,
 			chipIDToName(DYNAPSE_CONFIG_DYNAPSE_U2, true));
 
+	caerInputDynapseState state = moduleData->moduleState;
+
+	// The stimulation thread shares the config queue's device lock, stop it first.
+	caerGenSpikeExit(moduleData);
+
+	// Send out any bias change still waiting for its debounce window.
+	caerDeviceConfigQueueDetachConfig(&state->configQueue,
+			moduleData->moduleNode);
+	caerDeviceConfigQueueFlush(&state->configQueue, true);
+	caerDeviceConfigQueueDestroy(&state->configQueue);
+
 	caerDeviceDataStop(
 			((caerInputDynapseState) moduleData->moduleState)->deviceState);
 
@@ -4,6 +4,7 @@
 #include "main.h"
 #include "base/mainloop.h"
 #include "base/module.h"
+#include "device_config_queue.h"
 
 #include <limits.h>
 
@@ -53,6 +54,7 @@ struct caer_input_dynapse_state {
 	caerDeviceHandle deviceState;
 	sshsNode eventSourceConfigNode;
 	struct gen_spike_state genSpikeState;
+	struct caer_device_config_queue configQueue;
 };
 
 typedef struct caer_input_dynapse_state *caerInputDynapseState;
@@ -62,4 +64,7 @@ void caerInputDYNAPSEExit(caerModuleData moduleData);
 void caerInputDYNAPSERun(caerModuleData moduleData, size_t argsNumber, va_list args);
 const char *chipIDToName(int16_t chipID, bool withEndSlash);
 
+bool caerGenSpikeInit(caerModuleData moduleData);
+void caerGenSpikeExit(caerModuleData moduleData);
+
 #endif /* DYNAPSE_COMMON_H_ */
@@ -388,13 +388,15 @@ void spiketrainReg(void *spikeGenState) {
 
 	if (!atomic_load(&state->genSpikeState.done)) {
 		nanosleep(&tim, NULL);
-		// send spikes
+		// send spikes, holding the device so the config queue can't change the chip
+		caerDeviceConfigQueueLockDevice(&state->configQueue);
 		caerDeviceConfigSet((caerDeviceHandle) state->deviceState,
 		DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_ID,
 				atomic_load(&state->genSpikeState.chip_id));  //usb_handle
 		/*send the spike*/
 		caerDeviceConfigSet((caerDeviceHandle) state->deviceState,
 		DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_CONTENT, value); //usb_handle
+		caerDeviceConfigQueueUnlockDevice(&state->configQueue);
 		//caerLog(CAER_LOG_NOTICE, "spikeGen", "sending spikes %d \n", value);
 	}
 
@@ -464,7 +466,8 @@ void spiketrainPat(void *spikeGenState,
 
 	if (!atomic_load(&state->genSpikeState.done)) {
 		nanosleep(&tim, NULL);
-		// send spikes
+		// send spikes, holding the device so the config queue can't change the chip
+		caerDeviceConfigQueueLockDevice(&state->configQueue);
 		caerDeviceConfigSet(usb_handle, DYNAPSE_CONFIG_CHIP,
 		DYNAPSE_CONFIG_CHIP_ID, atomic_load(&state->genSpikeState.chip_id));
 		//send the spike
@@ -476,6 +479,7 @@ void spiketrainPat(void *spikeGenState,
 					DYNAPSE_CONFIG_CHIP_CONTENT, valueSent);
 				}
 			}
+		caerDeviceConfigQueueUnlockDevice(&state->configQueue);
 		//caerLog(CAER_LOG_NOTICE, "spikeGen", "sending spikes %d \n", value);
 	}
 
@@ -580,6 +584,8 @@ void spiketrainPatSingle(void *spikeGenState, uint32_t sourceAddress) {
 		// send spikes
 		if (atomic_load(&state->genSpikeState.doStimPrimitiveBias) == true
 				&& atomic_load(&state->genSpikeState.doStimPrimitiveCam) == true) {
+			// hold the device so the config queue can't change the chip
+			caerDeviceConfigQueueLockDevice(&state->configQueue);
 			caerDeviceConfigSet(usb_handle, DYNAPSE_CONFIG_CHIP,
 			DYNAPSE_CONFIG_CHIP_ID, atomic_load(&state->genSpikeState.chip_id));
 			//send the spike
@@ -605,6 +611,7 @@ void spiketrainPatSingle(void *spikeGenState, uint32_t sourceAddress) {
 				caerDeviceConfigSet(usb_handle, DYNAPSE_CONFIG_CHIP,
 				DYNAPSE_CONFIG_CHIP_CONTENT, valueSentInhibitoryControl);
 			}
+			caerDeviceConfigQueueUnlockDevice(&state->configQueue);
 		}
 		//caerLog(CAER_LOG_NOTICE, "spikeGen", "sending spikes %d \n", valueSent);
 	}
@@ -616,6 +623,8 @@ void SetCam(void *spikeGenState) {
 	}
 	caerInputDynapseState state = spikeGenState;
 	caerDeviceHandle usb_handle = (caerDeviceHandle) state->deviceState;
+	// hold the device so the config queue can't change the chip
+	caerDeviceConfigQueueLockDevice(&state->configQueue);
 	caerDeviceConfigSet(usb_handle, DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_ID,
 			atomic_load(&state->genSpikeState.chip_id)); //0
 	uint32_t neuronId;
@@ -625,6 +634,7 @@ void SetCam(void *spikeGenState) {
 			neuronId++) {
 		WriteCam(state, neuronId, neuronId, 0, 3);
 	}
+	caerDeviceConfigQueueUnlockDevice(&state->configQueue);
 	caerLog(CAER_LOG_NOTICE, "\nSpikeGen", "CAM programmed successfully.");
 
 	// set back setCam to false
@@ -661,6 +671,8 @@ void SetCamSingle(void *spikeGenState) {
 	}
 	caerInputDynapseState state = spikeGenState;
 	caerDeviceHandle usb_handle = (caerDeviceHandle) state->deviceState;
+	// hold the device so the config queue can't change the chip
+	caerDeviceConfigQueueLockDevice(&state->configQueue);
 	caerDeviceConfigSet(usb_handle, DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_ID,
 			atomic_load(&state->genSpikeState.chip_id)); //0
 
@@ -736,6 +748,7 @@ void SetCamSingle(void *spikeGenState) {
 	WriteCam(state, 1, neuronId, 61, 1);
 	WriteCam(state, 2, neuronId, 62, 1);
 	WriteCam(state, 3, neuronId, 63, 3);
+	caerDeviceConfigQueueUnlockDevice(&state->configQueue);
 
 	caerLog(CAER_LOG_NOTICE, "\nSpikeGen", "CAM programmed successfully.");
 
@@ -773,6 +786,8 @@ void ClearCam(void *spikeGenState) {
 	}
 	caerInputDynapseState state = spikeGenState;
 	caerDeviceHandle usb_handle = (caerDeviceHandle) state->deviceState;
+	// hold the device so the config queue can't change the chip
+	caerDeviceConfigQueueLockDevice(&state->configQueue);
 	caerDeviceConfigSet(usb_handle, DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_ID,
 			atomic_load(&state->genSpikeState.chip_id)); //0
 	uint32_t neuronId;
@@ -781,6 +796,8 @@ void ClearCam(void *spikeGenState) {
 	for (neuronId = 0; neuronId < DYNAPSE_CONFIG_NUMNEURONS; neuronId++) {
 		WriteCam(state, 0, neuronId, 0, 0);
 	}
+	caerDeviceConfigQueueInvalidate(&state->configQueue);
+	caerDeviceConfigQueueUnlockDevice(&state->configQueue);
 	caerLog(CAER_LOG_NOTICE, "\nSpikeGen", "Done, CAM cleared successfully.");
 	atomic_store(&state->genSpikeState.clearCam, false);
 
@@ -818,6 +835,8 @@ void ClearAllCam(void *spikeGenState) {
 	}
 	caerInputDynapseState state = spikeGenState;
 	caerDeviceHandle usb_handle = (caerDeviceHandle) state->deviceState;
+	// hold the device so the config queue can't change the chip
+	caerDeviceConfigQueueLockDevice(&state->configQueue);
 	caerDeviceConfigSet(usb_handle, DYNAPSE_CONFIG_CHIP, DYNAPSE_CONFIG_CHIP_ID,
 			atomic_load(&state->genSpikeState.chip_id));
 	uint32_t neuronId, camId;
@@ -827,6 +846,8 @@ void ClearAllCam(void *spikeGenState) {
 			WriteCam(state, 0, neuronId, camId, 0);
 		}
 	}
+	caerDeviceConfigQueueInvalidate(&state->configQueue);
+	caerDeviceConfigQueueUnlockDevice(&state->configQueue);
 	caerLog(CAER_LOG_NOTICE, "\nSpikeGen", "CAM cleared successfully.");
 	atomic_store(&state->genSpikeState.clearAllCam, false);
 
@@ -907,6 +928,8 @@ void ResetBiases(void *spikeGenState) {
 		else if (chipId_t == 3)
 			chipId = DYNAPSE_CONFIG_DYNAPSE_U3;
 
+		// hold the device so the config queue can't change the chip
+		caerDeviceConfigQueueLockDevice(&state->configQueue);
 		caerDeviceConfigSet(usb_handle, DYNAPSE_CONFIG_CHIP,
 		DYNAPSE_CONFIG_CHIP_ID, chipId);
 
@@ -975,6 +998,10 @@ void ResetBiases(void *spikeGenState) {
 			setBiasBits(state, chipId, coreId, "R2R_P", 4, 85, "HighBias",
 					"PBias");
 		}
+
+		// biases were written behind the config queue's back
+		caerDeviceConfigQueueInvalidate(&state->configQueue);
+		caerDeviceConfigQueueUnlockDevice(&state->configQueue);
 	}
 
 	// set back clearAllCam to false
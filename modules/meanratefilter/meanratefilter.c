@@ -10,13 +10,14 @@
 #include "base/module.h"
 #include "ext/buffers.h"
 #include "libcaer/devices/dynapse.h"
-#include "ext/colorjet/colorjet.h"
+#include "ext/colorjet/heatmap.h"
 
 struct MRFilter_state {
 	sshsNode eventSourceModuleState;
 	sshsNode eventSourceConfigNode;
 	simple2DBufferFloat frequencyMap;
 	simple2DBufferLong spikeCountMap;
+	heatmapRenderer heatmap;
 	int8_t subSampleBy;
 	int32_t colorscaleMax;
 	int32_t colorscaleMin;
@@ -25,6 +26,11 @@ struct MRFilter_state {
 	double measureStartedAt;
 	bool startedMeas;
 	bool doSetFreq;
+	sshsNodeAttrHandle colorscaleMaxHandle;
+	sshsNodeAttrHandle colorscaleMinHandle;
+	sshsNodeAttrHandle targetFreqHandle;
+	sshsNodeAttrHandle measureMinTimeHandle;
+	sshsNodeAttrHandle doSetFreqHandle;
 	struct timespec tstart;			//struct is defined in gen_spike.c
 	struct timespec tend;
 };
@@ -40,9 +46,8 @@ static bool allocateFrequencyMap(MRFilterState state, int16_t sourceID);
 static bool allocateSpikeCountMap(MRFilterState state, int16_t sourceID);
 
 static struct caer_module_functions caerMeanRateFilterFunctions = { .moduleInit =
-	&caerMeanRateFilterInit, .moduleRun = &caerMeanRateFilterRun, .moduleConfig =
-	&caerMeanRateFilterConfig, .moduleExit = &caerMeanRateFilterExit, .moduleReset =
-	&caerMeanRateFilterReset };
+	&caerMeanRateFilterInit, .moduleRun = &caerMeanRateFilterRun, .moduleConfig = NULL,
+	.moduleExit = &caerMeanRateFilterExit, .moduleReset = &caerMeanRateFilterReset };
 
 void caerMeanRateFilter(uint16_t moduleID,  int16_t eventSourceID, caerSpikeEventPacket spike, caerFrameEventPacket *freqplot) {
 	caerModuleData moduleData = caerMainloopFindModule(moduleID, "MeanRate", CAER_MODULE_PROCESSOR);
@@ -62,8 +67,12 @@ static bool caerMeanRateFilterInit(caerModuleData moduleData) {
 
 	MRFilterState state = moduleData->moduleState;
 
-	// Add config listeners last, to avoid having them dangling if Init doesn't succeed.
-	sshsNodeAddAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+	// Resolve configuration once, values are then refreshed lock-free on each run.
+	state->colorscaleMaxHandle = sshsNodeGetAttributeHandle(moduleData->moduleNode, "colorscaleMax", SSHS_INT);
+	state->colorscaleMinHandle = sshsNodeGetAttributeHandle(moduleData->moduleNode, "colorscaleMin", SSHS_INT);
+	state->targetFreqHandle = sshsNodeGetAttributeHandle(moduleData->moduleNode, "targetFreq", SSHS_FLOAT);
+	state->measureMinTimeHandle = sshsNodeGetAttributeHandle(moduleData->moduleNode, "measureMinTime", SSHS_FLOAT);
+	state->doSetFreqHandle = sshsNodeGetAttributeHandle(moduleData->moduleNode, "doSetFreq", SSHS_BOOL);
 
 	sshsNode sourceInfoNode = sshsGetRelativeNode(moduleData->moduleNode, "sourceInfo/");
 	if (!sshsNodeAttributeExists(sourceInfoNode, "dataSizeX", SSHS_SHORT)) { //to do for visualizer change name of field to a more generic one
@@ -74,7 +83,7 @@ static bool caerMeanRateFilterInit(caerModuleData moduleData) {
 	// internals
 	state->startedMeas = false;
 	state->measureStartedAt = 0.0f;
-	state->measureMinTime = sshsNodeGetFloat(moduleData->moduleNode, "measureMinTime");
+	caerMeanRateFilterConfig(moduleData);
 
 	// Nothing that can fail here.
 	return (true);
@@ -111,6 +120,15 @@ static void caerMeanRateFilterRun(caerModuleData moduleData, size_t argsNumber,
 			return;
 		}
 	}
+	// If the heatmap renderer is not allocated yet, do it.
+	if (state->heatmap == NULL) {
+		state->heatmap = heatmapRendererInit(state->frequencyMap->sizeX, state->frequencyMap->sizeY);
+		if (state->heatmap == NULL) {
+			// Failed to allocate memory, nothing to do.
+			caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate memory for heatmap.");
+			return;
+		}
+	}
 
 	// --- start  usb handle / from spike event source id
 	state->eventSourceModuleState = caerMainloopGetSourceState(U16T(eventSourceID));
@@ -137,6 +155,8 @@ static void caerMeanRateFilterRun(caerModuleData moduleData, size_t argsNumber,
 	int16_t sizeX = sshsNodeGetShort(sourceInfoNode, "dataSizeX");
 	int16_t sizeY = sshsNodeGetShort(sourceInfoNode, "dataSizeY");
 
+	bool mapUpdated = false;
+
 	// get current time
 	clock_gettime(CLOCK_MONOTONIC, &state->tend);
 	double now = ((double) state->tend.tv_sec + 1.0e-9 * state->tend.tv_nsec);
@@ -145,6 +165,7 @@ static void caerMeanRateFilterRun(caerModuleData moduleData, size_t argsNumber,
 
 		//caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString, "\nfreq measurement completed.\n");
 		state->startedMeas = false;
+		mapUpdated = true;
 
 		//update frequencyMap
 		for (size_t x = 0; x < sizeX; x++) {
@@ -328,52 +349,34 @@ static void caerMeanRateFilterRun(caerModuleData moduleData, size_t argsNumber,
 	CAER_SPIKE_ITERATOR_VALID_END
 
 
-	// put info into frame
-	*freqplot = caerFrameEventPacketAllocate(1, I16T(moduleData->moduleID), 0, sizeX, sizeY, 3);
-	if (*freqplot != NULL) {
-		caerFrameEvent singleplot = caerFrameEventPacketGetEvent(*freqplot, 0);
-
-		uint32_t counter = 0;
-		for (size_t x = 0; x < sizeX; x++) {
-			for (size_t y = 0; y < sizeY; y++) {
-				COLOUR col  = GetColour((double) state->frequencyMap->buffer2d[y][x], state->colorscaleMin, state->colorscaleMax);
-				singleplot->pixels[counter] = (uint16_t) ( (int)(col.r*65535));			// red
-				singleplot->pixels[counter + 1] = (uint16_t) ( (int)(col.g*65535));		// green
-				singleplot->pixels[counter + 2] = (uint16_t) ( (int)(col.b*65535) );		// blue
-				counter += 3;
-			}
-		}
-
-		//add info to the frame
-		caerFrameEventSetLengthXLengthYChannelNumber(singleplot, sizeX, sizeY, 3, *freqplot);
-		//validate frame
-		caerFrameEventValidate(singleplot, *freqplot);
+	// Redraw the heatmap only when the frequencies or the colour scale changed,
+	// the visualizer keeps showing the last frame in between.
+	bool rangeChanged = heatmapRendererSetRange(state->heatmap, state->colorscaleMin, state->colorscaleMax);
+	if (mapUpdated || rangeChanged) {
+		heatmapRendererUpdate(state->heatmap, state->frequencyMap);
 	}
 
+	*freqplot = heatmapRendererGetFrame(state->heatmap, I16T(moduleData->moduleID));
 }
 
 static void caerMeanRateFilterConfig(caerModuleData moduleData) {
-	caerModuleConfigUpdateReset(moduleData);
-
 	MRFilterState state = moduleData->moduleState;
 
-	state->colorscaleMax = sshsNodeGetInt(moduleData->moduleNode, "colorscaleMax");
-	state->colorscaleMin = sshsNodeGetInt(moduleData->moduleNode, "colorscaleMin");
-	state->targetFreq = sshsNodeGetFloat(moduleData->moduleNode, "targetFreq");
-	state->measureMinTime = sshsNodeGetFloat(moduleData->moduleNode, "measureMinTime");
-	state->doSetFreq = sshsNodeGetBool(moduleData->moduleNode, "doSetFreq");
+	state->colorscaleMax = sshsNodeAttrHandleGetInt(state->colorscaleMaxHandle);
+	state->colorscaleMin = sshsNodeAttrHandleGetInt(state->colorscaleMinHandle);
+	state->targetFreq = sshsNodeAttrHandleGetFloat(state->targetFreqHandle);
+	state->measureMinTime = sshsNodeAttrHandleGetFloat(state->measureMinTimeHandle);
+	state->doSetFreq = sshsNodeAttrHandleGetBool(state->doSetFreqHandle);
 
 }
 
 static void caerMeanRateFilterExit(caerModuleData moduleData) {
-	// Remove listener, which can reference invalid memory in userData.
-	sshsNodeRemoveAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
-
 	MRFilterState state = moduleData->moduleState;
 
 	// Ensure maps are freed.
 	simple2DBufferFreeFloat(state->frequencyMap);
 	simple2DBufferFreeLong(state->spikeCountMap);
+	heatmapRendererFree(state->heatmap);
 }
 
 static void caerMeanRateFilterReset(caerModuleData moduleData, uint16_t resetCallSourceID) {
@@ -384,6 +387,11 @@ static void caerMeanRateFilterReset(caerModuleData moduleData, uint16_t resetCal
 	// Reset maps to all zeros (startup state).
 	simple2DBufferResetLong(state->spikeCountMap);
 	simple2DBufferResetFloat(state->frequencyMap);
+
+	// Show the cleared map.
+	if (state->heatmap != NULL) {
+		heatmapRendererUpdate(state->heatmap, state->frequencyMap);
+	}
 }
 
 static bool allocateSpikeCountMap(MRFilterState state, int16_t sourceID) {
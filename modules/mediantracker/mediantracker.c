@@ -20,12 +20,19 @@ struct MTFilter_state {
 	float ystd;
 	float xmean;
 	float ymean;
-	int lastts;
-	int dt;
-	int prevlastts;
+	int64_t lastts;
+	int64_t dt;
+	int64_t prevlastts;
 	float radius;
 	float numStdDevsForBoundingBox;
 	float alpha;
+	sshsNodeAttrHandle numStdDevsForBoundingBoxHandle;
+	sshsNodeAttrHandle alphaHandle;
+	// Per-axis coordinate histograms, all zero between packets.
+	uint32_t *xhistogram;
+	uint32_t *yhistogram;
+	int16_t sizeX;
+	int16_t sizeY;
 };
 
 typedef struct MTFilter_state *MTFilterState;
@@ -35,12 +42,19 @@ static void caerMediantrackerRun(caerModuleData moduleData, size_t argsNumber, v
 static void caerMediantrackerConfig(caerModuleData moduleData);
 static void caerMediantrackerExit(caerModuleData moduleData);
 static void caerMediantrackerReset(caerModuleData moduleData, uint16_t resetCallSourceID);
+static bool allocateHistograms(MTFilterState state, int16_t sourceID);
+static float histogramMedian(uint32_t *histogram, size_t size, uint32_t count);
+static caerFrameEventPacket renderFrame(caerModuleData moduleData, caerPolarityEventPacket polarity);
 
 static struct caer_module_functions caerMediantrackerFunctions = { .moduleInit = &caerMediantrackerInit, .moduleRun =
-	&caerMediantrackerRun, .moduleConfig = &caerMediantrackerConfig, .moduleExit = &caerMediantrackerExit,
+	&caerMediantrackerRun, .moduleConfig = NULL, .moduleExit = &caerMediantrackerExit,
 	.moduleReset = &caerMediantrackerReset };
 
-void caerMediantrackerFilter(uint16_t moduleID, caerPolarityEventPacket polarity, caerFrameEventPacket frame) {
+void caerMediantrackerFilter(uint16_t moduleID, caerPolarityEventPacket polarity, caerFrameEventPacket *frame) {
+	if (frame != NULL) {
+		*frame = NULL;
+	}
+
 	caerModuleData moduleData = caerMainloopFindModule(moduleID, "MTFilter", CAER_MODULE_PROCESSOR);
 	if (moduleData == NULL) {
 		return;
@@ -64,23 +78,19 @@ static bool caerMediantrackerInit(caerModuleData moduleData) {
 	state->lastts = 0;
 	state->dt = 0;
 	state->prevlastts = 0;
-	state->numStdDevsForBoundingBox = sshsNodeGetFloat(moduleData->moduleNode, "numStdDevsForBoundingBox");
 	state->radius = 10.0f;
-	state->alpha = sshsNodeGetFloat(moduleData->moduleNode, "alpha");
 
-	// Add config listeners last, to avoid having them dangling if Init doesn't succeed.
-	sshsNodeAddAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+	// Resolve configuration once, values are then refreshed lock-free on each run.
+	state->numStdDevsForBoundingBoxHandle = sshsNodeGetAttributeHandle(moduleData->moduleNode,
+		"numStdDevsForBoundingBox", SSHS_FLOAT);
+	state->alphaHandle = sshsNodeGetAttributeHandle(moduleData->moduleNode, "alpha", SSHS_FLOAT);
 
-	sshsNode sourceInfoNode = sshsGetRelativeNode(moduleData->moduleNode, "sourceInfo/");
-	sshsNode sourceInfoNodeCA = caerMainloopGetSourceInfo(1);  // TODO !!! -> remove hard CODED moduleID
-	if (!sshsNodeAttributeExists(sourceInfoNode, "dataSizeX", SSHS_SHORT)) { //to do for visualizer change name of field to a more generic one
-		sshsNodePutShort(sourceInfoNode, "dataSizeX", sshsNodeGetShort(sourceInfoNodeCA, "dvsSizeX"));
-		sshsNodePutShort(sourceInfoNode, "dataSizeY", sshsNodeGetShort(sourceInfoNodeCA, "dvsSizeY"));
-	}
+	caerMediantrackerConfig(moduleData);
 
 	// Nothing that can fail here.
 	return (true);
 }
+
 static void caerMediantrackerRun(caerModuleData moduleData, size_t argsNumber, va_list args) {
 	UNUSED_ARGUMENT(argsNumber);
 
@@ -95,155 +105,252 @@ static void caerMediantrackerRun(caerModuleData moduleData, size_t argsNumber, v
 
 	MTFilterState state = moduleData->moduleState;
 
-	// get the size of the packet
-	int n = caerEventPacketHeaderGetEventNumber(&polarity->packetHeader);
+	// If the histograms are not allocated yet, do it.
+	if (state->xhistogram == NULL) {
+		if (!allocateHistograms(state, caerEventPacketHeaderGetEventSource(&polarity->packetHeader))) {
+			// Failed to allocate memory, nothing to do.
+			caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate memory for histograms.");
+			return;
+		}
+
+		// Frames have the same size as the source, tell the visualizer.
+		sshsNode sourceInfoNode = sshsGetRelativeNode(moduleData->moduleNode, "sourceInfo/");
+		sshsNodePutShort(sourceInfoNode, "dataSizeX", state->sizeX);
+		sshsNodePutShort(sourceInfoNode, "dataSizeY", state->sizeY);
+	}
+
+	// update filter parameters
+	caerMediantrackerConfig(moduleData);
+
+	// Single pass over the events: coordinate histograms for the median,
+	// sums and sums of squares for mean and std, and the last timestamp.
+	uint32_t *xhistogram = state->xhistogram;
+	uint32_t *yhistogram = state->yhistogram;
+	uint32_t count = 0;
+	int64_t xsum = 0, ysum = 0;
+	int64_t xsumsq = 0, ysumsq = 0;
+	int64_t maxLastTime = 0;
 
-	// get last time stamp of the packet
-	// update dt and prevlastts
-	//int countForLastTime = 0;
-	int maxLastTime = 0;
 	CAER_POLARITY_ITERATOR_VALID_START(polarity)
-		if (maxLastTime < caerPolarityEventGetTimestamp64(caerPolarityIteratorElement, polarity))
-			maxLastTime = caerPolarityEventGetTimestamp64(caerPolarityIteratorElement, polarity);
+		int64_t x = caerPolarityEventGetX(caerPolarityIteratorElement);
+		int64_t y = caerPolarityEventGetY(caerPolarityIteratorElement);
+		int64_t ts = caerPolarityEventGetTimestamp64(caerPolarityIteratorElement, polarity);
+
+		xhistogram[x]++;
+		yhistogram[y]++;
+		xsum += x;
+		ysum += y;
+		xsumsq += x * x;
+		ysumsq += y * y;
+		maxLastTime = (ts > maxLastTime) ? (ts) : (maxLastTime);
+		count++;
 	CAER_POLARITY_ITERATOR_VALID_END
+
+	if (count == 0) {
+		// No valid events, nothing to update.
+		return;
+	}
+
+	// update dt and prevlastts
 	state->lastts = maxLastTime;
 	state->dt = state->lastts - state->prevlastts;
 	state->prevlastts = state->lastts;
 	if (state->dt < 0)
 		state->dt = 0;
 
-	// save position of all events in the packet
-	int xs[n];
-	int ys[n];
-	int index = 0;
-	CAER_POLARITY_ITERATOR_VALID_START(polarity)
-		xs[index] = caerPolarityEventGetX(caerPolarityIteratorElement);
-		ys[index] = caerPolarityEventGetY(caerPolarityIteratorElement);
-		index++;
-	CAER_POLARITY_ITERATOR_VALID_END
-
-	// get median
-	int x, y;
-	if (index % 2 != 0) { // odd number of events take middle one
-		x = xs[index / 2];
-		y = ys[index / 2];
-	}
-	else { // even number of events take avg of middle two
-		x = (float) (((float) xs[index / 2 - 1] + xs[index / 2]) / 2.0f);
-		y = (float) (((float) ys[index / 2 - 1] + ys[index / 2]) / 2.0f);
-	}
-
 	float fac = state->alpha * (float) state->dt;
 	if (fac > 1)
 		fac = 1;
+
+	// get median, this also clears the histograms for the next packet
+	float x = histogramMedian(xhistogram, (size_t) state->sizeX, count);
+	float y = histogramMedian(yhistogram, (size_t) state->sizeY, count);
+
 	state->xmedian = state->xmedian + (x - state->xmedian) * fac;
 	state->ymedian = state->ymedian + (y - state->ymedian) * fac;
 
 	// get mean
-	int xsum = 0;
-	int ysum = 0;
-	for (int i = 0; i < index; i++) {
-		xsum += xs[i];
-		ysum += ys[i];
+	double n = (double) count;
+	double xmean = (double) xsum / n;
+	double ymean = (double) ysum / n;
+
+	state->xmean = state->xmean + ((float) xmean - state->xmean) * fac;
+	state->ymean = state->ymean + ((float) ymean - state->ymean) * fac;
+
+	// get std, around the tracked mean: E[(x - m)^2] = E[x^2] - 2 m E[x] + m^2
+	double m = state->xmean;
+	double xvar = ((double) xsumsq / n) - (2 * m * xmean) + (m * m);
+	m = state->ymean;
+	double yvar = ((double) ysumsq / n) - (2 * m * ymean) + (m * m);
+
+	xvar = (xvar > 0) ? (xvar) : (0);
+	yvar = (yvar > 0) ? (yvar) : (0);
+
+	state->xstd = state->xstd + ((float) sqrt(xvar) - state->xstd) * fac;
+	state->ystd = state->ystd + ((float) sqrt(yvar) - state->ystd) * fac;
+
+	// plot, only if someone wants it
+	if (frame != NULL) {
+		*frame = renderFrame(moduleData, polarity);
 	}
-	state->xmean = state->xmean + (xsum / n - state->xmean) * fac;
-	state->ymean = state->ymean + (ysum / n - state->ymean) * fac;
-
-	// get std
-	float xvar = 0.0f;
-	float yvar = 0.0f;
-	float tmp;
-	for (int i = 0; i < index; i++) {
-		tmp = xs[i] - state->xmean;
-		tmp *= tmp;
-		xvar += tmp;
-
-		tmp = ys[i] - state->ymean;
-		tmp *= tmp;
-		yvar += tmp;
+}
+
+static bool allocateHistograms(MTFilterState state, int16_t sourceID) {
+	// Get size information from source.
+	sshsNode sourceInfoNode = caerMainloopGetSourceInfo(U16T(sourceID));
+	if (sourceInfoNode == NULL) {
+		// This should never happen, but we handle it gracefully.
+		caerLog(CAER_LOG_ERROR, __func__, "Failed to get source info to allocate histograms.");
+		return (false);
 	}
-	if (index != 0) {
-		xvar /= index;
-		yvar /= index;
+
+	state->sizeX = sshsNodeGetShort(sourceInfoNode, "dvsSizeX");
+	state->sizeY = sshsNodeGetShort(sourceInfoNode, "dvsSizeY");
+
+	state->xhistogram = calloc((size_t) state->sizeX, sizeof(uint32_t));
+	state->yhistogram = calloc((size_t) state->sizeY, sizeof(uint32_t));
+
+	if (state->xhistogram == NULL || state->yhistogram == NULL) {
+		free(state->xhistogram);
+		state->xhistogram = NULL;
+		free(state->yhistogram);
+		state->yhistogram = NULL;
+
+		return (false);
 	}
-	state->xstd = state->xstd + ((float) sqrt(xvar) - state->xstd) * fac;
-	state->ystd = state->ystd + ((float) sqrt(yvar) - state->ystd) * fac;
 
-	// plot
-	sshsNode sourceInfoNode = caerMainloopGetSourceInfo(
-		U16T(caerEventPacketHeaderGetEventSource(&polarity->packetHeader)));
-	int16_t sizeX = sshsNodeGetShort(sourceInfoNode, "dvsSizeX");
-	int16_t sizeY = sshsNodeGetShort(sourceInfoNode, "dvsSizeY");
-
-	*frame = caerFrameEventPacketAllocate(1, I16T(moduleData->moduleID), 0, sizeX, sizeY, 1);
-	if (*frame != NULL) {
-		caerFrameEvent singleplot = caerFrameEventPacketGetEvent(*frame, 0);
-		uint32_t counter = 0;
-		for (size_t yy = 0; yy < sizeY; yy++) {
-			for (size_t xx = 0; xx < sizeX; xx++) {
-				if ((xx == (int) state->xmedian && yy == (int) state->ymedian)
-					|| (xx == (int) (state->xmedian + state->xstd * state->numStdDevsForBoundingBox)
-						&& yy <= (state->ymedian + state->ystd * state->numStdDevsForBoundingBox)
-						&& yy >= (state->ymedian - state->ystd * state->numStdDevsForBoundingBox)
-						|| (xx == (int) (state->xmedian - state->xstd * state->numStdDevsForBoundingBox)
-							&& yy <= (state->ymedian + state->ystd * state->numStdDevsForBoundingBox)
-							&& yy >= (state->ymedian - state->ystd * state->numStdDevsForBoundingBox)
-							|| (yy == (int) (state->ymedian + state->ystd * state->numStdDevsForBoundingBox)
-								&& xx <= (state->xmedian + state->xstd * state->numStdDevsForBoundingBox)
-								&& xx >= (state->xmedian - state->xstd * state->numStdDevsForBoundingBox)
-								|| (yy == (int) (state->ymedian - state->ystd * state->numStdDevsForBoundingBox)
-									&& xx <= (state->xmedian + state->xstd * state->numStdDevsForBoundingBox)
-									&& xx >= (state->xmedian - state->xstd * state->numStdDevsForBoundingBox)))))) {
-					singleplot->pixels[counter] = (uint16_t) ((int) 65000);		// red
-					//singleplot->pixels[counter + 1] = (uint16_t) ((int) 1);		// green
-					//singleplot->pixels[counter + 2] = (uint16_t) ((int) 1);		// blue
-				}
-				else {
-					singleplot->pixels[counter] = (uint16_t) ((int) 50);			// red
-					//singleplot->pixels[counter + 1] = (uint16_t) ((int) 1);		// green
-					//singleplot->pixels[counter + 2] = (uint16_t) ((int) 65000);	// blue
-				}
-				counter += 1;
-			}
+	return (true);
+}
+
+/**
+ * Median of the coordinates counted in a histogram, averaging the two middle
+ * ones for an even count. Walks the whole histogram once, resetting it to
+ * zero on the way, so the cost is O(size) independent of the event count.
+ */
+static float histogramMedian(uint32_t *histogram, size_t size, uint32_t count) {
+	// 1-based ranks of the two middle elements, the same for odd counts.
+	uint32_t lowRank = (count + 1) / 2;
+	uint32_t highRank = (count / 2) + 1;
+	size_t low = 0, high = 0;
+	uint32_t seen = 0;
+
+	for (size_t i = 0; i < size; i++) {
+		uint32_t bin = histogram[i];
+		histogram[i] = 0;
+
+		// Ranks seen + 1 ... seen + bin have coordinate i.
+		low = (seen < lowRank && (seen + bin) >= lowRank) ? (i) : (low);
+		high = (seen < highRank && (seen + bin) >= highRank) ? (i) : (high);
+		seen += bin;
+	}
+
+	return ((float) (low + high) / 2.0f);
+}
+
+static caerFrameEventPacket renderFrame(caerModuleData moduleData, caerPolarityEventPacket polarity) {
+	MTFilterState state = moduleData->moduleState;
+	int32_t sizeX = state->sizeX;
+	int32_t sizeY = state->sizeY;
+
+	caerFrameEventPacket framePacket = caerFrameEventPacketAllocate(1, I16T(moduleData->moduleID), 0, sizeX, sizeY, 1);
+	if (framePacket == NULL) {
+		return (NULL);
+	}
+
+	caerFrameEvent singleplot = caerFrameEventPacketGetEvent(framePacket, 0);
+	uint16_t *pixels = singleplot->pixels;
+
+	// Dark background.
+	for (size_t i = 0; i < ((size_t) sizeX * (size_t) sizeY); i++) {
+		pixels[i] = 50;
+	}
+
+	// Bounding box of numStdDevsForBoundingBox standard deviations around the median, and the median itself.
+	float xextent = state->xstd * state->numStdDevsForBoundingBox;
+	float yextent = state->ystd * state->numStdDevsForBoundingBox;
+
+	int32_t left = (int32_t) (state->xmedian - xextent);
+	int32_t right = (int32_t) (state->xmedian + xextent);
+	int32_t top = (int32_t) (state->ymedian - yextent);
+	int32_t bottom = (int32_t) (state->ymedian + yextent);
+
+	int32_t startX = (left > 0) ? (left) : (0);
+	int32_t endX = (right < sizeX - 1) ? (right) : (sizeX - 1);
+	int32_t startY = (top > 0) ? (top) : (0);
+	int32_t endY = (bottom < sizeY - 1) ? (bottom) : (sizeY - 1);
+
+	for (int32_t xx = startX; xx <= endX; xx++) {
+		if (top >= 0 && top < sizeY) {
+			pixels[(top * sizeX) + xx] = 65000;
+		}
+		if (bottom >= 0 && bottom < sizeY) {
+			pixels[(bottom * sizeX) + xx] = 65000;
+		}
+	}
+
+	for (int32_t yy = startY; yy <= endY; yy++) {
+		if (left >= 0 && left < sizeX) {
+			pixels[(yy * sizeX) + left] = 65000;
+		}
+		if (right >= 0 && right < sizeX) {
+			pixels[(yy * sizeX) + right] = 65000;
 		}
-		//add info to the frame
-		caerFrameEventSetLengthXLengthYChannelNumber(singleplot, sizeX, sizeY, 1, *frame);
-		//validate frame
-		caerFrameEventValidate(singleplot, *frame);
-
-		CAER_POLARITY_ITERATOR_VALID_START(polarity)
-			int x = caerPolarityEventGetX(caerPolarityIteratorElement);
-			int y = caerPolarityEventGetY(caerPolarityIteratorElement);
-			int pol = caerPolarityEventGetPolarity(caerPolarityIteratorElement);
-			int address = y * sizeX + x;
-			if (pol == 0) {
-				singleplot->pixels[address] = 35000;
-			}
-			else {
-				singleplot->pixels[address] = 15000;
-			}
-		CAER_POLARITY_ITERATOR_VALID_END
+	}
+
+	int32_t centerX = (int32_t) state->xmedian;
+	int32_t centerY = (int32_t) state->ymedian;
 
+	if (centerX >= 0 && centerX < sizeX && centerY >= 0 && centerY < sizeY) {
+		pixels[(centerY * sizeX) + centerX] = 65000;
 	}
+
+	// Events on top, by polarity.
+	CAER_POLARITY_ITERATOR_VALID_START(polarity)
+		int x = caerPolarityEventGetX(caerPolarityIteratorElement);
+		int y = caerPolarityEventGetY(caerPolarityIteratorElement);
+		int pol = caerPolarityEventGetPolarity(caerPolarityIteratorElement);
+		int address = y * sizeX + x;
+		if (pol == 0) {
+			pixels[address] = 35000;
+		}
+		else {
+			pixels[address] = 15000;
+		}
+	CAER_POLARITY_ITERATOR_VALID_END
+
+	//add info to the frame
+	caerFrameEventSetLengthXLengthYChannelNumber(singleplot, sizeX, sizeY, 1, framePacket);
+	//validate frame
+	caerFrameEventValidate(singleplot, framePacket);
+
+	return (framePacket);
 }
 
 static void caerMediantrackerConfig(caerModuleData moduleData) {
-	caerModuleConfigUpdateReset(moduleData);
-
 	MTFilterState state = moduleData->moduleState;
-	state->alpha = sshsNodeGetFloat(moduleData->moduleNode, "alpha");
-	state->numStdDevsForBoundingBox = sshsNodeGetFloat(moduleData->moduleNode, "numStdDevsForBoundingBox");
+	state->alpha = sshsNodeAttrHandleGetFloat(state->alphaHandle);
+	state->numStdDevsForBoundingBox = sshsNodeAttrHandleGetFloat(state->numStdDevsForBoundingBoxHandle);
 
 }
 
 static void caerMediantrackerExit(caerModuleData moduleData) {
-	// Remove listener, which can reference invalid memory in userData.
-	sshsNodeRemoveAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+	MTFilterState state = moduleData->moduleState;
 
+	// Ensure histograms are freed.
+	free(state->xhistogram);
+	state->xhistogram = NULL;
+	free(state->yhistogram);
+	state->yhistogram = NULL;
 }
 
 static void caerMediantrackerReset(caerModuleData moduleData, uint16_t resetCallSourceID) {
 	UNUSED_ARGUMENT(resetCallSourceID);
 
+	MTFilterState state = moduleData->moduleState;
+
+	// Timestamps start over, so does the time since the last packet.
+	state->lastts = 0;
+	state->prevlastts = 0;
+	state->dt = 0;
 }
 
@@ -13,6 +13,15 @@
 #include <libcaer/events/polarity.h>
 #include <libcaer/events/frame.h>
 
-void caerMediantrackerFilter(uint16_t moduleID, caerPolarityEventPacket polarity, caerFrameEventPacket frame);
+/**
+ * Track a single object by the median position of the events, with a
+ * bounding box of a configurable number of standard deviations around it.
+ *
+ * @param moduleID the module ID.
+ * @param polarity the polarity events to track.
+ * @param frame returns a rendering of the tracked object, NULL if none.
+ *              Pass NULL to skip rendering altogether. To be freed by the caller.
+ */
+void caerMediantrackerFilter(uint16_t moduleID, caerPolarityEventPacket polarity, caerFrameEventPacket *frame);
 
 #endif /* MEDIANTRACKER_H_ */
@@ -1,6 +1,7 @@
 #include "input_common.h"
 #include "input_visualizer_eventhandler.h"
 #include "base/mainloop.h"
+#include "base/log.h"
 #include "ext/portable_time.h"
 #include "ext/ringbuffer/ringbuffer.h"
 #include "ext/uthash/utarray.h"
@@ -13,6 +14,9 @@
 #ifdef ENABLE_INOUT_PNG_COMPRESSION
 #include <png.h>
 #endif
+#if !defined(OS_WINDOWS)
+#include "modules/misc/inout_shared_memory.h"
+#endif
 
 #include <stdatomic.h>
 #include <libcaer/events/common.h>
@@ -173,6 +177,8 @@ struct input_common_state {
 	struct input_common_packet_container_data packetContainer;
 	/// The file descriptor for reading.
 	int fileDescriptor;
+	/// Shared memory ring to read from instead. NULL if not a shared memory input.
+	struct caer_shared_ring *sharedRing;
 	/// Data buffer for reading from file descriptor (buffered I/O).
 	simpleBuffer dataBuffer;
 	/// Offset for current data buffer.
@@ -203,6 +209,7 @@ static int aedat3GetPacket(inputCommonState state, bool isAEDAT30);
 static void aedat30ChangeOrigin(inputCommonState state, caerEventPacketHeader packet);
 static bool decompressTimestampSerialize(inputCommonState state, caerEventPacketHeader packet, size_t packetSize);
 static bool decompressEventPacket(inputCommonState state, caerEventPacketHeader packet, size_t packetSize);
+static ssize_t readSharedMemory(inputCommonState state);
 static int inputReaderThread(void *stateArg);
 
 static bool addToPacketContainer(inputCommonState state, caerEventPacketHeader newPacket, packetData newPacketData);
@@ -1345,6 +1352,50 @@ static bool decompressEventPacket(inputCommonState state, caerEventPacketHeader
 	return (retVal);
 }
 
+/**
+ * Read from the shared memory ring into the data buffer, waiting for new data
+ * to be available. Readers never hold up the writer: if this reader is too
+ * slow, whole packets are lost and reading continues with the newest ones.
+ *
+ * @param state common input state.
+ *
+ * @return number of bytes read, zero if the writer closed the stream
+ *         or this module is shutting down.
+ */
+static ssize_t readSharedMemory(inputCommonState state) {
+#if !defined(OS_WINDOWS)
+	// If no data is available, sleep for 1 ms to avoid wasting resources in a busy loop.
+	struct timespec noDataSleep = { .tv_sec = 0, .tv_nsec = 1000000 };
+
+	while (atomic_load_explicit(&state->running, memory_order_relaxed)) {
+		uint64_t skipped = state->sharedRing->skipped;
+
+		ssize_t result = caerSharedRingRead(state->sharedRing, state->dataBuffer->buffer,
+			state->dataBuffer->bufferSize);
+
+		if (state->sharedRing->skipped != skipped) {
+			caerLog(CAER_LOG_WARNING, state->parentModule->moduleSubSystemString,
+				"Too slow to keep up with shared memory ring, skipped ahead to newest data (%" PRIu64 " times so far).",
+				state->sharedRing->skipped);
+		}
+
+		if (result < 0) {
+			return (0); // Writer gone, same as EOF.
+		}
+
+		if (result > 0) {
+			return (result);
+		}
+
+		thrd_sleep(&noDataSleep, NULL);
+	}
+#else
+	UNUSED_ARGUMENT(state);
+#endif
+
+	return (0);
+}
+
 static int inputReaderThread(void *stateArg) {
 	inputCommonState state = stateArg;
 
@@ -1372,12 +1423,21 @@ static int inputReaderThread(void *stateArg) {
 			}
 		}
 
-		// Read data from disk or socket.
-		ssize_t result = readUntilDone(state->fileDescriptor, state->dataBuffer->buffer, state->dataBuffer->bufferSize);
+		// Read data from disk, socket or shared memory.
+		ssize_t result;
+		if (state->sharedRing != NULL) {
+			result = readSharedMemory(state);
+		}
+		else {
+			result = readUntilDone(state->fileDescriptor, state->dataBuffer->buffer, state->dataBuffer->bufferSize);
+		}
+
 		if (result <= 0) {
 			// Error or EOF with no data. Let's just stop at this point.
-			close(state->fileDescriptor);
-			state->fileDescriptor = -1;
+			if (state->fileDescriptor >= 0) {
+				close(state->fileDescriptor);
+				state->fileDescriptor = -1;
+			}
 
 			// Distinguish EOF from errors based upon errno value.
 			if (result == 0) {
@@ -1739,8 +1799,10 @@ static void doPacketContainerCommit(inputCommonState state, caerEventPacketConta
 		}
 
 		caerEventPacketContainerFree(packetContainer);
+		atomic_fetch_add_explicit(&state->mainloopReference->dataDropped, 1, memory_order_relaxed);
 
-		caerLog(CAER_LOG_INFO, state->parentModule->moduleSubSystemString,
+		// Overload condition, keep logging cheap here.
+		caerLogRateLimited(CAER_LOG_INFO, state->parentModule->moduleSubSystemString,
 			"Failed to put new packet container on transfer ring-buffer: full.");
 	}
 	else {
@@ -1983,6 +2045,12 @@ static int inputAssemblerThread(void *stateArg) {
 
 static const UT_icd ut_caerEventPacketHeader_icd = { sizeof(caerEventPacketHeader), NULL, NULL, NULL };
 
+void caerInputCommonSetSharedMemory(caerModuleData moduleData, struct caer_shared_ring *sharedRing) {
+	inputCommonState state = moduleData->moduleState;
+
+	state->sharedRing = sharedRing;
+}
+
 bool caerInputCommonInit(caerModuleData moduleData, int readFd, bool isNetworkStream,
 bool isNetworkMessageBased) {
 	inputCommonState state = moduleData->moduleState;
@@ -2157,6 +2225,12 @@ void caerInputCommonExit(caerModuleData moduleData) {
 		close(state->fileDescriptor);
 	}
 
+#if !defined(OS_WINDOWS)
+	if (state->sharedRing != NULL) {
+		caerSharedRingClose(state->sharedRing);
+	}
+#endif
+
 	// Free allocated memory.
 	free(state->dataBuffer);
 
@@ -6,6 +6,11 @@
 
 extern size_t CAER_INPUT_COMMON_STATE_STRUCT_SIZE;
 
+/// Shared memory ring (see modules/misc/inout_shared_memory.h).
+struct caer_shared_ring;
+
+/// Read from a shared memory ring instead of a file descriptor. Input common takes ownership of it.
+void caerInputCommonSetSharedMemory(caerModuleData moduleData, struct caer_shared_ring *sharedRing);
 bool caerInputCommonInit(caerModuleData moduleData, int readFd, bool isNetworkStream,
 bool isNetworkMessageBased);
 void caerInputCommonExit(caerModuleData moduleData);
@@ -0,0 +1,54 @@
+#include "shared_memory.h"
+#include "base/mainloop.h"
+#include "base/module.h"
+#include "input_common.h"
+#include "modules/misc/inout_shared_memory.h"
+
+static bool caerInputSharedMemoryInit(caerModuleData moduleData);
+
+static struct caer_module_functions caerInputSharedMemoryFunctions = { .moduleInit = &caerInputSharedMemoryInit,
+	.moduleRun = &caerInputCommonRun, .moduleConfig = NULL, .moduleExit = &caerInputCommonExit };
+
+caerEventPacketContainer caerInputSharedMemory(uint16_t moduleID) {
+	caerModuleData moduleData = caerMainloopFindModule(moduleID, "SharedMemoryInput", CAER_MODULE_INPUT);
+	if (moduleData == NULL) {
+		return (NULL);
+	}
+
+	caerEventPacketContainer result = NULL;
+
+	caerModuleSM(&caerInputSharedMemoryFunctions, moduleData, CAER_INPUT_COMMON_STATE_STRUCT_SIZE, 1, &result);
+
+	return (result);
+}
+
+static bool caerInputSharedMemoryInit(caerModuleData moduleData) {
+	// First, always create all needed setting nodes, set their default values
+	// and add their listeners.
+	sshsNodePutStringIfAbsent(moduleData->moduleNode, "shmName", "/caer");
+
+	// Map an existing shared memory ring read-only, as created by a SharedMemoryOutput.
+	char *shmName = sshsNodeGetString(moduleData->moduleNode, "shmName");
+
+	caerSharedRing sharedRing = caerSharedRingOpen(shmName);
+	if (sharedRing == NULL) {
+		caerLog(CAER_LOG_CRITICAL, moduleData->moduleSubSystemString,
+			"Could not open shared memory ring '%s'. Error: %d.", shmName, errno);
+		free(shmName);
+		return (false);
+	}
+
+	caerInputCommonSetSharedMemory(moduleData, sharedRing);
+
+	if (!caerInputCommonInit(moduleData, -1, true, false)) {
+		caerSharedRingClose(sharedRing);
+		free(shmName);
+		return (false);
+	}
+
+	caerLog(CAER_LOG_INFO, moduleData->moduleSubSystemString, "Shared memory ring '%s' ready.", shmName);
+
+	free(shmName);
+
+	return (true);
+}
@@ -0,0 +1,427 @@
+#ifndef INPUT_OUTPUT_SHARED_MEMORY_H_
+#define INPUT_OUTPUT_SHARED_MEMORY_H_
+
+#include "modules/misc/inout_common.h"
+
+#include <stdatomic.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Shared memory ring for co-located consumers (POSIX shm, /dev/shm on Linux).
+ *
+ * One writer (SharedMemoryOutput) puts each event packet, already serialized
+ * exactly like on a network stream, into the ring once. Any number of readers
+ * on the same host map the ring read-only and never talk back to the writer,
+ * so the writer never blocks: readers that fall behind by more than the ring
+ * size notice that their data was overwritten and skip ahead to the newest data.
+ *
+ * Layout (all integers little-endian, native on supported platforms):
+ * - header (AEDAT3_SHM_HEADER_LENGTH bytes), see struct aedat3_shm_header.
+ * - data area (dataSize bytes), holding records aligned to 8 bytes. Each
+ *   record is a 4 byte payload size, 4 reserved bytes and the payload (one
+ *   AEDAT 3.X event packet). A size of AEDAT3_SHM_WRAP_MARKER means the rest
+ *   of the data area is unused and the next record starts at its beginning.
+ *
+ * The indexes are byte positions in an infinite stream, the position in the
+ * data area is (index % dataSize). The writer first publishes reserveIndex,
+ * then writes the record, then publishes writeIndex. A reader starts at
+ * writeIndex, copies a record out and then checks reserveIndex: if the writer
+ * could have touched the record meanwhile (reserveIndex > readIndex + dataSize),
+ * the copy is discarded and the reader jumps to writeIndex.
+ */
+#define AEDAT3_SHM_MAGIC_NUMBER AEDAT3_NETWORK_MAGIC_NUMBER
+#define AEDAT3_SHM_VERSION 0x01
+#define AEDAT3_SHM_HEADER_LENGTH 128
+#define AEDAT3_SHM_RECORD_HEADER_LENGTH 8
+#define AEDAT3_SHM_WRAP_MARKER UINT32_MAX
+
+enum aedat3_shm_stream_state {
+	AEDAT3_SHM_WAITING = 0, AEDAT3_SHM_STREAMING = 1, AEDAT3_SHM_CLOSED = 2,
+};
+
+struct aedat3_shm_header {
+	uint64_t magicNumber;
+	uint32_t versionNumber;
+	uint32_t headerSize;
+	uint64_t dataSize;
+	/// AEDAT 3.X network header of the stream, valid once streaming.
+	uint8_t networkHeader[AEDAT3_NETWORK_HEADER_LENGTH];
+	uint8_t reserved0[4];
+	/// Stream state (see aedat3_shm_stream_state).
+	_Atomic uint64_t streamState;
+	/// Everything before this index may be overwritten by the writer.
+	_Atomic uint64_t reserveIndex;
+	/// Everything before this index is complete and can be read.
+	_Atomic uint64_t writeIndex;
+};
+
+struct caer_shared_ring {
+	struct aedat3_shm_header *header;
+	uint8_t *data;
+	size_t mapSize;
+	/// Writer: name to unlink on destruction. Reader: NULL.
+	char *name;
+	/// Writer: next write position, published on commit. Reader: next read position.
+	uint64_t index;
+	/// Reader: staging area for one complete record, and how much of it was already returned.
+	uint8_t *record;
+	size_t recordCapacity;
+	size_t recordSize;
+	size_t recordPosition;
+	/// Reader: stream header was already returned.
+	bool headerRead;
+	/// Reader: how many times data was lost because the reader was too slow.
+	uint64_t skipped;
+};
+
+typedef struct caer_shared_ring *caerSharedRing;
+
+static inline uint64_t caerSharedRingRecordSize(size_t payloadSize) {
+	return ((AEDAT3_SHM_RECORD_HEADER_LENGTH + payloadSize + 7) & ~U64T(7));
+}
+
+/**
+ * Create a new shared memory ring, replacing any stale one with the same name.
+ *
+ * @param name POSIX shared memory object name (must start with '/').
+ * @param dataSize size of the data area in bytes, rounded down to a multiple of 8.
+ *
+ * @return the ring, or NULL on failure (errno is set).
+ */
+static inline caerSharedRing caerSharedRingCreate(const char *name, size_t dataSize) {
+	dataSize &= ~((size_t) 7);
+	if (dataSize < 4096) {
+		errno = EINVAL;
+		return (NULL);
+	}
+
+	caerSharedRing ring = calloc(1, sizeof(*ring));
+	if (ring == NULL) {
+		return (NULL);
+	}
+
+	ring->name = strdup(name);
+	if (ring->name == NULL) {
+		free(ring);
+		return (NULL);
+	}
+
+	// Remove leftovers from a previous run, readers still mapping it keep their copy.
+	shm_unlink(name);
+
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR | S_IRGRP);
+	if (fd < 0) {
+		free(ring->name);
+		free(ring);
+		return (NULL);
+	}
+
+	ring->mapSize = AEDAT3_SHM_HEADER_LENGTH + dataSize;
+
+	if (ftruncate(fd, (off_t) ring->mapSize) != 0) {
+		close(fd);
+		shm_unlink(name);
+		free(ring->name);
+		free(ring);
+		return (NULL);
+	}
+
+	void *map = mmap(NULL, ring->mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd); // Mapping stays valid.
+
+	if (map == MAP_FAILED) {
+		shm_unlink(name);
+		free(ring->name);
+		free(ring);
+		return (NULL);
+	}
+
+	ring->header = map;
+	ring->data = (uint8_t *) map + AEDAT3_SHM_HEADER_LENGTH;
+
+	// Fresh shared memory is zeroed, so all indexes start at zero.
+	ring->header->magicNumber = AEDAT3_SHM_MAGIC_NUMBER;
+	ring->header->versionNumber = AEDAT3_SHM_VERSION;
+	ring->header->headerSize = AEDAT3_SHM_HEADER_LENGTH;
+	ring->header->dataSize = dataSize;
+	atomic_store(&ring->header->streamState, AEDAT3_SHM_WAITING);
+
+	return (ring);
+}
+
+/**
+ * Publish the stream header and start streaming. Readers wait for this.
+ *
+ * @param ring shared memory ring (writer).
+ * @param networkHeader AEDAT 3.X network header, already in little-endian format.
+ */
+static inline void caerSharedRingStart(caerSharedRing ring, const struct aedat3_network_header *networkHeader) {
+	memcpy(ring->header->networkHeader, networkHeader, AEDAT3_NETWORK_HEADER_LENGTH);
+
+	atomic_store_explicit(&ring->header->streamState, AEDAT3_SHM_STREAMING, memory_order_release);
+}
+
+/**
+ * Write one record into the ring. It only becomes visible to readers
+ * on the next caerSharedRingCommit(), so a batch can be committed at once.
+ *
+ * @param ring shared memory ring (writer).
+ * @param payload record data.
+ * @param payloadSize record data size in bytes.
+ *
+ * @return true on success, false if the record can never fit into the ring.
+ */
+static inline bool caerSharedRingWrite(caerSharedRing ring, const uint8_t *payload, size_t payloadSize) {
+	uint64_t dataSize = ring->header->dataSize;
+	uint64_t recordSize = caerSharedRingRecordSize(payloadSize);
+
+	if (recordSize > dataSize || payloadSize >= AEDAT3_SHM_WRAP_MARKER) {
+		return (false);
+	}
+
+	uint64_t offset = ring->index % dataSize;
+	uint64_t padding = (offset + recordSize > dataSize) ? (dataSize - offset) : (0);
+
+	// Announce what is going to be overwritten, before actually doing it.
+	atomic_store_explicit(&ring->header->reserveIndex, ring->index + padding + recordSize, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	if (padding != 0) {
+		// Record doesn't fit at the end, mark the rest as unused and wrap around.
+		uint32_t wrapMarker = AEDAT3_SHM_WRAP_MARKER;
+		memcpy(ring->data + offset, &wrapMarker, sizeof(wrapMarker));
+
+		ring->index += padding;
+		offset = 0;
+	}
+
+	uint32_t recordHeader[2] = { htole32((uint32_t) payloadSize), 0 };
+	memcpy(ring->data + offset, recordHeader, AEDAT3_SHM_RECORD_HEADER_LENGTH);
+	memcpy(ring->data + offset + AEDAT3_SHM_RECORD_HEADER_LENGTH, payload, payloadSize);
+
+	ring->index += recordSize;
+
+	return (true);
+}
+
+/**
+ * Make all records written so far visible to readers.
+ *
+ * @param ring shared memory ring (writer).
+ */
+static inline void caerSharedRingCommit(caerSharedRing ring) {
+	atomic_store_explicit(&ring->header->writeIndex, ring->index, memory_order_release);
+}
+
+/**
+ * Mark the stream as closed, so readers see EOF, and remove the ring.
+ *
+ * @param ring shared memory ring (writer).
+ */
+static inline void caerSharedRingDestroy(caerSharedRing ring) {
+	atomic_store_explicit(&ring->header->streamState, AEDAT3_SHM_CLOSED, memory_order_release);
+
+	munmap(ring->header, ring->mapSize);
+	shm_unlink(ring->name);
+
+	free(ring->name);
+	free(ring);
+}
+
+/**
+ * Open an existing shared memory ring read-only. Reading starts at the
+ * newest data available.
+ *
+ * @param name POSIX shared memory object name (must start with '/').
+ *
+ * @return the ring, or NULL on failure (errno is set, EPROTO for an invalid ring).
+ */
+static inline caerSharedRing caerSharedRingOpen(const char *name) {
+	int fd = shm_open(name, O_RDONLY, 0);
+	if (fd < 0) {
+		return (NULL);
+	}
+
+	struct stat shmStat;
+	if (fstat(fd, &shmStat) != 0) {
+		close(fd);
+		return (NULL);
+	}
+
+	if (shmStat.st_size < AEDAT3_SHM_HEADER_LENGTH) {
+		close(fd);
+		errno = EPROTO;
+		return (NULL);
+	}
+
+	size_t mapSize = (size_t) shmStat.st_size;
+
+	void *map = mmap(NULL, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd); // Mapping stays valid.
+
+	if (map == MAP_FAILED) {
+		return (NULL);
+	}
+
+	struct aedat3_shm_header *header = map;
+
+	if (header->magicNumber != AEDAT3_SHM_MAGIC_NUMBER || header->versionNumber != AEDAT3_SHM_VERSION
+		|| header->headerSize != AEDAT3_SHM_HEADER_LENGTH || header->dataSize == 0
+		|| (header->headerSize + header->dataSize) > mapSize) {
+		munmap(map, mapSize);
+		errno = EPROTO;
+		return (NULL);
+	}
+
+	caerSharedRing ring = calloc(1, sizeof(*ring));
+	if (ring == NULL) {
+		munmap(map, mapSize);
+		return (NULL);
+	}
+
+	ring->header = header;
+	ring->data = (uint8_t *) map + header->headerSize;
+	ring->mapSize = mapSize;
+	ring->index = atomic_load_explicit(&header->writeIndex, memory_order_acquire);
+
+	return (ring);
+}
+
+/**
+ * Copy out the next complete record into the reader's staging area.
+ *
+ * @param ring shared memory ring (reader).
+ *
+ * @return true if a record was staged, false if there is no new data.
+ */
+static inline bool caerSharedRingStageRecord(caerSharedRing ring) {
+	uint64_t dataSize = ring->header->dataSize;
+
+	while (true) {
+		uint64_t writeIndex = atomic_load_explicit(&ring->header->writeIndex, memory_order_acquire);
+
+		if (ring->index == writeIndex) {
+			return (false);
+		}
+
+		if ((writeIndex - ring->index) > dataSize) {
+			// Overwritten already, skip ahead to newest data.
+			ring->index = writeIndex;
+			ring->skipped++;
+			continue;
+		}
+
+		uint64_t offset = ring->index % dataSize;
+
+		uint32_t recordHeader[2];
+		memcpy(recordHeader, ring->data + offset, AEDAT3_SHM_RECORD_HEADER_LENGTH);
+
+		uint32_t payloadSize = le32toh(recordHeader[0]);
+		bool wrap = (payloadSize == AEDAT3_SHM_WRAP_MARKER);
+		bool valid = wrap || (offset + caerSharedRingRecordSize(payloadSize) <= dataSize);
+
+		if (valid && !wrap) {
+			if (payloadSize > ring->recordCapacity) {
+				uint8_t *newRecord = realloc(ring->record, payloadSize);
+				if (newRecord == NULL) {
+					return (false);
+				}
+
+				ring->record = newRecord;
+				ring->recordCapacity = payloadSize;
+			}
+
+			memcpy(ring->record, ring->data + offset + AEDAT3_SHM_RECORD_HEADER_LENGTH, payloadSize);
+		}
+
+		// Check nothing we just copied could have been overwritten meanwhile.
+		atomic_thread_fence(memory_order_acquire);
+		uint64_t reserveIndex = atomic_load_explicit(&ring->header->reserveIndex, memory_order_relaxed);
+
+		if (!valid || reserveIndex > (ring->index + dataSize)) {
+			ring->index = atomic_load_explicit(&ring->header->writeIndex, memory_order_acquire);
+			ring->skipped++;
+			continue;
+		}
+
+		if (wrap) {
+			ring->index += dataSize - offset;
+			continue;
+		}
+
+		ring->index += caerSharedRingRecordSize(payloadSize);
+		ring->recordSize = payloadSize;
+		ring->recordPosition = 0;
+
+		return (true);
+	}
+}
+
+/**
+ * Read from the shared memory ring, as if it was a network stream: first the
+ * AEDAT 3.X network header, then complete event packets. Data lost due to the
+ * reader being too slow is always whole packets (see 'skipped').
+ *
+ * @param ring shared memory ring (reader).
+ * @param buffer buffer to fill.
+ * @param bufferSize buffer size, at least AEDAT3_NETWORK_HEADER_LENGTH.
+ *
+ * @return number of bytes read, zero if no new data is available yet,
+ *         -1 if the writer closed the stream.
+ */
+static inline ssize_t caerSharedRingRead(caerSharedRing ring, uint8_t *buffer, size_t bufferSize) {
+	uint64_t streamState = atomic_load_explicit(&ring->header->streamState, memory_order_acquire);
+
+	if (streamState == AEDAT3_SHM_CLOSED) {
+		return (-1);
+	}
+
+	if (!ring->headerRead) {
+		if (streamState != AEDAT3_SHM_STREAMING) {
+			return (0);
+		}
+
+		memcpy(buffer, ring->header->networkHeader, AEDAT3_NETWORK_HEADER_LENGTH);
+		ring->headerRead = true;
+
+		return (AEDAT3_NETWORK_HEADER_LENGTH);
+	}
+
+	size_t bytesRead = 0;
+
+	while (bytesRead < bufferSize) {
+		if (ring->recordPosition == ring->recordSize && !caerSharedRingStageRecord(ring)) {
+			break;
+		}
+
+		size_t copySize = ring->recordSize - ring->recordPosition;
+		if (copySize > (bufferSize - bytesRead)) {
+			copySize = bufferSize - bytesRead;
+		}
+
+		memcpy(buffer + bytesRead, ring->record + ring->recordPosition, copySize);
+
+		ring->recordPosition += copySize;
+		bytesRead += copySize;
+	}
+
+	return ((ssize_t) bytesRead);
+}
+
+/**
+ * Unmap a shared memory ring opened for reading.
+ *
+ * @param ring shared memory ring (reader).
+ */
+static inline void caerSharedRingClose(caerSharedRing ring) {
+	munmap(ring->header, ring->mapSize);
+
+	free(ring->record);
+	free(ring);
+}
+
+#endif /* INPUT_OUTPUT_SHARED_MEMORY_H_ */
@@ -31,6 +31,8 @@ void caerOutputFile(uint16_t moduleID, size_t outputTypesNumber, ...) {
 
 static char *getUserHomeDirectory(const char *subSystemString);
 static char *getFullFilePath(const char *subSystemString, const char *directory, const char *prefix);
+static int openOutputFile(caerModuleData moduleData, int extraFlags);
+static int openNextOutputFile(caerModuleData moduleData);
 
 // Remember to free strings returned by this.
 static char *getUserHomeDirectory(const char *subSystemString) {
@@ -112,6 +114,25 @@ static bool caerOutputFileInit(caerModuleData moduleData) {
 	sshsNodePutStringIfAbsent(moduleData->moduleNode, "prefix", DEFAULT_PREFIX);
 
 	// Generate current file name and open it.
+	int fileFd = openOutputFile(moduleData, 0);
+	if (fileFd < 0) {
+		// caerLog() called inside openOutputFile().
+		return (false);
+	}
+
+	// Support seamless rotation to new files (by size or time).
+	caerOutputCommonSetFileRotation(moduleData, &openNextOutputFile);
+
+	if (!caerOutputCommonInit(moduleData, fileFd, NULL)) {
+		close(fileFd);
+
+		return (false);
+	}
+
+	return (true);
+}
+
+static int openOutputFile(caerModuleData moduleData, int extraFlags) {
 	char *directory = sshsNodeGetString(moduleData->moduleNode, "directory");
 	char *prefix = sshsNodeGetString(moduleData->moduleNode, "prefix");
 
@@ -121,27 +142,27 @@ static bool caerOutputFileInit(caerModuleData moduleData) {
 
 	if (filePath == NULL) {
 		// caerLog() called inside getFullFilePath().
-		return (false);
+		return (-1);
 	}
 
-	int fileFd = open(filePath, O_WRONLY | O_CREAT, S_IWUSR | S_IRUSR | S_IRGRP);
+	int fileFd = open(filePath, O_WRONLY | O_CREAT | extraFlags, S_IWUSR | S_IRUSR | S_IRGRP);
 	if (fileFd < 0) {
 		caerLog(CAER_LOG_CRITICAL, moduleData->moduleSubSystemString,
 			"Could not create or open output file '%s' for writing. Error: %d.", filePath, errno);
 		free(filePath);
 
-		return (false);
+		return (-1);
 	}
 
 	caerLog(CAER_LOG_INFO, moduleData->moduleSubSystemString, "Opened output file '%s' successfully for writing.",
 		filePath);
 	free(filePath);
 
-	if (!caerOutputCommonInit(moduleData, fileFd, NULL)) {
-		close(fileFd);
-
-		return (false);
-	}
+	return (fileFd);
+}
 
-	return (true);
+static int openNextOutputFile(caerModuleData moduleData) {
+	// Called from the output compressor thread on rotation. Never reuse
+	// an existing file, as it would get overwritten from the start.
+	return (openOutputFile(moduleData, O_EXCL));
 }
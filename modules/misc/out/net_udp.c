@@ -4,11 +4,17 @@
 #include "output_common.h"
 
 static bool caerOutputNetUDPInit(caerModuleData moduleData);
+static bool caerOutputNetUDPMulticastInit(caerModuleData moduleData);
+static bool caerOutputNetUDPStart(caerModuleData moduleData, const char *ipAddress, bool multicast);
 
 static struct caer_module_functions caerOutputNetUDPFunctions = { .moduleInit = &caerOutputNetUDPInit, .moduleRun =
 	&caerOutputCommonRun, .moduleConfig = NULL, .moduleExit = &caerOutputCommonExit, .moduleReset =
 	&caerOutputCommonReset };
 
+static struct caer_module_functions caerOutputNetUDPMulticastFunctions = { .moduleInit =
+	&caerOutputNetUDPMulticastInit, .moduleRun = &caerOutputCommonRun, .moduleConfig = NULL, .moduleExit =
+	&caerOutputCommonExit, .moduleReset = &caerOutputCommonReset };
+
 void caerOutputNetUDP(uint16_t moduleID, size_t outputTypesNumber, ...) {
 	caerModuleData moduleData = caerMainloopFindModule(moduleID, "NetUDPOutput", CAER_MODULE_OUTPUT);
 	if (moduleData == NULL) {
@@ -22,21 +28,68 @@ void caerOutputNetUDP(uint16_t moduleID, size_t outputTypesNumber, ...) {
 	va_end(args);
 }
 
+void caerOutputNetUDPMulticast(uint16_t moduleID, size_t outputTypesNumber, ...) {
+	caerModuleData moduleData = caerMainloopFindModule(moduleID, "NetUDPMulticastOutput", CAER_MODULE_OUTPUT);
+	if (moduleData == NULL) {
+		return;
+	}
+
+	va_list args;
+	va_start(args, outputTypesNumber);
+	caerModuleSMv(&caerOutputNetUDPMulticastFunctions, moduleData, CAER_OUTPUT_COMMON_STATE_STRUCT_SIZE,
+		outputTypesNumber, args);
+	va_end(args);
+}
+
 static bool caerOutputNetUDPInit(caerModuleData moduleData) {
 	// First, always create all needed setting nodes, set their default values
 	// and add their listeners.
 	sshsNodePutStringIfAbsent(moduleData->moduleNode, "ipAddress", "127.0.0.1");
 	sshsNodePutIntIfAbsent(moduleData->moduleNode, "portNumber", 6666);
 
+	char *ipAddress = sshsNodeGetString(moduleData->moduleNode, "ipAddress");
+
+	bool retVal = caerOutputNetUDPStart(moduleData, ipAddress, false);
+
+	free(ipAddress);
+
+	return (retVal);
+}
+
+static bool caerOutputNetUDPMulticastInit(caerModuleData moduleData) {
+	// First, always create all needed setting nodes, set their default values
+	// and add their listeners.
+	// One send reaches all subscribers of the group, so additional consumers are free.
+	sshsNodePutStringIfAbsent(moduleData->moduleNode, "groupAddress", "239.255.66.66"); // organization-local scope
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "portNumber", 6666);
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "ttl", 1); // 1 = local network only, increase to cross routers
+	sshsNodePutStringIfAbsent(moduleData->moduleNode, "interfaceAddress", ""); // IPv4 address of interface to send on, empty for system default
+	sshsNodePutBoolIfAbsent(moduleData->moduleNode, "loopback", true); // also deliver to subscribers on this host
+
+	char *groupAddress = sshsNodeGetString(moduleData->moduleNode, "groupAddress");
+
+	bool retVal = caerOutputNetUDPStart(moduleData, groupAddress, true);
+
+	free(groupAddress);
+
+	return (retVal);
+}
+
+static bool caerOutputNetUDPStart(caerModuleData moduleData, const char *ipAddress, bool multicast) {
 	int retVal;
 
 	// Generate address.
 	struct sockaddr_in serverAddress;
 
-	char *ipAddress = sshsNodeGetString(moduleData->moduleNode, "ipAddress");
 	retVal = uv_ip4_addr(ipAddress, sshsNodeGetInt(moduleData->moduleNode, "portNumber"), &serverAddress);
-	UV_RET_CHECK(retVal, moduleData->moduleSubSystemString, "uv_ip4_addr", free(ipAddress); return (false));
-	free(ipAddress);
+	UV_RET_CHECK(retVal, moduleData->moduleSubSystemString, "uv_ip4_addr", return (false));
+
+	// Multicast groups are 224.0.0.0/4.
+	if (multicast && (ntohl(serverAddress.sin_addr.s_addr) & 0xF0000000) != 0xE0000000) {
+		caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "'%s' is not a multicast group address.",
+			ipAddress);
+		return (false);
+	}
 
 	// Allocate memory.
 	size_t numClients = 1;
@@ -85,11 +138,40 @@ static bool caerOutputNetUDPInit(caerModuleData moduleData) {
 	// Initialize loop and network handles.
 	retVal = uv_loop_init(&streams->loop);
 	UV_RET_CHECK(retVal, moduleData->moduleSubSystemString, "uv_loop_init",
-		free(udp); free(streams->address); free(streams));
+		free(udp); free(streams->address); free(streams); return (false));
 
 	retVal = uv_udp_init(&streams->loop, udp);
 	UV_RET_CHECK(retVal, moduleData->moduleSubSystemString, "uv_udp_init",
-		uv_loop_close(&streams->loop); free(udp); free(streams->address); free(streams));
+		uv_loop_close(&streams->loop); free(udp); free(streams->address); free(streams); return (false));
+
+	if (multicast) {
+		// Multicast options need the socket, so bind it now (any interface, any port),
+		// instead of letting the first send do it implicitly.
+		struct sockaddr_in anyAddress;
+		uv_ip4_addr("0.0.0.0", 0, &anyAddress);
+
+		retVal = uv_udp_bind(udp, (const struct sockaddr *) &anyAddress, 0);
+		UV_RET_CHECK(retVal, moduleData->moduleSubSystemString, "uv_udp_bind",
+			libuvCloseLoopHandles(&streams->loop); uv_loop_close(&streams->loop); free(streams->address); free(streams); return (false));
+
+		retVal = uv_udp_set_multicast_ttl(udp, sshsNodeGetInt(moduleData->moduleNode, "ttl"));
+		UV_RET_CHECK(retVal, moduleData->moduleSubSystemString, "uv_udp_set_multicast_ttl",
+			libuvCloseLoopHandles(&streams->loop); uv_loop_close(&streams->loop); free(streams->address); free(streams); return (false));
+
+		retVal = uv_udp_set_multicast_loop(udp, sshsNodeGetBool(moduleData->moduleNode, "loopback"));
+		UV_RET_CHECK(retVal, moduleData->moduleSubSystemString, "uv_udp_set_multicast_loop",
+			libuvCloseLoopHandles(&streams->loop); uv_loop_close(&streams->loop); free(streams->address); free(streams); return (false));
+
+		char *interfaceAddress = sshsNodeGetString(moduleData->moduleNode, "interfaceAddress");
+
+		if (!caerStrEquals(interfaceAddress, "")) {
+			retVal = uv_udp_set_multicast_interface(udp, interfaceAddress);
+			UV_RET_CHECK(retVal, moduleData->moduleSubSystemString, "uv_udp_set_multicast_interface",
+				free(interfaceAddress); libuvCloseLoopHandles(&streams->loop); uv_loop_close(&streams->loop); free(streams->address); free(streams); return (false));
+		}
+
+		free(interfaceAddress);
+	}
 
 	// Start.
 	if (!caerOutputCommonInit(moduleData, -1, streams)) {
@@ -101,5 +183,10 @@ static bool caerOutputNetUDPInit(caerModuleData moduleData) {
 		return (false);
 	}
 
+	if (multicast) {
+		caerLog(CAER_LOG_INFO, moduleData->moduleSubSystemString, "Sending to multicast group %s:%d.", ipAddress,
+			sshsNodeGetInt(moduleData->moduleNode, "portNumber"));
+	}
+
 	return (true);
 }
@@ -4,5 +4,6 @@
 #include "main.h"
 
 void caerOutputNetUDP(uint16_t moduleID, size_t outputTypesNumber, ...);
+void caerOutputNetUDPMulticast(uint16_t moduleID, size_t outputTypesNumber, ...);
 
 #endif /* OUTPUT_NET_UDP_H_ */
@@ -66,12 +66,19 @@
  * a sane restriction to impose anyway.
  */
 
+#if defined(OS_LINUX)
+// sendmmsg() and struct mmsghdr, for the batched UDP fast path.
+#define _GNU_SOURCE 1
+#endif
+
 #include "output_common.h"
 #include "base/mainloop.h"
+#include "base/log.h"
 #include "ext/portable_misc.h"
 #include "ext/ringbuffer/ringbuffer.h"
 #include "ext/buffers.h"
 #include "ext/nets.h"
+#include "ext/portable_time.h"
 #ifdef HAVE_PTHREADS
 #include "ext/c11threads_posix.h"
 #endif
@@ -80,6 +87,15 @@
 #endif
 
 #include <stdatomic.h>
+#if !defined(OS_WINDOWS)
+#include "modules/misc/inout_shared_memory.h"
+#endif
+#if defined(OS_LINUX)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <errno.h>
+#endif
 #include <libcaer/events/common.h>
 #include <libcaer/events/packetContainer.h>
 #include <libcaer/events/frame.h>
@@ -93,6 +109,44 @@ struct output_common_statistics {
 	uint64_t dataWritten;
 };
 
+enum output_common_slow_client_policy {
+	SLOW_CLIENT_DROP_NEWEST = 0, SLOW_CLIENT_DROP_OLDEST = 1, SLOW_CLIENT_DISCONNECT = 2,
+};
+
+struct output_common_client_queue {
+	/// Write batches waiting to be sent to this client, oldest first (circular).
+	libuvWriteMultiBuf pending[MAX_OUTPUT_CLIENT_QUEUE_LENGTH];
+	size_t pendingSize[MAX_OUTPUT_CLIENT_QUEUE_LENGTH];
+	uint64_t pendingTime[MAX_OUTPUT_CLIENT_QUEUE_LENGTH];
+	size_t pendingHead;
+	size_t pendingCount;
+	size_t pendingBytes;
+	/// Only one write at a time is in flight to the client.
+	bool writeActive;
+	size_t writeActiveSize;
+	uint64_t writeActiveTime;
+	/// Client statistics, published to SSHS.
+	uint64_t droppedBuffers;
+	uint64_t droppedBytes;
+	char address[64];
+};
+
+struct output_common_pretrigger {
+	/// Compressed packets kept in memory, oldest first (circular, grows as needed).
+	libuvWriteBuf *buffers;
+	/// Arrival time of each packet (monotonic, in µs).
+	uint64_t *times;
+	size_t capacity;
+	size_t head;
+	size_t count;
+	size_t bytes;
+	/// Currently writing to file, until recordingEnd (monotonic, in µs).
+	bool recording;
+	uint64_t recordingEnd;
+	/// Number of triggered recordings so far, the first one goes into the initial file.
+	size_t recordings;
+};
+
 struct output_common_state {
 	/// Control flag for output handling thread.
 	atomic_bool running;
@@ -111,10 +165,45 @@ struct output_common_state {
 	sshsNode sourceInfoNode;
 	/// The file descriptor for file writing.
 	int fileIO;
+	/// Open next file for rotation. NULL if rotation is not supported (network).
+	outputCommonFileOpen fileOpen;
+	/// Rotate to a new file after this many MiB were written to the current one (0 = never).
+	atomic_int_fast32_t rotateMaxSize;
+	/// Rotate to a new file after this many minutes of writing to the current one (0 = never).
+	atomic_int_fast32_t rotateMaxTime;
+	/// Bytes sent to the current file, tracked by the compressor thread for rotation.
+	uint64_t fileBytesSent;
+	/// Monotonic time when the current file was started, for rotation.
+	struct timespec fileStartTime;
+	/// Pre-trigger recording: keep recent data in memory, only write it out
+	/// around triggers (file outputs only, fixed at init time).
+	bool preTriggerMode;
+	/// Trigger requested (SSHS 'trigger' or external input event), consumed by output thread.
+	atomic_bool triggerPending;
+	/// Trigger on external input special events (rising edge, pulse).
+	atomic_bool triggerOnExternalInput;
+	/// Keep this much data from before a trigger, in ms, but at most preTriggerMaxSize MiB.
+	atomic_int_fast32_t preTriggerTime;
+	atomic_int_fast32_t preTriggerMaxSize;
+	/// Continue writing this long after the last trigger, in ms.
+	atomic_int_fast32_t postTriggerTime;
+	/// Pre-trigger buffer and recording state, output thread only.
+	struct output_common_pretrigger preTrigger;
+	/// UDP fast path: socket probed for GSO support, and result of that probe.
+	bool udpGSOProbed;
+	bool udpGSO;
 	/// Network-like stream or file-like stream. Matters for header format.
 	bool isNetworkStream;
+	/// Shared memory ring for co-located readers. NULL if not a shared memory output.
+	struct caer_shared_ring *sharedRing;
 	/// The libuv stream descriptors for network writing and server mode.
 	outputCommonNetIO networkIO;
+	/// What to do with stream clients that can't keep up (see output_common_slow_client_policy).
+	atomic_int_fast32_t slowClientPolicy;
+	/// Maximum data queued per stream client, in KiB.
+	atomic_int_fast32_t clientQueueSize;
+	/// Lag after which slow stream clients are disconnected, in ms (disconnect policy only).
+	atomic_int_fast32_t clientMaxLag;
 	/// Filter out invalidated events or not.
 	atomic_bool validOnly;
 	/// Force all incoming packets to be committed to the transfer ring-buffer.
@@ -139,6 +228,28 @@ struct output_common_state {
 
 typedef struct output_common_state *outputCommonState;
 
+#if defined(OS_LINUX)
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103 // Linux 4.18+ UDP generic segmentation offload (GSO).
+#endif
+
+#define MAX_OUTPUT_UDP_MMSG 64 // messages per sendmmsg() call
+#define MAX_OUTPUT_UDP_DATAGRAMS 256 // datagrams (header + data) per sendmmsg() call
+#define MAX_OUTPUT_UDP_GSO_SEGMENTS 32 // datagrams per GSO message (kernel limits: 64 segments, 64KB)
+
+struct output_common_udp_batch {
+	struct mmsghdr messages[MAX_OUTPUT_UDP_MMSG];
+	struct iovec iov[MAX_OUTPUT_UDP_DATAGRAMS * 2];
+	uint8_t headers[MAX_OUTPUT_UDP_DATAGRAMS][AEDAT3_NETWORK_HEADER_LENGTH];
+	size_t messagesSize;
+	size_t datagramsSize;
+	size_t messageSegments;
+};
+#endif
+
 size_t CAER_OUTPUT_COMMON_STATE_STRUCT_SIZE = sizeof(struct output_common_state);
 
 static void caerOutputCommonConfigListener(sshsNode node, void *userData, enum sshs_node_attribute_events event,
@@ -285,7 +396,7 @@ static void copyPacketsToTransferRing(outputCommonState state, size_t packetsLis
 	for (size_t i = 0; i < packetsSize; i++) {
 		if ((validOnly && (caerEventPacketHeaderGetEventValid(packets[i]) == 0))
 			|| (!validOnly && (caerEventPacketHeaderGetEventNumber(packets[i]) == 0))) {
-			caerLog(CAER_LOG_NOTICE, state->parentModule->moduleSubSystemString,
+			caerLogRateLimited(CAER_LOG_NOTICE, state->parentModule->moduleSubSystemString,
 				"Submitted empty event packet to output. Ignoring empty event packet.");
 			continue;
 		}
@@ -361,8 +472,10 @@ static void copyPacketsToTransferRing(outputCommonState state, size_t packetsLis
 		}
 
 		caerEventPacketContainerFree(eventPackets);
+		atomic_fetch_add_explicit(&caerMainloopGetReference()->dataDropped, 1, memory_order_relaxed);
 
-		caerLog(CAER_LOG_INFO, state->parentModule->moduleSubSystemString,
+		// Overload condition, keep logging cheap here.
+		caerLogRateLimited(CAER_LOG_INFO, state->parentModule->moduleSubSystemString,
 			"Failed to put packet's array copy on transfer ring-buffer: full.");
 	}
 }
@@ -382,6 +495,9 @@ static int packetsFirstTimestampThenTypeCmp(const void *a, const void *b);
 static void sendEventPacket(outputCommonState state, caerEventPacketHeader packet);
 static size_t compressEventPacket(outputCommonState state, caerEventPacketHeader packet, size_t packetSize);
 static size_t compressTimestampSerialize(outputCommonState state, caerEventPacketHeader packet);
+static void checkFileRotation(outputCommonState state);
+static void checkExternalInputTrigger(outputCommonState state, caerSpecialEventPacket packet);
+static void writeFileHeader(outputCommonState state, int fileDescriptor);
 
 #ifdef ENABLE_INOUT_PNG_COMPRESSION
 static void caerLibPNGWriteBuffer(png_structp png_ptr, png_bytep data, png_size_t length);
@@ -417,6 +533,9 @@ static int compressorThread(void *stateArg) {
 		// comes first. If equal, order by increasing type ID as a convenience,
 		// not strictly required by specification!
 		orderAndSendEventPackets(state, currPacketContainer);
+
+		// Packet container boundary, the only valid place to switch to a new file.
+		checkFileRotation(state);
 	}
 
 	// Handle shutdown, write out all content remaining in the transfer ring-buffer.
@@ -436,8 +555,16 @@ static void orderAndSendEventPackets(outputCommonState state, caerEventPacketCon
 		&packetsFirstTimestampThenTypeCmp);
 
 	for (size_t cpIdx = 0; cpIdx < currPacketContainerSize; cpIdx++) {
+		caerEventPacketHeader packet = caerEventPacketContainerGetEventPacket(currPacketContainer, (int32_t) cpIdx);
+
+		// Look for trigger events before compression.
+		if (state->preTriggerMode && caerEventPacketHeaderGetEventType(packet) == SPECIAL_EVENT
+			&& atomic_load_explicit(&state->triggerOnExternalInput, memory_order_relaxed)) {
+			checkExternalInputTrigger(state, (caerSpecialEventPacket) packet);
+		}
+
 		// Send the packets out to the file descriptor.
-		sendEventPacket(state, caerEventPacketContainerGetEventPacket(currPacketContainer, (int32_t) cpIdx));
+		sendEventPacket(state, packet);
 	}
 
 	// Free packet container. The individual packets have already been either
@@ -494,6 +621,7 @@ static void sendEventPacket(outputCommonState state, caerEventPacketHeader packe
 
 	// Statistics support (after compression).
 	state->statistics.dataWritten += packetSize;
+	state->fileBytesSent += packetSize;
 
 	// Send compressed packet out to output handling thread.
 	// Already format it as a libuv buffer.
@@ -522,6 +650,117 @@ static void sendEventPacket(outputCommonState state, caerEventPacketHeader packe
 	}
 }
 
+/**
+ * Check if the current output file has reached its maximum size or duration,
+ * and if so, open the next one and write its header right here, so the output
+ * thread is never blocked by it. The new file descriptor is then handed over
+ * to the output thread with a rotation marker on the output ring-buffer, which
+ * keeps the switch-over in order with the packets, right at the packet container
+ * boundary, so that each file is complete and valid on its own.
+ *
+ * @param state common output state.
+ */
+static void checkFileRotation(outputCommonState state) {
+	// Pre-trigger mode starts a new file for each recording by itself.
+	if (state->fileOpen == NULL || state->preTriggerMode) {
+		return;
+	}
+
+	int32_t rotateMaxSizeMiB = I32T(atomic_load_explicit(&state->rotateMaxSize, memory_order_relaxed));
+	int32_t rotateMaxTimeMin = I32T(atomic_load_explicit(&state->rotateMaxTime, memory_order_relaxed));
+
+	// Zero (or negative) disables the respective threshold.
+	uint64_t rotateMaxSize = (rotateMaxSizeMiB > 0) ? (U64T(rotateMaxSizeMiB) * 1024 * 1024) : (0);
+	int64_t rotateMaxTime = (rotateMaxTimeMin > 0) ? (I64T(rotateMaxTimeMin) * 60) : (0);
+
+	if (rotateMaxSize == 0 && rotateMaxTime == 0) {
+		return;
+	}
+
+	struct timespec currentTime;
+	portable_clock_gettime_monotonic(&currentTime);
+
+	int64_t fileDuration = I64T(currentTime.tv_sec - state->fileStartTime.tv_sec);
+
+	// Never rotate more than once per second, file names have second resolution.
+	if (fileDuration < 1) {
+		return;
+	}
+
+	if ((rotateMaxSize == 0 || state->fileBytesSent < rotateMaxSize)
+		&& (rotateMaxTime == 0 || fileDuration < rotateMaxTime)) {
+		return;
+	}
+
+	// Start counting for the next file now, also on failure, so that a failed
+	// rotation is only retried after another full size/time period.
+	state->fileBytesSent = 0;
+	state->fileStartTime = currentTime;
+
+	int nextFileIO = (*state->fileOpen)(state->parentModule);
+	if (nextFileIO < 0) {
+		caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString,
+			"Failed to open next output file for rotation, continuing with current one.");
+		return;
+	}
+
+	writeFileHeader(state, nextFileIO);
+
+	// Rotation marker: zero-length buffer, holding the next file descriptor.
+	libuvWriteBuf rotationMarker = malloc(sizeof(*rotationMarker));
+	int *rotationFileIO = malloc(sizeof(*rotationFileIO));
+	if (rotationMarker == NULL || rotationFileIO == NULL) {
+		free(rotationMarker);
+		free(rotationFileIO);
+		close(nextFileIO);
+
+		caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString,
+			"Failed to allocate memory for file rotation, continuing with current one.");
+		return;
+	}
+
+	*rotationFileIO = nextFileIO;
+
+	rotationMarker->buf.base = NULL;
+	rotationMarker->buf.len = 0;
+	rotationMarker->freeBuf = rotationFileIO;
+
+	// Put rotation marker onto output ring-buffer. Retry until successful.
+	while (!ringBufferPut(state->outputRing, rotationMarker)) {
+		// If the output thread failed, we'd forever block here, if it can't accept
+		// any more data. So we detect that condition and give up on rotation.
+		if (atomic_load_explicit(&state->outputThreadFailure, memory_order_relaxed)) {
+			free(rotationMarker);
+			free(rotationFileIO);
+			close(nextFileIO);
+			return;
+		}
+
+		// Delay by 500 µs if no change, to avoid a wasteful busy loop.
+		struct timespec retrySleep = { .tv_sec = 0, .tv_nsec = 500000 };
+		thrd_sleep(&retrySleep, NULL);
+	}
+}
+
+/**
+ * Look for an external input trigger (rising edge or pulse) in a special events
+ * packet, and if one is found, flag it for the output thread, which then starts
+ * a new recording in pre-trigger mode.
+ *
+ * @param state common output state.
+ * @param packet special events packet to scan.
+ */
+static void checkExternalInputTrigger(outputCommonState state, caerSpecialEventPacket packet) {
+	CAER_SPECIAL_ITERATOR_VALID_START(packet)
+		enum caer_special_event_types type = caerSpecialEventGetType(caerSpecialIteratorElement);
+
+		if (type == EXTERNAL_INPUT_RISING_EDGE || type == EXTERNAL_INPUT_PULSE) {
+			atomic_store(&state->triggerPending, true);
+			return;
+		}
+	CAER_SPECIAL_ITERATOR_VALID_END
+}
+
 /**
  * Compress event packets.
  * Compressed event packets have the highest bit of the type field
@@ -863,10 +1102,39 @@ static void libuvRingBufferGet(uv_idle_t *handle);
 static void libuvAsyncShutdown(uv_async_t *handle);
 static void libuvClientShutdown(uv_shutdown_t *clientShutdown, int status);
 static void libuvWriteStatusCheck(uv_handle_t *handle, int status);
-static void writePacket(outputCommonState state, libuvWriteBuf packetBuffer);
-static void initializeNetworkHeader(outputCommonState state);
+static size_t getPacketBatch(outputCommonState state, libuvWriteBuf *packetBuffers);
+static void freePacketBatch(libuvWriteBuf *packetBuffers, size_t packetBuffersSize);
+static void writePacketBatchToFile(outputCommonState state, libuvWriteBuf *packetBuffers, size_t packetBuffersSize);
+static void writePacketBatchTriggered(outputCommonState state, libuvWriteBuf *packetBuffers, size_t packetBuffersSize);
+static void startTriggeredRecording(outputCommonState state);
+static void preTriggerPush(outputCommonState state, libuvWriteBuf packetBuffer, uint64_t currentTime);
+static void preTriggerWrite(outputCommonState state);
+static void preTriggerClear(outputCommonState state);
+static void writePacketBatchToSharedMemory(outputCommonState state, libuvWriteBuf *packetBuffers,
+	size_t packetBuffersSize);
+static void startSharedMemoryStream(outputCommonState state);
+static void writePacketBatch(outputCommonState state, libuvWriteBuf *packetBuffers, size_t packetBuffersSize);
+static void writePacketBatchUDP(outputCommonState state, libuvWriteBuf *packetBuffers, size_t packetBuffersSize);
+static void writePacketUDP(outputCommonState state, libuvWriteBuf packetBuffer);
+static bool writeDatagramUDP(outputCommonState state, const uint8_t *header, const uint8_t *data, size_t dataSize);
+#if defined(OS_LINUX)
+static void udpBatchAdd(outputCommonState state, struct output_common_udp_batch *batch, const uint8_t *data,
+	size_t dataSize, bool firstChunk);
+static void udpBatchSend(outputCommonState state, struct output_common_udp_batch *batch, int udpSocket);
+#endif
+static void clientQueueInit(outputCommonNetIO streams, size_t idx, uv_stream_t *client);
+static void clientQueueClear(outputCommonNetIO streams, size_t idx);
+static void clientQueuePush(outputCommonState state, size_t idx, libuvWriteMultiBuf buffers, size_t buffersSize);
+static void clientQueueWrite(outputCommonNetIO streams, size_t idx);
+static void clientQueueFlush(outputCommonNetIO streams, size_t idx);
+static uint64_t clientQueueLag(outputCommonNetIO streams, size_t idx);
+static void clientDisconnect(outputCommonNetIO streams, size_t idx);
+static void libuvClientQueueWriteDone(uv_handle_t *handle, int status);
+static void libuvClientStatistics(uv_timer_t *handle);
+static enum output_common_slow_client_policy parseSlowClientPolicy(const char *policy);
+static void initializeNetworkHeader(outputCommonState state, struct aedat3_network_header *networkHeader);
 static bool writeNetworkHeader(outputCommonNetIO streams, libuvWriteBuf buf, bool startOfUDPPacket);
-static void writeFileHeader(outputCommonState state);
+static void fillNetworkHeader(outputCommonNetIO streams, uint8_t *headerBuffer, bool startOfUDPPacket);
 
 static inline _Noreturn void errorExit(outputCommonState state, libuvWriteBuf packetBuffer) {
 	// Free currently held memory.
@@ -909,11 +1177,14 @@ static int outputThread(void *stateArg) {
 		}
 
 		// Send appropriate header.
-		if (state->isNetworkStream) {
-			initializeNetworkHeader(state);
+		if (state->sharedRing != NULL) {
+			startSharedMemoryStream(state);
+		}
+		else if (state->isNetworkStream) {
+			initializeNetworkHeader(state, &state->networkIO->networkHeader);
 		}
 		else {
-			writeFileHeader(state);
+			writeFileHeader(state, state->fileIO);
 		}
 
 		headerSent = true;
@@ -935,7 +1206,8 @@ static int outputThread(void *stateArg) {
 		return (thrd_success);
 	}
 
-	// If destination is a file, just loop and write to it. Else start a libuv event loop.
+	// If destination is a file (or shared memory), just loop and write to it.
+	// Else start a libuv event loop.
 	if (state->isNetworkStream) {
 		// libuv network IO (state->networkIO != NULL).
 		// Start libuv event loop.
@@ -954,53 +1226,379 @@ static int outputThread(void *stateArg) {
 		// to avoid wasting resources in a busy loop.
 		struct timespec noDataSleep = { .tv_sec = 0, .tv_nsec = 1000000 };
 
+		libuvWriteBuf packetBuffers[MAX_OUTPUT_RINGBUFFER_GET];
+		size_t packetBuffersSize;
+
 		while (atomic_load_explicit(&state->running, memory_order_relaxed)) {
-			libuvWriteBuf packetBuffer = ringBufferGet(state->outputRing);
-			if (packetBuffer == NULL) {
+			packetBuffersSize = getPacketBatch(state, packetBuffers);
+			if (packetBuffersSize == 0) {
 				// There is none, so we can't work on and commit this.
 				// We just sleep here a little and then try again, as we need the data!
 				thrd_sleep(&noDataSleep, NULL);
 				continue;
 			}
 
-			// Write buffer to file descriptor.
-			if (!writeUntilDone(state->fileIO, (uint8_t *) packetBuffer->buf.base, packetBuffer->buf.len)) {
-				errorExit(state, packetBuffer);
+			// Write all gathered buffers to file descriptor (or shared memory) at once.
+			if (state->sharedRing != NULL) {
+				writePacketBatchToSharedMemory(state, packetBuffers, packetBuffersSize);
+			}
+			else if (state->preTriggerMode) {
+				writePacketBatchTriggered(state, packetBuffers, packetBuffersSize);
+			}
+			else {
+				writePacketBatchToFile(state, packetBuffers, packetBuffersSize);
+			}
+		}
+
+		// Write all remaining buffers to file (or shared memory).
+		while ((packetBuffersSize = getPacketBatch(state, packetBuffers)) != 0) {
+			if (state->sharedRing != NULL) {
+				writePacketBatchToSharedMemory(state, packetBuffers, packetBuffersSize);
+			}
+			else if (state->preTriggerMode) {
+				writePacketBatchTriggered(state, packetBuffers, packetBuffersSize);
 			}
+			else {
+				writePacketBatchToFile(state, packetBuffers, packetBuffersSize);
+			}
+		}
 
-			free(packetBuffer->freeBuf);
-			free(packetBuffer);
+		// Data never triggered is not written.
+		if (state->preTriggerMode) {
+			preTriggerClear(state);
 		}
+	}
 
-		// Write all remaining buffers to file.
-		libuvWriteBuf packetBuffer;
-		while ((packetBuffer = ringBufferGet(state->outputRing)) != NULL) {
-			if (!writeUntilDone(state->fileIO, (uint8_t *) packetBuffer->buf.base, packetBuffer->buf.len)) {
-				errorExit(state, packetBuffer);
+	return (thrd_success);
+}
+
+/**
+ * Gather consecutive packet buffers from the output ring-buffer, so that
+ * they can be written out together with one system call. Stops when the
+ * next buffer would push the batch over MAX_OUTPUT_QUEUED_SIZE bytes (a
+ * single larger buffer is still returned alone), or when the batch holds
+ * MAX_OUTPUT_RINGBUFFER_GET buffers.
+ *
+ * @param state common output state.
+ * @param packetBuffers array of at least MAX_OUTPUT_RINGBUFFER_GET elements to fill.
+ *
+ * @return number of packet buffers gathered, zero if none were available.
+ */
+static size_t getPacketBatch(outputCommonState state, libuvWriteBuf *packetBuffers) {
+	size_t count = 0;
+	size_t bytes = 0;
+	libuvWriteBuf packetBuffer;
+
+	// Only the output thread ever gets from outputRing, so looking first
+	// and then getting the same element is safe.
+	while (count < MAX_OUTPUT_RINGBUFFER_GET && (packetBuffer = ringBufferLook(state->outputRing)) != NULL) {
+		if (count > 0 && (bytes + packetBuffer->buf.len) > MAX_OUTPUT_QUEUED_SIZE) {
+			break;
+		}
+
+		// File rotation markers are always returned alone, never mixed with data.
+		if (packetBuffer->buf.base == NULL) {
+			if (count == 0) {
+				packetBuffers[count++] = ringBufferGet(state->outputRing);
 			}
 
+			break;
+		}
+
+		packetBuffers[count++] = ringBufferGet(state->outputRing);
+		bytes += packetBuffer->buf.len;
+	}
+
+	return (count);
+}
+
+static void freePacketBatch(libuvWriteBuf *packetBuffers, size_t packetBuffersSize) {
+	for (size_t i = 0; i < packetBuffersSize; i++) {
+		free(packetBuffers[i]->freeBuf);
+		free(packetBuffers[i]);
+	}
+}
+
+static void writePacketBatchToFile(outputCommonState state, libuvWriteBuf *packetBuffers, size_t packetBuffersSize) {
+	// File rotation: switch to the next file, which already has its header.
+	if (packetBuffers[0]->buf.base == NULL) {
+		int nextFileIO = *((int *) packetBuffers[0]->freeBuf);
+
+		freePacketBatch(packetBuffers, packetBuffersSize);
+
+		// Ensure all data written to disk, then close old file.
+		portable_fsync(state->fileIO);
+		close(state->fileIO);
+
+		state->fileIO = nextFileIO;
+
+		return;
+	}
+
+	uv_buf_t buffers[packetBuffersSize];
+
+	for (size_t i = 0; i < packetBuffersSize; i++) {
+		buffers[i] = packetBuffers[i]->buf;
+	}
+
+	bool success = writevUntilDone(state->fileIO, buffers, packetBuffersSize);
+
+	freePacketBatch(packetBuffers, packetBuffersSize);
+
+	if (!success) {
+		errorExit(state, NULL);
+	}
+}
+
+static inline uint64_t getMonotonicTimeUs(void) {
+	struct timespec currentTime;
+	portable_clock_gettime_monotonic(&currentTime);
+
+	return ((U64T(currentTime.tv_sec) * 1000000LLU) + U64T(currentTime.tv_nsec / 1000));
+}
+
+/**
+ * Pre-trigger recording: keep the most recent compressed packets in memory,
+ * and only write to file when a trigger arrives. Then the buffered packets
+ * are written out with one sequential write, followed by all new packets,
+ * until 'postTriggerTime' ms after the last trigger. Each recording after
+ * the first goes into a new file.
+ *
+ * @param state common output state.
+ * @param packetBuffers gathered packet buffers, ownership is taken.
+ * @param packetBuffersSize number of gathered packet buffers.
+ */
+static void writePacketBatchTriggered(outputCommonState state, libuvWriteBuf *packetBuffers, size_t packetBuffersSize) {
+	// File rotation markers are handled as usual.
+	if (packetBuffers[0]->buf.base == NULL) {
+		writePacketBatchToFile(state, packetBuffers, packetBuffersSize);
+		return;
+	}
+
+	uint64_t currentTime = getMonotonicTimeUs();
+
+	if (atomic_exchange(&state->triggerPending, false)) {
+		if (!state->preTrigger.recording) {
+			startTriggeredRecording(state);
+		}
+
+		// Every trigger extends the current recording.
+		state->preTrigger.recordingEnd = currentTime
+			+ (U64T(atomic_load_explicit(&state->postTriggerTime, memory_order_relaxed)) * 1000);
+
+		// Re-arm the SSHS trigger.
+		sshsNodePutBool(state->parentModule->moduleNode, "trigger", false);
+	}
+
+	if (state->preTrigger.recording) {
+		writePacketBatchToFile(state, packetBuffers, packetBuffersSize);
+
+		if (currentTime >= state->preTrigger.recordingEnd) {
+			state->preTrigger.recording = false;
+
+			// Recording done, ensure all data is on disk.
+			portable_fsync(state->fileIO);
+
+			caerLog(CAER_LOG_INFO, state->parentModule->moduleSubSystemString,
+				"Triggered recording %zu done, buffering again.", state->preTrigger.recordings);
+		}
+
+		return;
+	}
+
+	for (size_t i = 0; i < packetBuffersSize; i++) {
+		preTriggerPush(state, packetBuffers[i], currentTime);
+	}
+}
+
+static void startTriggeredRecording(outputCommonState state) {
+	// The initial file is used for the first recording, then a new one for each.
+	if (state->preTrigger.recordings > 0) {
+		int nextFileIO = state->fileOpen(state->parentModule);
+		if (nextFileIO < 0) {
+			caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString,
+				"Failed to open file for triggered recording, continuing in current file.");
+		}
+		else {
+			writeFileHeader(state, nextFileIO);
+
+			// Ensure all data written to disk, then close old file.
+			portable_fsync(state->fileIO);
+			close(state->fileIO);
+
+			state->fileIO = nextFileIO;
+		}
+	}
+
+	state->preTrigger.recordings++;
+	state->preTrigger.recording = true;
+
+	caerLog(CAER_LOG_INFO, state->parentModule->moduleSubSystemString,
+		"Triggered recording %zu started, writing %zu bytes of pre-trigger data.", state->preTrigger.recordings,
+		state->preTrigger.bytes);
+
+	preTriggerWrite(state);
+}
+
+static void preTriggerPush(outputCommonState state, libuvWriteBuf packetBuffer, uint64_t currentTime) {
+	struct output_common_pretrigger *preTrigger = &state->preTrigger;
+
+	uint64_t maxTime = U64T(atomic_load_explicit(&state->preTriggerTime, memory_order_relaxed)) * 1000;
+	size_t maxBytes = (size_t) atomic_load_explicit(&state->preTriggerMaxSize, memory_order_relaxed) * 1024 * 1024;
+
+	// Grow as needed, the time and size limits bound the buffer.
+	if (preTrigger->count == preTrigger->capacity) {
+		size_t newCapacity = (preTrigger->capacity == 0) ? (1024) : (preTrigger->capacity * 2);
+
+		libuvWriteBuf *newBuffers = malloc(newCapacity * sizeof(libuvWriteBuf));
+		uint64_t *newTimes = malloc(newCapacity * sizeof(uint64_t));
+
+		if (newBuffers == NULL || newTimes == NULL) {
+			free(newBuffers);
+			free(newTimes);
+
+			caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString,
+				"Failed to grow pre-trigger buffer, dropping packet.");
+
 			free(packetBuffer->freeBuf);
 			free(packetBuffer);
+			return;
+		}
+
+		// Unroll circular content to the start of the new arrays.
+		for (size_t i = 0; i < preTrigger->count; i++) {
+			size_t idx = (preTrigger->head + i) % preTrigger->capacity;
+
+			newBuffers[i] = preTrigger->buffers[idx];
+			newTimes[i] = preTrigger->times[idx];
 		}
+
+		free(preTrigger->buffers);
+		free(preTrigger->times);
+
+		preTrigger->buffers = newBuffers;
+		preTrigger->times = newTimes;
+		preTrigger->capacity = newCapacity;
+		preTrigger->head = 0;
 	}
 
-	return (thrd_success);
+	size_t tail = (preTrigger->head + preTrigger->count) % preTrigger->capacity;
+
+	preTrigger->buffers[tail] = packetBuffer;
+	preTrigger->times[tail] = currentTime;
+	preTrigger->count++;
+	preTrigger->bytes += packetBuffer->buf.len;
+
+	// Drop what is now too old, or over the size limit.
+	while (preTrigger->count > 0
+		&& ((currentTime - preTrigger->times[preTrigger->head]) > maxTime || preTrigger->bytes > maxBytes)) {
+		libuvWriteBuf oldest = preTrigger->buffers[preTrigger->head];
+
+		preTrigger->bytes -= oldest->buf.len;
+		preTrigger->head = (preTrigger->head + 1) % preTrigger->capacity;
+		preTrigger->count--;
+
+		free(oldest->freeBuf);
+		free(oldest);
+	}
+}
+
+static void preTriggerWrite(outputCommonState state) {
+	struct output_common_pretrigger *preTrigger = &state->preTrigger;
+
+	libuvWriteBuf packetBuffers[MAX_OUTPUT_RINGBUFFER_GET];
+
+	while (preTrigger->count > 0) {
+		size_t packetBuffersSize = 0;
+
+		while (packetBuffersSize < MAX_OUTPUT_RINGBUFFER_GET && preTrigger->count > 0) {
+			packetBuffers[packetBuffersSize++] = preTrigger->buffers[preTrigger->head];
+
+			preTrigger->head = (preTrigger->head + 1) % preTrigger->capacity;
+			preTrigger->count--;
+		}
+
+		writePacketBatchToFile(state, packetBuffers, packetBuffersSize);
+	}
+
+	preTrigger->head = 0;
+	preTrigger->bytes = 0;
+}
+
+static void preTriggerClear(outputCommonState state) {
+	struct output_common_pretrigger *preTrigger = &state->preTrigger;
+
+	while (preTrigger->count > 0) {
+		libuvWriteBuf oldest = preTrigger->buffers[preTrigger->head];
+
+		preTrigger->head = (preTrigger->head + 1) % preTrigger->capacity;
+		preTrigger->count--;
+
+		free(oldest->freeBuf);
+		free(oldest);
+	}
+
+	free(preTrigger->buffers);
+	free(preTrigger->times);
+
+	memset(preTrigger, 0, sizeof(*preTrigger));
+}
+
+/**
+ * Publish the AEDAT 3.X network header in the shared memory ring, after
+ * which readers start consuming packets. Shared memory is a stream-like
+ * transport, so the sequence number stays zero.
+ *
+ * @param state common output state.
+ */
+static void startSharedMemoryStream(outputCommonState state) {
+#if !defined(OS_WINDOWS)
+	struct aedat3_network_header networkHeader;
+	initializeNetworkHeader(state, &networkHeader);
+
+	caerSharedRingStart(state->sharedRing, &networkHeader);
+#else
+	UNUSED_ARGUMENT(state);
+#endif
+}
+
+static void writePacketBatchToSharedMemory(outputCommonState state, libuvWriteBuf *packetBuffers,
+	size_t packetBuffersSize) {
+#if !defined(OS_WINDOWS)
+	// Each packet is one record, readers always get whole packets. Readers
+	// never hold up the writer, so this can't fail except for packets that
+	// are larger than the whole ring.
+	for (size_t i = 0; i < packetBuffersSize; i++) {
+		if (!caerSharedRingWrite(state->sharedRing, (uint8_t *) packetBuffers[i]->buf.base,
+			packetBuffers[i]->buf.len)) {
+			caerLogRateLimited(CAER_LOG_WARNING, state->parentModule->moduleSubSystemString,
+				"Packet of %zu bytes doesn't fit into shared memory ring, dropped. Increase 'shmSize'.",
+				packetBuffers[i]->buf.len);
+		}
+	}
+
+	// Make the whole batch visible to readers at once.
+	caerSharedRingCommit(state->sharedRing);
+#else
+	UNUSED_ARGUMENT(state);
+#endif
+
+	freePacketBatch(packetBuffers, packetBuffersSize);
 }
 
 static void libuvRingBufferGet(uv_idle_t *handle) {
 	outputCommonState state = handle->data;
 
 	// Write all packets that are currently available out in order,
-	// but never more than 10 at a time.
-	size_t count = 0;
-	libuvWriteBuf packetBuffer;
-	while (count < MAX_OUTPUT_RINGBUFFER_GET && (packetBuffer = ringBufferGet(state->outputRing)) != NULL) {
-		writePacket(state, packetBuffer);
-		count++;
-	}
+	// gathered into one batch, bounded in count and total size.
+	libuvWriteBuf packetBuffers[MAX_OUTPUT_RINGBUFFER_GET];
+	size_t count = getPacketBatch(state, packetBuffers);
 
-	// If nothing, avoid busy loop within libuv event loop by sleeping a little.
-	if (count == 0) {
+	if (count > 0) {
+		writePacketBatch(state, packetBuffers, count);
+	}
+	else {
+		// If nothing, avoid busy loop within libuv event loop by sleeping a little.
 		// Sleep for 1 ms.
 		struct timespec noDataSleep = { .tv_sec = 0, .tv_nsec = 1000000 };
 		thrd_sleep(&noDataSleep, NULL);
@@ -1019,10 +1617,18 @@ static void libuvAsyncShutdown(uv_async_t *handle) {
 
 	uv_close((uv_handle_t *) &state->networkIO->ringBufferGet, NULL);
 
+	if (state->networkIO->clientQueues != NULL) {
+		retVal = uv_timer_stop(&state->networkIO->clientStatistics);
+		UV_RET_CHECK(retVal, state->parentModule->moduleSubSystemString, "uv_timer_stop",);
+
+		uv_close((uv_handle_t *) &state->networkIO->clientStatistics, NULL);
+	}
+
 	// Then we empty the ring-buffer and write out all data.
-	libuvWriteBuf packetBuffer;
-	while ((packetBuffer = ringBufferGet(state->outputRing)) != NULL) {
-		writePacket(state, packetBuffer);
+	libuvWriteBuf packetBuffers[MAX_OUTPUT_RINGBUFFER_GET];
+	size_t packetBuffersSize;
+	while ((packetBuffersSize = getPacketBatch(state, packetBuffers)) != 0) {
+		writePacketBatch(state, packetBuffers, packetBuffersSize);
 	}
 
 	// Shutdown server (if it exists).
@@ -1044,6 +1650,9 @@ static void libuvAsyncShutdown(uv_async_t *handle) {
 			continue;
 		}
 
+		// Hand all still queued data to libuv, the shutdown will wait for it.
+		clientQueueFlush(state->networkIO, i);
+
 		uv_shutdown_t *clientShutdown = calloc(1, sizeof(*clientShutdown));
 		if (clientShutdown == NULL) {
 			caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString,
@@ -1082,146 +1691,545 @@ static void libuvWriteStatusCheck(uv_handle_t *handle, int status) {
 
 		for (size_t i = 0; i < streams->clientsSize; i++) {
 			if ((uv_handle_t *) streams->clients[i] == handle) {
-				streams->clients[i] = NULL;
-				streams->activeClients--;
+				clientDisconnect(streams, i);
+				break;
+			}
+		}
+	}
+}
 
-				// Close connection and free its memory.
-				uv_close(handle, &libuvCloseFree);
+static void libuvClientQueueWriteDone(uv_handle_t *handle, int status) {
+	if (status < 0) {
+		libuvWriteStatusCheck(handle, status);
+		return;
+	}
 
-				break;
+	// Write done, send the next queued batch to this client, if any.
+	outputCommonNetIO streams = handle->data;
+
+	for (size_t i = 0; i < streams->clientsSize; i++) {
+		if ((uv_handle_t *) streams->clients[i] == handle) {
+			streams->clientQueues[i].writeActive = false;
+			clientQueueWrite(streams, i);
+			break;
+		}
+	}
+}
+
+static void clientDisconnect(outputCommonNetIO streams, size_t idx) {
+	uv_stream_t *client = streams->clients[idx];
+
+	streams->clients[idx] = NULL;
+	streams->activeClients--;
+
+	if (streams->clientQueues != NULL) {
+		clientQueueClear(streams, idx);
+	}
+
+	// Close connection and free its memory.
+	uv_close((uv_handle_t *) client, &libuvCloseFree);
+}
+
+static void clientQueueInit(outputCommonNetIO streams, size_t idx, uv_stream_t *client) {
+	if (streams->clientQueues == NULL) {
+		return;
+	}
+
+	struct output_common_client_queue *queue = &streams->clientQueues[idx];
+
+	memset(queue, 0, sizeof(*queue));
+
+	// Remember remote address for statistics (TCP only).
+	if (streams->isTCP) {
+		struct sockaddr_storage peerAddress;
+		int peerAddressLength = sizeof(peerAddress);
+
+		if (uv_tcp_getpeername((uv_tcp_t *) client, (struct sockaddr *) &peerAddress, &peerAddressLength) == 0) {
+			char ipAddress[48] = { 0 };
+			int port = 0;
+
+			if (peerAddress.ss_family == AF_INET6) {
+				uv_ip6_name((struct sockaddr_in6 *) &peerAddress, ipAddress, sizeof(ipAddress));
+				port = ntohs(((struct sockaddr_in6 *) &peerAddress)->sin6_port);
+			}
+			else {
+				uv_ip4_name((struct sockaddr_in *) &peerAddress, ipAddress, sizeof(ipAddress));
+				port = ntohs(((struct sockaddr_in *) &peerAddress)->sin_port);
 			}
+
+			snprintf(queue->address, sizeof(queue->address), "%s:%d", ipAddress, port);
+		}
+	}
+}
+
+static void clientQueueClear(outputCommonNetIO streams, size_t idx) {
+	struct output_common_client_queue *queue = &streams->clientQueues[idx];
+
+	while (queue->pendingCount > 0) {
+		libuvWriteBufFree(queue->pending[queue->pendingHead]);
+		queue->pending[queue->pendingHead] = NULL;
+
+		queue->pendingHead = (queue->pendingHead + 1) % MAX_OUTPUT_CLIENT_QUEUE_LENGTH;
+		queue->pendingCount--;
+	}
+
+	queue->pendingBytes = 0;
+}
+
+/**
+ * Queue a write batch for one stream client. Every client has its own bounded
+ * queue, with only one write in flight at a time, so that a slow client can
+ * only ever lose its own data, and never back up the output for the others.
+ * When the queue is full, the configured slow client policy decides what to
+ * drop. The 'disconnect' policy drops the newest data, like 'dropNewest', until
+ * the client lags more than 'clientMaxLag' ms behind, then it is disconnected.
+ *
+ * @param state common output state.
+ * @param idx client index.
+ * @param buffers shared write batch, one reference is owned by this client.
+ * @param buffersSize total size of the write batch, in bytes.
+ */
+static void clientQueuePush(outputCommonState state, size_t idx, libuvWriteMultiBuf buffers, size_t buffersSize) {
+	outputCommonNetIO streams = state->networkIO;
+	struct output_common_client_queue *queue = &streams->clientQueues[idx];
+
+	enum output_common_slow_client_policy policy = (enum output_common_slow_client_policy) atomic_load_explicit(
+		&state->slowClientPolicy, memory_order_relaxed);
+	size_t maxQueuedBytes = (size_t) atomic_load_explicit(&state->clientQueueSize, memory_order_relaxed) * 1024;
+
+	// Make room if the queue is full. An empty queue always accepts a batch.
+	while (queue->pendingCount == MAX_OUTPUT_CLIENT_QUEUE_LENGTH
+		|| (queue->pendingCount > 0 && (queue->pendingBytes + buffersSize) > maxQueuedBytes)) {
+		if (policy == SLOW_CLIENT_DROP_OLDEST) {
+			size_t oldest = queue->pendingHead;
+
+			queue->droppedBuffers++;
+			queue->droppedBytes += queue->pendingSize[oldest];
+			queue->pendingBytes -= queue->pendingSize[oldest];
+
+			libuvWriteBufFree(queue->pending[oldest]);
+			queue->pending[oldest] = NULL;
+
+			queue->pendingHead = (queue->pendingHead + 1) % MAX_OUTPUT_CLIENT_QUEUE_LENGTH;
+			queue->pendingCount--;
+		}
+		else {
+			queue->droppedBuffers++;
+			queue->droppedBytes += buffersSize;
+
+			libuvWriteBufFree(buffers);
+			buffers = NULL;
+
+			break;
+		}
+	}
+
+	if (buffers != NULL) {
+		size_t tail = (queue->pendingHead + queue->pendingCount) % MAX_OUTPUT_CLIENT_QUEUE_LENGTH;
+
+		queue->pending[tail] = buffers;
+		queue->pendingSize[tail] = buffersSize;
+		queue->pendingTime[tail] = uv_now(&streams->loop);
+
+		queue->pendingCount++;
+		queue->pendingBytes += buffersSize;
+
+		clientQueueWrite(streams, idx);
+	}
+
+	if (policy == SLOW_CLIENT_DISCONNECT) {
+		uint64_t lag = clientQueueLag(streams, idx);
+
+		if (lag > U64T(atomic_load_explicit(&state->clientMaxLag, memory_order_relaxed))) {
+			caerLog(CAER_LOG_WARNING, state->parentModule->moduleSubSystemString,
+				"Client %zu (%s) is lagging %" PRIu64 " ms behind, disconnecting it.", idx, queue->address, lag);
+
+			clientDisconnect(streams, idx);
 		}
 	}
 }
 
-static void writePacket(outputCommonState state, libuvWriteBuf packetBuffer) {
+static void clientQueueWrite(outputCommonNetIO streams, size_t idx) {
+	struct output_common_client_queue *queue = &streams->clientQueues[idx];
+
+	if (queue->writeActive || queue->pendingCount == 0) {
+		return;
+	}
+
+	size_t head = queue->pendingHead;
+	libuvWriteMultiBuf buffers = queue->pending[head];
+
+	queue->writeActive = true;
+	queue->writeActiveSize = queue->pendingSize[head];
+	queue->writeActiveTime = queue->pendingTime[head];
+
+	queue->pending[head] = NULL;
+	queue->pendingBytes -= queue->pendingSize[head];
+	queue->pendingHead = (head + 1) % MAX_OUTPUT_CLIENT_QUEUE_LENGTH;
+	queue->pendingCount--;
+
+	int retVal = libuvWrite(streams->clients[idx], buffers);
+	UV_RET_CHECK(retVal, __func__, "libuvWrite", libuvWriteBufFree(buffers); queue->writeActive = false);
+}
+
+static void clientQueueFlush(outputCommonNetIO streams, size_t idx) {
+	if (streams->clientQueues == NULL) {
+		return;
+	}
+
+	struct output_common_client_queue *queue = &streams->clientQueues[idx];
+
+	while (queue->pendingCount > 0) {
+		libuvWriteMultiBuf buffers = queue->pending[queue->pendingHead];
+
+		queue->pending[queue->pendingHead] = NULL;
+		queue->pendingHead = (queue->pendingHead + 1) % MAX_OUTPUT_CLIENT_QUEUE_LENGTH;
+		queue->pendingCount--;
+
+		int retVal = libuvWrite(streams->clients[idx], buffers);
+		UV_RET_CHECK(retVal, __func__, "libuvWrite", libuvWriteBufFree(buffers));
+	}
+
+	queue->pendingBytes = 0;
+}
+
+static uint64_t clientQueueLag(outputCommonNetIO streams, size_t idx) {
+	struct output_common_client_queue *queue = &streams->clientQueues[idx];
+
+	// Age of the oldest data not yet delivered to the client. The one
+	// write in flight, if any, is always older than anything queued.
+	uint64_t oldestTime;
+
+	if (queue->writeActive) {
+		oldestTime = queue->writeActiveTime;
+	}
+	else if (queue->pendingCount > 0) {
+		oldestTime = queue->pendingTime[queue->pendingHead];
+	}
+	else {
+		return (0);
+	}
+
+	uint64_t now = uv_now(&streams->loop);
+
+	return ((now > oldestTime) ? (now - oldestTime) : (0));
+}
+
+static void libuvClientStatistics(uv_timer_t *handle) {
+	outputCommonState state = handle->data;
+	outputCommonNetIO streams = state->networkIO;
+
+	for (size_t i = 0; i < streams->clientsSize; i++) {
+		struct output_common_client_queue *queue = &streams->clientQueues[i];
+		bool connected = (streams->clients[i] != NULL);
+
+		char clientNodePath[48];
+		snprintf(clientNodePath, sizeof(clientNodePath), "clientStatistics/client%zu/", i);
+
+		sshsNode clientNode = sshsGetRelativeNode(state->parentModule->moduleNode, clientNodePath);
+
+		sshsNodePutBool(clientNode, "connected", connected);
+		sshsNodePutString(clientNode, "address", queue->address);
+		sshsNodePutLong(clientNode, "lag", (connected) ? (I64T(clientQueueLag(streams, i))) : (0));
+		sshsNodePutLong(clientNode, "queuedBytes",
+			(connected) ? (I64T(queue->pendingBytes + ((queue->writeActive) ? (queue->writeActiveSize) : (0)))) : (0));
+		sshsNodePutLong(clientNode, "droppedBuffers", I64T(queue->droppedBuffers));
+		sshsNodePutLong(clientNode, "droppedBytes", I64T(queue->droppedBytes));
+	}
+}
+
+static enum output_common_slow_client_policy parseSlowClientPolicy(const char *policy) {
+	if (caerStrEquals(policy, "dropOldest")) {
+		return (SLOW_CLIENT_DROP_OLDEST);
+	}
+	else if (caerStrEquals(policy, "disconnect")) {
+		return (SLOW_CLIENT_DISCONNECT);
+	}
+	else {
+		// Default is dropNewest.
+		return (SLOW_CLIENT_DROP_NEWEST);
+	}
+}
+
+static void writePacketBatch(outputCommonState state, libuvWriteBuf *packetBuffers, size_t packetBuffersSize) {
 	// If no active clients exist, don't write anything.
 	if (state->networkIO->activeClients == 0) {
-		free(packetBuffer->freeBuf);
-		free(packetBuffer);
-
+		freePacketBatch(packetBuffers, packetBuffersSize);
 		return;
 	}
 
-	// Write packets to network. TCP/Pipe have their header already written in the
-	// Connection callbacks. Also, the size of the written data doesn't matter, as
-	// they are stream transports, and the network stack will take care of things
-	// like buffering and packet sizes.
 	// Only UDP needs special treatment here to write the proper header and split
 	// the packets up into manageable sizes (<=64K), together with keeping track
-	// of the sequence number.
+	// of the sequence number. Each packet starts a new datagram sequence there.
 	if (state->networkIO->isUDP) {
-		// UDP output.
-		// If too much data waiting to be sent, just skip current packet.
-		if (((uv_udp_t *) state->networkIO->clients[0])->send_queue_size > MAX_OUTPUT_QUEUED_SIZE) {
-			goto freePacketBufferUDP;
+		writePacketBatchUDP(state, packetBuffers, packetBuffersSize);
+		return;
+	}
+
+	// TCP/Pipe outputs. They have their header already written in the Connection
+	// callbacks. Also, the size of the written data doesn't matter, as they are
+	// stream transports, and the network stack will take care of things like
+	// buffering and packet sizes. So we send the whole batch of packets with
+	// one write request (scatter-gather) per client.
+	// Prepare buffers, increase reference count.
+	libuvWriteMultiBuf buffers = libuvWriteBufAlloc(packetBuffersSize);
+	if (buffers == NULL) {
+		caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString,
+			"Failed to allocate memory for network buffers.");
+
+		freePacketBatch(packetBuffers, packetBuffersSize);
+		return;
+	}
+
+	buffers->statusCheck = &libuvClientQueueWriteDone;
+
+	buffers->refCount = state->networkIO->activeClients;
+
+	size_t buffersSize = 0;
+
+	for (size_t i = 0; i < packetBuffersSize; i++) {
+		buffersSize += packetBuffers[i]->buf.len;
+
+		buffers->buffers[i] = *packetBuffers[i];
+		free(packetBuffers[i]);
+	}
+
+	// Queue for each client, but use common reference-counted buffer.
+	for (size_t i = 0; i < state->networkIO->clientsSize; i++) {
+		if (state->networkIO->clients[i] == NULL) {
+			continue;
 		}
 
-		size_t packetSize = packetBuffer->buf.len;
-		size_t packetIndex = 0;
-		bool firstChunk = true;
+		clientQueuePush(state, i, buffers, buffersSize);
+	}
+}
 
-		// Split packets up into chunks for UDP. Send each chunk with its own
-		// header and increasing sequence number. The very first packet of a chunk is
-		// identifiable by having a negative sequence number (highest bit set to one).
-		while (packetSize > 0) {
-			libuvWriteMultiBuf buffers = libuvWriteBufAlloc(2); // One for network header, one for data.
-			if (buffers == NULL) {
-				caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString,
-					"Failed to allocate memory for network buffers.");
+static void writePacketBatchUDP(outputCommonState state, libuvWriteBuf *packetBuffers, size_t packetBuffersSize) {
+#if defined(OS_LINUX)
+	// Linux fast path: send many datagrams per system call with sendmmsg(), and,
+	// where the kernel supports it, let it do the splitting of each packet into
+	// datagrams itself (UDP GSO). Datagram boundaries, headers and sequence
+	// numbers are exactly the same as with the libuv path below.
+	uv_udp_t *udp = (uv_udp_t *) state->networkIO->clients[0];
+	uv_os_fd_t udpSocket;
+
+	// The socket only exists after the first send through libuv.
+	if (uv_fileno((uv_handle_t *) udp, &udpSocket) == 0) {
+		if (!state->udpGSOProbed) {
+			// Segment size is one full datagram: header plus maximum data.
+			// Smaller sends are not affected and go out as single datagrams.
+			int segmentSize = AEDAT3_NETWORK_HEADER_LENGTH + MAX_OUTPUT_UDP_SIZE;
+
+			state->udpGSO = (setsockopt(udpSocket, SOL_UDP, UDP_SEGMENT, &segmentSize, sizeof(segmentSize)) == 0);
+			state->udpGSOProbed = true;
+
+			caerLog(CAER_LOG_DEBUG, state->parentModule->moduleSubSystemString,
+				"UDP fast path enabled, segmentation offload (GSO) %s.",
+				(state->udpGSO) ? ("supported") : ("not supported"));
+		}
+
+		struct output_common_udp_batch batch;
+		batch.messagesSize = 0;
+		batch.datagramsSize = 0;
+		batch.messageSegments = 0;
 
-				goto freePacketBufferUDP;
+		for (size_t i = 0; i < packetBuffersSize; i++) {
+			// If too much data waiting to be sent, just skip current packet.
+			if (udp->send_queue_size > MAX_OUTPUT_QUEUED_SIZE) {
+				continue;
 			}
 
-			buffers->statusCheck = &libuvWriteStatusCheck;
+			size_t packetSize = packetBuffers[i]->buf.len;
+			size_t packetIndex = 0;
+			bool firstChunk = true;
 
-			// Write header into first buffer.
-			if (!writeNetworkHeader(state->networkIO, &buffers->buffers[0], firstChunk)) {
-				caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString, "Failed to write network header.");
+			while (packetSize > 0) {
+				size_t sendSize = (packetSize > MAX_OUTPUT_UDP_SIZE) ? (MAX_OUTPUT_UDP_SIZE) : (packetSize);
 
-				libuvWriteBufFree(buffers);
-				goto freePacketBufferUDP;
+				udpBatchAdd(state, &batch, (uint8_t *) packetBuffers[i]->buf.base + packetIndex, sendSize, firstChunk);
+
+				// Full batch, send it out now.
+				if (batch.datagramsSize == MAX_OUTPUT_UDP_DATAGRAMS || batch.messagesSize == MAX_OUTPUT_UDP_MMSG) {
+					udpBatchSend(state, &batch, udpSocket);
+				}
+
+				firstChunk = false;
+
+				// Update loop indexes.
+				packetSize -= sendSize;
+				packetIndex += sendSize;
 			}
+		}
 
-			firstChunk = false;
+		udpBatchSend(state, &batch, udpSocket);
 
-			// Write data into second buffer.
-			size_t sendSize = (packetSize > MAX_OUTPUT_UDP_SIZE) ? (MAX_OUTPUT_UDP_SIZE) : (packetSize);
+		// Data pointed to by the batch is only released after sending.
+		freePacketBatch(packetBuffers, packetBuffersSize);
 
-			libuvWriteBufInit(&buffers->buffers[1], sendSize);
-			if (buffers->buffers[1].buf.base == NULL) {
-				caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString,
-					"Failed to allocate memory for data buffer.");
+		return;
+	}
+#endif
 
-				libuvWriteBufFree(buffers);
-				goto freePacketBufferUDP;
-			}
+	for (size_t i = 0; i < packetBuffersSize; i++) {
+		writePacketUDP(state, packetBuffers[i]);
+	}
+}
+
+#if defined(OS_LINUX)
+static void udpBatchAdd(outputCommonState state, struct output_common_udp_batch *batch, const uint8_t *data,
+	size_t dataSize, bool firstChunk) {
+	size_t datagram = batch->datagramsSize++;
+
+	fillNetworkHeader(state->networkIO, batch->headers[datagram], firstChunk);
+
+	batch->iov[datagram * 2].iov_base = batch->headers[datagram];
+	batch->iov[datagram * 2].iov_len = AEDAT3_NETWORK_HEADER_LENGTH;
+	batch->iov[(datagram * 2) + 1].iov_base = (void *) data;
+	batch->iov[(datagram * 2) + 1].iov_len = dataSize;
+
+	// With GSO, all datagrams of a packet go into one message, that the kernel
+	// splits at full datagram size. All but the last datagram of a packet are
+	// full, and a new packet always starts a new message, so this is exact.
+	if (state->udpGSO && !firstChunk && batch->messagesSize > 0
+		&& batch->messageSegments < MAX_OUTPUT_UDP_GSO_SEGMENTS) {
+		batch->messages[batch->messagesSize - 1].msg_hdr.msg_iovlen += 2;
+		batch->messageSegments++;
+		return;
+	}
 
-			memcpy(buffers->buffers[1].buf.base, packetBuffer->buf.base + packetIndex, sendSize);
+	struct mmsghdr *message = &batch->messages[batch->messagesSize++];
 
-			// For UDP we only support client mode to ONE outside address.
-			int retVal = libuvWriteUDP((uv_udp_t *) state->networkIO->clients[0], state->networkIO->address, buffers);
-			UV_RET_CHECK(retVal, state->parentModule->moduleSubSystemString, "libuvWriteUDP",
-				libuvWriteBufFree(buffers); goto freePacketBufferUDP);
+	memset(message, 0, sizeof(*message));
+	message->msg_hdr.msg_name = state->networkIO->address;
+	message->msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+	message->msg_hdr.msg_iov = &batch->iov[datagram * 2];
+	message->msg_hdr.msg_iovlen = 2;
 
-			// Update loop indexes.
-			packetSize -= sendSize;
-			packetIndex += sendSize;
-		}
+	batch->messageSegments = 1;
+}
 
-		// Free all packet memory.
-		freePacketBufferUDP: {
-			free(packetBuffer->freeBuf);
-			free(packetBuffer);
+static void udpBatchSend(outputCommonState state, struct output_common_udp_batch *batch, int udpSocket) {
+	uv_udp_t *udp = (uv_udp_t *) state->networkIO->clients[0];
+	size_t sent = 0;
+
+	// Only send directly if libuv has nothing queued, to keep datagram order.
+	if (udp->send_queue_count == 0) {
+		while (sent < batch->messagesSize) {
+			int result = sendmmsg(udpSocket, &batch->messages[sent], (unsigned int) (batch->messagesSize - sent), 0);
+			if (result <= 0) {
+				if (result < 0 && errno == EIO && state->udpGSO) {
+					// Network device can't do GSO after all, disable it.
+					int segmentSize = 0;
+					setsockopt(udpSocket, SOL_UDP, UDP_SEGMENT, &segmentSize, sizeof(segmentSize));
+					state->udpGSO = false;
+
+					caerLog(CAER_LOG_WARNING, state->parentModule->moduleSubSystemString,
+						"UDP segmentation offload (GSO) failed, disabling it.");
+				}
+
+				break;
+			}
+
+			sent += (size_t) result;
 		}
 	}
-	else {
-		// TCP/Pipe outputs.
-		// Prepare buffers, increase reference count.
-		libuvWriteMultiBuf buffers = libuvWriteBufAlloc(1);
-		if (buffers == NULL) {
-			caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString,
-				"Failed to allocate memory for network buffers.");
 
-			free(packetBuffer->freeBuf);
-			free(packetBuffer);
-			return;
+	// Whatever couldn't be sent directly (socket buffer full, errors) goes
+	// through libuv's send queue, which takes care of retrying and errors.
+	for (size_t i = sent; i < batch->messagesSize; i++) {
+		struct msghdr *message = &batch->messages[i].msg_hdr;
+
+		for (size_t j = 0; j < message->msg_iovlen; j += 2) {
+			if (!writeDatagramUDP(state, message->msg_iov[j].iov_base, message->msg_iov[j + 1].iov_base,
+				message->msg_iov[j + 1].iov_len)) {
+				break;
+			}
 		}
+	}
 
-		buffers->statusCheck = &libuvWriteStatusCheck;
+	batch->messagesSize = 0;
+	batch->datagramsSize = 0;
+	batch->messageSegments = 0;
+}
+#endif
 
-		buffers->refCount = state->networkIO->activeClients;
+static void writePacketUDP(outputCommonState state, libuvWriteBuf packetBuffer) {
+	// UDP output.
+	// If too much data waiting to be sent, just skip current packet.
+	if (((uv_udp_t *) state->networkIO->clients[0])->send_queue_size > MAX_OUTPUT_QUEUED_SIZE) {
+		goto freePacketBufferUDP;
+	}
 
-		buffers->buffers[0] = *packetBuffer;
-		free(packetBuffer);
+	size_t packetSize = packetBuffer->buf.len;
+	size_t packetIndex = 0;
+	bool firstChunk = true;
 
-		// Write to each client, but use common reference-counted buffer.
-		for (size_t i = 0; i < state->networkIO->clientsSize; i++) {
-			uv_stream_t *client = state->networkIO->clients[i];
+	// Split packets up into chunks for UDP. Send each chunk with its own
+	// header and increasing sequence number. The very first packet of a chunk is
+	// identifiable by having a negative sequence number (highest bit set to one).
+	while (packetSize > 0) {
+		uint8_t header[AEDAT3_NETWORK_HEADER_LENGTH];
+		fillNetworkHeader(state->networkIO, header, firstChunk);
 
-			if (client == NULL) {
-				continue;
-			}
+		firstChunk = false;
 
-			// If too much data waiting to be sent, just skip current packet.
-			if (client->write_queue_size > MAX_OUTPUT_QUEUED_SIZE) {
-				libuvWriteBufFree(buffers);
-				return;
-			}
+		size_t sendSize = (packetSize > MAX_OUTPUT_UDP_SIZE) ? (MAX_OUTPUT_UDP_SIZE) : (packetSize);
 
-			int retVal = libuvWrite(client, buffers);
-			UV_RET_CHECK(retVal, state->parentModule->moduleSubSystemString, "libuvWrite", libuvWriteBufFree(buffers));
+		if (!writeDatagramUDP(state, header, (uint8_t *) packetBuffer->buf.base + packetIndex, sendSize)) {
+			goto freePacketBufferUDP;
 		}
+
+		// Update loop indexes.
+		packetSize -= sendSize;
+		packetIndex += sendSize;
+	}
+
+	// Free all packet memory.
+	freePacketBufferUDP: {
+		free(packetBuffer->freeBuf);
+		free(packetBuffer);
+	}
+}
+
+static bool writeDatagramUDP(outputCommonState state, const uint8_t *header, const uint8_t *data, size_t dataSize) {
+	libuvWriteMultiBuf buffers = libuvWriteBufAlloc(2); // One for network header, one for data.
+	if (buffers == NULL) {
+		caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString,
+			"Failed to allocate memory for network buffers.");
+		return (false);
+	}
+
+	buffers->statusCheck = &libuvWriteStatusCheck;
+
+	// Write header into first buffer, data into second buffer.
+	libuvWriteBufInit(&buffers->buffers[0], AEDAT3_NETWORK_HEADER_LENGTH);
+	libuvWriteBufInit(&buffers->buffers[1], dataSize);
+	if (buffers->buffers[0].buf.base == NULL || buffers->buffers[1].buf.base == NULL) {
+		caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString,
+			"Failed to allocate memory for data buffer.");
+
+		libuvWriteBufFree(buffers);
+		return (false);
 	}
+
+	memcpy(buffers->buffers[0].buf.base, header, AEDAT3_NETWORK_HEADER_LENGTH);
+	memcpy(buffers->buffers[1].buf.base, data, dataSize);
+
+	// For UDP we only support client mode to ONE outside address.
+	int retVal = libuvWriteUDP((uv_udp_t *) state->networkIO->clients[0], state->networkIO->address, buffers);
+	UV_RET_CHECK(retVal, state->parentModule->moduleSubSystemString, "libuvWriteUDP",
+		libuvWriteBufFree(buffers); return (false));
+
+	return (true);
 }
 
-static void initializeNetworkHeader(outputCommonState state) {
+static void initializeNetworkHeader(outputCommonState state, struct aedat3_network_header *networkHeader) {
 	// Generate AEDAT 3.1 header for network streams (20 bytes total).
-	state->networkIO->networkHeader.magicNumber = htole64(AEDAT3_NETWORK_MAGIC_NUMBER);
-	state->networkIO->networkHeader.sequenceNumber = htole64(0);
-	state->networkIO->networkHeader.versionNumber = AEDAT3_NETWORK_VERSION;
-	state->networkIO->networkHeader.formatNumber = state->formatID; // Send numeric format ID.
-	state->networkIO->networkHeader.sourceID = htole16(I16T(atomic_load(&state->sourceID))); // Always one source per output module.
+	networkHeader->magicNumber = htole64(AEDAT3_NETWORK_MAGIC_NUMBER);
+	networkHeader->sequenceNumber = htole64(0);
+	networkHeader->versionNumber = AEDAT3_NETWORK_VERSION;
+	networkHeader->formatNumber = state->formatID; // Send numeric format ID.
+	networkHeader->sourceID = htole16(I16T(atomic_load(&state->sourceID))); // Always one source per output module.
 }
 
 static bool writeNetworkHeader(outputCommonNetIO streams, libuvWriteBuf buf, bool startOfUDPPacket) {
@@ -1233,6 +2241,12 @@ static bool writeNetworkHeader(outputCommonNetIO streams, libuvWriteBuf buf, boo
 		return (false);
 	}
 
+	fillNetworkHeader(streams, (uint8_t *) buf->buf.base, startOfUDPPacket);
+
+	return (true);
+}
+
+static void fillNetworkHeader(outputCommonNetIO streams, uint8_t *headerBuffer, bool startOfUDPPacket) {
 	if (streams->isUDP && startOfUDPPacket) {
 		// Set highest bit of sequence number to one.
 		streams->networkHeader.sequenceNumber = htole64(
@@ -1240,7 +2254,7 @@ static bool writeNetworkHeader(outputCommonNetIO streams, libuvWriteBuf buf, boo
 	}
 
 	// Copy in current header.
-	memcpy(buf->buf.base, &streams->networkHeader, AEDAT3_NETWORK_HEADER_LENGTH);
+	memcpy(headerBuffer, &streams->networkHeader, AEDAT3_NETWORK_HEADER_LENGTH);
 
 	if (streams->isUDP) {
 		if (startOfUDPPacket) {
@@ -1253,41 +2267,39 @@ static bool writeNetworkHeader(outputCommonNetIO streams, libuvWriteBuf buf, boo
 		// message-based network protocol (UDP for example).
 		streams->networkHeader.sequenceNumber = htole64(I64T(le64toh(streams->networkHeader.sequenceNumber) + 1));
 	}
-
-	return (true);
 }
 
-static void writeFileHeader(outputCommonState state) {
+static void writeFileHeader(outputCommonState state, int fileDescriptor) {
 	// Write AEDAT 3.1 header.
-	writeUntilDone(state->fileIO, (const uint8_t *) "#!AER-DAT" AEDAT3_FILE_VERSION "\r\n",
+	writeUntilDone(fileDescriptor, (const uint8_t *) "#!AER-DAT" AEDAT3_FILE_VERSION "\r\n",
 		11 + strlen(AEDAT3_FILE_VERSION));
 
 	// Write format header for all supported formats.
-	writeUntilDone(state->fileIO, (const uint8_t *) "#Format: ", 9);
+	writeUntilDone(fileDescriptor, (const uint8_t *) "#Format: ", 9);
 
 	if (state->formatID == 0x00) {
-		writeUntilDone(state->fileIO, (const uint8_t *) "RAW", 3);
+		writeUntilDone(fileDescriptor, (const uint8_t *) "RAW", 3);
 	}
 	else {
 		// Support the various formats and their mixing.
 		if (state->formatID == 0x01) {
-			writeUntilDone(state->fileIO, (const uint8_t *) "SerializedTS", 12);
+			writeUntilDone(fileDescriptor, (const uint8_t *) "SerializedTS", 12);
 		}
 
 		if (state->formatID == 0x02) {
-			writeUntilDone(state->fileIO, (const uint8_t *) "PNGFrames", 9);
+			writeUntilDone(fileDescriptor, (const uint8_t *) "PNGFrames", 9);
 		}
 
 		if (state->formatID == 0x03) {
 			// Serial and PNG together.
-			writeUntilDone(state->fileIO, (const uint8_t *) "SerializedTS,PNGFrames", 12 + 1 + 9);
+			writeUntilDone(fileDescriptor, (const uint8_t *) "SerializedTS,PNGFrames", 12 + 1 + 9);
 		}
 	}
 
-	writeUntilDone(state->fileIO, (const uint8_t *) "\r\n", 2);
+	writeUntilDone(fileDescriptor, (const uint8_t *) "\r\n", 2);
 
 	char *sourceString = sshsNodeGetString(state->sourceInfoNode, "sourceString");
-	writeUntilDone(state->fileIO, (const uint8_t *) sourceString, strlen(sourceString));
+	writeUntilDone(fileDescriptor, (const uint8_t *) sourceString, strlen(sourceString));
 	free(sourceString);
 
 	// First prepend the time.
@@ -1320,9 +2332,9 @@ static void writeFileHeader(outputCommonState state) {
 	strftime(currentTimeString, currentTimeStringLength + 1, "#Start-Time: %Y-%m-%d %H:%M:%S (TZ%z)\r\n", &currentTime);
 #endif
 
-	writeUntilDone(state->fileIO, (const uint8_t *) currentTimeString, currentTimeStringLength);
+	writeUntilDone(fileDescriptor, (const uint8_t *) currentTimeString, currentTimeStringLength);
 
-	writeUntilDone(state->fileIO, (const uint8_t *) "#!END-HEADER\r\n", 14);
+	writeUntilDone(fileDescriptor, (const uint8_t *) "#!END-HEADER\r\n", 14);
 }
 
 void caerOutputCommonOnServerConnection(uv_stream_t *server, int status) {
@@ -1385,7 +2397,8 @@ void caerOutputCommonOnServerConnection(uv_stream_t *server, int status) {
 			retVal = libuvWrite(client, buffers);
 			UV_RET_CHECK(retVal, __func__, "libuvWrite", libuvWriteBufFree(buffers); goto killConnection);
 
-			// Ready now for more data, so set client field for writePacket().
+			// Ready now for more data, so set client field for writePacketBatch().
+			clientQueueInit(streams, i, client);
 			streams->clients[i] = client;
 			streams->activeClients++;
 
@@ -1424,7 +2437,8 @@ void caerOutputCommonOnClientConnection(uv_connect_t *connectionRequest, int sta
 	int retVal = libuvWrite(connectionRequest->handle, buffers);
 	UV_RET_CHECK(retVal, __func__, "libuvWrite", libuvWriteBufFree(buffers); goto cleanupRequest);
 
-	// Ready now for more data, so set client field for writePacket().
+	// Ready now for more data, so set client field for writePacketBatch().
+	clientQueueInit(streams, 0, connectionRequest->handle);
 	streams->clients[0] = connectionRequest->handle;
 	streams->activeClients++;
 
@@ -1433,13 +2447,40 @@ void caerOutputCommonOnClientConnection(uv_connect_t *connectionRequest, int sta
 	}
 }
 
+/**
+ * Enable seamless file rotation for a file output. Must be called before
+ * caerOutputCommonInit(). The rotation thresholds are taken from the
+ * 'rotateMaxSize' (MiB) and 'rotateMaxTime' (minutes) attributes of the
+ * module's configuration node, zero disables the respective threshold.
+ *
+ * @param moduleData output module data.
+ * @param fileOpen function to open the next output file.
+ */
+void caerOutputCommonSetFileRotation(caerModuleData moduleData, outputCommonFileOpen fileOpen) {
+	outputCommonState state = moduleData->moduleState;
+
+	state->fileOpen = fileOpen;
+}
+
+void caerOutputCommonSetSharedMemory(caerModuleData moduleData, struct caer_shared_ring *sharedRing) {
+	outputCommonState state = moduleData->moduleState;
+
+	state->sharedRing = sharedRing;
+}
+
 bool caerOutputCommonInit(caerModuleData moduleData, int fileDescriptor, outputCommonNetIO streams) {
 	outputCommonState state = moduleData->moduleState;
 
 	state->parentModule = moduleData;
 
 	// Check for invalid input combinations.
-	if ((fileDescriptor < 0 && streams == NULL) || (fileDescriptor != -1 && streams != NULL)) {
+	// Shared memory outputs have neither file descriptor nor streams.
+	if (state->sharedRing != NULL) {
+		if (fileDescriptor != -1 || streams != NULL) {
+			return (false);
+		}
+	}
+	else if ((fileDescriptor < 0 && streams == NULL) || (fileDescriptor != -1 && streams != NULL)) {
 		return (false);
 	}
 
@@ -1468,6 +2509,35 @@ bool caerOutputCommonInit(caerModuleData moduleData, int fileDescriptor, outputC
 	// Format configuration (compression modes).
 	state->formatID = 0x00; // RAW format by default.
 
+	// File rotation configuration (file outputs only).
+	if (!state->isNetworkStream && state->fileOpen != NULL) {
+		sshsNodePutIntIfAbsent(moduleData->moduleNode, "rotateMaxSize", 0); // in MiB, 0 = disabled
+		sshsNodePutIntIfAbsent(moduleData->moduleNode, "rotateMaxTime", 0); // in minutes, 0 = disabled
+
+		atomic_store(&state->rotateMaxSize, sshsNodeGetInt(moduleData->moduleNode, "rotateMaxSize"));
+		atomic_store(&state->rotateMaxTime, sshsNodeGetInt(moduleData->moduleNode, "rotateMaxTime"));
+
+		state->fileBytesSent = 0;
+		portable_clock_gettime_monotonic(&state->fileStartTime);
+
+		// Pre-trigger recording, only changes here at init time!
+		sshsNodePutBoolIfAbsent(moduleData->moduleNode, "preTrigger", false); // only write data around triggers
+		sshsNodePutIntIfAbsent(moduleData->moduleNode, "preTriggerTime", 10000); // in ms, data kept from before trigger
+		sshsNodePutIntIfAbsent(moduleData->moduleNode, "preTriggerMaxSize", 512); // in MiB, memory limit for the above
+		sshsNodePutIntIfAbsent(moduleData->moduleNode, "postTriggerTime", 10000); // in ms, recording after last trigger
+		sshsNodePutBoolIfAbsent(moduleData->moduleNode, "triggerOnExternalInput", true); // external input events trigger
+		sshsNodePutBool(moduleData->moduleNode, "trigger", false); // set to trigger, from GUI or other modules
+
+		state->preTriggerMode = sshsNodeGetBool(moduleData->moduleNode, "preTrigger");
+
+		atomic_store(&state->preTriggerTime, sshsNodeGetInt(moduleData->moduleNode, "preTriggerTime"));
+		atomic_store(&state->preTriggerMaxSize, sshsNodeGetInt(moduleData->moduleNode, "preTriggerMaxSize"));
+		atomic_store(&state->postTriggerTime, sshsNodeGetInt(moduleData->moduleNode, "postTriggerTime"));
+		atomic_store(&state->triggerOnExternalInput,
+			sshsNodeGetBool(moduleData->moduleNode, "triggerOnExternalInput"));
+		atomic_store(&state->triggerPending, false);
+	}
+
 	// Initialize compressor ring-buffer. ringBufferSize only changes here at init time!
 	state->compressorRing = ringBufferInit((size_t) ringSize);
 	if (state->compressorRing == NULL) {
@@ -1502,6 +2572,46 @@ bool caerOutputCommonInit(caerModuleData moduleData, int fileDescriptor, outputC
 		retVal = uv_idle_start(&state->networkIO->ringBufferGet, &libuvRingBufferGet);
 		UV_RET_CHECK(retVal, state->parentModule->moduleSubSystemString, "uv_idle_start",
 			uv_close((uv_handle_t *) &state->networkIO->ringBufferGet, NULL); uv_close((uv_handle_t *) &state->networkIO->shutdown, NULL); ringBufferFree(state->compressorRing); ringBufferFree(state->outputRing); return (false));
+
+		// Stream outputs (TCP/Pipe) get bounded per-client send queues.
+		state->networkIO->clientQueues = NULL;
+
+		if (!state->networkIO->isUDP) {
+			sshsNodePutStringIfAbsent(moduleData->moduleNode, "slowClientPolicy", "dropNewest"); // dropNewest, dropOldest or disconnect
+			sshsNodePutIntIfAbsent(moduleData->moduleNode, "clientQueueSize", 1024); // in KiB, per client
+			sshsNodePutIntIfAbsent(moduleData->moduleNode, "clientMaxLag", 2000); // in ms, for disconnect policy
+
+			char *slowClientPolicy = sshsNodeGetString(moduleData->moduleNode, "slowClientPolicy");
+			atomic_store(&state->slowClientPolicy, parseSlowClientPolicy(slowClientPolicy));
+			free(slowClientPolicy);
+
+			atomic_store(&state->clientQueueSize, sshsNodeGetInt(moduleData->moduleNode, "clientQueueSize"));
+			atomic_store(&state->clientMaxLag, sshsNodeGetInt(moduleData->moduleNode, "clientMaxLag"));
+
+			state->networkIO->clientQueues = calloc(state->networkIO->clientsSize,
+				sizeof(struct output_common_client_queue));
+			if (state->networkIO->clientQueues == NULL) {
+				uv_idle_stop(&state->networkIO->ringBufferGet);
+				uv_close((uv_handle_t *) &state->networkIO->ringBufferGet, NULL);
+				uv_close((uv_handle_t *) &state->networkIO->shutdown, NULL);
+				ringBufferFree(state->compressorRing);
+				ringBufferFree(state->outputRing);
+
+				caerLog(CAER_LOG_ERROR, state->parentModule->moduleSubSystemString,
+					"Failed to allocate client queues.");
+				return (false);
+			}
+
+			// Publish per-client statistics to SSHS once a second.
+			state->networkIO->clientStatistics.data = state;
+			retVal = uv_timer_init(&state->networkIO->loop, &state->networkIO->clientStatistics);
+			UV_RET_CHECK(retVal, state->parentModule->moduleSubSystemString, "uv_timer_init",
+				free(state->networkIO->clientQueues); uv_idle_stop(&state->networkIO->ringBufferGet); uv_close((uv_handle_t *) &state->networkIO->ringBufferGet, NULL); uv_close((uv_handle_t *) &state->networkIO->shutdown, NULL); ringBufferFree(state->compressorRing); ringBufferFree(state->outputRing); return (false));
+
+			retVal = uv_timer_start(&state->networkIO->clientStatistics, &libuvClientStatistics, 1000, 1000);
+			UV_RET_CHECK(retVal, state->parentModule->moduleSubSystemString, "uv_timer_start",
+				uv_close((uv_handle_t *) &state->networkIO->clientStatistics, NULL); free(state->networkIO->clientQueues); uv_idle_stop(&state->networkIO->ringBufferGet); uv_close((uv_handle_t *) &state->networkIO->ringBufferGet, NULL); uv_close((uv_handle_t *) &state->networkIO->shutdown, NULL); ringBufferFree(state->compressorRing); ringBufferFree(state->outputRing); return (false));
+		}
 	}
 
 	// Start output handling thread.
@@ -1512,6 +2622,12 @@ bool caerOutputCommonInit(caerModuleData moduleData, int fileDescriptor, outputC
 			uv_idle_stop(&state->networkIO->ringBufferGet);
 			uv_close((uv_handle_t *) &state->networkIO->ringBufferGet, NULL);
 			uv_close((uv_handle_t *) &state->networkIO->shutdown, NULL);
+
+			if (state->networkIO->clientQueues != NULL) {
+				uv_timer_stop(&state->networkIO->clientStatistics);
+				uv_close((uv_handle_t *) &state->networkIO->clientStatistics, NULL);
+				free(state->networkIO->clientQueues);
+			}
 		}
 		ringBufferFree(state->compressorRing);
 		ringBufferFree(state->outputRing);
@@ -1534,6 +2650,12 @@ bool caerOutputCommonInit(caerModuleData moduleData, int fileDescriptor, outputC
 			uv_idle_stop(&state->networkIO->ringBufferGet);
 			uv_close((uv_handle_t *) &state->networkIO->ringBufferGet, NULL);
 			uv_close((uv_handle_t *) &state->networkIO->shutdown, NULL);
+
+			if (state->networkIO->clientQueues != NULL) {
+				uv_timer_stop(&state->networkIO->clientStatistics);
+				uv_close((uv_handle_t *) &state->networkIO->clientStatistics, NULL);
+				free(state->networkIO->clientQueues);
+			}
 		}
 		ringBufferFree(state->compressorRing);
 		ringBufferFree(state->outputRing);
@@ -1612,10 +2734,24 @@ void caerOutputCommonExit(caerModuleData moduleData) {
 			free(state->networkIO->clients[i]);
 		}
 
+		if (state->networkIO->clientQueues != NULL) {
+			for (size_t i = 0; i < state->networkIO->clientsSize; i++) {
+				clientQueueClear(state->networkIO, i);
+			}
+
+			free(state->networkIO->clientQueues);
+		}
+
 		free(state->networkIO->server);
 		free(state->networkIO->address);
 		free(state->networkIO);
 	}
+	else if (state->sharedRing != NULL) {
+#if !defined(OS_WINDOWS)
+		// Readers see the stream closing, then remove the ring.
+		caerSharedRingDestroy(state->sharedRing);
+#endif
+	}
 	else {
 		// Ensure all data written to disk.
 		portable_fsync(state->fileIO);
@@ -1649,5 +2785,45 @@ static void caerOutputCommonConfigListener(sshsNode node, void *userData, enum s
 			// Set keep packets flag to given value.
 			atomic_store(&state->keepPackets, changeValue.boolean);
 		}
+		else if (changeType == SSHS_STRING && caerStrEquals(changeKey, "slowClientPolicy")) {
+			// Set slow client policy to given value.
+			atomic_store(&state->slowClientPolicy, parseSlowClientPolicy(changeValue.string));
+		}
+		else if (changeType == SSHS_INT && caerStrEquals(changeKey, "clientQueueSize")) {
+			// Set per-client queue size to given value.
+			atomic_store(&state->clientQueueSize, changeValue.iint);
+		}
+		else if (changeType == SSHS_INT && caerStrEquals(changeKey, "clientMaxLag")) {
+			// Set slow client lag threshold to given value.
+			atomic_store(&state->clientMaxLag, changeValue.iint);
+		}
+		else if (changeType == SSHS_INT && caerStrEquals(changeKey, "rotateMaxSize")) {
+			// Set file rotation size threshold to given value.
+			atomic_store(&state->rotateMaxSize, changeValue.iint);
+		}
+		else if (changeType == SSHS_INT && caerStrEquals(changeKey, "rotateMaxTime")) {
+			// Set file rotation time threshold to given value.
+			atomic_store(&state->rotateMaxTime, changeValue.iint);
+		}
+		else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "trigger") && changeValue.boolean) {
+			// Trigger a pre-trigger recording, reset by the output thread.
+			atomic_store(&state->triggerPending, true);
+		}
+		else if (changeType == SSHS_BOOL && caerStrEquals(changeKey, "triggerOnExternalInput")) {
+			// Set external input trigger flag to given value.
+			atomic_store(&state->triggerOnExternalInput, changeValue.boolean);
+		}
+		else if (changeType == SSHS_INT && caerStrEquals(changeKey, "preTriggerTime")) {
+			// Set pre-trigger time to given value.
+			atomic_store(&state->preTriggerTime, changeValue.iint);
+		}
+		else if (changeType == SSHS_INT && caerStrEquals(changeKey, "preTriggerMaxSize")) {
+			// Set pre-trigger memory limit to given value.
+			atomic_store(&state->preTriggerMaxSize, changeValue.iint);
+		}
+		else if (changeType == SSHS_INT && caerStrEquals(changeKey, "postTriggerTime")) {
+			// Set post-trigger time to given value.
+			atomic_store(&state->postTriggerTime, changeValue.iint);
+		}
 	}
 }
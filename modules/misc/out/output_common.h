@@ -5,8 +5,9 @@
 #include "modules/misc/inout_common.h"
 #include "ext/libuv.h"
 
-#define MAX_OUTPUT_RINGBUFFER_GET 10
+#define MAX_OUTPUT_RINGBUFFER_GET 256 // packet buffers gathered into one write
 #define MAX_OUTPUT_QUEUED_SIZE (1 * 1024 * 1024) // 1MB outstanding writes
+#define MAX_OUTPUT_CLIENT_QUEUE_LENGTH 64 // write batches queued per stream client
 
 extern size_t CAER_OUTPUT_COMMON_STATE_STRUCT_SIZE;
 
@@ -20,7 +21,10 @@ struct output_common_netio {
 	uv_loop_t loop;
 	uv_async_t shutdown;
 	uv_idle_t ringBufferGet;
+	uv_timer_t clientStatistics;
 	uv_stream_t *server;
+	/// Per-client send queues (TCP/Pipe only, else NULL), same index as clients.
+	struct output_common_client_queue *clientQueues;
 	size_t activeClients;
 	size_t clientsSize;
 	uv_stream_t *clients[];
@@ -28,6 +32,15 @@ struct output_common_netio {
 
 typedef struct output_common_netio *outputCommonNetIO;
 
+/// Open the next output file for rotation, returning its file descriptor (or -1 on failure).
+typedef int (*outputCommonFileOpen)(caerModuleData moduleData);
+
+/// Shared memory ring (see modules/misc/inout_shared_memory.h).
+struct caer_shared_ring;
+
+void caerOutputCommonSetFileRotation(caerModuleData moduleData, outputCommonFileOpen fileOpen);
+/// Write to a shared memory ring instead of a file or stream. Output common takes ownership of it.
+void caerOutputCommonSetSharedMemory(caerModuleData moduleData, struct caer_shared_ring *sharedRing);
 bool caerOutputCommonInit(caerModuleData moduleData, int fileDescriptor, outputCommonNetIO streams);
 void caerOutputCommonExit(caerModuleData moduleData);
 void caerOutputCommonRun(caerModuleData moduleData, size_t argsNumber, va_list args);
@@ -0,0 +1,58 @@
+#include "shared_memory.h"
+#include "base/mainloop.h"
+#include "base/module.h"
+#include "output_common.h"
+#include "modules/misc/inout_shared_memory.h"
+
+static bool caerOutputSharedMemoryInit(caerModuleData moduleData);
+
+static struct caer_module_functions caerOutputSharedMemoryFunctions = { .moduleInit = &caerOutputSharedMemoryInit,
+	.moduleRun = &caerOutputCommonRun, .moduleConfig = NULL, .moduleExit = &caerOutputCommonExit, .moduleReset =
+		&caerOutputCommonReset };
+
+void caerOutputSharedMemory(uint16_t moduleID, size_t outputTypesNumber, ...) {
+	caerModuleData moduleData = caerMainloopFindModule(moduleID, "SharedMemoryOutput", CAER_MODULE_OUTPUT);
+	if (moduleData == NULL) {
+		return;
+	}
+
+	va_list args;
+	va_start(args, outputTypesNumber);
+	caerModuleSMv(&caerOutputSharedMemoryFunctions, moduleData, CAER_OUTPUT_COMMON_STATE_STRUCT_SIZE,
+		outputTypesNumber, args);
+	va_end(args);
+}
+
+static bool caerOutputSharedMemoryInit(caerModuleData moduleData) {
+	// First, always create all needed setting nodes, set their default values
+	// and add their listeners.
+	sshsNodePutStringIfAbsent(moduleData->moduleNode, "shmName", "/caer"); // POSIX shared memory name, /dev/shm/caer on Linux
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "shmSize", 16384); // in KiB, size of the ring's data area
+
+	char *shmName = sshsNodeGetString(moduleData->moduleNode, "shmName");
+	size_t shmSize = (size_t) sshsNodeGetInt(moduleData->moduleNode, "shmSize") * 1024;
+
+	// Create the shared memory ring, readers on the same host map it read-only.
+	caerSharedRing sharedRing = caerSharedRingCreate(shmName, shmSize);
+	if (sharedRing == NULL) {
+		caerLog(CAER_LOG_CRITICAL, moduleData->moduleSubSystemString,
+			"Could not create shared memory ring '%s'. Error: %d.", shmName, errno);
+		free(shmName);
+		return (false);
+	}
+
+	caerOutputCommonSetSharedMemory(moduleData, sharedRing);
+
+	if (!caerOutputCommonInit(moduleData, -1, NULL)) {
+		caerSharedRingDestroy(sharedRing);
+		free(shmName);
+		return (false);
+	}
+
+	caerLog(CAER_LOG_INFO, moduleData->moduleSubSystemString, "Shared memory ring ready at '%s' (%zu KiB).",
+		shmName, shmSize / 1024);
+
+	free(shmName);
+
+	return (true);
+}
@@ -0,0 +1,8 @@
+#ifndef OUTPUT_SHARED_MEMORY_H_
+#define OUTPUT_SHARED_MEMORY_H_
+
+#include "main.h"
+
+void caerOutputSharedMemory(uint16_t moduleID, size_t outputTypesNumber, ...);
+
+#endif /* OUTPUT_SHARED_MEMORY_H_ */
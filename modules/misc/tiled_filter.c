@@ -0,0 +1,362 @@
+#include "tiled_filter.h"
+
+static int tiledFilterWorkerThread(void *tfPtr);
+static void tiledFilterProcessTiles(caerTiledFilter tf);
+static void tiledFilterStopWorkers(caerTiledFilter tf, size_t workersStarted);
+static size_t tiledFilterPartition(caerTiledFilter tf, caerPolarityEventPacket polarity, bool fill);
+
+bool caerTiledFilterInit(caerTiledFilter tf, int16_t sizeX, int16_t sizeY, int8_t subSampleBy, int16_t tileSize,
+	int16_t halo, size_t threads, const char *logSubSystem) {
+	snprintf(tf->logSubSystem, sizeof(tf->logSubSystem), "%s", logSubSystem);
+
+	if (tileSize <= 0) {
+		tileSize = 1;
+	}
+
+	// A halo wider than a tile would need events from non-adjacent tiles.
+	if (halo > tileSize) {
+		halo = tileSize;
+	}
+
+	tf->sizeX = I16T((sizeX + (1 << subSampleBy) - 1) >> subSampleBy);
+	tf->sizeY = I16T((sizeY + (1 << subSampleBy) - 1) >> subSampleBy);
+	tf->subSampleBy = subSampleBy;
+	tf->tileSize = tileSize;
+	tf->halo = halo;
+	tf->tilesX = I16T((tf->sizeX + tileSize - 1) / tileSize);
+	tf->tilesY = I16T((tf->sizeY + tileSize - 1) / tileSize);
+	tf->tilesNumber = (size_t) tf->tilesX * (size_t) tf->tilesY;
+
+	tf->tiles = calloc(tf->tilesNumber, sizeof(struct caer_tiled_filter_tile));
+	if (tf->tiles == NULL) {
+		caerLog(CAER_LOG_ERROR, tf->logSubSystem, "Failed to allocate memory for tiles.");
+		return (false);
+	}
+
+	for (int16_t ty = 0; ty < tf->tilesY; ty++) {
+		for (int16_t tx = 0; tx < tf->tilesX; tx++) {
+			struct caer_tiled_filter_tile *tile = &tf->tiles[(ty * tf->tilesX) + tx];
+
+			tile->originX = I16T(tx * tileSize);
+			tile->originY = I16T(ty * tileSize);
+			tile->sizeX = I16T((tf->sizeX - tile->originX < tileSize) ? (tf->sizeX - tile->originX) : (tileSize));
+			tile->sizeY = I16T((tf->sizeY - tile->originY < tileSize) ? (tf->sizeY - tile->originY) : (tileSize));
+		}
+	}
+
+	// The calling thread works on tiles too, so start one less.
+	tf->workersNumber = (threads > 1) ? (threads - 1) : (0);
+
+	if (tf->workersNumber == 0) {
+		return (true);
+	}
+
+	tf->workers = calloc(tf->workersNumber, sizeof(thrd_t));
+	if (tf->workers == NULL) {
+		free(tf->tiles);
+		tf->tiles = NULL;
+
+		caerLog(CAER_LOG_ERROR, tf->logSubSystem, "Failed to allocate memory for worker threads.");
+		return (false);
+	}
+
+	if (mtx_init(&tf->poolLock, mtx_plain) != thrd_success) {
+		free(tf->workers);
+		tf->workers = NULL;
+		free(tf->tiles);
+		tf->tiles = NULL;
+
+		caerLog(CAER_LOG_ERROR, tf->logSubSystem, "Failed to initialize worker pool lock.");
+		return (false);
+	}
+
+	if (cnd_init(&tf->poolStart) != thrd_success) {
+		mtx_destroy(&tf->poolLock);
+		free(tf->workers);
+		tf->workers = NULL;
+		free(tf->tiles);
+		tf->tiles = NULL;
+
+		caerLog(CAER_LOG_ERROR, tf->logSubSystem, "Failed to initialize worker pool condition.");
+		return (false);
+	}
+
+	if (cnd_init(&tf->poolDone) != thrd_success) {
+		cnd_destroy(&tf->poolStart);
+		mtx_destroy(&tf->poolLock);
+		free(tf->workers);
+		tf->workers = NULL;
+		free(tf->tiles);
+		tf->tiles = NULL;
+
+		caerLog(CAER_LOG_ERROR, tf->logSubSystem, "Failed to initialize worker pool condition.");
+		return (false);
+	}
+
+	tf->poolGeneration = 0;
+	tf->poolBusy = 0;
+	tf->poolRunning = true;
+
+	for (size_t i = 0; i < tf->workersNumber; i++) {
+		if (thrd_create(&tf->workers[i], &tiledFilterWorkerThread, tf) != thrd_success) {
+			tiledFilterStopWorkers(tf, i);
+
+			free(tf->tiles);
+			tf->tiles = NULL;
+
+			caerLog(CAER_LOG_ERROR, tf->logSubSystem, "Failed to start worker thread %zu.", i);
+			return (false);
+		}
+	}
+
+	return (true);
+}
+
+void caerTiledFilterDestroy(caerTiledFilter tf) {
+	if (tf->workersNumber > 0 && tf->workers != NULL) {
+		tiledFilterStopWorkers(tf, tf->workersNumber);
+	}
+
+	free(tf->tiles);
+	tf->tiles = NULL;
+
+	free(tf->events);
+	tf->events = NULL;
+	tf->eventsCapacity = 0;
+
+	free(tf->invalidate);
+	tf->invalidate = NULL;
+	tf->invalidateCapacity = 0;
+}
+
+int32_t caerTiledFilterRun(caerTiledFilter tf, caerPolarityEventPacket polarity, caerTiledFilterKernel kernel,
+	void *userData) {
+	int32_t eventsNumber = caerEventPacketHeaderGetEventNumber(&polarity->packetHeader);
+	if (eventsNumber <= 0) {
+		return (0);
+	}
+
+	// First pass only counts, so memory can be sized exactly.
+	size_t partitionedNumber = tiledFilterPartition(tf, polarity, false);
+
+	if (partitionedNumber > tf->eventsCapacity) {
+		struct caer_tiled_filter_event *newEvents = realloc(tf->events,
+			partitionedNumber * sizeof(struct caer_tiled_filter_event));
+		if (newEvents == NULL) {
+			caerLog(CAER_LOG_ERROR, tf->logSubSystem, "Failed to allocate memory for partitioned events.");
+			return (-1);
+		}
+
+		tf->events = newEvents;
+		tf->eventsCapacity = partitionedNumber;
+	}
+
+	if ((size_t) eventsNumber > tf->invalidateCapacity) {
+		uint8_t *newInvalidate = realloc(tf->invalidate, (size_t) eventsNumber);
+		if (newInvalidate == NULL) {
+			caerLog(CAER_LOG_ERROR, tf->logSubSystem, "Failed to allocate memory for invalidate flags.");
+			return (-1);
+		}
+
+		tf->invalidate = newInvalidate;
+		tf->invalidateCapacity = (size_t) eventsNumber;
+	}
+
+	memset(tf->invalidate, 0, (size_t) eventsNumber);
+
+	// Lay out the tiles' events back to back.
+	size_t offset = 0;
+
+	for (size_t t = 0; t < tf->tilesNumber; t++) {
+		tf->tiles[t].events = &tf->events[offset];
+		offset += tf->tiles[t].eventsNumber;
+	}
+
+	// Second pass puts the events in place, in packet order per tile.
+	tiledFilterPartition(tf, polarity, true);
+
+	tf->kernel = kernel;
+	tf->kernelUserData = userData;
+	atomic_store(&tf->nextTile, 0);
+
+	if (tf->workersNumber > 0) {
+		mtx_lock(&tf->poolLock);
+
+		tf->poolGeneration++;
+		tf->poolBusy = tf->workersNumber;
+		cnd_broadcast(&tf->poolStart);
+
+		mtx_unlock(&tf->poolLock);
+	}
+
+	tiledFilterProcessTiles(tf);
+
+	if (tf->workersNumber > 0) {
+		mtx_lock(&tf->poolLock);
+
+		while (tf->poolBusy > 0) {
+			cnd_wait(&tf->poolDone, &tf->poolLock);
+		}
+
+		mtx_unlock(&tf->poolLock);
+	}
+
+	// Merge results back, in packet order. Done here and not in the kernels,
+	// as invalidating updates the packet's valid events counter.
+	int32_t invalidated = 0;
+
+	for (int32_t i = 0; i < eventsNumber; i++) {
+		if (tf->invalidate[i]) {
+			caerPolarityEventInvalidate(caerPolarityEventPacketGetEvent(polarity, i), polarity);
+			invalidated++;
+		}
+	}
+
+	return (invalidated);
+}
+
+static int tiledFilterWorkerThread(void *tfPtr) {
+	caerTiledFilter tf = tfPtr;
+
+	thrd_set_name("TiledFilterWorker");
+
+	uint64_t seenGeneration = 0;
+
+	mtx_lock(&tf->poolLock);
+
+	while (true) {
+		while (tf->poolRunning && tf->poolGeneration == seenGeneration) {
+			cnd_wait(&tf->poolStart, &tf->poolLock);
+		}
+
+		if (!tf->poolRunning) {
+			break;
+		}
+
+		seenGeneration = tf->poolGeneration;
+
+		mtx_unlock(&tf->poolLock);
+
+		tiledFilterProcessTiles(tf);
+
+		mtx_lock(&tf->poolLock);
+
+		tf->poolBusy--;
+		if (tf->poolBusy == 0) {
+			cnd_signal(&tf->poolDone);
+		}
+	}
+
+	mtx_unlock(&tf->poolLock);
+
+	return (EXIT_SUCCESS);
+}
+
+static void tiledFilterProcessTiles(caerTiledFilter tf) {
+	// Tiles are handed out dynamically, so busy regions don't stall a fixed thread.
+	size_t tileIndex;
+
+	while ((tileIndex = atomic_fetch_add(&tf->nextTile, 1)) < tf->tilesNumber) {
+		struct caer_tiled_filter_tile *tile = &tf->tiles[tileIndex];
+
+		if (tile->eventsNumber == 0) {
+			continue;
+		}
+
+		(*tf->kernel)(tf->kernelUserData, tile, tf->invalidate);
+	}
+}
+
+static void tiledFilterStopWorkers(caerTiledFilter tf, size_t workersStarted) {
+	mtx_lock(&tf->poolLock);
+
+	tf->poolRunning = false;
+	cnd_broadcast(&tf->poolStart);
+
+	mtx_unlock(&tf->poolLock);
+
+	for (size_t i = 0; i < workersStarted; i++) {
+		if (thrd_join(tf->workers[i], NULL) != thrd_success) {
+			caerLog(CAER_LOG_ERROR, tf->logSubSystem, "Failed to join worker thread %zu.", i);
+		}
+	}
+
+	cnd_destroy(&tf->poolDone);
+	cnd_destroy(&tf->poolStart);
+	mtx_destroy(&tf->poolLock);
+
+	free(tf->workers);
+	tf->workers = NULL;
+}
+
+/**
+ * Assign each valid event to its tile and, if it lies within 'halo' pixels
+ * of the tile border, to the adjacent tiles as halo event.
+ * When 'fill' is false, only count events per tile; when true, also store
+ * them, which requires the tiles' event pointers to be laid out according
+ * to a counting pass on the same packet.
+ *
+ * @return total number of partitioned events, including halo copies.
+ */
+static size_t tiledFilterPartition(caerTiledFilter tf, caerPolarityEventPacket polarity, bool fill) {
+	int32_t eventsNumber = caerEventPacketHeaderGetEventNumber(&polarity->packetHeader);
+	int16_t tileSize = tf->tileSize;
+	int16_t halo = tf->halo;
+
+	for (size_t t = 0; t < tf->tilesNumber; t++) {
+		tf->tiles[t].eventsNumber = 0;
+	}
+
+	for (int32_t i = 0; i < eventsNumber; i++) {
+		caerPolarityEvent event = caerPolarityEventPacketGetEvent(polarity, i);
+
+		if (!caerPolarityEventIsValid(event)) {
+			continue;
+		}
+
+		int16_t x = I16T(caerPolarityEventGetX(event) >> tf->subSampleBy);
+		int16_t y = I16T(caerPolarityEventGetY(event) >> tf->subSampleBy);
+
+		if (x >= tf->sizeX || y >= tf->sizeY) {
+			continue;
+		}
+
+		int16_t tx = I16T(x / tileSize);
+		int16_t ty = I16T(y / tileSize);
+		const struct caer_tiled_filter_tile *ownTile = &tf->tiles[(ty * tf->tilesX) + tx];
+
+		// Range of tiles this event is relevant to, in tile coordinates.
+		int16_t txStart = (x - ownTile->originX < halo && tx > 0) ? I16T(tx - 1) : (tx);
+		int16_t txEnd = (x - ownTile->originX >= ownTile->sizeX - halo && tx < tf->tilesX - 1) ? I16T(tx + 1) : (tx);
+		int16_t tyStart = (y - ownTile->originY < halo && ty > 0) ? I16T(ty - 1) : (ty);
+		int16_t tyEnd = (y - ownTile->originY >= ownTile->sizeY - halo && ty < tf->tilesY - 1) ? I16T(ty + 1) : (ty);
+
+		int64_t timestamp = (fill) ? (caerPolarityEventGetTimestamp64(event, polarity)) : (0);
+
+		for (int16_t nty = tyStart; nty <= tyEnd; nty++) {
+			for (int16_t ntx = txStart; ntx <= txEnd; ntx++) {
+				struct caer_tiled_filter_tile *tile = &tf->tiles[(nty * tf->tilesX) + ntx];
+
+				if (fill) {
+					struct caer_tiled_filter_event *tiledEvent = &tile->events[tile->eventsNumber];
+
+					tiledEvent->index = i;
+					tiledEvent->x = I16T(x - tile->originX);
+					tiledEvent->y = I16T(y - tile->originY);
+					tiledEvent->timestamp = timestamp;
+					tiledEvent->halo = (ntx != tx || nty != ty);
+				}
+
+				tile->eventsNumber++;
+			}
+		}
+	}
+
+	size_t total = 0;
+
+	for (size_t t = 0; t < tf->tilesNumber; t++) {
+		total += tf->tiles[t].eventsNumber;
+	}
+
+	return (total);
+}
@@ -0,0 +1,139 @@
+#ifndef TILED_FILTER_H_
+#define TILED_FILTER_H_
+
+#include "main.h"
+
+#ifdef HAVE_PTHREADS
+#include "ext/c11threads_posix.h"
+#endif
+
+#include <stdatomic.h>
+#include <libcaer/events/polarity.h>
+
+/**
+ * Spatially tiled, multi-threaded execution of per-pixel polarity filters.
+ *
+ * The sensor array is cut into square tiles. For each packet, events are
+ * partitioned by tile, keeping packet order inside each tile, and a filter
+ * kernel is run on each tile by a pool of worker threads. Since a tile only
+ * ever sees its own events, the kernel can keep per-tile state without any
+ * locking. Filters that look at a neighborhood of radius 'halo' around each
+ * pixel additionally get the events falling within 'halo' pixels outside
+ * their tile, flagged as halo events: those must only be used to update
+ * state, never be judged, as they belong to a different tile.
+ *
+ * Kernels don't touch the packet: they mark events to invalidate in a flag
+ * array indexed by packet position, which is then applied in packet order
+ * once all tiles are done.
+ */
+
+struct caer_tiled_filter_event {
+	/// Position of the event inside the packet.
+	int32_t index;
+	/// Tile-local coordinates, in [-halo, tileSize + halo).
+	int16_t x;
+	int16_t y;
+	/// Full 64 bit timestamp of the event.
+	int64_t timestamp;
+	/// Event belongs to a neighboring tile, update state only.
+	bool halo;
+};
+
+struct caer_tiled_filter_tile {
+	/// Tile position in the (sub-sampled) pixel array.
+	int16_t originX;
+	int16_t originY;
+	/// Tile size, smaller than tileSize for the last row/column.
+	int16_t sizeX;
+	int16_t sizeY;
+	/// Per-tile filter state, owned by the user of the framework.
+	void *state;
+	/// Events for this tile in packet order, valid during a kernel call only.
+	struct caer_tiled_filter_event *events;
+	size_t eventsNumber;
+};
+
+/**
+ * Kernel run on each tile. Must only touch the tile's own state and the
+ * invalidate flags of the tile's own (non-halo) events.
+ *
+ * @param userData pointer passed to caerTiledFilterRun().
+ * @param tile the tile to process.
+ * @param invalidate one flag per packet event, set to true to invalidate it.
+ */
+typedef void (*caerTiledFilterKernel)(void *userData, struct caer_tiled_filter_tile *tile, uint8_t *invalidate);
+
+struct caer_tiled_filter {
+	/// Sub-sampled pixel array size and sub-sampling shift applied to event addresses.
+	int16_t sizeX;
+	int16_t sizeY;
+	int8_t subSampleBy;
+	int16_t tileSize;
+	int16_t halo;
+	int16_t tilesX;
+	int16_t tilesY;
+	size_t tilesNumber;
+	struct caer_tiled_filter_tile *tiles;
+	/// Partitioned events for all tiles, and per-packet invalidate flags.
+	struct caer_tiled_filter_event *events;
+	size_t eventsCapacity;
+	uint8_t *invalidate;
+	size_t invalidateCapacity;
+	/// Current job, set up by caerTiledFilterRun() for the workers.
+	caerTiledFilterKernel kernel;
+	void *kernelUserData;
+	atomic_size_t nextTile;
+	/// Worker pool; the calling thread processes tiles too.
+	size_t workersNumber;
+	thrd_t *workers;
+	mtx_t poolLock;
+	cnd_t poolStart;
+	cnd_t poolDone;
+	uint64_t poolGeneration;
+	size_t poolBusy;
+	bool poolRunning;
+	/// Sub-system string for log messages.
+	char logSubSystem[64];
+};
+
+typedef struct caer_tiled_filter *caerTiledFilter;
+
+/**
+ * Initialize a tiled filter and start its worker threads.
+ *
+ * @param tf the tiled filter to initialize, must be zeroed memory.
+ * @param sizeX full resolution pixel array width.
+ * @param sizeY full resolution pixel array height.
+ * @param subSampleBy event addresses are shifted right by this before tiling,
+ *                    tiles are then in sub-sampled coordinates.
+ * @param tileSize side length of square tiles, in sub-sampled pixels.
+ * @param halo neighborhood radius of the filter, 0 for pure per-pixel filters.
+ * @param threads total number of threads processing tiles, including the caller.
+ * @param logSubSystem sub-system string for log messages.
+ *
+ * @return true on success, false on memory or thread creation failure.
+ */
+bool caerTiledFilterInit(caerTiledFilter tf, int16_t sizeX, int16_t sizeY, int8_t subSampleBy, int16_t tileSize,
+	int16_t halo, size_t threads, const char *logSubSystem);
+/**
+ * Stop the worker threads and free all memory held by the tiled filter.
+ * Per-tile state is owned by the caller and must be freed before.
+ *
+ * @param tf the tiled filter to destroy.
+ */
+void caerTiledFilterDestroy(caerTiledFilter tf);
+/**
+ * Partition a packet by tile, run the kernel on all tiles in parallel
+ * and invalidate the marked events, in packet order.
+ *
+ * @param tf the tiled filter.
+ * @param polarity the packet to filter.
+ * @param kernel the kernel to run on each tile.
+ * @param userData pointer passed on to the kernel.
+ *
+ * @return number of events invalidated, or -1 on memory allocation failure.
+ */
+int32_t caerTiledFilterRun(caerTiledFilter tf, caerPolarityEventPacket polarity, caerTiledFilterKernel kernel,
+	void *userData);
+
+#endif /* TILED_FILTER_H_ */
@@ -0,0 +1,594 @@
+#include "opticalflow.h"
+#include "base/mainloop.h"
+#include "base/module.h"
+#include "ext/ringbuffer/portable_aligned_alloc.h"
+#include "ext/relative_timestamps.h"
+
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Neighborhood radius is bounded, so each event costs the same, at most
+// (2 * 5 + 1)^2 timestamps.
+#define OPTICALFLOW_MAX_RADIUS 5
+// Neighborhood rows are processed 4 pixels at a time, padded with masked out pixels.
+#define OPTICALFLOW_WINDOW_WIDTH 12
+// Map rows are padded to a multiple of one cache line (16 x 32 bit).
+#define OPTICALFLOW_MAP_ALIGNMENT 64
+#define OPTICALFLOW_MAP_ROW_ALIGN (OPTICALFLOW_MAP_ALIGNMENT / sizeof(uint32_t))
+
+/**
+ * Surface of active events, one map per polarity. Same layout as the
+ * Background Activity Filter's timestamp map: row-major, with a border of
+ * OPTICALFLOW_MAX_RADIUS cells all around so neighborhoods never need bounds
+ * checks, and timestamps relative to a base (see ext/relative_timestamps.h),
+ * so they fit 32 bit and zero still means "no event yet".
+ */
+struct OpticalFlow_map {
+	uint32_t *cells[2];
+	size_t stride;
+	size_t rows;
+	struct relative_timestamps timestamps;
+};
+
+/**
+ * Plane t = a * dx + b * dy + c, with t in µs relative to the current event
+ * and dx, dy in pixels relative to its position.
+ */
+struct OpticalFlow_plane {
+	float a;
+	float b;
+	float c;
+};
+
+struct OpticalFlow_state {
+	struct OpticalFlow_map map;
+	int16_t sizeX;
+	int16_t sizeY;
+	/// Offsets and lane masks of the neighborhood columns, for the current radius.
+	float windowDX[OPTICALFLOW_WINDOW_WIDTH] __attribute__((__aligned__(16)));
+	uint32_t windowMask[OPTICALFLOW_WINDOW_WIDTH] __attribute__((__aligned__(16)));
+	size_t windowWidth;
+	int32_t radius;
+	int32_t timeWindow;
+	int32_t minPoints;
+	float maxResidual;
+	float minGradient2;
+	float *flowX;
+	float *flowY;
+	int64_t lastFrameTimestamp;
+	int32_t frameInterval;
+	float frameSpeedScale;
+};
+
+typedef struct OpticalFlow_state *OpticalFlowState;
+
+static bool caerOpticalFlowInit(caerModuleData moduleData);
+static void caerOpticalFlowRun(caerModuleData moduleData, size_t argsNumber, va_list args);
+static void caerOpticalFlowConfig(caerModuleData moduleData);
+static void caerOpticalFlowExit(caerModuleData moduleData);
+static void caerOpticalFlowReset(caerModuleData moduleData, uint16_t resetCallSourceID);
+static bool allocateMaps(OpticalFlowState state, int16_t sourceID);
+static void freeMaps(OpticalFlowState state);
+static void resetMaps(OpticalFlowState state);
+static void updateTimestampBase(OpticalFlowState state, int64_t firstTS, int64_t lastTS);
+static bool fitPlane(OpticalFlowState state, const uint32_t *center, uint32_t now,
+	const struct OpticalFlow_plane *reject, float maxResidual, struct OpticalFlow_plane *plane);
+static caerFrameEventPacket renderFrame(caerModuleData moduleData);
+
+static struct caer_module_functions caerOpticalFlowFunctions = { .moduleInit = &caerOpticalFlowInit, .moduleRun =
+	&caerOpticalFlowRun, .moduleConfig = &caerOpticalFlowConfig, .moduleExit = &caerOpticalFlowExit, .moduleReset =
+	&caerOpticalFlowReset };
+
+void caerOpticalFlow(uint16_t moduleID, caerPolarityEventPacket polarity, caerPoint4DEventPacket *flow,
+	caerFrameEventPacket *frame) {
+	// Nothing to return unless the module runs and has something.
+	*flow = NULL;
+	*frame = NULL;
+
+	caerModuleData moduleData = caerMainloopFindModule(moduleID, "OpticalFlow", CAER_MODULE_PROCESSOR);
+	if (moduleData == NULL) {
+		return;
+	}
+
+	caerModuleSM(&caerOpticalFlowFunctions, moduleData, sizeof(struct OpticalFlow_state), 3, polarity, flow, frame);
+}
+
+static bool caerOpticalFlowInit(caerModuleData moduleData) {
+	sshsNodePutByteIfAbsent(moduleData->moduleNode, "radius", 3);
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "timeWindow", 20000); // in µs
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "minPoints", 8);
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "maxResidual", 2000); // in µs, 0 disables refitting
+	sshsNodePutFloatIfAbsent(moduleData->moduleNode, "maxSpeed", 10000.0f); // in pixels/s, 0 disables
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "frameInterval", 0); // in µs, 0 disables frames
+	sshsNodePutFloatIfAbsent(moduleData->moduleNode, "frameSpeedScale", 1000.0f); // in pixels/s
+
+	caerOpticalFlowConfig(moduleData);
+
+	// Add config listeners last, to avoid having them dangling if Init doesn't succeed.
+	sshsNodeAddAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+
+	// Nothing that can fail here.
+	return (true);
+}
+
+static void caerOpticalFlowRun(caerModuleData moduleData, size_t argsNumber, va_list args) {
+	UNUSED_ARGUMENT(argsNumber);
+
+	// Interpret variable arguments (same as above in main function).
+	caerPolarityEventPacket polarity = va_arg(args, caerPolarityEventPacket);
+	caerPoint4DEventPacket *flow = va_arg(args, caerPoint4DEventPacket *);
+	caerFrameEventPacket *frame = va_arg(args, caerFrameEventPacket *);
+
+	// Only process packets with content.
+	if (polarity == NULL || caerEventPacketHeaderGetEventNumber(&polarity->packetHeader) <= 0) {
+		return;
+	}
+
+	OpticalFlowState state = moduleData->moduleState;
+
+	// If the maps are not allocated yet, do it.
+	if (state->map.cells[0] == NULL) {
+		if (!allocateMaps(state, caerEventPacketHeaderGetEventSource(&polarity->packetHeader))) {
+			// Failed to allocate memory, nothing to do.
+			caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate memory for maps.");
+			return;
+		}
+
+		// Frames have the same size as the source, tell the visualizer.
+		sshsNode sourceInfoNode = sshsGetRelativeNode(moduleData->moduleNode, "sourceInfo/");
+		sshsNodePutShort(sourceInfoNode, "dataSizeX", state->sizeX);
+		sshsNodePutShort(sourceInfoNode, "dataSizeY", state->sizeY);
+	}
+
+	int32_t eventsNumber = caerEventPacketHeaderGetEventNumber(&polarity->packetHeader);
+
+	// Events in a packet are ordered by time, so first and last bound all timestamps.
+	int64_t firstTS = caerPolarityEventGetTimestamp64(caerPolarityEventPacketGetEvent(polarity, 0), polarity);
+	int64_t lastTS = caerPolarityEventGetTimestamp64(caerPolarityEventPacketGetEvent(polarity, eventsNumber - 1),
+		polarity);
+
+	updateTimestampBase(state, firstTS, lastTS);
+
+	// At most one flow event per polarity event.
+	caerPoint4DEventPacket flowPacket = caerPoint4DEventPacketAllocate(eventsNumber, I16T(moduleData->moduleID),
+		caerEventPacketHeaderGetEventTSOverflow(&polarity->packetHeader));
+	if (flowPacket == NULL) {
+		caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate flow event packet.");
+		return;
+	}
+
+	struct OpticalFlow_map *map = &state->map;
+	size_t stride = map->stride;
+	const struct OpticalFlow_plane noReject = { 0, 0, 0 };
+	int32_t flowNumber = 0;
+
+	CAER_POLARITY_ITERATOR_VALID_START(polarity)
+		uint16_t x = caerPolarityEventGetX(caerPolarityIteratorElement);
+		uint16_t y = caerPolarityEventGetY(caerPolarityIteratorElement);
+		uint32_t now = relativeTimestampsGet(&map->timestamps,
+			caerPolarityEventGetTimestamp64(caerPolarityIteratorElement, polarity));
+
+		uint32_t *center = &map->cells[caerPolarityEventGetPolarity(caerPolarityIteratorElement)][((size_t) (y
+			+ OPTICALFLOW_MAX_RADIUS) * stride) + x + OPTICALFLOW_MAX_RADIUS];
+		*center = now;
+
+		// Fit a plane to the recent events of the same polarity around this
+		// one, then refit without the points too far from it (noise, or
+		// older edges still in the time window).
+		struct OpticalFlow_plane plane;
+
+		if (!fitPlane(state, center, now, &noReject, INFINITY, &plane)) {
+			continue;
+		}
+
+		if (state->maxResidual > 0 && !fitPlane(state, center, now, &plane, state->maxResidual, &plane)) {
+			continue;
+		}
+
+		// The plane's gradient is the inverse of the normal flow: an edge
+		// moving at v pixels/µs takes 1/v µs per pixel.
+		float gradient2 = (plane.a * plane.a) + (plane.b * plane.b);
+		if (gradient2 <= state->minGradient2) {
+			// Too fast to be real, or flat.
+			continue;
+		}
+
+		float flowX = (1000000.0f * plane.a) / gradient2;
+		float flowY = (1000000.0f * plane.b) / gradient2;
+
+		caerPoint4DEvent flowEvent = caerPoint4DEventPacketGetEvent(flowPacket, flowNumber++);
+		caerPoint4DEventSetX(flowEvent, (float) x);
+		caerPoint4DEventSetY(flowEvent, (float) y);
+		caerPoint4DEventSetZ(flowEvent, flowX);
+		caerPoint4DEventSetW(flowEvent, flowY);
+		caerPoint4DEventSetTimestamp(flowEvent, caerPolarityEventGetTimestamp(caerPolarityIteratorElement));
+		caerPoint4DEventValidate(flowEvent, flowPacket);
+
+		if (state->frameInterval > 0) {
+			size_t idx = ((size_t) y * (size_t) state->sizeX) + x;
+
+			state->flowX[idx] = flowX;
+			state->flowY[idx] = flowY;
+		}
+	CAER_POLARITY_ITERATOR_VALID_END
+
+	if (flowNumber > 0) {
+		caerEventPacketHeaderSetEventNumber(&flowPacket->packetHeader, flowNumber);
+
+		*flow = flowPacket;
+	}
+	else {
+		free(flowPacket);
+	}
+
+	// Frames are generated at a fixed rate in event time.
+	if (state->frameInterval > 0 && (lastTS - state->lastFrameTimestamp) >= state->frameInterval) {
+		state->lastFrameTimestamp = lastTS;
+
+		*frame = renderFrame(moduleData);
+	}
+}
+
+static void caerOpticalFlowConfig(caerModuleData moduleData) {
+	caerModuleConfigUpdateReset(moduleData);
+
+	OpticalFlowState state = moduleData->moduleState;
+
+	int32_t radius = sshsNodeGetByte(moduleData->moduleNode, "radius");
+	if (radius < 1) {
+		radius = 1;
+	}
+	if (radius > OPTICALFLOW_MAX_RADIUS) {
+		radius = OPTICALFLOW_MAX_RADIUS;
+	}
+
+	// Columns dx = -radius ... radius, then masked out lanes up to a multiple of 4.
+	state->radius = radius;
+	state->windowWidth = ((size_t) (2 * radius) + 1 + 3) & ~(size_t) 3;
+
+	for (size_t j = 0; j < OPTICALFLOW_WINDOW_WIDTH; j++) {
+		state->windowDX[j] = (float) ((int32_t) j - radius);
+		state->windowMask[j] = ((int32_t) j <= (2 * radius)) ? (UINT32_MAX) : (0);
+	}
+
+	int32_t timeWindow = sshsNodeGetInt(moduleData->moduleNode, "timeWindow");
+	state->timeWindow = (timeWindow > 0 && timeWindow < INT32_C(1) << 30) ? (timeWindow) : (INT32_C(1) << 30);
+
+	int32_t minPoints = sshsNodeGetInt(moduleData->moduleNode, "minPoints");
+	state->minPoints = (minPoints > 3) ? (minPoints) : (3);
+
+	state->maxResidual = (float) sshsNodeGetInt(moduleData->moduleNode, "maxResidual");
+
+	// Speed v in pixels/s means a gradient of 10^6 / v µs per pixel.
+	float maxSpeed = sshsNodeGetFloat(moduleData->moduleNode, "maxSpeed");
+	float minGradient = (maxSpeed > 0) ? (1000000.0f / maxSpeed) : (0.0f);
+	state->minGradient2 = minGradient * minGradient;
+
+	state->frameInterval = sshsNodeGetInt(moduleData->moduleNode, "frameInterval");
+	state->frameSpeedScale = sshsNodeGetFloat(moduleData->moduleNode, "frameSpeedScale");
+}
+
+static void caerOpticalFlowExit(caerModuleData moduleData) {
+	// Remove listener, which can reference invalid memory in userData.
+	sshsNodeRemoveAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+
+	OpticalFlowState state = moduleData->moduleState;
+
+	// Ensure maps are freed.
+	freeMaps(state);
+}
+
+static void caerOpticalFlowReset(caerModuleData moduleData, uint16_t resetCallSourceID) {
+	UNUSED_ARGUMENT(resetCallSourceID);
+
+	OpticalFlowState state = moduleData->moduleState;
+
+	// Reset maps to all zeros (startup state).
+	resetMaps(state);
+}
+
+static bool allocateMaps(OpticalFlowState state, int16_t sourceID) {
+	// Get size information from source.
+	sshsNode sourceInfoNode = caerMainloopGetSourceInfo(U16T(sourceID));
+	if (sourceInfoNode == NULL) {
+		// This should never happen, but we handle it gracefully.
+		caerLog(CAER_LOG_ERROR, __func__, "Failed to get source info to allocate maps.");
+		return (false);
+	}
+
+	state->sizeX = sshsNodeGetShort(sourceInfoNode, "dvsSizeX");
+	state->sizeY = sshsNodeGetShort(sourceInfoNode, "dvsSizeY");
+
+	struct OpticalFlow_map *map = &state->map;
+
+	size_t stride = (size_t) state->sizeX + (2 * OPTICALFLOW_MAX_RADIUS);
+	map->stride = (stride + OPTICALFLOW_MAP_ROW_ALIGN - 1) & ~(OPTICALFLOW_MAP_ROW_ALIGN - 1);
+	map->rows = (size_t) state->sizeY + (2 * OPTICALFLOW_MAX_RADIUS);
+
+	// Padded neighborhood rows can read a few cells past the end of the last row.
+	size_t mapSize = ((map->stride * map->rows) + OPTICALFLOW_WINDOW_WIDTH) * sizeof(uint32_t);
+
+	map->cells[0] = portable_aligned_alloc(OPTICALFLOW_MAP_ALIGNMENT, mapSize);
+	map->cells[1] = portable_aligned_alloc(OPTICALFLOW_MAP_ALIGNMENT, mapSize);
+
+	size_t pixels = (size_t) state->sizeX * (size_t) state->sizeY;
+
+	state->flowX = calloc(pixels, sizeof(float));
+	state->flowY = calloc(pixels, sizeof(float));
+
+	if (map->cells[0] == NULL || map->cells[1] == NULL || state->flowX == NULL || state->flowY == NULL) {
+		freeMaps(state);
+		return (false);
+	}
+
+	resetMaps(state);
+
+	return (true);
+}
+
+static void freeMaps(OpticalFlowState state) {
+	portable_aligned_free(state->map.cells[0]);
+	state->map.cells[0] = NULL;
+	portable_aligned_free(state->map.cells[1]);
+	state->map.cells[1] = NULL;
+
+	free(state->flowX);
+	state->flowX = NULL;
+	free(state->flowY);
+	state->flowY = NULL;
+}
+
+static void resetMaps(OpticalFlowState state) {
+	struct OpticalFlow_map *map = &state->map;
+
+	if (map->cells[0] == NULL) {
+		return;
+	}
+
+	size_t mapSize = ((map->stride * map->rows) + OPTICALFLOW_WINDOW_WIDTH) * sizeof(uint32_t);
+
+	memset(map->cells[0], 0, mapSize);
+	memset(map->cells[1], 0, mapSize);
+	relativeTimestampsReset(&map->timestamps);
+
+	size_t pixels = (size_t) state->sizeX * (size_t) state->sizeY;
+
+	memset(state->flowX, 0, pixels * sizeof(float));
+	memset(state->flowY, 0, pixels * sizeof(float));
+	state->lastFrameTimestamp = 0;
+}
+
+/**
+ * Make sure timestamps between firstTS and lastTS fit the maps' relative
+ * 32 bit representation, rebasing them if needed.
+ */
+static void updateTimestampBase(OpticalFlowState state, int64_t firstTS, int64_t lastTS) {
+	struct OpticalFlow_map *map = &state->map;
+
+	uint32_t shift = 0;
+
+	switch (relativeTimestampsUpdate(&map->timestamps, firstTS, lastTS, &shift)) {
+		case RELATIVE_TIMESTAMPS_RESTART:
+			// First packet, or time went backwards without a reset: start over.
+			resetMaps(state);
+			relativeTimestampsStart(&map->timestamps, firstTS);
+			state->lastFrameTimestamp = firstTS;
+			break;
+
+		case RELATIVE_TIMESTAMPS_SHIFT: {
+			size_t mapSize = (map->stride * map->rows) + OPTICALFLOW_WINDOW_WIDTH;
+
+			relativeTimestampsShift(map->cells[0], mapSize, shift);
+			relativeTimestampsShift(map->cells[1], mapSize, shift);
+			break;
+		}
+
+		case RELATIVE_TIMESTAMPS_FIT:
+			break;
+	}
+}
+
+#if defined(__SSE2__)
+static inline float horizontalSum(__m128 v) {
+	__m128 shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+	__m128 sums = _mm_add_ps(v, shuffled);
+	shuffled = _mm_movehl_ps(shuffled, sums);
+	sums = _mm_add_ss(sums, shuffled);
+
+	return (_mm_cvtss_f32(sums));
+}
+#endif
+
+/**
+ * Least-squares fit of a plane to the timestamps in the neighborhood of
+ * 'center' that are at most timeWindow older than 'now'. Points further than
+ * maxResidual from the 'reject' plane are left out.
+ *
+ * @return true if enough points were found and they define a plane.
+ */
+static bool fitPlane(OpticalFlowState state, const uint32_t *center, uint32_t now,
+	const struct OpticalFlow_plane *reject, float maxResidual, struct OpticalFlow_plane *plane) {
+	size_t stride = state->map.stride;
+	int32_t radius = state->radius;
+
+	// Moments of the points: n, sums of dx, dy, dx^2, dx*dy, dy^2, t, dx*t, dy*t.
+	float n, sx, sy, sxx, sxy, syy, st, sxt, syt;
+
+#if defined(__SSE2__)
+	// Each row is done 4 columns at a time, a point is used if its lane mask
+	// is all ones, which also zeroes its contributions otherwise.
+	__m128 vN = _mm_setzero_ps(), vSX = _mm_setzero_ps(), vSY = _mm_setzero_ps();
+	__m128 vSXX = _mm_setzero_ps(), vSXY = _mm_setzero_ps(), vSYY = _mm_setzero_ps();
+	__m128 vST = _mm_setzero_ps(), vSXT = _mm_setzero_ps(), vSYT = _mm_setzero_ps();
+
+	const __m128i vZero = _mm_setzero_si128();
+	const __m128i vNow = _mm_set1_epi32(I32T(now));
+	const __m128i vOldest = _mm_set1_epi32(-state->timeWindow - 1);
+	const __m128 vOne = _mm_set1_ps(1.0f);
+	const __m128 vAbs = _mm_castsi128_ps(_mm_set1_epi32(INT32_MAX));
+	const __m128 vRejectA = _mm_set1_ps(reject->a);
+	const __m128 vRejectB = _mm_set1_ps(reject->b);
+	const __m128 vRejectC = _mm_set1_ps(reject->c);
+	const __m128 vMaxResidual = _mm_set1_ps(maxResidual);
+
+	// Top-left corner of the neighborhood, going down one row at a time.
+	const uint32_t *row = center - ((size_t) radius * stride) - radius;
+
+	for (int32_t dy = -radius; dy <= radius; dy++, row += stride) {
+		__m128 vDY = _mm_set1_ps((float) dy);
+		__m128 vRejectRow = _mm_add_ps(_mm_mul_ps(vRejectB, vDY), vRejectC);
+
+		for (size_t j = 0; j < state->windowWidth; j += 4) {
+			__m128i cells = _mm_loadu_si128((const __m128i *) &row[j]);
+			__m128i dt = _mm_sub_epi32(cells, vNow);
+
+			// Pixel has an event, recent enough, and is inside the neighborhood.
+			__m128i valid = _mm_andnot_si128(_mm_cmpeq_epi32(cells, vZero), _mm_cmpgt_epi32(dt, vOldest));
+			valid = _mm_and_si128(valid, _mm_load_si128((const __m128i *) &state->windowMask[j]));
+
+			__m128 t = _mm_cvtepi32_ps(dt);
+			__m128 x = _mm_load_ps(&state->windowDX[j]);
+
+			__m128 residual = _mm_sub_ps(t, _mm_add_ps(_mm_mul_ps(vRejectA, x), vRejectRow));
+			__m128 mask = _mm_and_ps(_mm_castsi128_ps(valid),
+				_mm_cmplt_ps(_mm_and_ps(residual, vAbs), vMaxResidual));
+
+			__m128 w = _mm_and_ps(mask, vOne);
+			__m128 xm = _mm_and_ps(mask, x);
+			__m128 tm = _mm_and_ps(mask, t);
+
+			vN = _mm_add_ps(vN, w);
+			vSX = _mm_add_ps(vSX, xm);
+			vSY = _mm_add_ps(vSY, _mm_mul_ps(w, vDY));
+			vSXX = _mm_add_ps(vSXX, _mm_mul_ps(xm, x));
+			vSXY = _mm_add_ps(vSXY, _mm_mul_ps(xm, vDY));
+			vSYY = _mm_add_ps(vSYY, _mm_mul_ps(_mm_mul_ps(w, vDY), vDY));
+			vST = _mm_add_ps(vST, tm);
+			vSXT = _mm_add_ps(vSXT, _mm_mul_ps(tm, x));
+			vSYT = _mm_add_ps(vSYT, _mm_mul_ps(tm, vDY));
+		}
+	}
+
+	n = horizontalSum(vN);
+	sx = horizontalSum(vSX);
+	sy = horizontalSum(vSY);
+	sxx = horizontalSum(vSXX);
+	sxy = horizontalSum(vSXY);
+	syy = horizontalSum(vSYY);
+	st = horizontalSum(vST);
+	sxt = horizontalSum(vSXT);
+	syt = horizontalSum(vSYT);
+#else
+	n = sx = sy = sxx = sxy = syy = st = sxt = syt = 0;
+
+	// Top-left corner of the neighborhood, going down one row at a time.
+	const uint32_t *row = center - ((size_t) radius * stride) - radius;
+
+	for (int32_t dy = -radius; dy <= radius; dy++, row += stride) {
+		for (int32_t dx = -radius; dx <= radius; dx++) {
+			uint32_t cell = row[dx + radius];
+			int32_t dt = I32T(cell - now);
+
+			if (cell == 0 || dt < -state->timeWindow) {
+				continue;
+			}
+
+			float t = (float) dt;
+
+			if (fabsf(t - ((reject->a * (float) dx) + (reject->b * (float) dy) + reject->c)) >= maxResidual) {
+				continue;
+			}
+
+			n += 1.0f;
+			sx += (float) dx;
+			sy += (float) dy;
+			sxx += (float) (dx * dx);
+			sxy += (float) (dx * dy);
+			syy += (float) (dy * dy);
+			st += t;
+			sxt += t * (float) dx;
+			syt += t * (float) dy;
+		}
+	}
+#endif
+
+	if (n < (float) state->minPoints) {
+		return (false);
+	}
+
+	// Solve the normal equations on centered moments.
+	float mx = sx / n;
+	float my = sy / n;
+	float mt = st / n;
+
+	float cxx = sxx - (sx * mx);
+	float cxy = sxy - (sx * my);
+	float cyy = syy - (sy * my);
+	float cxt = sxt - (sx * mt);
+	float cyt = syt - (sy * mt);
+
+	float det = (cxx * cyy) - (cxy * cxy);
+	if (det <= (0.01f * n * n)) {
+		// Points (almost) on a line, no plane through them.
+		return (false);
+	}
+
+	plane->a = ((cyy * cxt) - (cxy * cyt)) / det;
+	plane->b = ((cxx * cyt) - (cxy * cxt)) / det;
+	plane->c = mt - (plane->a * mx) - (plane->b * my);
+
+	return (true);
+}
+
+static caerFrameEventPacket renderFrame(caerModuleData moduleData) {
+	OpticalFlowState state = moduleData->moduleState;
+
+	caerFrameEventPacket framePacket = caerFrameEventPacketAllocate(1, I16T(moduleData->moduleID), 0, state->sizeX,
+		state->sizeY, 3);
+	if (framePacket == NULL) {
+		return (NULL);
+	}
+
+	caerFrameEvent frameEvent = caerFrameEventPacketGetEvent(framePacket, 0);
+	uint16_t *pixels = frameEvent->pixels;
+	size_t pixelsNumber = (size_t) state->sizeX * (size_t) state->sizeY;
+	float speedScale = (state->frameSpeedScale > 0) ? (1.0f / state->frameSpeedScale) : (1.0f);
+
+	// Flow since the last frame, direction as hue and speed as brightness.
+	for (size_t i = 0; i < pixelsNumber; i++) {
+		float flowX = state->flowX[i];
+		float flowY = state->flowY[i];
+
+		float value = sqrtf((flowX * flowX) + (flowY * flowY)) * speedScale;
+		value = (value < 1.0f) ? (value) : (1.0f);
+
+		// Hue in [0, 6): red to the right, then yellow, green, cyan, blue, magenta.
+		float hue = (atan2f(flowY, flowX) * (float) (3.0 / M_PI)) + 6.0f;
+		hue = (hue < 6.0f) ? (hue) : (hue - 6.0f);
+
+		float red = fabsf(hue - 3.0f) - 1.0f;
+		float green = 2.0f - fabsf(hue - 2.0f);
+		float blue = 2.0f - fabsf(hue - 4.0f);
+
+		red = (red < 0) ? (0) : ((red > 1) ? (1) : (red));
+		green = (green < 0) ? (0) : ((green > 1) ? (1) : (green));
+		blue = (blue < 0) ? (0) : ((blue > 1) ? (1) : (blue));
+
+		pixels[(i * 3)] = U16T(red * value * 65535.0f);
+		pixels[(i * 3) + 1] = U16T(green * value * 65535.0f);
+		pixels[(i * 3) + 2] = U16T(blue * value * 65535.0f);
+	}
+
+	memset(state->flowX, 0, pixelsNumber * sizeof(float));
+	memset(state->flowY, 0, pixelsNumber * sizeof(float));
+
+	// Add info to the frame.
+	caerFrameEventSetLengthXLengthYChannelNumber(frameEvent, state->sizeX, state->sizeY, 3, framePacket);
+	// Validate frame.
+	caerFrameEventValidate(frameEvent, framePacket);
+
+	return (framePacket);
+}
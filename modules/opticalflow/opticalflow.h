@@ -0,0 +1,27 @@
+#ifndef OPTICALFLOW_H_
+#define OPTICALFLOW_H_
+
+#include "main.h"
+
+#include <libcaer/events/polarity.h>
+#include <libcaer/events/point4d.h>
+#include <libcaer/events/frame.h>
+
+/**
+ * Compute the normal optical flow of each polarity event, by fitting a plane
+ * to the surface of active events (last timestamp of each pixel) around it.
+ *
+ * Flow events carry the event position in X and Y, and the flow velocity in
+ * pixels per second in Z (horizontal) and W (vertical). Only events that
+ * got a good enough fit produce a flow event.
+ *
+ * @param moduleID the module ID.
+ * @param polarity the polarity events to compute flow for.
+ * @param flow returns the flow events, NULL if none. To be freed by the caller.
+ * @param frame returns a rendering of the recent flow when the frame interval
+ *              elapsed, NULL otherwise. To be freed by the caller.
+ */
+void caerOpticalFlow(uint16_t moduleID, caerPolarityEventPacket polarity, caerPoint4DEventPacket *flow,
+	caerFrameEventPacket *frame);
+
+#endif /* OPTICALFLOW_H_ */
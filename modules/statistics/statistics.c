@@ -3,58 +3,317 @@
 #include "base/module.h"
 #include "ext/portable_time.h"
 
+// Event types with their own statistics, higher ones are counted together as 'other'.
+#define CAER_STATISTICS_EVENT_TYPES 16
+
+static const char *eventTypeNames[CAER_STATISTICS_EVENT_TYPES] = { [SPECIAL_EVENT] = "special", [POLARITY_EVENT] =
+	"polarity", [FRAME_EVENT] = "frame", [IMU6_EVENT] = "imu6", [IMU9_EVENT] = "imu9", [SAMPLE_EVENT] = "sample",
+	[EAR_EVENT] = "ear", [CONFIG_EVENT] = "config", [POINT1D_EVENT] = "point1d", [POINT2D_EVENT] = "point2d",
+	[POINT3D_EVENT] = "point3d", [POINT4D_EVENT] = "point4d", [SPIKE_EVENT] = "spike",
+	[CAER_STATISTICS_EVENT_TYPES - 1] = "other" };
+
+struct caer_statistics_event_type {
+	/// Seen at least once, only those are published.
+	bool seen;
+	uint64_t totalEvents;
+	uint64_t validEvents;
+	uint64_t packets;
+	/// Events per packet.
+	struct caer_statistics_histogram packetSize;
+};
+
+struct caer_statistics_metrics_state {
+	int32_t publishInterval;
+	struct caer_statistics_event_type eventTypes[CAER_STATISTICS_EVENT_TYPES];
+	uint64_t containers;
+	/// Time between containers, in µs.
+	struct caer_statistics_histogram containerLatency;
+	/// Arrival of the last container, in µs, 0 if none yet.
+	uint64_t lastContainerTime;
+	uint64_t lastPublishTime;
+	uint64_t lastDataDropped;
+};
+
+typedef struct caer_statistics_metrics_state *caerStatisticsMetricsState;
+
 static bool caerStatisticsInit(caerModuleData moduleData);
 static void caerStatisticsRun(caerModuleData moduleData, size_t argsNumber, va_list args);
+static void caerStatisticsConfig(caerModuleData moduleData);
 static void caerStatisticsExit(caerModuleData moduleData);
 static void caerStatisticsReset(caerModuleData moduleData, uint16_t resetCallSourceID);
+static void caerStatisticsPublish(caerModuleData moduleData, uint64_t now);
+static void caerStatisticsClear(caerStatisticsMetricsState state);
+static inline uint64_t monotonicTimeMicro(void);
 
 static struct caer_module_functions caerStatisticsFunctions = { .moduleInit = &caerStatisticsInit, .moduleRun =
-	&caerStatisticsRun, .moduleConfig = NULL, .moduleExit = &caerStatisticsExit, .moduleReset = &caerStatisticsReset };
+	&caerStatisticsRun, .moduleConfig = &caerStatisticsConfig, .moduleExit = &caerStatisticsExit, .moduleReset =
+	&caerStatisticsReset };
 
-void caerStatistics(uint16_t moduleID, caerEventPacketHeader packetHeader, size_t divisionFactor) {
+void caerStatistics(uint16_t moduleID, caerEventPacketContainer container) {
 	caerModuleData moduleData = caerMainloopFindModule(moduleID, "Statistics", CAER_MODULE_PROCESSOR);
 	if (moduleData == NULL) {
 		return;
 	}
 
-	caerModuleSM(&caerStatisticsFunctions, moduleData, sizeof(struct caer_statistics_state), 2, packetHeader,
-		divisionFactor);
+	caerModuleSM(&caerStatisticsFunctions, moduleData, sizeof(struct caer_statistics_metrics_state), 1, container);
 }
 
 static bool caerStatisticsInit(caerModuleData moduleData) {
-	caerStatisticsState state = moduleData->moduleState;
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "publishInterval", 1000); // in ms
+
+	caerStatisticsMetricsState state = moduleData->moduleState;
+
+	caerStatisticsClear(state);
+
+	caerStatisticsConfig(moduleData);
+
+	// Add config listeners last, to avoid having them dangling if Init doesn't succeed.
+	sshsNodeAddAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
 
-	return (caerStatisticsStringInit(state));
+	// Nothing that can fail here.
+	return (true);
 }
 
 static void caerStatisticsRun(caerModuleData moduleData, size_t argsNumber, va_list args) {
 	UNUSED_ARGUMENT(argsNumber);
 
 	// Interpret variable arguments (same as above in main function).
-	caerEventPacketHeader packetHeader = va_arg(args, caerEventPacketHeader);
-	size_t divisionFactor = va_arg(args, size_t);
+	caerEventPacketContainer container = va_arg(args, caerEventPacketContainer);
+
+	caerStatisticsMetricsState state = moduleData->moduleState;
+
+	uint64_t now = monotonicTimeMicro();
+
+	// Only non-NULL containers count as data, the mainloop also runs without.
+	if (container != NULL) {
+		if (state->lastContainerTime != 0) {
+			caerStatisticsHistogramRecord(&state->containerLatency, now - state->lastContainerTime);
+		}
 
-	caerStatisticsState state = moduleData->moduleState;
-	state->divisionFactor = divisionFactor;
+		state->lastContainerTime = now;
+		state->containers++;
 
-	caerStatisticsStringUpdate(packetHeader, state);
+		for (int32_t i = 0; i < caerEventPacketContainerGetEventPacketsNumber(container); i++) {
+			caerEventPacketHeader packetHeader = caerEventPacketContainerGetEventPacket(container, i);
+			if (packetHeader == NULL) {
+				continue;
+			}
 
-	fprintf(stdout, "\r%s - %s", state->currentStatisticsStringTotal, state->currentStatisticsStringValid);
-	fflush(stdout);
+			int16_t type = caerEventPacketHeaderGetEventType(packetHeader);
+			if (type < 0 || type >= CAER_STATISTICS_EVENT_TYPES) {
+				type = CAER_STATISTICS_EVENT_TYPES - 1;
+			}
+
+			struct caer_statistics_event_type *eventType = &state->eventTypes[type];
+			int32_t events = caerEventPacketHeaderGetEventNumber(packetHeader);
+
+			eventType->seen = true;
+			eventType->totalEvents += U64T(events);
+			eventType->validEvents += U64T(caerEventPacketHeaderGetEventValid(packetHeader));
+			eventType->packets++;
+
+			caerStatisticsHistogramRecord(&eventType->packetSize, U64T(events));
+		}
+	}
+
+	if ((now - state->lastPublishTime) >= ((uint64_t) state->publishInterval * 1000)) {
+		caerStatisticsPublish(moduleData, now);
+	}
 }
 
-static void caerStatisticsExit(caerModuleData moduleData) {
-	caerStatisticsState state = moduleData->moduleState;
+static void caerStatisticsConfig(caerModuleData moduleData) {
+	caerModuleConfigUpdateReset(moduleData);
+
+	caerStatisticsMetricsState state = moduleData->moduleState;
 
-	caerStatisticsStringExit(state);
+	state->publishInterval = sshsNodeGetInt(moduleData->moduleNode, "publishInterval");
+
+	// At most once per mainloop run anyway, but never busy.
+	if (state->publishInterval < 1) {
+		state->publishInterval = 1;
+	}
+}
+
+static void caerStatisticsExit(caerModuleData moduleData) {
+	// Remove listener, which can reference invalid memory in userData.
+	sshsNodeRemoveAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
 }
 
 static void caerStatisticsReset(caerModuleData moduleData, uint16_t resetCallSourceID) {
 	UNUSED_ARGUMENT(resetCallSourceID);
 
-	caerStatisticsState state = moduleData->moduleState;
+	caerStatisticsMetricsState state = moduleData->moduleState;
+
+	caerStatisticsClear(state);
+}
+
+/**
+ * Publish rates and percentiles for the period since the last call to SSHS,
+ * then start a new period. Percentiles are 0 if there was no data.
+ */
+static void caerStatisticsPublish(caerModuleData moduleData, uint64_t now) {
+	caerStatisticsMetricsState state = moduleData->moduleState;
+
+	double period = (double) (now - state->lastPublishTime) / 1000000.0; // in seconds
+
+	// Own sub-node: no config listener fires on updates, and it's never saved with the configuration.
+	sshsNode metricsNode = sshsGetRelativeNode(moduleData->moduleNode, "metrics/");
+
+	for (size_t i = 0; i < CAER_STATISTICS_EVENT_TYPES; i++) {
+		struct caer_statistics_event_type *eventType = &state->eventTypes[i];
+
+		if (!eventType->seen) {
+			continue;
+		}
+
+		char typeNodePath[32];
+		if (eventTypeNames[i] != NULL) {
+			snprintf(typeNodePath, sizeof(typeNodePath), "eventTypes/%s/", eventTypeNames[i]);
+		}
+		else {
+			snprintf(typeNodePath, sizeof(typeNodePath), "eventTypes/type%zu/", i);
+		}
+
+		sshsNode typeNode = sshsGetRelativeNode(metricsNode, typeNodePath);
+
+		sshsNodePutLong(typeNode, "eventsPerSecond", I64T((double) eventType->totalEvents / period));
+		sshsNodePutLong(typeNode, "validEventsPerSecond", I64T((double) eventType->validEvents / period));
+		sshsNodePutDouble(typeNode, "validRatio",
+			(eventType->totalEvents == 0) ?
+				(0) : ((double) eventType->validEvents / (double) eventType->totalEvents));
+		sshsNodePutLong(typeNode, "packetsPerSecond", I64T((double) eventType->packets / period));
+		sshsNodePutLong(typeNode, "packetSizeP50",
+			I64T(caerStatisticsHistogramPercentile(&eventType->packetSize, 50)));
+		sshsNodePutLong(typeNode, "packetSizeP90",
+			I64T(caerStatisticsHistogramPercentile(&eventType->packetSize, 90)));
+		sshsNodePutLong(typeNode, "packetSizeP99",
+			I64T(caerStatisticsHistogramPercentile(&eventType->packetSize, 99)));
+		sshsNodePutLong(typeNode, "packetSizeMax", I64T(atomic_load(&eventType->packetSize.max)));
+
+		eventType->totalEvents = 0;
+		eventType->validEvents = 0;
+		eventType->packets = 0;
+		caerStatisticsHistogramReset(&eventType->packetSize);
+	}
+
+	sshsNode latencyNode = sshsGetRelativeNode(metricsNode, "containerLatency/");
+
+	sshsNodePutLong(latencyNode, "containersPerSecond", I64T((double) state->containers / period));
+	sshsNodePutLong(latencyNode, "p50", I64T(caerStatisticsHistogramPercentile(&state->containerLatency, 50)));
+	sshsNodePutLong(latencyNode, "p90", I64T(caerStatisticsHistogramPercentile(&state->containerLatency, 90)));
+	sshsNodePutLong(latencyNode, "p99", I64T(caerStatisticsHistogramPercentile(&state->containerLatency, 99)));
+	sshsNodePutLong(latencyNode, "max", I64T(atomic_load(&state->containerLatency.max)));
+
+	state->containers = 0;
+	caerStatisticsHistogramReset(&state->containerLatency);
+
+	uint64_t dataDropped = atomic_load_explicit(&caerMainloopGetReference()->dataDropped, memory_order_relaxed);
+
+	sshsNodePutLong(metricsNode, "ringBufferDrops", I64T(dataDropped));
+	sshsNodePutLong(metricsNode, "ringBufferDropsPerSecond",
+		I64T((double) (dataDropped - state->lastDataDropped) / period));
+
+	state->lastDataDropped = dataDropped;
+	state->lastPublishTime = now;
+}
+
+static void caerStatisticsClear(caerStatisticsMetricsState state) {
+	for (size_t i = 0; i < CAER_STATISTICS_EVENT_TYPES; i++) {
+		state->eventTypes[i].totalEvents = 0;
+		state->eventTypes[i].validEvents = 0;
+		state->eventTypes[i].packets = 0;
+		caerStatisticsHistogramReset(&state->eventTypes[i].packetSize);
+	}
+
+	state->containers = 0;
+	caerStatisticsHistogramReset(&state->containerLatency);
+
+	state->lastContainerTime = 0;
+	state->lastPublishTime = monotonicTimeMicro();
+	state->lastDataDropped = atomic_load_explicit(&caerMainloopGetReference()->dataDropped, memory_order_relaxed);
+}
+
+static inline uint64_t monotonicTimeMicro(void) {
+	struct timespec currentTime;
+	portable_clock_gettime_monotonic(&currentTime);
+
+	return ((uint64_t) currentTime.tv_sec * 1000000LLU + (uint64_t) currentTime.tv_nsec / 1000);
+}
+
+static inline size_t histogramBucket(uint64_t value) {
+	if (value < CAER_STATISTICS_HISTOGRAM_SUB_BUCKETS) {
+		return ((size_t) value);
+	}
+
+	// Position of the highest set bit, at least SUB_BITS here.
+	unsigned int exponent = 0;
+	for (unsigned int shift = 32; shift > 0; shift /= 2) {
+		if ((value >> (exponent + shift)) != 0) {
+			exponent += shift;
+		}
+	}
+
+	// The SUB_BITS bits below the highest one select the bucket in this power of two.
+	unsigned int scale = exponent - CAER_STATISTICS_HISTOGRAM_SUB_BITS;
+
+	return ((size_t) ((scale + 1) * CAER_STATISTICS_HISTOGRAM_SUB_BUCKETS)
+		+ (size_t) ((value >> scale) & (CAER_STATISTICS_HISTOGRAM_SUB_BUCKETS - 1)));
+}
+
+void caerStatisticsHistogramRecord(caerStatisticsHistogram histogram, uint64_t value) {
+	atomic_fetch_add_explicit(&histogram->buckets[histogramBucket(value)], 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&histogram->count, 1, memory_order_relaxed);
+
+	uint64_t max = atomic_load_explicit(&histogram->max, memory_order_relaxed);
+	while (value > max
+		&& !atomic_compare_exchange_weak_explicit(&histogram->max, &max, value, memory_order_relaxed,
+			memory_order_relaxed)) {
+		// Retry with the updated max.
+	}
+}
+
+uint64_t caerStatisticsHistogramPercentile(caerStatisticsHistogram histogram, double percentile) {
+	uint64_t count = atomic_load_explicit(&histogram->count, memory_order_relaxed);
+	if (count == 0) {
+		return (0);
+	}
+
+	// Rank of the wanted value, 1-based.
+	uint64_t rank = (uint64_t) ((percentile / 100.0) * (double) count + 0.5);
+	rank = (rank < 1) ? (1) : ((rank > count) ? (count) : (rank));
+
+	uint64_t seen = 0;
+	size_t bucket = 0;
+
+	for (; bucket < (CAER_STATISTICS_HISTOGRAM_BUCKETS - 1); bucket++) {
+		seen += atomic_load_explicit(&histogram->buckets[bucket], memory_order_relaxed);
+
+		if (seen >= rank) {
+			break;
+		}
+	}
+
+	if (bucket < CAER_STATISTICS_HISTOGRAM_SUB_BUCKETS) {
+		return (bucket);
+	}
+
+	// Middle of the bucket, never above the largest value recorded.
+	unsigned int scale = (unsigned int) (bucket / CAER_STATISTICS_HISTOGRAM_SUB_BUCKETS) - 1;
+	uint64_t low = (uint64_t) (CAER_STATISTICS_HISTOGRAM_SUB_BUCKETS + (bucket % CAER_STATISTICS_HISTOGRAM_SUB_BUCKETS))
+		<< scale;
+	uint64_t value = low + ((1LLU << scale) / 2);
+	uint64_t max = atomic_load_explicit(&histogram->max, memory_order_relaxed);
+
+	return ((value > max) ? (max) : (value));
+}
+
+void caerStatisticsHistogramReset(caerStatisticsHistogram histogram) {
+	for (size_t i = 0; i < CAER_STATISTICS_HISTOGRAM_BUCKETS; i++) {
+		atomic_store_explicit(&histogram->buckets[i], 0, memory_order_relaxed);
+	}
 
-	caerStatisticsStringReset(state);
+	atomic_store_explicit(&histogram->count, 0, memory_order_relaxed);
+	atomic_store_explicit(&histogram->max, 0, memory_order_relaxed);
 }
 
 bool caerStatisticsStringInit(caerStatisticsState state) {
@@ -4,6 +4,7 @@
 #include "main.h"
 
 #include <libcaer/events/common.h>
+#include <stdatomic.h>
 #include <time.h>
 #include <sys/time.h>
 
@@ -28,6 +29,44 @@ void caerStatisticsStringUpdate(caerEventPacketHeader packetHeader, caerStatisti
 void caerStatisticsStringExit(caerStatisticsState state);
 void caerStatisticsStringReset(caerStatisticsState state);
 
-void caerStatistics(uint16_t moduleID, caerEventPacketHeader packetHeader, size_t divisionFactor);
+// Log-linear histogram: values below 2^SUB_BITS are counted exactly, larger ones
+// in SUB_BUCKETS buckets per power of two, so the relative error stays below
+// 1 / SUB_BUCKETS over the whole 64 bit range.
+#define CAER_STATISTICS_HISTOGRAM_SUB_BITS 3
+#define CAER_STATISTICS_HISTOGRAM_SUB_BUCKETS (1 << CAER_STATISTICS_HISTOGRAM_SUB_BITS)
+#define CAER_STATISTICS_HISTOGRAM_BUCKETS \
+	((64 - CAER_STATISTICS_HISTOGRAM_SUB_BITS + 1) * CAER_STATISTICS_HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * Fixed-size histogram, safe to record into from any thread without locks.
+ * Reading it while others record gives a consistent enough snapshot for
+ * statistics purposes.
+ */
+struct caer_statistics_histogram {
+	atomic_uint_fast64_t buckets[CAER_STATISTICS_HISTOGRAM_BUCKETS];
+	atomic_uint_fast64_t count;
+	atomic_uint_fast64_t max;
+};
+
+typedef struct caer_statistics_histogram *caerStatisticsHistogram;
+
+void caerStatisticsHistogramRecord(caerStatisticsHistogram histogram, uint64_t value);
+uint64_t caerStatisticsHistogramPercentile(caerStatisticsHistogram histogram, double percentile);
+void caerStatisticsHistogramReset(caerStatisticsHistogram histogram);
+
+/**
+ * Collect statistics about all the event packets in a container, and publish
+ * them periodically under the 'metrics/' sub-node of the module's configuration
+ * node, so they can be read through the configuration server:
+ * - per event type: events, valid events and packets per second, the valid
+ *   events ratio and packet size percentiles, under 'eventTypes/<type>/';
+ * - time between containers in µs, as percentiles, under 'containerLatency/';
+ * - packet containers dropped on full ring-buffers, total and per second.
+ *
+ * @param moduleID the module ID.
+ * @param container the packet container to collect statistics on, NULL counts
+ *                  as no data.
+ */
+void caerStatistics(uint16_t moduleID, caerEventPacketContainer container);
 
 #endif /* STATISTICS_H_ */
@@ -9,6 +9,12 @@ struct StereoMatchingSettings_struct {
 	int captureDelay;
 	char * loadFileName_extrinsic;
 	char * loadFileName_intrinsic;
+	bool doRectification;
+	uint32_t timeWindow;
+	uint32_t maxDisparity;
+	uint32_t epipolarTolerance;
+	uint32_t imageWidth;
+	uint32_t imageHeigth;
 };
 
 typedef struct StereoMatchingSettings_struct *StereoMatchingSettings;
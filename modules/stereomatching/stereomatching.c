@@ -7,11 +7,6 @@
 struct StereoMatchingState_struct {
 	struct StereoMatchingSettings_struct settings; // Struct containing all settings (shared)
 	struct StereoMatching *cpp_class; 			  // Pointer to cpp_class_object
-	uint64_t lastFrameTimestamp_cam0;
-	uint64_t lastFrameTimestamp_cam1;
-	uint32_t points_found;
-	uint32_t last_points_found;
-	size_t lastFoundPoints;
 	bool calibrationLoaded;
 };
 
@@ -27,24 +22,32 @@ static struct caer_module_functions caerStereoMatchingFunctions = { .moduleInit
 	.moduleRun = &caerStereoMatchingRun, .moduleConfig = &caerStereoMatchingConfig, .moduleExit =
 		&caerStereoMatchingExit };
 
-void caerStereoMatching(uint16_t moduleID, caerFrameEventPacket frame_0, caerFrameEventPacket frame_1) {
+void caerStereoMatching(uint16_t moduleID, caerPolarityEventPacket polarity_0, caerPolarityEventPacket polarity_1,
+	caerFrameEventPacket frame_0, caerFrameEventPacket frame_1, caerPoint4DEventPacket *depth) {
+	// Ensure output is always initialized.
+	*depth = NULL;
+
 	caerModuleData moduleData = caerMainloopFindModule(moduleID, "StereoMatching", CAER_MODULE_PROCESSOR);
 	if (moduleData == NULL) {
 		return;
 	}
 
-	caerModuleSM(&caerStereoMatchingFunctions, moduleData, sizeof(struct StereoMatchingState_struct), 2, frame_0,
-		frame_1);
+	caerModuleSM(&caerStereoMatchingFunctions, moduleData, sizeof(struct StereoMatchingState_struct), 5, polarity_0,
+		polarity_1, frame_0, frame_1, depth);
 }
 
 static bool caerStereoMatchingInit(caerModuleData moduleData) {
 	StereoMatchingState state = moduleData->moduleState;
 
 	// Create config settings.
-	sshsNodePutBoolIfAbsent(moduleData->moduleNode, "doMatching", false); // Do calibration using live images
+	sshsNodePutBoolIfAbsent(moduleData->moduleNode, "doMatching", false); // Match events between the two cameras, for depth
 	sshsNodePutIntIfAbsent(moduleData->moduleNode, "captureDelay", 2000);
 	sshsNodePutStringIfAbsent(moduleData->moduleNode, "loadFileName_extrinsic", "extrinsics.xml"); // The name of the file from which to load the calibration
 	sshsNodePutStringIfAbsent(moduleData->moduleNode, "loadFileName_intrinsic", "intrinsics.xml"); // The name of the file from which to load the calibration
+	sshsNodePutBoolIfAbsent(moduleData->moduleNode, "doRectification", true); // Rectify frames and events in-place
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "timeWindow", 1000); // Maximum time between matching events (in µs)
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "maxDisparity", 40); // Maximum disparity of matching events (in pixels)
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "epipolarTolerance", 1); // Maximum distance of matching events from the epipolar line (in pixels)
 
 	// Update all settings.
 	updateSettings(moduleData);
@@ -68,8 +71,10 @@ static void updateSettings(caerModuleData moduleData) {
 	state->settings.captureDelay = sshsNodeGetInt(moduleData->moduleNode, "captureDelay");
 	state->settings.loadFileName_extrinsic = sshsNodeGetString(moduleData->moduleNode, "loadFileName_extrinsic");
 	state->settings.loadFileName_intrinsic = sshsNodeGetString(moduleData->moduleNode, "loadFileName_intrinsic");
-
-
+	state->settings.doRectification = sshsNodeGetBool(moduleData->moduleNode, "doRectification");
+	state->settings.timeWindow = U32T(sshsNodeGetInt(moduleData->moduleNode, "timeWindow"));
+	state->settings.maxDisparity = U32T(sshsNodeGetInt(moduleData->moduleNode, "maxDisparity"));
+	state->settings.epipolarTolerance = U32T(sshsNodeGetInt(moduleData->moduleNode, "epipolarTolerance"));
 }
 
 static void caerStereoMatchingConfig(caerModuleData moduleData) {
@@ -77,6 +82,17 @@ static void caerStereoMatchingConfig(caerModuleData moduleData) {
 
 	StereoMatchingState state = moduleData->moduleState;
 
+	// Free filename strings, get reloaded in next step.
+	free(state->settings.loadFileName_extrinsic);
+	free(state->settings.loadFileName_intrinsic);
+
+	// Reload all local settings.
+	updateSettings(moduleData);
+
+	StereoMatching_updateSettings(state->cpp_class);
+
+	// Reload the calibration and recompute the rectification, the files may have changed.
+	state->calibrationLoaded = false;
 }
 
 static void caerStereoMatchingExit(caerModuleData moduleData) {
@@ -85,72 +101,67 @@ static void caerStereoMatchingExit(caerModuleData moduleData) {
 
 	StereoMatchingState state = moduleData->moduleState;
 
+	StereoMatching_destroy(state->cpp_class);
 
+	free(state->settings.loadFileName_extrinsic);
+	free(state->settings.loadFileName_intrinsic);
 }
 
 static void caerStereoMatchingRun(caerModuleData moduleData, size_t argsNumber, va_list args) {
 	UNUSED_ARGUMENT(argsNumber);
 
 	// Interpret variable arguments (same as above in main function).
+	caerPolarityEventPacket polarity_0 = va_arg(args, caerPolarityEventPacket);
+	caerPolarityEventPacket polarity_1 = va_arg(args, caerPolarityEventPacket);
 	caerFrameEventPacket frame_0 = va_arg(args, caerFrameEventPacket);
 	caerFrameEventPacket frame_1 = va_arg(args, caerFrameEventPacket);
+	caerPoint4DEventPacket *depth = va_arg(args, caerPoint4DEventPacket *);
 
 	StereoMatchingState state = moduleData->moduleState;
 
-	// At this point we always try to load the calibration settings for undistorsion.
-	// Maybe they just got created or exist from a previous run.
+	// The calibration, and with it the rectification maps, is loaded once we know the image size,
+	// and then only reloaded after a configuration change.
 	if (!state->calibrationLoaded) {
-		state->calibrationLoaded = StereoMatching_loadCalibrationFile(state->cpp_class, &state->settings);
-	}
-
-	// Stereo Camera calibration is done only using frames.
-	if (state->settings.doMatching && frame_0 != NULL && frame_1 != NULL) {
-
-		//caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString, "Looking for calibration patterns...");
+		int16_t sourceID = -1;
 
-		bool frame_0_pattern = false;
-		uint64_t frame_0_ts = NULL;
-		bool frame_1_pattern = false;
-		uint64_t frame_1_ts = NULL;
-		void * foundPoint_cam1 = NULL;
-		void * foundPoint_cam0 = NULL;
-
-
-		// get last valid frame in packet for both cameras
-		caerFrameEventPacket currFramePacket_cam0 = (caerFrameEventPacket) frame_0;
-		caerFrameEvent currFrameEvent_cam0;
-		bool have_frame_0 = false;
-
-		for (int32_t i = caerEventPacketHeaderGetEventNumber(&currFramePacket_cam0->packetHeader) - 1; i >= 0; i--) {
-			currFrameEvent_cam0 = caerFrameEventPacketGetEvent(currFramePacket_cam0, i);
-			if (caerFrameEventIsValid(currFrameEvent_cam0)) {
-				//currFrameEvent_cam0
-				have_frame_0 = true;
-				break;
-			}
+		if (polarity_0 != NULL) {
+			sourceID = caerEventPacketHeaderGetEventSource(&polarity_0->packetHeader);
+		}
+		else if (frame_0 != NULL) {
+			sourceID = caerEventPacketHeaderGetEventSource(&frame_0->packetHeader);
+		}
+		else {
+			return;
 		}
 
-		caerFrameEventPacket currFramePacket_cam1 = (caerFrameEventPacket) frame_1;
-		caerFrameEvent currFrameEvent_cam1;
-		bool have_frame_1 = false;
-
-		for (int32_t i = caerEventPacketHeaderGetEventNumber(&currFramePacket_cam1->packetHeader) - 1; i >= 0; i--) {
-			currFrameEvent_cam1 = caerFrameEventPacketGetEvent(currFramePacket_cam1, i);
-			if (caerFrameEventIsValid(currFrameEvent_cam1)) {
-				//currFrameEvent_cam1
-				have_frame_1 = true;
-				break;
-			}
+		sshsNode sourceInfoNode = caerMainloopGetSourceInfo(U16T(sourceID));
+		if (sourceInfoNode == NULL) {
+			// This should never happen, but we handle it gracefully.
+			caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString,
+				"Failed to get source info to setup stereo rectification.");
+			return;
 		}
 
-		if(have_frame_1 && have_frame_0){
-			//we got frames proceed with stereo matching
-			StereoMatching_stereoMatch(state->cpp_class,  &state->settings, currFrameEvent_cam0, currFrameEvent_cam1);
+		// The calibration is done on frames, so it's in APS pixel coordinates.
+		state->settings.imageWidth = U32T(sshsNodeGetShort(sourceInfoNode, "apsSizeX"));
+		state->settings.imageHeigth = U32T(sshsNodeGetShort(sourceInfoNode, "apsSizeY"));
+
+		state->calibrationLoaded = StereoMatching_loadCalibrationFile(state->cpp_class, &state->settings);
+		if (!state->calibrationLoaded) {
+			return;
 		}
+	}
 
+	// Matching uses its own rectified coordinates, so it has to see the original events.
+	if (state->settings.doMatching && (polarity_0 != NULL || polarity_1 != NULL)) {
+		*depth = StereoMatching_matchEvents(state->cpp_class, polarity_0, polarity_1, I16T(moduleData->moduleID));
 	}
 
-	// update settings
-	updateSettings(moduleData);
+	if (state->settings.doRectification) {
+		StereoMatching_rectifyEvents(state->cpp_class, polarity_0, 0);
+		StereoMatching_rectifyEvents(state->cpp_class, polarity_1, 1);
 
+		StereoMatching_rectifyFrames(state->cpp_class, frame_0, 0);
+		StereoMatching_rectifyFrames(state->cpp_class, frame_1, 1);
+	}
 }
@@ -2,35 +2,208 @@
 #include <fstream>
 #include <iostream>
 
-StereoMatching::StereoMatching(StereoMatchingSettings settings){
+StereoMatching::StereoMatching(StereoMatchingSettings settings) {
+	updateSettings(settings);
+}
+
+void StereoMatching::rectifyFrame(caerFrameEvent frame, size_t camera) {
+	Size frameSize(caerFrameEventGetLengthX(frame), caerFrameEventGetLengthY(frame));
+
+	// The maps only fit frames of the calibrated size.
+	if (frameSize != imageSize) {
+		return;
+	}
+
+	Mat view(frameSize, CV_16UC(caerFrameEventGetChannelNumber(frame)), caerFrameEventGetPixelArrayUnsafe(frame));
 
-	updateSettings(this->settings);
+	// Reuses the buffer from the last frame, as long as size and type stay the same.
+	view.copyTo(rectifyFrameInput);
 
+	remap(rectifyFrameInput, view, rectifyRemap1[camera], rectifyRemap2[camera], INTER_LINEAR, BORDER_CONSTANT);
 }
 
-bool StereoMatching::stereoMatch(StereoMatchingSettings settings, caerFrameEvent vec1, caerFrameEvent vec2) {
-	this->settings = settings;
+void StereoMatching::rectifyFrames(caerFrameEventPacket frame, size_t camera) {
+	if (frame == NULL || rectifyEventLUT[camera].empty()) {
+		return;
+	}
 
-	// Initialize OpenCV Mat based on caerFrameEvent data directly (no image copy).
-	Size frameSize_cam0(caerFrameEventGetLengthX(vec1), caerFrameEventGetLengthY(vec1));
-	Mat Image_cam0(frameSize_cam0, CV_16UC(caerFrameEventGetChannelNumber(vec1)), caerFrameEventGetPixelArrayUnsafe(vec1));
+	// Rectification maps are computed once, at calibration load, and only applied here.
+	// Each camera's frames are rectified on their own, no need to pair them up.
+	CAER_FRAME_ITERATOR_VALID_START(frame)
+		rectifyFrame(caerFrameIteratorElement, camera);
+	CAER_FRAME_ITERATOR_VALID_END
+}
 
-	Size frameSize_cam1(caerFrameEventGetLengthX(vec2), caerFrameEventGetLengthY(vec2));
-	Mat Image_cam1(frameSize_cam1, CV_16UC(caerFrameEventGetChannelNumber(vec2)), caerFrameEventGetPixelArrayUnsafe(vec2));
+void StereoMatching::rectifyEvents(caerPolarityEventPacket polarity, size_t camera) {
+	if (polarity == NULL || rectifyEventLUT[camera].empty()) {
+		return;
+	}
 
-    cv::stereoRectify( M1, D1, M2, D2, frameSize_cam0, R, T, R1, R2, P1, P2, Q, CALIB_ZERO_DISPARITY, -1, frameSize_cam0);
+	const uint32_t *lut = rectifyEventLUT[camera].data();
+	const uint32_t width = (uint32_t) imageSize.width;
+	const uint32_t heigth = (uint32_t) imageSize.height;
 
-    /*Mat map11, map12, map21, map22;
-    cv::initUndistortRectifyMap(M1, D1, R1, P1, frameSize_cam0, CV_16SC2, map11, map12);
-    cv::initUndistortRectifyMap(M2, D2, R2, P2, frameSize_cam1, CV_16SC2, map21, map22);
+	CAER_POLARITY_ITERATOR_VALID_START(polarity)
+		uint32_t x = caerPolarityEventGetX(caerPolarityIteratorElement);
+		uint32_t y = caerPolarityEventGetY(caerPolarityIteratorElement);
+
+		// Events rectified to outside the view are invalidated.
+		uint32_t coordinates = (x < width && y < heigth) ? (lut[(y * width) + x]) : (STEREO_RECTIFY_INVALID);
+
+		if (coordinates == STEREO_RECTIFY_INVALID) {
+			caerPolarityEventInvalidate(caerPolarityIteratorElement, polarity);
+		}
+		else {
+			caerPolarityEventSetX(caerPolarityIteratorElement, (uint16_t) (coordinates >> 16));
+			caerPolarityEventSetY(caerPolarityIteratorElement, (uint16_t) (coordinates & 0xFFFF));
+		}
+	CAER_POLARITY_ITERATOR_VALID_END
+}
+
+/**
+ * Look for the most recent event of the same polarity in the other camera,
+ * within the time window, on the same rectified row (up to the epipolar
+ * tolerance) and at most maxDisparity pixels away in the direction of
+ * positive disparity. Camera 0 is the left one.
+ */
+bool StereoMatching::matchEvent(size_t camera, uint32_t x, uint32_t y, bool polarity, int64_t timestamp,
+	uint32_t *disparity) {
+	const size_t width = (size_t) imageSize.width;
+	const int64_t *other = lastTimestamp[1 - camera][polarity].data();
+
+	uint32_t rowStart = (y > settings->epipolarTolerance) ? (y - settings->epipolarTolerance) : (0);
+	uint32_t rowEnd = (uint32_t) min((int64_t) y + settings->epipolarTolerance, (int64_t) imageSize.height - 1);
+
+	// Left camera events match to the left on the right image, and vice-versa.
+	uint32_t colStart, colEnd;
+	if (camera == 0) {
+		colStart = (x > settings->maxDisparity) ? (x - settings->maxDisparity) : (0);
+		colEnd = x;
+	}
+	else {
+		colStart = x;
+		colEnd = (uint32_t) min((int64_t) x + settings->maxDisparity, (int64_t) imageSize.width - 1);
+	}
 
-    Mat img1r, img2r;
-	cv::remap(Image_cam0, img1r, map11, map12, INTER_LINEAR);
-	cv::remap(Image_cam1, img2r, map21, map22, INTER_LINEAR);
+	int64_t bestTimestamp = timestamp - settings->timeWindow;
+	bool found = false;
 
-	Image_cam0 = img1r;
-	Image_cam1 = img2r;*/
+	for (uint32_t row = rowStart; row <= rowEnd; row++) {
+		const int64_t *otherRow = other + (row * width);
 
+		for (uint32_t col = colStart; col <= colEnd; col++) {
+			// Closest in time wins.
+			if (otherRow[col] > bestTimestamp) {
+				bestTimestamp = otherRow[col];
+				*disparity = (camera == 0) ? (x - col) : (col - x);
+				found = true;
+			}
+		}
+	}
+
+	return (found);
+}
+
+caerPoint4DEventPacket StereoMatching::matchEvents(caerPolarityEventPacket polarity_0,
+	caerPolarityEventPacket polarity_1, int16_t sourceID) {
+	if (rectifyEventLUT[0].empty()) {
+		return (NULL);
+	}
+
+	caerPolarityEventPacket packets[2] = { polarity_0, polarity_1 };
+	int32_t eventsNumber[2] = { 0, 0 };
+
+	for (size_t c = 0; c < 2; c++) {
+		if (packets[c] != NULL) {
+			eventsNumber[c] = caerEventPacketHeaderGetEventNumber(&packets[c]->packetHeader);
+		}
+	}
+
+	if (eventsNumber[0] + eventsNumber[1] == 0) {
+		return (NULL);
+	}
+
+	// At most one depth event per polarity event.
+	caerPoint4DEventPacket depthPacket = caerPoint4DEventPacketAllocate(eventsNumber[0] + eventsNumber[1], sourceID,
+		caerEventPacketHeaderGetEventTSOverflow(
+			(packets[0] != NULL) ? (&packets[0]->packetHeader) : (&packets[1]->packetHeader)));
+	if (depthPacket == NULL) {
+		return (NULL);
+	}
+
+	// Depth from disparity: Z = f * B / d, as in the reprojection matrix Q.
+	const double depthNumerator = Q.at<double>(2, 3);
+	const double depthScale = Q.at<double>(3, 2);
+	const double depthOffset = Q.at<double>(3, 3);
+	const size_t width = (size_t) imageSize.width;
+
+	int32_t depthNumber = 0;
+	int32_t i[2] = { 0, 0 };
+
+	// Both packets are ordered by time: merge them, so each event is matched
+	// against all the events of the other camera that came before it.
+	while (i[0] < eventsNumber[0] || i[1] < eventsNumber[1]) {
+		caerPolarityEvent events[2] = { NULL, NULL };
+		int64_t timestamps[2] = { INT64_MAX, INT64_MAX };
+
+		for (size_t c = 0; c < 2; c++) {
+			if (i[c] < eventsNumber[c]) {
+				events[c] = caerPolarityEventPacketGetEvent(packets[c], i[c]);
+				timestamps[c] = caerPolarityEventGetTimestamp64(events[c], packets[c]);
+			}
+		}
+
+		size_t camera = (timestamps[0] <= timestamps[1]) ? (0) : (1);
+		caerPolarityEvent event = events[camera];
+		int64_t timestamp = timestamps[camera];
+		i[camera]++;
+
+		if (!caerPolarityEventIsValid(event)) {
+			continue;
+		}
+
+		uint32_t x = caerPolarityEventGetX(event);
+		uint32_t y = caerPolarityEventGetY(event);
+
+		if (x >= (uint32_t) imageSize.width || y >= (uint32_t) imageSize.height) {
+			continue;
+		}
+
+		uint32_t coordinates = rectifyEventLUT[camera][(y * width) + x];
+		if (coordinates == STEREO_RECTIFY_INVALID) {
+			continue;
+		}
+
+		x = coordinates >> 16;
+		y = coordinates & 0xFFFF;
+		bool polarity = caerPolarityEventGetPolarity(event);
+
+		lastTimestamp[camera][polarity][(y * width) + x] = timestamp;
+
+		uint32_t disparity;
+		if (!matchEvent(camera, x, y, polarity, timestamp, &disparity) || disparity == 0) {
+			// No match, or at infinity.
+			continue;
+		}
+
+		caerPoint4DEvent depthEvent = caerPoint4DEventPacketGetEvent(depthPacket, depthNumber++);
+		caerPoint4DEventSetX(depthEvent, (float) ((camera == 0) ? (x) : (x + disparity)));
+		caerPoint4DEventSetY(depthEvent, (float) y);
+		caerPoint4DEventSetZ(depthEvent, (float) disparity);
+		caerPoint4DEventSetW(depthEvent,
+			(float) (depthNumerator / ((depthScale * (double) disparity) + depthOffset)));
+		caerPoint4DEventSetTimestamp(depthEvent, caerPolarityEventGetTimestamp(event));
+		caerPoint4DEventValidate(depthEvent, depthPacket);
+	}
+
+	if (depthNumber == 0) {
+		free(depthPacket);
+		return (NULL);
+	}
+
+	caerEventPacketHeaderSetEventNumber(&depthPacket->packetHeader, depthNumber);
+
+	return (depthPacket);
 }
 
 void StereoMatching::updateSettings(StereoMatchingSettings settings) {
@@ -40,6 +213,12 @@ void StereoMatching::updateSettings(StereoMatchingSettings settings) {
 
 
 bool StereoMatching::loadCalibrationFile(StereoMatchingSettings settings) {
+	this->settings = settings;
+
+	// Check that image size is properly defined.
+	if (settings->imageWidth <= 0 || settings->imageHeigth <= 0) {
+		return (false);
+	}
 
 	// Open file with undistort matrices.
 	FileStorage fs(settings->loadFileName_intrinsic, FileStorage::READ);
@@ -61,10 +240,62 @@ bool StereoMatching::loadCalibrationFile(StereoMatchingSettings settings) {
 	if (!fs1.isOpened()) {
 		return (false);
 	}
-    fs1["R"] >> R;
-    fs1["T"] >> T;
+	fs1["R"] >> R;
+	fs1["T"] >> T;
 
 	fs1.release();
 
+	// Compute rectification once for this calibration, for both frames and events.
+	imageSize = Size(settings->imageWidth, settings->imageHeigth);
+
+	cv::stereoRectify(M1, D1, M2, D2, imageSize, R, T, R1, R2, P1, P2, Q, CALIB_ZERO_DISPARITY, -1, imageSize);
+
+	const Mat *cameraMatrix[2] = { &M1, &M2 };
+	const Mat *distCoeffs[2] = { &D1, &D2 };
+	const Mat *rectification[2] = { &R1, &R2 };
+	const Mat *projection[2] = { &P1, &P2 };
+
+	// All possible (x, y) addresses, at the pixel center.
+	vector<Point2f> rectifyEventInputMap;
+	rectifyEventInputMap.reserve(settings->imageWidth * settings->imageHeigth);
+
+	for (size_t y = 0; y < settings->imageHeigth; y++) {
+		for (size_t x = 0; x < settings->imageWidth; x++) {
+			rectifyEventInputMap.push_back(Point2f(x + 0.5, y + 0.5));
+		}
+	}
+
+	for (size_t c = 0; c < 2; c++) {
+		cv::initUndistortRectifyMap(*cameraMatrix[c], *distCoeffs[c], *rectification[c], *projection[c], imageSize,
+			CV_16SC2, rectifyRemap1[c], rectifyRemap2[c]);
+
+		vector<Point2f> rectifyEventOutputMap;
+		cv::undistortPoints(rectifyEventInputMap, rectifyEventOutputMap, *cameraMatrix[c], *distCoeffs[c],
+			*rectification[c], *projection[c]);
+
+		rectifyEventLUT[c].clear();
+		rectifyEventLUT[c].reserve(rectifyEventOutputMap.size());
+
+		for (size_t i = 0; i < rectifyEventOutputMap.size(); i++) {
+			int x = cvRound(rectifyEventOutputMap[i].x);
+			int y = cvRound(rectifyEventOutputMap[i].y);
+
+			if (x < 0 || x >= imageSize.width || y < 0 || y >= imageSize.height) {
+				rectifyEventLUT[c].push_back(STEREO_RECTIFY_INVALID);
+			}
+			else {
+				rectifyEventLUT[c].push_back((uint32_t) ((x << 16) | y));
+			}
+		}
+
+		// Forget events from before this calibration.
+		for (size_t p = 0; p < 2; p++) {
+			lastTimestamp[c][p].assign(settings->imageWidth * settings->imageHeigth, INT64_MIN / 2);
+		}
+	}
+
+	// The last input frame copy is of no use with new maps.
+	rectifyFrameInput.release();
+
 	return (true);
 }
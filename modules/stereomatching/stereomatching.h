@@ -5,7 +5,30 @@
 
 #include <libcaer/events/polarity.h>
 #include <libcaer/events/frame.h>
+#include <libcaer/events/point4d.h>
 
-void caerStereoMatching(uint16_t moduleID, caerFrameEventPacket frame_0, caerFrameEventPacket frame_1);
+/**
+ * Rectify the frames and events of a calibrated stereo camera pair, and
+ * match events between the two cameras to get depth at event rate.
+ *
+ * Rectification maps are computed once, when the calibration is loaded.
+ * Event matching looks, for each event, for the most recent event of the
+ * same polarity from the other camera, within a time window, on the same
+ * rectified row and at most a maximum disparity away. Both cameras need
+ * synchronized timestamps.
+ *
+ * Depth events carry the rectified position in the left camera (cam0) in X
+ * and Y, the disparity in pixels in Z and the depth, in the units of the
+ * stereo calibration, in W.
+ *
+ * @param moduleID the module ID.
+ * @param polarity_0 the events of the left camera, rectified in-place.
+ * @param polarity_1 the events of the right camera, rectified in-place.
+ * @param frame_0 the frames of the left camera, rectified in-place.
+ * @param frame_1 the frames of the right camera, rectified in-place.
+ * @param depth returns the depth events, NULL if none. To be freed by the caller.
+ */
+void caerStereoMatching(uint16_t moduleID, caerPolarityEventPacket polarity_0, caerPolarityEventPacket polarity_1,
+	caerFrameEventPacket frame_0, caerFrameEventPacket frame_1, caerPoint4DEventPacket *depth);
 
 #endif /* STEREOMATCHING_H_ */
@@ -17,6 +17,7 @@
 
 #include <libcaer/events/polarity.h>
 #include <libcaer/events/frame.h>
+#include <libcaer/events/point4d.h>
 
 #include <opencv2/core.hpp>
 #include <opencv2/core/utility.hpp>
@@ -27,6 +28,9 @@
 #include <opencv2/aruco.hpp>
 #include <opencv2/highgui/highgui.hpp>
 
+// Marks pixels that are rectified to outside of the view.
+#define STEREO_RECTIFY_INVALID UINT32_MAX
+
 using namespace cv;
 using namespace std;
 
@@ -36,7 +40,10 @@ public:
 	StereoMatching(StereoMatchingSettings settings);
 	void updateSettings(StereoMatchingSettings settings);
 	bool loadCalibrationFile(StereoMatchingSettings settings);
-	bool stereoMatch(StereoMatchingSettings settings, caerFrameEvent vec1, caerFrameEvent vec2);
+	void rectifyFrames(caerFrameEventPacket frame, size_t camera);
+	void rectifyEvents(caerPolarityEventPacket polarity, size_t camera);
+	caerPoint4DEventPacket matchEvents(caerPolarityEventPacket polarity_0, caerPolarityEventPacket polarity_1,
+		int16_t sourceID);
 
 private:
 	Mat M1, D1, M2, D2;
@@ -44,6 +51,20 @@ private:
 	Mat Q;
 	StereoMatchingSettings settings = NULL;
 
+	// Rectification, computed once per calibration load: fixed-point maps for
+	// frame remap(), and rectified event coordinates per pixel, packed as
+	// (x << 16) | y, or STEREO_RECTIFY_INVALID, for both cameras.
+	Size imageSize;
+	Mat rectifyRemap1[2];
+	Mat rectifyRemap2[2];
+	Mat rectifyFrameInput;
+	vector<uint32_t> rectifyEventLUT[2];
+
+	// Last timestamp of each rectified pixel, per camera and polarity.
+	vector<int64_t> lastTimestamp[2][2];
+
+	void rectifyFrame(caerFrameEvent frame, size_t camera);
+	bool matchEvent(size_t camera, uint32_t x, uint32_t y, bool polarity, int64_t timestamp, uint32_t *disparity);
 };
 
 #endif /* STEREOMATCHING_HPP_ */
@@ -24,26 +24,42 @@ void StereoMatching_updateSettings(StereoMatching *calibClass) {
 
 }
 
-bool StereoMatching_stereoMatch(StereoMatching *calibClass, StereoMatchingSettings settings,
-	caerFrameEvent  vec1, caerFrameEvent  vec2) {
+bool StereoMatching_loadCalibrationFile(StereoMatching *calibClass,
+		StereoMatchingSettings settings) {
+	try {
+		return (calibClass->loadCalibrationFile(settings));
+	} catch (const std::exception& ex) {
+		caerLog(CAER_LOG_ERROR, "StereoMatching_loadCalibrationFile()",
+				"Failed with C++ exception: %s", ex.what());
+		return (false);
+	}
+}
 
+void StereoMatching_rectifyFrames(StereoMatching *matchingClass, caerFrameEventPacket frame, size_t camera) {
 	try {
-			return (calibClass->stereoMatch(settings, vec1, vec2));
+		matchingClass->rectifyFrames(frame, camera);
 	} catch (const std::exception& ex) {
-			caerLog(CAER_LOG_ERROR, "StereoMatching_stereMatch()",
-					"Failed with C++ exception: %s", ex.what());
-			return (false);
+		caerLog(CAER_LOG_ERROR, "StereoMatching_rectifyFrames()",
+				"Failed with C++ exception: %s", ex.what());
 	}
+}
 
+void StereoMatching_rectifyEvents(StereoMatching *matchingClass, caerPolarityEventPacket polarity, size_t camera) {
+	try {
+		matchingClass->rectifyEvents(polarity, camera);
+	} catch (const std::exception& ex) {
+		caerLog(CAER_LOG_ERROR, "StereoMatching_rectifyEvents()",
+				"Failed with C++ exception: %s", ex.what());
+	}
 }
 
-bool StereoMatching_loadCalibrationFile(StereoMatching *calibClass,
-		StereoMatchingSettings settings) {
+caerPoint4DEventPacket StereoMatching_matchEvents(StereoMatching *matchingClass, caerPolarityEventPacket polarity_0,
+	caerPolarityEventPacket polarity_1, int16_t sourceID) {
 	try {
-		return (calibClass->loadCalibrationFile(settings));
+		return (matchingClass->matchEvents(polarity_0, polarity_1, sourceID));
 	} catch (const std::exception& ex) {
-		caerLog(CAER_LOG_ERROR, "StereoMatching_loadCalibrationFile()",
+		caerLog(CAER_LOG_ERROR, "StereoMatching_matchEvents()",
 				"Failed with C++ exception: %s", ex.what());
-		return (false);
+		return (NULL);
 	}
 }
@@ -14,7 +14,10 @@ void StereoMatching_destroy(StereoMatching *matchingClass);
 void StereoMatching_updateSettings(StereoMatching *matchingClass);
 bool StereoMatching_loadCalibrationFile(StereoMatching *matchingClass,
 		StereoMatchingSettings settings);
-bool StereoMatching_stereoMatch(StereoMatching *matchingClass, StereoMatchingSettings setting,  caerFrameEvent vec1, caerFrameEvent vec2);
+void StereoMatching_rectifyFrames(StereoMatching *matchingClass, caerFrameEventPacket frame, size_t camera);
+void StereoMatching_rectifyEvents(StereoMatching *matchingClass, caerPolarityEventPacket polarity, size_t camera);
+caerPoint4DEventPacket StereoMatching_matchEvents(StereoMatching *matchingClass, caerPolarityEventPacket polarity_0,
+	caerPolarityEventPacket polarity_1, int16_t sourceID);
 
 #ifdef __cplusplus
 }
@@ -8,465 +8,571 @@
 #include "surveillance.h"
 #include "base/mainloop.h"
 #include "base/module.h"
-#include "ext/buffers.h"
-#include "math.h"
 
-struct SVFilter_state {
-	simple2DBufferLong blobMap;
-	int32_t deltaT;
-	int8_t subSampleBy;
-};
+#include <math.h>
 
+// Cluster IDs are reported as float, which is exact up to 2^24.
+#define SVFILTER_CLUSTER_ID_MASK 0x00FFFFFF
+#define SVFILTER_NO_CLUSTER (-1)
 
-static float visualThrehold = 40;
-//static int timeThrehold = 10000;
-//static int maxClusterDistance = 50;
-static int maxClusterNum = 5;
-static int currentClusterNum = 0;
-static int clusterMassDecay = 10000;
-static int defaultClusterRadius = 70;
-static double mixingFactor = 0.01;
-static float massForVisible = 40;
-static int TimeStep = 100;
-static float mVelocity = 0;
-
-
-typedef struct cluster {
-	int32_t xCenter;
-	int32_t yCenter;
-	float xRadius;
-	float yRadius;
-	float xVelocity;
-	float yVelocity;
-	float Radius;
-	int32_t xTotal;
-	int32_t yTotal;
-	int32_t EventsNum;
-	int64_t LastTime;
-	int64_t birthTime;
+/**
+ * Clusters live in a fixed pool, free ones are kept on a stack. Used ones
+ * are also linked into the grid cell that contains their center, so that
+ * finding the clusters close to an event only looks at a few of them.
+ */
+struct SVFilter_cluster {
+	float x;
+	float y;
+	/// Exponentially decaying event count, as of lastTime.
 	float mass;
-	bool isEmpty;
-	bool isVisible;
-	//int64_t startVisibleTime;
-}Cluster;
-
-Cluster clusterList[5];
-
-
-
+	int64_t lastTime;
+	int64_t birthTime;
+	uint32_t id;
+	bool visible;
+	/// Grid cell the center is in, SVFILTER_NO_CLUSTER for free clusters.
+	int32_t gridCell;
+	int32_t gridPrev;
+	int32_t gridNext;
+};
 
+struct SVFilter_state {
+	struct SVFilter_cluster *clusters;
+	int32_t *freeClusters;
+	int32_t freeClustersNumber;
+	/// First cluster of each grid cell, cells are clusterRadius pixels wide.
+	int32_t *grid;
+	int32_t gridSizeX;
+	int32_t gridSizeY;
+	int16_t sizeX;
+	int16_t sizeY;
+	uint32_t nextClusterID;
+	int64_t lastPruneTimestamp;
+	int64_t lastFrameTimestamp;
+	// Layout the pool and grid were allocated with.
+	int32_t poolMaxClusters;
+	int32_t poolClusterRadius;
+	// Configuration.
+	int32_t maxClusters;
+	int32_t clusterRadius;
+	float mixingFactor;
+	float massDecayTime;
+	float massVisible;
+	int32_t pruneInterval;
+	int32_t frameInterval;
+};
 
 typedef struct SVFilter_state *SVFilterState;
 
 static bool caerSurveillanceInit(caerModuleData moduleData);
 static void caerSurveillanceRun(caerModuleData moduleData, size_t argsNumber, va_list args);
-//static void caerSurveillanceRun(caerModuleData moduleData, size_t argsNumber, va_list args, ClusterList *clusterListHead);
 static void caerSurveillanceConfig(caerModuleData moduleData);
 static void caerSurveillanceExit(caerModuleData moduleData);
 static void caerSurveillanceReset(caerModuleData moduleData, uint16_t resetCallSourceID);
-static bool allocateBlobMap(SVFilterState state, int16_t sourceID);
-static int getNearestCluster(uint16_t x, uint16_t y, int64_t ts);
-static void updateCluster(int i, uint16_t x, uint16_t y, int64_t ts);
-static Cluster newCluster(uint16_t x, uint16_t y, int64_t ts);
-static int pruning( int64_t ts);
-static void merge();
-
-static struct caer_module_functions caerSurveillanceFunctions = { .moduleInit =
-	&caerSurveillanceInit, .moduleRun = &caerSurveillanceRun, .moduleConfig =
-	&caerSurveillanceConfig, .moduleExit = &caerSurveillanceExit, .moduleReset =
+static bool allocateClusters(SVFilterState state, int16_t sourceID);
+static void freeClusters(SVFilterState state);
+static void resetClusters(SVFilterState state);
+static int32_t getNearestCluster(SVFilterState state, float x, float y, int32_t exclude);
+static void updateCluster(SVFilterState state, int32_t index, uint16_t x, uint16_t y, int64_t ts);
+static void newCluster(SVFilterState state, uint16_t x, uint16_t y, int64_t ts);
+static void deleteCluster(SVFilterState state, int32_t index);
+static void gridLink(SVFilterState state, int32_t index);
+static void gridUnlink(SVFilterState state, int32_t index);
+static void pruneClusters(SVFilterState state, int64_t ts);
+static caerPoint4DEventPacket outputClusters(caerModuleData moduleData, caerPolarityEventPacket polarity, int64_t ts);
+static caerFrameEventPacket renderFrame(caerModuleData moduleData);
+
+static struct caer_module_functions caerSurveillanceFunctions = { .moduleInit = &caerSurveillanceInit, .moduleRun =
+	&caerSurveillanceRun, .moduleConfig = &caerSurveillanceConfig, .moduleExit = &caerSurveillanceExit, .moduleReset =
 	&caerSurveillanceReset };
 
-void caerSurveillanceFilter(uint16_t moduleID, caerPolarityEventPacket polarity, caerFrameEventPacket frame) {
+void caerSurveillanceFilter(uint16_t moduleID, caerPolarityEventPacket polarity, caerPoint4DEventPacket *clusters,
+	caerFrameEventPacket *frame) {
+	// Nothing to return unless the module runs and has something.
+	if (clusters != NULL) {
+		*clusters = NULL;
+	}
+	*frame = NULL;
+
 	caerModuleData moduleData = caerMainloopFindModule(moduleID, "SVFilter", CAER_MODULE_PROCESSOR);
 	if (moduleData == NULL) {
 		return;
 	}
 
-	caerModuleSM(&caerSurveillanceFunctions, moduleData, sizeof(struct SVFilter_state), 2, polarity, frame);
+	caerModuleSM(&caerSurveillanceFunctions, moduleData, sizeof(struct SVFilter_state), 3, polarity, clusters,
+		frame);
 }
 
 static bool caerSurveillanceInit(caerModuleData moduleData) {
-	sshsNodePutIntIfAbsent(moduleData->moduleNode, "deltaT", 30000);
-	sshsNodePutByteIfAbsent(moduleData->moduleNode, "subSampleBy", 0);
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "maxClusters", 256);
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "clusterRadius", 20); // in pixels
+	sshsNodePutFloatIfAbsent(moduleData->moduleNode, "mixingFactor", 0.01f);
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "massDecayTime", 10000); // in µs
+	sshsNodePutFloatIfAbsent(moduleData->moduleNode, "massVisible", 40.0f);
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "pruneInterval", 1000); // in µs
+	sshsNodePutIntIfAbsent(moduleData->moduleNode, "frameInterval", 0); // in µs, 0 disables frames
 
-	SVFilterState state = moduleData->moduleState;
-
-	state->deltaT = sshsNodeGetInt(moduleData->moduleNode, "deltaT");
-	state->subSampleBy = sshsNodeGetByte(moduleData->moduleNode, "subSampleBy");
+	caerSurveillanceConfig(moduleData);
 
 	// Add config listeners last, to avoid having them dangling if Init doesn't succeed.
 	sshsNodeAddAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
 
-	sshsNode sourceInfoNode = sshsGetRelativeNode(moduleData->moduleNode, "sourceInfo/");
-	sshsNode sourceInfoNodeCA = caerMainloopGetSourceInfo(1);  // TODO !!! -> remove hard CODED moduleID
-	if (!sshsNodeAttributeExists(sourceInfoNode, "dataSizeX", SSHS_SHORT)) { //to do for visualizer change name of field to a more generic one
-		sshsNodePutShort(sourceInfoNode, "dataSizeX", sshsNodeGetShort(sourceInfoNodeCA, "dvsSizeX"));
-		sshsNodePutShort(sourceInfoNode, "dataSizeY", sshsNodeGetShort(sourceInfoNodeCA, "dvsSizeX"));
-	}
-
-	// initialize all cluster as empty
-    int i;
-    for (i=0; i<maxClusterNum; i++){
-    	clusterList[i].isEmpty = true;
-    	clusterList[i].isVisible = false;
-    }
 	// Nothing that can fail here.
 	return (true);
 }
+
 static void caerSurveillanceRun(caerModuleData moduleData, size_t argsNumber, va_list args) {
 	UNUSED_ARGUMENT(argsNumber);
 
 	// Interpret variable arguments (same as above in main function).
 	caerPolarityEventPacket polarity = va_arg(args, caerPolarityEventPacket);
-	caerFrameEventPacket *frame = va_arg(args, caerFrameEventPacket*);
+	caerPoint4DEventPacket *clusters = va_arg(args, caerPoint4DEventPacket *);
+	caerFrameEventPacket *frame = va_arg(args, caerFrameEventPacket *);
 
 	// Only process packets with content.
-	if (polarity == NULL) {
+	if (polarity == NULL || caerEventPacketHeaderGetEventNumber(&polarity->packetHeader) <= 0) {
 		return;
 	}
 
 	SVFilterState state = moduleData->moduleState;
 
-	// If the map is not allocated yet, do it.
-	if (state->blobMap == NULL) {
-		if (!allocateBlobMap(state, caerEventPacketHeaderGetEventSource(&polarity->packetHeader))) {
+	// If the cluster pool is not allocated yet, or its layout changed, (re-)do it.
+	if (state->clusters == NULL || state->poolMaxClusters != state->maxClusters
+		|| state->poolClusterRadius != state->clusterRadius) {
+		freeClusters(state);
+
+		if (!allocateClusters(state, caerEventPacketHeaderGetEventSource(&polarity->packetHeader))) {
 			// Failed to allocate memory, nothing to do.
-			caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate memory for blobMap.");
+			caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate memory for clusters.");
 			return;
 		}
+
+		// Frames have the same size as the source, tell the visualizer.
+		sshsNode sourceInfoNode = sshsGetRelativeNode(moduleData->moduleNode, "sourceInfo/");
+		sshsNodePutShort(sourceInfoNode, "dataSizeX", state->sizeX);
+		sshsNodePutShort(sourceInfoNode, "dataSizeY", state->sizeY);
 	}
 
-	// Iterate over events and filter out ones that are not supported by other
-	// events within a certain region in the specified timeframe.
+	int64_t ts = 0;
+
 	CAER_POLARITY_ITERATOR_VALID_START(polarity)
-		// Get values on which to operate.
-		int64_t ts = caerPolarityEventGetTimestamp64(caerPolarityIteratorElement, polarity);
+		ts = caerPolarityEventGetTimestamp64(caerPolarityIteratorElement, polarity);
 		uint16_t x = caerPolarityEventGetX(caerPolarityIteratorElement);
 		uint16_t y = caerPolarityEventGetY(caerPolarityIteratorElement);
 
-		// Apply sub-sampling.
-		//x = U16T(x >> state->subSampleBy);
-		//y = U16T(y >> state->subSampleBy);
+		// Time went backwards without a reset: start over.
+		if (ts < state->lastPruneTimestamp) {
+			resetClusters(state);
+		}
 
-		// Get value from map.
-		int64_t lastTS = state->blobMap->buffer2d[x][y];
+		// Update the nearest cluster in range, or start a new one if there's room.
+		int32_t chosenCluster = getNearestCluster(state, (float) x, (float) y, SVFILTER_NO_CLUSTER);
 
-		/*if ((I64T(ts - lastTS) >= I64T(state->deltaT)) || (lastTS == 0)) {
-			// Filter out invalid.
-			caerPolarityEventInvalidate(caerPolarityIteratorElement, polarity);
-		}*/
+		if (chosenCluster != SVFILTER_NO_CLUSTER) {
+			updateCluster(state, chosenCluster, x, y, ts);
+		}
+		else if (state->freeClustersNumber > 0) {
+			newCluster(state, x, y, ts);
+		}
 
-		// Update neighboring region.
-		size_t sizeMaxX = (state->blobMap->sizeX - 1);
-		size_t sizeMaxY = (state->blobMap->sizeY - 1);
+		// Drop faded clusters and merge overlapping ones, at a fixed rate in event time.
+		if ((ts - state->lastPruneTimestamp) >= state->pruneInterval) {
+			pruneClusters(state, ts);
+		}
+	CAER_POLARITY_ITERATOR_VALID_END
 
-//		caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString, "x equal %d", x);
-//		caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString, "y equal %d", y);
-//		caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString, "ts equal %d", ts);
+	if (ts == 0) {
+		// No valid events.
+		return;
+	}
 
-		//state->blobMap->buffer2d[x - 1][y] = ts;
+	// Only build the cluster events if someone wants them.
+	if (clusters != NULL) {
+		*clusters = outputClusters(moduleData, polarity, ts);
+	}
 
-		//caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString, "from the surveillance filter %d", ts);
+	// Frames are generated at a fixed rate in event time.
+	if (state->frameInterval > 0 && (ts - state->lastFrameTimestamp) >= state->frameInterval) {
+		state->lastFrameTimestamp = ts;
 
-//		int i;
-//		for(i=0;i<10;i++){
-//			if (clusterList[i].isEmpty==1)
-//				caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString, "clusterList %d is empty", i);
-//		}
+		*frame = renderFrame(moduleData);
+	}
+}
 
+static void caerSurveillanceConfig(caerModuleData moduleData) {
+	caerModuleConfigUpdateReset(moduleData);
 
+	SVFilterState state = moduleData->moduleState;
 
+	int32_t maxClusters = sshsNodeGetInt(moduleData->moduleNode, "maxClusters");
+	state->maxClusters = (maxClusters < 1) ? (1) : ((maxClusters > 65536) ? (65536) : (maxClusters));
 
-		// check nearestCluster exist?
-		int chosenClusterIndex = getNearestCluster(x, y, ts);
+	int32_t clusterRadius = sshsNodeGetInt(moduleData->moduleNode, "clusterRadius");
+	state->clusterRadius = (clusterRadius < 1) ? (1) : ((clusterRadius > 4096) ? (4096) : (clusterRadius));
 
-		// if exist, update it
-		if (chosenClusterIndex != -1){
-			updateCluster(chosenClusterIndex, x, y, ts);
-		}
+	state->mixingFactor = sshsNodeGetFloat(moduleData->moduleNode, "mixingFactor");
 
-		// if not, create new cluster
-		else {
-			if (currentClusterNum < maxClusterNum) {
-				Cluster clusterNew = newCluster(x, y, ts);
-				int i;
-				for (i=0; i<maxClusterNum; i++){
-					if (clusterList[i].isEmpty == true){
-						clusterList[i] = clusterNew;
-						currentClusterNum = currentClusterNum + 1;
-					}
-				}
+	int32_t massDecayTime = sshsNodeGetInt(moduleData->moduleNode, "massDecayTime");
+	state->massDecayTime = (massDecayTime > 0) ? ((float) massDecayTime) : (1.0f);
 
-				//caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString, "New cluster is created");
-			}
-			//else caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString, "Cluster number is full");
-		}
+	state->massVisible = sshsNodeGetFloat(moduleData->moduleNode, "massVisible");
+	state->pruneInterval = sshsNodeGetInt(moduleData->moduleNode, "pruneInterval");
+	state->frameInterval = sshsNodeGetInt(moduleData->moduleNode, "frameInterval");
+}
 
-		// At each TimeStep point, do pruning
-		if (ts % TimeStep == 0){
-			int count;
-			count = pruning(ts);
-			//caerLog(CAER_LOG_NOTICE, moduleData->moduleSubSystemString, "%d cluster is deleted", count);
-		}
+static void caerSurveillanceExit(caerModuleData moduleData) {
+	// Remove listener, which can reference invalid memory in userData.
+	sshsNodeRemoveAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
 
-		// merge clusters that track the same object, this function does not work well, may cause error
-		//if (maxClusterNum > 1)
-			//merge();
+	SVFilterState state = moduleData->moduleState;
 
+	// Ensure clusters are freed.
+	freeClusters(state);
+}
 
-		CAER_POLARITY_ITERATOR_VALID_END
+static void caerSurveillanceReset(caerModuleData moduleData, uint16_t resetCallSourceID) {
+	UNUSED_ARGUMENT(resetCallSourceID);
 
-		sshsNode sourceInfoNode = caerMainloopGetSourceInfo(U16T(caerEventPacketHeaderGetEventSource(&polarity->packetHeader)));
-		int16_t sizeX =  sshsNodeGetShort(sourceInfoNode, "dvsSizeX");
-		int16_t sizeY =  sshsNodeGetShort(sourceInfoNode, "dvsSizeY");
+	SVFilterState state = moduleData->moduleState;
 
+	// Forget all clusters (startup state).
+	resetClusters(state);
+}
 
-		//fill the frame with the clusters
-		*frame = caerFrameEventPacketAllocate(1, I16T(moduleData->moduleID), 0, sizeX, sizeY, 3);
-		if (*frame != NULL) {
-				caerFrameEvent singleplot = caerFrameEventPacketGetEvent(*frame, 0);
+static bool allocateClusters(SVFilterState state, int16_t sourceID) {
+	// Get size information from source.
+	sshsNode sourceInfoNode = caerMainloopGetSourceInfo(U16T(sourceID));
+	if (sourceInfoNode == NULL) {
+		// This should never happen, but we handle it gracefully.
+		caerLog(CAER_LOG_ERROR, __func__, "Failed to get source info to allocate clusters.");
+		return (false);
+	}
 
-				uint32_t counter = 0;
-				for (size_t x = 0; x < sizeX; x++) {
-					for (size_t y = 0; y < sizeY; y++) {
-							singleplot->pixels[counter] = (uint16_t) ( (int) 1);					// red
-							singleplot->pixels[counter + 1] = (uint16_t) ( (int) 1);		// green
-							singleplot->pixels[counter + 2] = (uint16_t) ( (int)65000 );			// blue
-						counter += 3;
-					}
-				}
+	state->sizeX = sshsNodeGetShort(sourceInfoNode, "dvsSizeX");
+	state->sizeY = sshsNodeGetShort(sourceInfoNode, "dvsSizeY");
 
-				//add info to the frame
-				caerFrameEventSetLengthXLengthYChannelNumber(singleplot, sizeX, sizeY, 3, *frame);
-				//validate frame
-				caerFrameEventValidate(singleplot, *frame);
-		}
+	state->poolMaxClusters = state->maxClusters;
+	state->poolClusterRadius = state->clusterRadius;
 
+	state->gridSizeX = (state->sizeX / state->poolClusterRadius) + 1;
+	state->gridSizeY = (state->sizeY / state->poolClusterRadius) + 1;
 
-//		//for all clusters
-//		//loop over the frame and color the pixels of clusters of different colors
-		int i;
-		for (i=0; i<maxClusterNum; i++){
-			if ((*frame != NULL ) && clusterList[i].isEmpty != true && clusterList[i].isVisible == true ||(*frame != NULL ) && clusterList[i].isEmpty != true && clusterList[i].mass > massForVisible) {
-							clusterList[i].isVisible = true;
-							//clusterList[i].startVisibleTime = ts;
-							caerFrameEvent singleplot = caerFrameEventPacketGetEvent(*frame, 0);
-							uint32_t counter = 0;
-							for (size_t y = 0; y < sizeY; y++) {
-								for (size_t x = 0; x < sizeX; x++) {
-									if ( (x== clusterList[i].xCenter && y == clusterList[i].yCenter)||
-										 (x == (clusterList[i].xCenter + clusterList[i].xRadius) && y<=(clusterList[i].yCenter + clusterList[i].yRadius) && y >=(clusterList[i].yCenter - clusterList[i].yRadius) ||
-										 (x == (clusterList[i].xCenter - clusterList[i].xRadius) && y<=(clusterList[i].yCenter + clusterList[i].yRadius) && y >=(clusterList[i].yCenter - clusterList[i].yRadius) ||
-										 (y == (clusterList[i].yCenter + clusterList[i].yRadius) && x<=(clusterList[i].xCenter + clusterList[i].xRadius) && x >=(clusterList[i].xCenter - clusterList[i].xRadius) ||
-										 (y == (clusterList[i].yCenter - clusterList[i].yRadius) && x<=(clusterList[i].xCenter + clusterList[i].xRadius) && x >=(clusterList[i].xCenter - clusterList[i].xRadius)
-									   ))))) {
-										singleplot->pixels[counter] = (uint16_t) ( (int) 65000);		// red
-										singleplot->pixels[counter + 1] = (uint16_t) ( (int) 1);		// green
-										singleplot->pixels[counter + 2] = (uint16_t) ( (int) 1);		// blue
-									}
-									counter += 3;
-								}
-							}
-					}
-		}
+	state->clusters = calloc((size_t) state->poolMaxClusters, sizeof(struct SVFilter_cluster));
+	state->freeClusters = calloc((size_t) state->poolMaxClusters, sizeof(int32_t));
+	state->grid = calloc((size_t) state->gridSizeX * (size_t) state->gridSizeY, sizeof(int32_t));
+
+	if (state->clusters == NULL || state->freeClusters == NULL || state->grid == NULL) {
+		freeClusters(state);
+		return (false);
+	}
+
+	resetClusters(state);
+
+	return (true);
+}
+
+static void freeClusters(SVFilterState state) {
+	free(state->clusters);
+	state->clusters = NULL;
+	free(state->freeClusters);
+	state->freeClusters = NULL;
+	free(state->grid);
+	state->grid = NULL;
+}
+
+static void resetClusters(SVFilterState state) {
+	if (state->clusters == NULL) {
+		return;
+	}
 
+	// All clusters free, lowest indexes used first.
+	for (int32_t i = 0; i < state->poolMaxClusters; i++) {
+		state->clusters[i].gridCell = SVFILTER_NO_CLUSTER;
+		state->freeClusters[i] = state->poolMaxClusters - 1 - i;
+	}
+
+	state->freeClustersNumber = state->poolMaxClusters;
 
+	for (size_t i = 0; i < ((size_t) state->gridSizeX * (size_t) state->gridSizeY); i++) {
+		state->grid[i] = SVFILTER_NO_CLUSTER;
+	}
 
+	state->lastPruneTimestamp = 0;
+	state->lastFrameTimestamp = 0;
 }
 
+/**
+ * Find the cluster whose center is closest (L1 distance) to the given
+ * position, and within clusterRadius of it on both axes. Cells are as wide
+ * as the radius, so only the 3x3 cells around the position can have one.
+ *
+ * @return cluster index, or SVFILTER_NO_CLUSTER if none is in range.
+ */
+static int32_t getNearestCluster(SVFilterState state, float x, float y, int32_t exclude) {
+	int32_t radius = state->poolClusterRadius;
+	int32_t gridX = (int32_t) x / radius;
+	int32_t gridY = (int32_t) y / radius;
+
+	int32_t startX = (gridX > 0) ? (gridX - 1) : (0);
+	int32_t endX = (gridX < (state->gridSizeX - 1)) ? (gridX + 1) : (state->gridSizeX - 1);
+	int32_t startY = (gridY > 0) ? (gridY - 1) : (0);
+	int32_t endY = (gridY < (state->gridSizeY - 1)) ? (gridY + 1) : (state->gridSizeY - 1);
+
+	int32_t closest = SVFILTER_NO_CLUSTER;
+	float minDistance = INFINITY;
+
+	for (int32_t cellY = startY; cellY <= endY; cellY++) {
+		for (int32_t cellX = startX; cellX <= endX; cellX++) {
+			int32_t i = state->grid[(cellY * state->gridSizeX) + cellX];
+
+			for (; i != SVFILTER_NO_CLUSTER; i = state->clusters[i].gridNext) {
+				if (i == exclude) {
+					continue;
+				}
+
+				float xDiff = fabsf(x - state->clusters[i].x);
+				float yDiff = fabsf(y - state->clusters[i].y);
 
-static int getNearestCluster(uint16_t x, uint16_t y, int64_t ts){
-	int closest = -1;
-	int minDistance = 10000000;
-	int currentDistance = 0;
-	int i;
-	for (i = 0; i < maxClusterNum; i++){
-		if(clusterList[i].isEmpty != true){
-			int64_t dt = ts - clusterList[i].LastTime;
-			int xDiff = abs(x - clusterList[i].xCenter + clusterList[i].xVelocity * dt * mVelocity);
-			int yDiff = abs(y - clusterList[i].yCenter + clusterList[i].yVelocity * dt * mVelocity);
-			if (xDiff < clusterList[i].xRadius && yDiff < clusterList[i].yRadius) {
-				currentDistance = xDiff + yDiff;
-				if (currentDistance < minDistance){
+				if (xDiff < (float) radius && yDiff < (float) radius && (xDiff + yDiff) < minDistance) {
 					closest = i;
-					minDistance = currentDistance;
+					minDistance = xDiff + yDiff;
 				}
 			}
 		}
 	}
+
 	return (closest);
 }
 
+// Position is moved a bit towards each new event.
+static void updateCluster(SVFilterState state, int32_t index, uint16_t x, uint16_t y, int64_t ts) {
+	struct SVFilter_cluster *cluster = &state->clusters[index];
+	float m = state->mixingFactor;
+
+	cluster->x = ((1 - m) * cluster->x) + (m * (float) x);
+	cluster->y = ((1 - m) * cluster->y) + (m * (float) y);
 
-// position decided by moving a bit to new Event
+	cluster->mass = 1 + (cluster->mass * expf((float) (cluster->lastTime - ts) / state->massDecayTime));
+	cluster->lastTime = ts;
 
-static void updateCluster(int i, uint16_t x, uint16_t y, int64_t ts) {
-	float m = mixingFactor;
-	int64_t dt = ts - clusterList[i].LastTime;
+	if (cluster->mass >= state->massVisible) {
+		cluster->visible = true;
+	}
 
-	// get current position
-	int32_t xCurrent = clusterList[i].xCenter + clusterList[i].xVelocity * dt * mVelocity;
-	int32_t yCurrent = clusterList[i].yCenter + clusterList[i].yVelocity * dt * mVelocity;
+	// Keep the grid in sync with the center.
+	int32_t gridCell = (((int32_t) cluster->y / state->poolClusterRadius) * state->gridSizeX)
+		+ ((int32_t) cluster->x / state->poolClusterRadius);
 
-	// get new position && check the boundary
-	int32_t xNew = (1 - m) * xCurrent + m * x;
-	int32_t yNew = (1 - m) * yCurrent + m * y;
-	if (xNew < 0) xNew = 0;
-	if (xNew > 240) xNew = 240;
-	if (yNew < 0) yNew = 0;
-	if (yNew > 180) yNew = 180;
+	if (gridCell != cluster->gridCell) {
+		gridUnlink(state, index);
+		cluster->gridCell = gridCell;
+		gridLink(state, index);
+	}
+}
 
-	// get movement distance
-	int32_t xMoveDistance = xNew - xCurrent;
-	int32_t yMoveDistance = yNew - yCurrent;
+static void newCluster(SVFilterState state, uint16_t x, uint16_t y, int64_t ts) {
+	int32_t index = state->freeClusters[--state->freeClustersNumber];
+	struct SVFilter_cluster *cluster = &state->clusters[index];
 
-	// update position
-	clusterList[i].xCenter = xNew;
-	clusterList[i].yCenter = yNew;
+	cluster->x = (float) x;
+	cluster->y = (float) y;
+	cluster->mass = 1;
+	cluster->lastTime = ts;
+	cluster->birthTime = ts;
+	cluster->id = state->nextClusterID;
+	cluster->visible = false;
 
-	// update velocity
-	clusterList[i].xVelocity = (1-m) * clusterList[i].xVelocity + m * xMoveDistance;
-	clusterList[i].yVelocity = (1-m) * clusterList[i].yVelocity + m * yMoveDistance;
+	state->nextClusterID = (state->nextClusterID + 1) & SVFILTER_CLUSTER_ID_MASK;
+
+	cluster->gridCell = ((y / state->poolClusterRadius) * state->gridSizeX) + (x / state->poolClusterRadius);
+	gridLink(state, index);
+}
 
-	// update other information
-	clusterList[i].EventsNum = clusterList[i].EventsNum + 1;
-	clusterList[i].mass = 1 + clusterList[i].mass * exp(-dt / clusterMassDecay);
-	clusterList[i].LastTime = ts;
+static void deleteCluster(SVFilterState state, int32_t index) {
+	gridUnlink(state, index);
+	state->clusters[index].gridCell = SVFILTER_NO_CLUSTER;
 
+	state->freeClusters[state->freeClustersNumber++] = index;
 }
 
+static void gridLink(SVFilterState state, int32_t index) {
+	struct SVFilter_cluster *cluster = &state->clusters[index];
+	int32_t *head = &state->grid[cluster->gridCell];
 
+	cluster->gridPrev = SVFILTER_NO_CLUSTER;
+	cluster->gridNext = *head;
 
-static Cluster newCluster(uint16_t x, uint16_t y, int64_t ts) {
-	Cluster clusterNew;
-	clusterNew.xCenter = x;
-	clusterNew.yCenter = y;
-	clusterNew.xTotal = x;
-	clusterNew.yTotal = y;
-	clusterNew.xVelocity = 0;
-	clusterNew.yVelocity = 0;
-	clusterNew.xRadius = defaultClusterRadius;
-	clusterNew.yRadius = defaultClusterRadius;
-	clusterNew.EventsNum = 1;
-	clusterNew.mass = 1;
-	clusterNew.LastTime = ts;
-	clusterNew.birthTime = ts;
-	clusterNew.isEmpty = false;
-	clusterNew.isVisible = false;
-	return (clusterNew);
+	if (*head != SVFILTER_NO_CLUSTER) {
+		state->clusters[*head].gridPrev = index;
+	}
+
+	*head = index;
 }
 
+static void gridUnlink(SVFilterState state, int32_t index) {
+	struct SVFilter_cluster *cluster = &state->clusters[index];
 
-static int pruning(int64_t ts){
-	int i;
-	int c = 0;
-	for (i=0; i<maxClusterNum; i++) {
-		if (clusterList[i].isEmpty != true) {
-			int64_t dt = ts - clusterList[i].LastTime;
-			float mass = clusterList[i].mass * exp(-dt / clusterMassDecay);
-			if ((ts - clusterList[i].birthTime) > clusterMassDecay && mass < visualThrehold){
-				clusterList[i].isEmpty = true;
-				clusterList[i].isVisible = false;
-				currentClusterNum = currentClusterNum - 1;
-				c++;
-			}
-		}
+	if (cluster->gridPrev != SVFILTER_NO_CLUSTER) {
+		state->clusters[cluster->gridPrev].gridNext = cluster->gridNext;
+	}
+	else {
+		state->grid[cluster->gridCell] = cluster->gridNext;
+	}
+
+	if (cluster->gridNext != SVFILTER_NO_CLUSTER) {
+		state->clusters[cluster->gridNext].gridPrev = cluster->gridPrev;
 	}
-	return (c);
 }
 
+/**
+ * Delete clusters whose mass faded below massVisible, once they had
+ * massDecayTime to build it up, and merge clusters that track the same
+ * object into the older one.
+ */
+static void pruneClusters(SVFilterState state, int64_t ts) {
+	state->lastPruneTimestamp = ts;
 
+	for (int32_t i = 0; i < state->poolMaxClusters; i++) {
+		struct SVFilter_cluster *cluster = &state->clusters[i];
 
-static void merge() {
-	int i,j;
-	for (i = 0; i < maxClusterNum; i++) {
-		if (clusterList[i].isEmpty != true) {
-			for (j = i + 1; j < maxClusterNum; j++) {
-				if (clusterList[i].isEmpty != true && clusterList[j].isEmpty != true) {
+		if (cluster->gridCell == SVFILTER_NO_CLUSTER) {
+			continue;
+		}
 
-					// check merge condition
-					float distanceC1C2 = abs(clusterList[i].xCenter - clusterList[j].xCenter) + abs(clusterList[i].yCenter - clusterList[j].yCenter);
-							//float radiusC1C2 = sqrt(clusterList[i].xRadius * clusterList[i].xRadius + clusterList[i].yRadius * clusterList[i].yRadius) + sqrt(clusterList[j].xRadius * clusterList[j].xRadius + clusterList[j].yRadius * clusterList[j].yRadius);
-					float radiusC1C2 = clusterList[i].xRadius + clusterList[i].yRadius + clusterList[j].xRadius + clusterList[j].yRadius;
-							//&& clusterList[i].isVisible == true && clusterList[j].isVisible == true
-					if (distanceC1C2 < radiusC1C2) {
-						clusterList[i].isEmpty = true;
-						currentClusterNum = currentClusterNum - 1;
+		float mass = cluster->mass * expf((float) (cluster->lastTime - ts) / state->massDecayTime);
 
+		if ((float) (ts - cluster->birthTime) > state->massDecayTime && mass < state->massVisible) {
+			deleteCluster(state, i);
+			continue;
+		}
 
-						// find weak one and delete it
-//						if (clusterList[i].mass < clusterList[j].mass)
-//							weak = i;
-//						else
-//							weak = j;
-						//float mMerge = clusterList[j].mass / (clusterList[i].mass + clusterList[j].mass);
-						//clusterList[j].xCenter = (1 - mMerge) * clusterList[i].xCenter + mMerge * clusterList[j].xCenter;
-						//if (clusterList[i].LastTime > clusterList[j].LastTime)
-						//	clusterList[j].LastTime = clusterList[i].LastTime;
+		int32_t j = getNearestCluster(state, cluster->x, cluster->y, i);
+		if (j == SVFILTER_NO_CLUSTER) {
+			continue;
+		}
 
+		struct SVFilter_cluster *other = &state->clusters[j];
+		float otherMass = other->mass * expf((float) (other->lastTime - ts) / state->massDecayTime);
 
-						//clusterList[i]->EventsNum = clusterList[i]->EventsNum + clusterList[j]->EventsNum;
-						//clusterList[i]->xTotal = clusterList[i]->xTotal + clusterList[j]->xTotal;
-						//clusterList[i]->xCenter = clusterList[i]->xTotal / clusterList[i]->EventsNum;
-						//clusterList[i]->yTotal = clusterList[i]->yTotal + clusterList[j]->yTotal;
-						//clusterList[i]->yCenter = clusterList[i]->yTotal / clusterList[i]->EventsNum;
-						//if (clusterList[j]->LastTime > clusterList[i]->LastTime) clusterList[i]->LastTime = clusterList[j]->LastTime;
+		// Keep the older one, moved to the mass-weighted center of both.
+		struct SVFilter_cluster *keep = (cluster->birthTime <= other->birthTime) ? (cluster) : (other);
+		int32_t keepIndex = (keep == cluster) ? (i) : (j);
+		int32_t dropIndex = (keep == cluster) ? (j) : (i);
+		float weight = (mass + otherMass > 0) ? (otherMass / (mass + otherMass)) : (0.5f);
 
-					}
-				}
-			}
+		keep->x = cluster->x + (weight * (other->x - cluster->x));
+		keep->y = cluster->y + (weight * (other->y - cluster->y));
+		keep->mass = mass + otherMass;
+		keep->lastTime = ts;
+		keep->visible = cluster->visible || other->visible;
+
+		deleteCluster(state, dropIndex);
+
+		int32_t gridCell = (((int32_t) keep->y / state->poolClusterRadius) * state->gridSizeX)
+			+ ((int32_t) keep->x / state->poolClusterRadius);
+
+		if (gridCell != keep->gridCell) {
+			gridUnlink(state, keepIndex);
+			keep->gridCell = gridCell;
+			gridLink(state, keepIndex);
 		}
 	}
 }
 
+static caerPoint4DEventPacket outputClusters(caerModuleData moduleData, caerPolarityEventPacket polarity, int64_t ts) {
+	SVFilterState state = moduleData->moduleState;
 
+	int32_t clustersNumber = state->poolMaxClusters - state->freeClustersNumber;
+	if (clustersNumber == 0) {
+		return (NULL);
+	}
 
-static void caerSurveillanceConfig(caerModuleData moduleData) {
-	caerModuleConfigUpdateReset(moduleData);
-
-	SVFilterState state = moduleData->moduleState;
+	// Timestamps of the output are the packet's last one, same overflow.
+	caerPoint4DEventPacket clusterPacket = caerPoint4DEventPacketAllocate(clustersNumber, I16T(moduleData->moduleID),
+		caerEventPacketHeaderGetEventTSOverflow(&polarity->packetHeader));
+	if (clusterPacket == NULL) {
+		caerLog(CAER_LOG_ERROR, moduleData->moduleSubSystemString, "Failed to allocate cluster event packet.");
+		return (NULL);
+	}
 
-	state->deltaT = sshsNodeGetInt(moduleData->moduleNode, "deltaT");
-	state->subSampleBy = sshsNodeGetByte(moduleData->moduleNode, "subSampleBy");
-}
+	int32_t outputNumber = 0;
 
-static void caerSurveillanceExit(caerModuleData moduleData) {
-	// Remove listener, which can reference invalid memory in userData.
-	sshsNodeRemoveAttributeListener(moduleData->moduleNode, moduleData, &caerModuleConfigDefaultListener);
+	for (int32_t i = 0; i < state->poolMaxClusters; i++) {
+		struct SVFilter_cluster *cluster = &state->clusters[i];
 
-	SVFilterState state = moduleData->moduleState;
+		if (cluster->gridCell == SVFILTER_NO_CLUSTER || !cluster->visible) {
+			continue;
+		}
 
-	// Ensure map is freed.
-	simple2DBufferFreeLong(state->blobMap);
-}
+		caerPoint4DEvent clusterEvent = caerPoint4DEventPacketGetEvent(clusterPacket, outputNumber++);
+		caerPoint4DEventSetX(clusterEvent, cluster->x);
+		caerPoint4DEventSetY(clusterEvent, cluster->y);
+		caerPoint4DEventSetZ(clusterEvent, (float) cluster->id);
+		caerPoint4DEventSetW(clusterEvent,
+			cluster->mass * expf((float) (cluster->lastTime - ts) / state->massDecayTime));
+		caerPoint4DEventSetTimestamp(clusterEvent, I32T(ts & INT32_MAX));
+		caerPoint4DEventValidate(clusterEvent, clusterPacket);
+	}
 
-static void caerSurveillanceReset(caerModuleData moduleData, uint16_t resetCallSourceID) {
-	UNUSED_ARGUMENT(resetCallSourceID);
+	if (outputNumber == 0) {
+		free(clusterPacket);
+		return (NULL);
+	}
 
-	SVFilterState state = moduleData->moduleState;
+	caerEventPacketHeaderSetEventNumber(&clusterPacket->packetHeader, outputNumber);
 
-	// Reset timestamp map to all zeros (startup state).
-	simple2DBufferResetLong(state->blobMap);
+	return (clusterPacket);
 }
 
-static bool allocateBlobMap(SVFilterState state, int16_t sourceID) {
-	// Get size information from source.
-	sshsNode sourceInfoNode = caerMainloopGetSourceInfo(U16T(sourceID));
-	if (sourceInfoNode == NULL) {
-		// This should never happen, but we handle it gracefully.
-		caerLog(CAER_LOG_ERROR, __func__, "Failed to get source info to allocate timestamp map.");
-		return (false);
+static caerFrameEventPacket renderFrame(caerModuleData moduleData) {
+	SVFilterState state = moduleData->moduleState;
+	int32_t sizeX = state->sizeX;
+	int32_t sizeY = state->sizeY;
+
+	caerFrameEventPacket framePacket = caerFrameEventPacketAllocate(1, I16T(moduleData->moduleID), 0, sizeX, sizeY,
+		3);
+	if (framePacket == NULL) {
+		return (NULL);
 	}
 
-	int16_t sizeX = sshsNodeGetShort(sourceInfoNode, "dvsSizeX");
-	int16_t sizeY = sshsNodeGetShort(sourceInfoNode, "dvsSizeY");
+	caerFrameEvent frameEvent = caerFrameEventPacketGetEvent(framePacket, 0);
+	uint16_t *pixels = frameEvent->pixels;
 
-	state->blobMap = simple2DBufferInitLong((size_t) sizeX, (size_t) sizeY);
-	if (state->blobMap == NULL) {
-		return (false);
+	// Pixels start out black, only the visible clusters' boxes are drawn (in red).
+	memset(pixels, 0, (size_t) sizeX * (size_t) sizeY * 3 * sizeof(uint16_t));
+
+	for (int32_t i = 0; i < state->poolMaxClusters; i++) {
+		struct SVFilter_cluster *cluster = &state->clusters[i];
+
+		if (cluster->gridCell == SVFILTER_NO_CLUSTER || !cluster->visible) {
+			continue;
+		}
+
+		int32_t centerX = (int32_t) cluster->x;
+		int32_t centerY = (int32_t) cluster->y;
+		int32_t radius = state->poolClusterRadius;
+
+		int32_t startX = (centerX - radius > 0) ? (centerX - radius) : (0);
+		int32_t endX = (centerX + radius < sizeX - 1) ? (centerX + radius) : (sizeX - 1);
+		int32_t startY = (centerY - radius > 0) ? (centerY - radius) : (0);
+		int32_t endY = (centerY + radius < sizeY - 1) ? (centerY + radius) : (sizeY - 1);
+
+		for (int32_t x = startX; x <= endX; x++) {
+			pixels[((startY * sizeX) + x) * 3] = UINT16_MAX;
+			pixels[((endY * sizeX) + x) * 3] = UINT16_MAX;
+		}
+
+		for (int32_t y = startY; y <= endY; y++) {
+			pixels[((y * sizeX) + startX) * 3] = UINT16_MAX;
+			pixels[((y * sizeX) + endX) * 3] = UINT16_MAX;
+		}
+
+		pixels[((centerY * sizeX) + centerX) * 3] = UINT16_MAX;
 	}
 
-	// TODO: size the map differently if subSampleBy is set!
-	return (true);
-}
+	// Add info to the frame.
+	caerFrameEventSetLengthXLengthYChannelNumber(frameEvent, sizeX, sizeY, 3, framePacket);
+	// Validate frame.
+	caerFrameEventValidate(frameEvent, framePacket);
 
+	return (framePacket);
+}
@@ -1,5 +1,5 @@
 /*
- * backgroundactivityfilter.h
+ * surveillance.h
  *
  *  Created on: Jan  2017
  *      Author: Tianyu
@@ -11,8 +11,24 @@
 #include "main.h"
 
 #include <libcaer/events/polarity.h>
+#include <libcaer/events/point4d.h>
 #include <libcaer/events/frame.h>
 
-void caerSurveillanceFilter(uint16_t moduleID, caerPolarityEventPacket polarity, caerFrameEventPacket frame);
+/**
+ * Track clusters of events, such as people moving in a scene.
+ *
+ * Each visible cluster is reported once per packet as a Point4D event, with
+ * its center in X and Y, its ID in Z and its mass (decayed event count) in W.
+ * IDs stay the same while a cluster is tracked.
+ *
+ * @param moduleID the module ID.
+ * @param polarity the polarity events to track.
+ * @param clusters returns the visible clusters, NULL if none. To be freed by the caller.
+ *                 Can be NULL, if the clusters are not needed.
+ * @param frame returns a rendering of the visible clusters when the frame
+ *              interval elapsed, NULL otherwise. To be freed by the caller.
+ */
+void caerSurveillanceFilter(uint16_t moduleID, caerPolarityEventPacket polarity, caerPoint4DEventPacket *clusters,
+	caerFrameEventPacket *frame);
 
 #endif /* SURVEILLANCE_H_ */
@@ -1,5 +1,6 @@
 #include "visualizer.h"
 #include "base/mainloop.h"
+#include "base/log.h"
 #include "ext/ringbuffer/ringbuffer.h"
 #include "modules/statistics/statistics.h"
 #ifdef HAVE_PTHREADS
@@ -336,8 +337,10 @@ void caerVisualizerUpdate(caerVisualizerState state, caerEventPacketContainer co
 
 	if (!ringBufferPut(state->dataTransfer, containerCopy)) {
 		caerEventPacketContainerFree(containerCopy);
+		atomic_fetch_add_explicit(&caerMainloopGetReference()->dataDropped, 1, memory_order_relaxed);
 
-		caerLog(CAER_LOG_INFO, state->parentModule->moduleSubSystemString,
+		// Overload condition, keep logging cheap here.
+		caerLogRateLimited(CAER_LOG_INFO, state->parentModule->moduleSubSystemString,
 			"Visualizer: Failed to move event packet container copy to ring-buffer (full).");
 		return;
 	}